@@ -0,0 +1,77 @@
+#include "atomicfilewriter.h"
+#include <QCryptographicHash>
+#include <QSaveFile>
+#include <QFileInfo>
+#include <QFile>
+#include <QMutexLocker>
+
+QMutex AtomicFileWriter::stampMutex;
+QHash<QString, AtomicFileWriter::FileStamp> AtomicFileWriter::stamps;
+
+QByteArray AtomicFileWriter::contentHash(const QByteArray &content)
+{
+    return QCryptographicHash::hash(content, QCryptographicHash::Sha1);
+}
+
+bool AtomicFileWriter::diskMatches(const QString &path, const QByteArray &hash, qint64 size)
+{
+    QFileInfo info(path);
+    if (!info.exists() || info.size() != size) {
+        return false;
+    }
+
+    // A file we already know about and that hasn't been touched since doesn't need reading
+    {
+        QMutexLocker locker(&stampMutex);
+        auto it = stamps.constFind(path);
+        if (it != stamps.constEnd() && it->size == info.size() && it->modified == info.lastModified()) {
+            return it->hash == hash;
+        }
+    }
+
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    QByteArray diskHash = contentHash(file.readAll());
+    file.close();
+
+    QMutexLocker locker(&stampMutex);
+    stamps.insert(path, {info.size(), info.lastModified(), diskHash});
+    return diskHash == hash;
+}
+
+AtomicFileWriter::Result AtomicFileWriter::write(const QString &path, const QByteArray &content, QString *errorMessage)
+{
+    const QByteArray hash = contentHash(content);
+    if (diskMatches(path, hash, content.size())) {
+        return Unchanged;
+    }
+
+    // QSaveFile writes next to the target and renames on commit, so readers never see a partial file
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        if (errorMessage) {
+            *errorMessage = file.errorString();
+        }
+        return Failed;
+    }
+
+    if (file.write(content) != content.size() || !file.commit()) {
+        if (errorMessage) {
+            *errorMessage = file.errorString();
+        }
+        return Failed;
+    }
+
+    QFileInfo info(path);
+    QMutexLocker locker(&stampMutex);
+    stamps.insert(path, {info.size(), info.lastModified(), hash});
+    return Written;
+}
+
+void AtomicFileWriter::forget(const QString &path)
+{
+    QMutexLocker locker(&stampMutex);
+    stamps.remove(path);
+}
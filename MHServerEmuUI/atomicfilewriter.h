@@ -0,0 +1,40 @@
+#ifndef ATOMICFILEWRITER_H
+#define ATOMICFILEWRITER_H
+
+#include <QString>
+#include <QByteArray>
+#include <QDateTime>
+#include <QHash>
+#include <QMutex>
+
+// Publishes file contents the server may read at any moment. Content is written to a
+// temporary file and renamed over the target, and identical content is not written at all.
+class AtomicFileWriter
+{
+public:
+    enum Result {
+        Written,
+        Unchanged,
+        Failed
+    };
+
+    static Result write(const QString &path, const QByteArray &content, QString *errorMessage = nullptr);
+    static QByteArray contentHash(const QByteArray &content);
+
+    // Safe to call from any thread; hashes of files we've written or read are remembered
+    static void forget(const QString &path);
+
+private:
+    struct FileStamp {
+        qint64 size = -1;
+        QDateTime modified;
+        QByteArray hash;
+    };
+
+    static bool diskMatches(const QString &path, const QByteArray &hash, qint64 size);
+
+    static QMutex stampMutex;
+    static QHash<QString, FileStamp> stamps;
+};
+
+#endif // ATOMICFILEWRITER_H
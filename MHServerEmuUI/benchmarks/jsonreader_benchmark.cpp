@@ -0,0 +1,174 @@
+// Compares the streaming readers against QJsonDocument on generated multi-megabyte inputs.
+// Usage: jsonreader_benchmark [entries] [iterations]
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QJsonDocument>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QTemporaryDir>
+#include <QFile>
+#include <QTextStream>
+#include <QDebug>
+#include <functional>
+#include "../livetuningstore.h"
+#include "../billingcatalog.h"
+
+namespace {
+
+QByteArray makeLiveTuning(int entries)
+{
+    static const char *settings[] = {
+        "eGTV_XPGain", "eWETV_MobDropRate", "ePTV_PowerCost", "eRT_BonusXPPct", "eLT_RareItemFind",
+        "eMTV_EventInterval", "eCTV_DurationMult", "eAETV_XPBuff", "eATV_SpawnRate", "ePOTV_SpawnMult"
+    };
+
+    LiveTuningStore store;
+    store.reserve(entries);
+    for (int i = 0; i < entries; ++i) {
+        const QString prototype = QString("Entity/Characters/Mobs/Group%1/Mob%2.prototype").arg(i / 100).arg(i);
+        store.append(prototype, settings[i % 10], 1.0 + (i % 40) * 0.25);
+    }
+    return store.toJson();
+}
+
+QByteArray makeCatalog(int entries)
+{
+    QByteArray out = "{\n  \"Entries\": [\n";
+    for (int i = 0; i < entries; ++i) {
+        out += QString(
+            "    {\n"
+            "      \"SkuId\": %1,\n"
+            "      \"GuidItems\": [ { \"ItemPrototypeRuntimeIdForClient\": %2, \"Quantity\": 1 } ],\n"
+            "      \"AdditionalGuidItems\": [],\n"
+            "      \"LocalizedEntries\": [ { \"LanguageId\": \"en_us\", \"Description\": \"Generated entry %1 with a longer description string\", "
+            "\"Title\": \"Costume %1\", \"ReleaseDate\": \"\", \"ItemPrice\": %3 } ],\n"
+            "      \"InfoUrls\": [],\n"
+            "      \"ContentData\": [],\n"
+            "      \"Type\": { \"Name\": \"Costume\", \"Order\": 1 },\n"
+            "      \"TypeModifiers\": [ { \"Name\": \"Giftable\", \"Order\": 1 } ]\n"
+            "    }%4\n")
+            .arg(i + 1)
+            .arg(1000000000LL + i)
+            .arg(400 + (i % 10) * 100)
+            .arg(i + 1 < entries ? "," : "")
+            .toUtf8();
+    }
+    out += "  ]\n}\n";
+    return out;
+}
+
+// What the UI did before: a full DOM, then one pass to pull the typed fields out
+int domLiveTuning(const QByteArray &json)
+{
+    LiveTuningStore store;
+    const QJsonArray array = QJsonDocument::fromJson(json).array();
+    store.reserve(array.size());
+    for (const QJsonValue &value : array) {
+        const QJsonObject object = value.toObject();
+        store.append(object["Prototype"].toString(), object["Setting"].toString(), object["Value"].toDouble());
+    }
+    return store.size();
+}
+
+int domCatalog(const QByteArray &json)
+{
+    QVector<BillingCatalogEntry> entries;
+    const QJsonArray array = QJsonDocument::fromJson(json).object()["Entries"].toArray();
+    entries.reserve(array.size());
+    for (const QJsonValue &value : array) {
+        const QJsonObject object = value.toObject();
+        const QJsonObject localized = object["LocalizedEntries"].toArray().first().toObject();
+        BillingCatalogEntry entry;
+        entry.skuId = object["SkuId"].toInteger();
+        entry.typeName = object["Type"].toObject()["Name"].toString();
+        entry.title = localized["Title"].toString();
+        entry.price = localized["ItemPrice"].toInteger();
+        entry.itemCount = object["GuidItems"].toArray().size();
+        entries.append(entry);
+    }
+    return entries.size();
+}
+
+// Best of several runs, in milliseconds
+double bestOf(int iterations, const std::function<int()> &run, int *result)
+{
+    qint64 best = -1;
+    for (int i = 0; i < iterations; ++i) {
+        QElapsedTimer timer;
+        timer.start();
+        *result = run();
+        const qint64 elapsed = timer.nsecsElapsed();
+        if (best < 0 || elapsed < best) {
+            best = elapsed;
+        }
+    }
+    return best / 1e6;
+}
+
+void report(QTextStream &out, const QString &name, qint64 bytes, int iterations,
+            const std::function<int()> &dom, const std::function<int()> &stream)
+{
+    int domCount = 0;
+    int streamCount = 0;
+    const double domMs = bestOf(iterations, dom, &domCount);
+    const double streamMs = bestOf(iterations, stream, &streamCount);
+
+    out << QString("%1 (%2 MB, %3 entries)\n").arg(name).arg(bytes / 1048576.0, 0, 'f', 1).arg(streamCount);
+    out << QString("    QJsonDocument: %1 ms\n").arg(domMs, 0, 'f', 2);
+    out << QString("    Streaming:     %1 ms (%2x)\n").arg(streamMs, 0, 'f', 2).arg(domMs / streamMs, 0, 'f', 1);
+    if (domCount != streamCount) {
+        out << QString("    MISMATCH: %1 vs %2 entries\n").arg(domCount).arg(streamCount);
+    }
+    out.flush();
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    const QStringList args = app.arguments();
+    const int entries = args.size() > 1 ? args.at(1).toInt() : 50000;
+    const int iterations = args.size() > 2 ? args.at(2).toInt() : 5;
+
+    QTemporaryDir dir;
+    const QString liveTuningPath = dir.filePath("LiveTuningData.json");
+    const QString catalogPath = dir.filePath("Catalog.json");
+    const QByteArray liveTuning = makeLiveTuning(entries);
+    const QByteArray catalog = makeCatalog(entries);
+
+    for (const auto &file : {qMakePair(liveTuningPath, liveTuning), qMakePair(catalogPath, catalog)}) {
+        QFile out(file.first);
+        if (!out.open(QIODevice::WriteOnly) || out.write(file.second) != file.second.size()) {
+            qWarning() << "Could not write" << file.first;
+            return 1;
+        }
+    }
+
+    // Both sides start from the file so the read is part of the measurement
+    QTextStream out(stdout);
+    report(out, "LiveTuningData.json", liveTuning.size(), iterations,
+        [&]() {
+            QFile file(liveTuningPath);
+            file.open(QIODevice::ReadOnly);
+            return domLiveTuning(file.readAll());
+        },
+        [&]() {
+            LiveTuningStore store;
+            store.loadFile(liveTuningPath, nullptr);
+            return store.size();
+        });
+    report(out, "Catalog.json", catalog.size(), iterations,
+        [&]() {
+            QFile file(catalogPath);
+            file.open(QIODevice::ReadOnly);
+            return domCatalog(file.readAll());
+        },
+        [&]() {
+            BillingCatalog store;
+            store.loadFile(catalogPath, nullptr);
+            return store.size();
+        });
+    return 0;
+}
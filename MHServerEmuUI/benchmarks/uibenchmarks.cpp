@@ -0,0 +1,398 @@
+// QBENCHMARK suite over the UI's hot paths, each run on generated fixtures at a realistic size
+// and at 100x that. Machine-readable results: ui_benchmarks -csv -o results.csv,csv
+// (ctest runs it that way and leaves ui_benchmarks.csv in the build directory).
+
+#include <QtTest>
+#include <QApplication>
+#include <QTemporaryDir>
+#include <QCheckBox>
+#include <QComboBox>
+#include <QLineEdit>
+#include <QListWidget>
+#include <QJsonDocument>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include "../serverinstance.h"
+#include "../livetuningstore.h"
+#include "../livetuningmodel.h"
+#include "../effectivelivetuning.h"
+#include "../eventchangeset.h"
+#include "../eventregistry.h"
+#include "../inifile.h"
+#include "../configschema.h"
+#include "../atomicfilewriter.h"
+
+namespace {
+
+// Realistic sizes, the 100x rows multiply every one of them
+constexpr int ConsoleLinesPerRead = 500;
+constexpr int SessionsOnline = 200;
+constexpr int LiveTuningEntries = 500;
+constexpr int ConfigSections = 12;
+constexpr int ConfigKeysPerSection = 6;
+constexpr int EventFiles = 12;
+constexpr int EntriesPerEvent = 20;
+
+const char *const tuningSettings[] = {
+    "eGTV_XPGain", "eWETV_MobDropRate", "ePTV_PowerCost", "eRT_BonusXPPct", "eLT_RareItemFind",
+    "eMTV_EventInterval", "eCTV_DurationMult", "eAETV_XPBuff", "eATV_SpawnRate", "ePOTV_SpawnMult"
+};
+
+void addScales()
+{
+    QTest::addColumn<int>("scale");
+    QTest::newRow("realistic") << 1;
+    QTest::newRow("100x") << 100;
+}
+
+QByteArray loginLine(int session)
+{
+    return QString("[Info] [PlayerConnectionManager] Accepted and registered client [Account=Player%1 (0x%2), SessionId=0x%3]\n")
+        .arg(session).arg(0x1000 + session, 0, 16).arg(0x50000 + session, 0, 16).toLatin1();
+}
+
+QByteArray logoutLine(int session)
+{
+    return QString("[Info] [PlayerConnectionManager] Removed client [Account=Player%1 (0x%2), SessionId=0x%3]\n")
+        .arg(session).arg(0x1000 + session, 0, 16).arg(0x50000 + session, 0, 16).toLatin1();
+}
+
+// Mostly chatter with logins, matching logouts and a client info block mixed in, so the
+// session registry ends every read where it started
+QByteArray makeConsoleRead(int lines)
+{
+    QByteArray out;
+    int session = 0;
+    for (int i = 0; i < lines; ++i) {
+        switch (i % 50) {
+        case 10:
+            out += loginLine(session);
+            break;
+        case 30:
+            out += logoutLine(session++);
+            break;
+        case 40:
+            out += "SessionId: 0x50000\nAccount: Player0\nRegion: Avengers Tower\nEnd of client info\n";
+            i += 3;
+            break;
+        default:
+            out += QString("[Info] [Game] Region %1 ticked, %2 entities simulated\n").arg(i % 37).arg(i * 7 % 1000).toLatin1();
+            break;
+        }
+    }
+    return out;
+}
+
+QByteArray makeLiveTuning(int entries)
+{
+    LiveTuningStore store;
+    store.reserve(entries);
+    for (int i = 0; i < entries; ++i) {
+        const QString prototype = QString("Entity/Characters/Mobs/Group%1/Mob%2.prototype").arg(i / 100).arg(i);
+        store.append(prototype, tuningSettings[i % 10], 1.0 + (i % 40) * 0.25);
+    }
+    return store.toJson();
+}
+
+QByteArray makeConfig(int sections, int keysPerSection)
+{
+    QByteArray out;
+    for (int s = 0; s < sections; ++s) {
+        out += QString("; Settings for section %1\n[Section%1]\n").arg(s).toLatin1();
+        for (int k = 0; k < keysPerSection; ++k) {
+            out += QString("Key%1=%2\n").arg(k).arg(k % 3 == 1 ? QString::number(k % 4) : QString("Value%1").arg(k)).toLatin1();
+        }
+        out += "\n";
+    }
+    return out;
+}
+
+bool writeFile(const QString &path, const QByteArray &content)
+{
+    QFile file(path);
+    return file.open(QIODevice::WriteOnly) && file.write(content) == content.size();
+}
+
+// Widgets the schema fills: every third key is a combo box, the rest alternate check box / line edit
+void buildSchema(ConfigSchema *schema, QWidget *parent, int sections, int keysPerSection)
+{
+    for (int s = 0; s < sections; ++s) {
+        for (int k = 0; k < keysPerSection; ++k) {
+            const QString section = QString("Section%1").arg(s);
+            const QString key = QString("Key%1").arg(k);
+            if (k % 3 == 1) {
+                QComboBox *comboBox = new QComboBox(parent);
+                comboBox->addItems({"0", "1", "2", "3"});
+                schema->add(section, key, ConfigSchema::Integer, comboBox, "0");
+            } else if (k % 3 == 2) {
+                schema->add(section, key, ConfigSchema::Bool, new QCheckBox(parent), "false");
+            } else {
+                schema->add(section, key, ConfigSchema::Text, new QLineEdit(parent));
+            }
+        }
+    }
+}
+
+} // namespace
+
+class UiBenchmarks : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void consoleIngestion_data() { addScales(); }
+    void consoleIngestion();
+    void sessionAddRemove_data() { addScales(); }
+    void sessionAddRemove();
+
+    void liveTuningLoad_data() { addScales(); }
+    void liveTuningLoad();
+    void liveTuningCategorySwitch_data() { addScales(); }
+    void liveTuningCategorySwitch();
+    void liveTuningSave_data() { addScales(); }
+    void liveTuningSave();
+    void liveTuningAddSetting_data() { addScales(); }
+    void liveTuningAddSetting();
+
+    void configLoad_data() { addScales(); }
+    void configLoad();
+    void configSave_data() { addScales(); }
+    void configSave();
+
+    void eventToggle_data() { addScales(); }
+    void eventToggle();
+
+private:
+    QString fixturePath(const QString &name, int scale) const { return dir.filePath(QString("%1/%2").arg(scale).arg(name)); }
+
+    QTemporaryDir dir;
+};
+
+void UiBenchmarks::initTestCase()
+{
+    QVERIFY(dir.isValid());
+
+    // Fixtures are written once up front so the measured loops only see their own work
+    for (int scale : {1, 100}) {
+        QVERIFY(QDir(dir.path()).mkpath(QString("%1/LiveTuning").arg(scale)));
+        QVERIFY(writeFile(fixturePath("LiveTuningData.json", scale), makeLiveTuning(LiveTuningEntries * scale)));
+        QVERIFY(writeFile(fixturePath("config.ini", scale), makeConfig(ConfigSections * scale, ConfigKeysPerSection)));
+        QVERIFY(writeFile(fixturePath("ConfigOverride.ini", scale), makeConfig(ConfigSections * scale / 2, ConfigKeysPerSection / 2)));
+
+        // Half of the events start switched off
+        for (int i = 0; i < EventFiles * scale; ++i) {
+            LiveTuningStore event;
+            for (int j = 0; j < EntriesPerEvent; ++j) {
+                event.append(QString("Entity/Events/Event%1/Entry%2.prototype").arg(i).arg(j), tuningSettings[j % 10], 2.0);
+            }
+            const QString fileName = QString("%1LiveTuningData_Event%2.json").arg(i % 2 ? "OFF_" : "").arg(i);
+            QVERIFY(writeFile(fixturePath("LiveTuning/" + fileName, scale), event.toJson()));
+        }
+    }
+}
+
+void UiBenchmarks::consoleIngestion()
+{
+    QFETCH(int, scale);
+    const QByteArray read = makeConsoleRead(ConsoleLinesPerRead * scale);
+    ServerInstance instance("Benchmark", dir.path());
+
+    QBENCHMARK {
+        instance.handleOutput(read);
+    }
+    QCOMPARE(instance.loggedInUsers().size(), 0);
+}
+
+void UiBenchmarks::sessionAddRemove()
+{
+    QFETCH(int, scale);
+    const int sessions = SessionsOnline * scale;
+
+    QByteArray logins;
+    for (int i = 0; i < sessions; ++i) {
+        logins += loginLine(i);
+    }
+
+    // Players leave in a different order than they came
+    QVector<int> order(sessions);
+    std::iota(order.begin(), order.end(), 0);
+    std::shuffle(order.begin(), order.end(), std::mt19937(42));
+    QByteArray logouts;
+    for (int session : order) {
+        logouts += logoutLine(session);
+    }
+
+    // Same list bookkeeping as MainWindow::addUserToList / removeUserFromList
+    ServerInstance instance("Benchmark", dir.path());
+    QListWidget list;
+    connect(&instance, &ServerInstance::playerLoggedIn, &list, [&list](const QString &sessionId, const QString &accountName) {
+        QListWidgetItem *item = new QListWidgetItem(accountName, &list);
+        item->setData(Qt::UserRole, sessionId);
+    });
+    connect(&instance, &ServerInstance::playerLoggedOut, &list, [&list](const QString &sessionId, const QString &) {
+        for (int i = 0; i < list.count(); ++i) {
+            if (list.item(i)->data(Qt::UserRole).toString() == sessionId) {
+                delete list.takeItem(i);
+                return;
+            }
+        }
+    });
+
+    QBENCHMARK {
+        instance.handleOutput(logins);
+        instance.handleOutput(logouts);
+    }
+    QCOMPARE(list.count(), 0);
+}
+
+void UiBenchmarks::liveTuningLoad()
+{
+    QFETCH(int, scale);
+    const QString path = fixturePath("LiveTuningData.json", scale);
+    LiveTuningStore store;
+
+    QBENCHMARK {
+        QVERIFY(store.loadFile(path, nullptr));
+    }
+    QCOMPARE(store.size(), LiveTuningEntries * scale);
+}
+
+void UiBenchmarks::liveTuningCategorySwitch()
+{
+    QFETCH(int, scale);
+    LiveTuningStore store;
+    QVERIFY(store.loadFile(fixturePath("LiveTuningData.json", scale), nullptr));
+    LiveTuningModel model;
+    model.setStore(&store);
+
+    // One pass through every category, as when clicking down the category list
+    QBENCHMARK {
+        for (int category = 0; category < static_cast<int>(LiveTuningCategory::Count); ++category) {
+            model.setCategory(static_cast<LiveTuningCategory>(category));
+        }
+    }
+}
+
+void UiBenchmarks::liveTuningSave()
+{
+    QFETCH(int, scale);
+    LiveTuningStore store;
+    QVERIFY(store.loadFile(fixturePath("LiveTuningData.json", scale), nullptr));
+    const QString path = fixturePath("Saved.json", scale);
+
+    // One edited value per save so every write really reaches the disk
+    int edit = 0;
+    QBENCHMARK {
+        store.setValue(edit % store.size(), 10.0 + edit);
+        ++edit;
+        QVERIFY(AtomicFileWriter::write(path, store.toJson()) != AtomicFileWriter::Failed);
+        store.markClean();
+    }
+}
+
+void UiBenchmarks::liveTuningAddSetting()
+{
+    QFETCH(int, scale);
+    const QString source = fixturePath("LiveTuningData.json", scale);
+    const QString path = fixturePath("Added.json", scale);
+
+    // Same steps as MainWindow::onPushButtonAddLTSettingClicked: read, append, write back
+    int added = 0;
+    QBENCHMARK {
+        QFile file(source);
+        QVERIFY(file.open(QIODevice::ReadOnly));
+        QJsonArray entries = QJsonDocument::fromJson(file.readAll()).array();
+
+        QJsonObject setting;
+        setting["Prototype"] = QString("Entity/Characters/Mobs/Added/Mob%1.prototype").arg(added++);
+        setting["Setting"] = "eWETV_MobDropRate";
+        setting["Value"] = 2.5;
+        entries.append(setting);
+        QVERIFY(AtomicFileWriter::write(path, QJsonDocument(entries).toJson()) != AtomicFileWriter::Failed);
+    }
+}
+
+void UiBenchmarks::configLoad()
+{
+    QFETCH(int, scale);
+    QWidget page;
+    ConfigSchema schema;
+    buildSchema(&schema, &page, ConfigSections * scale, ConfigKeysPerSection);
+
+    QBENCHMARK {
+        IniFile base;
+        IniFile overrides;
+        QVERIFY(base.load(fixturePath("config.ini", scale)));
+        QVERIFY(overrides.load(fixturePath("ConfigOverride.ini", scale)));
+        schema.load(base.toMap(), overrides.toMap());
+    }
+}
+
+void UiBenchmarks::configSave()
+{
+    QFETCH(int, scale);
+    QWidget page;
+    ConfigSchema schema;
+    buildSchema(&schema, &page, ConfigSections * scale, ConfigKeysPerSection);
+
+    IniFile base;
+    QVERIFY(base.load(fixturePath("config.ini", scale)));
+    const QVariantMap baseValues = base.toMap();
+    schema.load(baseValues, QVariantMap());
+
+    QFile overrideFile(fixturePath("ConfigOverride.ini", scale));
+    QVERIFY(overrideFile.open(QIODevice::ReadOnly));
+    const QByteArray overrideText = overrideFile.readAll();
+    const QString path = fixturePath("Saved.ini", scale);
+
+    // A check box flips between saves so the override actually changes
+    QCheckBox *toggled = qobject_cast<QCheckBox *>(schema.fields().at(2).widget);
+    QVERIFY(toggled);
+    QBENCHMARK {
+        toggled->setChecked(!toggled->isChecked());
+        IniFile overrides;
+        overrides.parse(overrideText);
+        schema.applyTo(&overrides, baseValues);
+        QVERIFY(AtomicFileWriter::write(path, overrides.toText()) != AtomicFileWriter::Failed);
+    }
+}
+
+void UiBenchmarks::eventToggle()
+{
+    QFETCH(int, scale);
+    const QString folder = fixturePath("LiveTuning", scale);
+
+    EffectiveLiveTuning effective;
+    effective.setDirectory(folder);
+    QStringList errors;
+    QVERIFY(effective.reloadAll(&errors));
+    EventRegistry registry;
+    registry.rebuild(folder, QStringList());
+
+    // The same event goes on and off; each toggle is a commit, an effective-tuning update
+    // and the event list refresh that follows it
+    EventChangeSet changes;
+    changes.setDirectory(folder);
+    EventChangeSet::Change change;
+    change.eventName = "Event1";
+    change.fileName = "LiveTuningData_Event1.json";
+    QBENCHMARK {
+        change.enable = !change.enable;
+        changes.stage(change);
+        QString errorMessage;
+        QVERIFY2(changes.commit(&errorMessage), qPrintable(errorMessage));
+        changes.clear();
+        QVERIFY(effective.updateFile(change.fileName, &errorMessage));
+        registry.rebuild(folder, QStringList());
+    }
+    QCOMPARE(registry.size(), EventFiles * scale);
+}
+
+QTEST_MAIN(UiBenchmarks)
+
+#include "uibenchmarks.moc"
@@ -0,0 +1,188 @@
+#include "billingcatalog.h"
+#include "jsonstreamreader.h"
+#include <QFile>
+
+namespace {
+
+// Reads the first object of an array through fieldReader and skips the rest of the array
+template <typename FieldReader>
+bool readFirstObject(JsonStreamReader &reader, JsonStreamReader::Token token, FieldReader fieldReader)
+{
+    if (token != JsonStreamReader::BeginArray) {
+        return reader.skip(token);
+    }
+
+    bool first = true;
+    while ((token = reader.next()) != JsonStreamReader::EndArray) {
+        if (token != JsonStreamReader::BeginObject || !first) {
+            if (!reader.skip(token)) {
+                return false;
+            }
+            continue;
+        }
+        first = false;
+        while ((token = reader.next()) == JsonStreamReader::Name) {
+            if (!fieldReader()) {
+                return false;
+            }
+        }
+        if (token != JsonStreamReader::EndObject) {
+            return false;
+        }
+    }
+    return true;
+}
+
+qint64 readInteger(JsonStreamReader &reader, JsonStreamReader::Token token)
+{
+    return token == JsonStreamReader::Number ? static_cast<qint64>(reader.numberValue()) : 0;
+}
+
+bool readEntry(JsonStreamReader &reader, BillingCatalogEntry &entry)
+{
+    JsonStreamReader::Token token;
+    while ((token = reader.next()) == JsonStreamReader::Name) {
+        if (reader.nameEquals("SkuId")) {
+            token = reader.next();
+            entry.skuId = readInteger(reader, token);
+        } else if (reader.nameEquals("GuidItems")) {
+            token = reader.next();
+            if (token == JsonStreamReader::BeginArray) {
+                JsonStreamReader::Token item;
+                while ((item = reader.next()) != JsonStreamReader::EndArray) {
+                    if (!reader.skip(item)) {
+                        return false;
+                    }
+                    entry.itemCount++;
+                }
+                continue;
+            }
+        } else if (reader.nameEquals("LocalizedEntries")) {
+            token = reader.next();
+            const bool ok = readFirstObject(reader, token, [&reader, &entry]() {
+                if (reader.nameEquals("Title")) {
+                    JsonStreamReader::Token value = reader.next();
+                    if (value == JsonStreamReader::String) {
+                        entry.title = reader.stringValue();
+                        return true;
+                    }
+                    return reader.skip(value);
+                }
+                if (reader.nameEquals("ItemPrice")) {
+                    JsonStreamReader::Token value = reader.next();
+                    entry.price = readInteger(reader, value);
+                    return reader.skip(value);
+                }
+                return reader.skip(reader.next());
+            });
+            if (!ok) {
+                return false;
+            }
+            continue;
+        } else if (reader.nameEquals("Type")) {
+            token = reader.next();
+            if (token == JsonStreamReader::BeginObject) {
+                JsonStreamReader::Token field;
+                while ((field = reader.next()) == JsonStreamReader::Name) {
+                    const bool isName = reader.nameEquals("Name");
+                    JsonStreamReader::Token value = reader.next();
+                    if (isName && value == JsonStreamReader::String) {
+                        entry.typeName = reader.stringValue();
+                    } else if (!reader.skip(value)) {
+                        return false;
+                    }
+                }
+                if (field != JsonStreamReader::EndObject) {
+                    return false;
+                }
+                continue;
+            }
+        } else {
+            token = reader.next();
+        }
+
+        if (!reader.skip(token)) {
+            return false;
+        }
+    }
+    return token == JsonStreamReader::EndObject;
+}
+
+bool readEntries(JsonStreamReader &reader, QVector<BillingCatalogEntry> &entries)
+{
+    JsonStreamReader::Token token;
+    while ((token = reader.next()) != JsonStreamReader::EndArray) {
+        if (token != JsonStreamReader::BeginObject) {
+            if (!reader.skip(token)) {
+                return false;
+            }
+            continue;
+        }
+        BillingCatalogEntry entry;
+        if (!readEntry(reader, entry)) {
+            return false;
+        }
+        entries.append(entry);
+    }
+    return true;
+}
+
+} // namespace
+
+bool BillingCatalog::loadJson(const char *data, qint64 size, QString *errorMessage)
+{
+    clear();
+    JsonStreamReader reader(data, size);
+    JsonStreamReader::Token token = reader.next();
+
+    bool ok = false;
+    if (token == JsonStreamReader::BeginArray) {
+        ok = readEntries(reader, entryList);
+    } else if (token == JsonStreamReader::BeginObject) {
+        bool foundEntries = false;
+        ok = true;
+        while (ok && (token = reader.next()) == JsonStreamReader::Name) {
+            const bool isEntries = reader.nameEquals("Entries");
+            token = reader.next();
+            if (isEntries && token == JsonStreamReader::BeginArray && !foundEntries) {
+                foundEntries = true;
+                ok = readEntries(reader, entryList);
+            } else {
+                ok = reader.skip(token);
+            }
+        }
+        ok = ok && token == JsonStreamReader::EndObject && foundEntries;
+    }
+
+    if (!ok || reader.next() != JsonStreamReader::End) {
+        if (errorMessage) {
+            *errorMessage = reader.errorString().isEmpty() ? QString("Expected an array of catalog entries.") : reader.errorString();
+        }
+        clear();
+        return false;
+    }
+    return true;
+}
+
+bool BillingCatalog::loadFile(const QString &path, QString *errorMessage)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        if (errorMessage) {
+            *errorMessage = file.errorString();
+        }
+        return false;
+    }
+
+    if (file.size() == 0) {
+        return loadJson(nullptr, 0, errorMessage);
+    }
+
+    if (uchar *mapped = file.map(0, file.size())) {
+        bool ok = loadJson(reinterpret_cast<const char *>(mapped), file.size(), errorMessage);
+        file.unmap(mapped);
+        return ok;
+    }
+    const QByteArray content = file.readAll();
+    return loadJson(content.constData(), content.size(), errorMessage);
+}
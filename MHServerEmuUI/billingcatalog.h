@@ -0,0 +1,34 @@
+#ifndef BILLINGCATALOG_H
+#define BILLINGCATALOG_H
+
+#include <QString>
+#include <QVector>
+
+struct BillingCatalogEntry {
+    qint64 skuId = 0;
+    QString typeName;  // Type.Name, e.g. "Costume" or "Hero"
+    QString title;     // First localized entry
+    qint64 price = 0;  // First localized entry's ItemPrice, in G
+    int itemCount = 0; // GuidItems
+};
+
+// Summary of Data/Billing/Catalog.json (or CatalogPatch.json). Only the fields listed above are
+// decoded; everything else, including the large per-entry arrays, is skipped while streaming.
+class BillingCatalog
+{
+public:
+    void clear() { entryList.clear(); }
+
+    // Accepts both a bare array of entries and an object with an "Entries" array
+    bool loadJson(const char *data, qint64 size, QString *errorMessage);
+    bool loadFile(const QString &path, QString *errorMessage);
+
+    int size() const { return entryList.size(); }
+    const BillingCatalogEntry &at(int index) const { return entryList.at(index); }
+    const QVector<BillingCatalogEntry> &entries() const { return entryList; }
+
+private:
+    QVector<BillingCatalogEntry> entryList;
+};
+
+#endif // BILLINGCATALOG_H
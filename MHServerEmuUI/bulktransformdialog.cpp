@@ -0,0 +1,209 @@
+#include "bulktransformdialog.h"
+#include <QComboBox>
+#include <QLineEdit>
+#include <QLabel>
+#include <QTableWidget>
+#include <QHeaderView>
+#include <QPushButton>
+#include <QFormLayout>
+#include <QHBoxLayout>
+#include <QVBoxLayout>
+#include <QRegularExpression>
+#include <QElapsedTimer>
+#include <QDebug>
+
+BulkTransformDialog::BulkTransformDialog(const LiveTuningStore &store, QWidget *parent)
+    : QDialog(parent)
+    , tuningStore(store)
+{
+    setWindowTitle("Bulk Edit Live Tuning");
+    resize(760, 560);
+
+    categoryCombo = new QComboBox(this);
+    categoryCombo->addItem("All categories");
+    categoryCombo->addItems(store.categoryNames());
+
+    settingPatternEdit = new QLineEdit(this);
+    settingPatternEdit->setPlaceholderText("Wildcards allowed, e.g. eGTV_XP*; empty matches all");
+
+    prototypeFilterEdit = new QLineEdit(this);
+    prototypeFilterEdit->setPlaceholderText("Path prefix, e.g. Loot/Tables/Events/; empty matches all");
+
+    expressionEdit = new QLineEdit(this);
+    expressionEdit->setPlaceholderText("v*1.5   clamp(v,0,5)   =2   round(v*1.1,2)");
+
+    QFormLayout *form = new QFormLayout();
+    form->addRow("Category:", categoryCombo);
+    form->addRow("Setting:", settingPatternEdit);
+    form->addRow("Prototype:", prototypeFilterEdit);
+    form->addRow("Expression:", expressionEdit);
+
+    summaryLabel = new QLabel(this);
+    summaryLabel->setWordWrap(true);
+
+    previewTable = new QTableWidget(0, 4, this);
+    previewTable->setHorizontalHeaderLabels({"Prototype", "Setting", "Current", "New"});
+    previewTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    previewTable->setSelectionBehavior(QAbstractItemView::SelectRows);
+    previewTable->verticalHeader()->setVisible(false);
+    previewTable->verticalHeader()->setDefaultSectionSize(22);
+    previewTable->horizontalHeader()->setStretchLastSection(true);
+    previewTable->setColumnWidth(0, 300);
+    previewTable->setColumnWidth(1, 200);
+    previewTable->setTextElideMode(Qt::ElideMiddle);
+
+    QPushButton *previewButton = new QPushButton("Preview", this);
+    applyButton = new QPushButton("Apply, Save and Reload", this);
+    applyButton->setEnabled(false);
+    QPushButton *cancelButton = new QPushButton("Cancel", this);
+
+    QHBoxLayout *buttons = new QHBoxLayout();
+    buttons->addWidget(previewButton);
+    buttons->addStretch();
+    buttons->addWidget(applyButton);
+    buttons->addWidget(cancelButton);
+
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    layout->addLayout(form);
+    layout->addWidget(summaryLabel);
+    layout->addWidget(previewTable, 1);
+    layout->addLayout(buttons);
+
+    connect(previewButton, &QPushButton::clicked, this, &BulkTransformDialog::preview);
+    connect(expressionEdit, &QLineEdit::returnPressed, this, &BulkTransformDialog::preview);
+    connect(applyButton, &QPushButton::clicked, this, &QDialog::accept);
+    connect(cancelButton, &QPushButton::clicked, this, &QDialog::reject);
+
+    // Whatever was previewed is what gets applied, so any change to the inputs needs a new preview
+    connect(categoryCombo, &QComboBox::currentTextChanged, this, &BulkTransformDialog::invalidatePreview);
+    connect(settingPatternEdit, &QLineEdit::textChanged, this, &BulkTransformDialog::invalidatePreview);
+    connect(prototypeFilterEdit, &QLineEdit::textChanged, this, &BulkTransformDialog::invalidatePreview);
+    connect(expressionEdit, &QLineEdit::textChanged, this, &BulkTransformDialog::invalidatePreview);
+}
+
+void BulkTransformDialog::setCategory(const QString &category)
+{
+    const int index = categoryCombo->findText(category);
+    if (index >= 0) {
+        categoryCombo->setCurrentIndex(index);
+    }
+}
+
+void BulkTransformDialog::setPrototypePrefix(const QString &prefix)
+{
+    prototypeFilterEdit->setText(prefix);
+}
+
+QVector<int> BulkTransformDialog::select(const LiveTuningStore &store, const QString &category, const QString &settingPattern,
+                                         const QString &prototypePrefix)
+{
+    // Filters are decided once per distinct string, the per-entry pass only looks up ids
+    const StringPool &settings = store.settingPool();
+    QVector<bool> settingMatches(settings.size(), true);
+    if (!settingPattern.isEmpty()) {
+        const QRegularExpression pattern(QRegularExpression::wildcardToRegularExpression(settingPattern),
+                                         QRegularExpression::CaseInsensitiveOption);
+        for (int id = 0; id < settings.size(); ++id) {
+            settingMatches[id] = pattern.match(settings.at(id)).hasMatch();
+        }
+    }
+
+    const StringPool &prototypes = store.prototypePool();
+    QVector<bool> prototypeMatches(prototypes.size(), true);
+    if (!prototypePrefix.isEmpty()) {
+        for (int id = 0; id < prototypes.size(); ++id) {
+            prototypeMatches[id] = prototypes.at(id).startsWith(prototypePrefix);
+        }
+    }
+
+    QVector<int> candidates;
+    const LiveTuningCategory categoryId = liveTuningCategoryFromName(category);
+    if (store.categoryNames().contains(category)) {
+        candidates = store.rowsInCategory(categoryId);
+    } else {
+        candidates.resize(store.size());
+        for (int i = 0; i < store.size(); ++i) {
+            candidates[i] = i;
+        }
+    }
+
+    QVector<int> selected;
+    selected.reserve(candidates.size());
+    for (int index : candidates) {
+        if (settingMatches.at(store.settingId(index)) && prototypeMatches.at(store.prototypeId(index))) {
+            selected.append(index);
+        }
+    }
+    return selected;
+}
+
+QVector<LiveTuningJournal::Change> BulkTransformDialog::transform(const LiveTuningStore &store, const QVector<int> &indices,
+                                                                  const TuningExpression &expression)
+{
+    // Gather into one contiguous column, evaluate it in a single pass, then keep what moved
+    QVector<double> current(indices.size());
+    const double *values = store.values();
+    for (int i = 0; i < indices.size(); ++i) {
+        current[i] = values[indices.at(i)];
+    }
+    QVector<double> result(indices.size());
+    expression.evaluate(current.constData(), result.data(), current.size());
+
+    QVector<LiveTuningJournal::Change> changes;
+    for (int i = 0; i < indices.size(); ++i) {
+        if (result.at(i) != current.at(i)) {
+            changes.append({indices.at(i), current.at(i), result.at(i)});
+        }
+    }
+    return changes;
+}
+
+void BulkTransformDialog::preview()
+{
+    QString errorMessage;
+    if (!expression.parse(expressionEdit->text(), &errorMessage)) {
+        summaryLabel->setText(QString("Invalid expression: %1").arg(errorMessage));
+        return;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    const QVector<int> selected = select(tuningStore, categoryCombo->currentText(), settingPatternEdit->text().trimmed(),
+                                         prototypeFilterEdit->text().trimmed());
+    pendingChanges = transform(tuningStore, selected, expression);
+    qDebug() << "Bulk transform of" << selected.size() << "entries took" << timer.nsecsElapsed() / 1000 << "us";
+
+    const int shown = qMin(pendingChanges.size(), static_cast<int>(MaxPreviewRows));
+    previewTable->setRowCount(shown);
+    for (int row = 0; row < shown; ++row) {
+        const LiveTuningJournal::Change &change = pendingChanges.at(row);
+        const QStringList cells = {tuningStore.prototype(change.index), tuningStore.setting(change.index),
+                                   QString::number(change.from), QString::number(change.to)};
+        for (int column = 0; column < cells.size(); ++column) {
+            QTableWidgetItem *item = previewTable->item(row, column);
+            if (!item) {
+                item = new QTableWidgetItem();
+                previewTable->setItem(row, column, item);
+            }
+            item->setText(cells.at(column));
+            item->setToolTip(column == 0 ? cells.at(column) : QString());
+        }
+    }
+
+    QString summary = QString("%1 entries selected, %2 would change.").arg(selected.size()).arg(pendingChanges.size());
+    if (shown < pendingChanges.size()) {
+        summary += QString(" Showing the first %1.").arg(shown);
+    }
+    summaryLabel->setText(summary);
+    applyButton->setEnabled(!pendingChanges.isEmpty());
+}
+
+void BulkTransformDialog::invalidatePreview()
+{
+    pendingChanges.clear();
+    applyButton->setEnabled(false);
+    if (previewTable->rowCount() > 0) {
+        previewTable->setRowCount(0);
+        summaryLabel->setText("Inputs changed, preview again before applying.");
+    }
+}
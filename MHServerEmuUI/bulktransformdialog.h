@@ -0,0 +1,57 @@
+#ifndef BULKTRANSFORMDIALOG_H
+#define BULKTRANSFORMDIALOG_H
+
+#include <QDialog>
+#include "livetuningstore.h"
+#include "livetuningjournal.h"
+#include "tuningexpression.h"
+
+class QComboBox;
+class QLineEdit;
+class QLabel;
+class QTableWidget;
+class QPushButton;
+
+// Selects live tuning entries by category, setting wildcard and prototype prefix, applies an
+// expression to all of them at once and shows the resulting changes before anything is kept.
+class BulkTransformDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    static constexpr int MaxPreviewRows = 2000;
+
+    explicit BulkTransformDialog(const LiveTuningStore &store, QWidget *parent = nullptr);
+
+    void setCategory(const QString &category);
+    void setPrototypePrefix(const QString &prefix);
+    QLineEdit *prototypeEdit() const { return prototypeFilterEdit; }
+
+    QString expressionText() const { return expression.text(); }
+    const QVector<LiveTuningJournal::Change> &changes() const { return pendingChanges; }
+
+    // Store indices matching the filters, in store order
+    static QVector<int> select(const LiveTuningStore &store, const QString &category, const QString &settingPattern,
+                               const QString &prototypePrefix);
+    static QVector<LiveTuningJournal::Change> transform(const LiveTuningStore &store, const QVector<int> &indices,
+                                                        const TuningExpression &expression);
+
+private slots:
+    void preview();
+    void invalidatePreview();
+
+private:
+    const LiveTuningStore &tuningStore;
+    QComboBox *categoryCombo;
+    QLineEdit *settingPatternEdit;
+    QLineEdit *prototypeFilterEdit;
+    QLineEdit *expressionEdit;
+    QLabel *summaryLabel;
+    QTableWidget *previewTable;
+    QPushButton *applyButton;
+
+    TuningExpression expression;
+    QVector<LiveTuningJournal::Change> pendingChanges;
+};
+
+#endif // BULKTRANSFORMDIALOG_H
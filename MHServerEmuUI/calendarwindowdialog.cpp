@@ -0,0 +1,145 @@
+#include "calendarwindowdialog.h"
+#include <QComboBox>
+#include <QDateTimeEdit>
+#include <QSpinBox>
+#include <QCheckBox>
+#include <QLineEdit>
+#include <QLocale>
+#include <QFormLayout>
+#include <QHBoxLayout>
+#include <QVBoxLayout>
+#include <QDialogButtonBox>
+#include <QMessageBox>
+
+CalendarWindowDialog::CalendarWindowDialog(const QStringList &eventFiles, QWidget *parent)
+    : QDialog(parent)
+{
+    setWindowTitle("Event Window");
+
+    fileCombo = new QComboBox(this);
+    fileCombo->setEditable(true);
+    fileCombo->addItems(eventFiles);
+
+    repeatCombo = new QComboBox(this);
+    repeatCombo->addItems({"Once", "Daily", "Weekly"});
+
+    startEdit = new QDateTimeEdit(QDateTime::currentDateTime(), this);
+    startEdit->setCalendarPopup(true);
+    startEdit->setDisplayFormat("yyyy-MM-dd HH:mm");
+
+    durationSpin = new QSpinBox(this);
+    durationSpin->setRange(1, 60 * 24 * 14);
+    durationSpin->setValue(60);
+    durationSpin->setSuffix(" min");
+
+    QHBoxLayout *weekdays = new QHBoxLayout();
+    for (int day = 1; day <= 7; ++day) {
+        weekdayBoxes[day - 1] = new QCheckBox(QLocale::c().dayName(day, QLocale::ShortFormat), this);
+        weekdays->addWidget(weekdayBoxes[day - 1]);
+    }
+
+    untilBox = new QCheckBox("Until", this);
+    untilEdit = new QDateEdit(QDate::currentDate().addMonths(1), this);
+    untilEdit->setCalendarPopup(true);
+    untilEdit->setDisplayFormat("yyyy-MM-dd");
+    QHBoxLayout *until = new QHBoxLayout();
+    until->addWidget(untilBox);
+    until->addWidget(untilEdit, 1);
+
+    groupEdit = new QLineEdit(this);
+    groupEdit->setPlaceholderText("Windows in the same group never run together");
+
+    prioritySpin = new QSpinBox(this);
+    prioritySpin->setRange(-100, 100);
+    prioritySpin->setToolTip("Within a group the highest priority wins, ties go to the window that started first");
+
+    QFormLayout *form = new QFormLayout();
+    form->addRow("Event file:", fileCombo);
+    form->addRow("Repeat:", repeatCombo);
+    form->addRow("Starts:", startEdit);
+    form->addRow("Duration:", durationSpin);
+    form->addRow("Weekdays:", weekdays);
+    form->addRow("Ends:", until);
+    form->addRow("Group:", groupEdit);
+    form->addRow("Priority:", prioritySpin);
+
+    QDialogButtonBox *buttons = new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel, this);
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    layout->addLayout(form);
+    layout->addWidget(buttons);
+
+    connect(buttons, &QDialogButtonBox::accepted, this, &CalendarWindowDialog::accept);
+    connect(buttons, &QDialogButtonBox::rejected, this, &QDialog::reject);
+    connect(repeatCombo, &QComboBox::currentIndexChanged, this, &CalendarWindowDialog::updateRepeatControls);
+    connect(untilBox, &QCheckBox::toggled, this, &CalendarWindowDialog::updateRepeatControls);
+    updateRepeatControls();
+}
+
+void CalendarWindowDialog::setWindow(const EventCalendar::Window &window)
+{
+    fileCombo->setCurrentText(window.fileName);
+    repeatCombo->setCurrentIndex(window.repeat);
+    startEdit->setDateTime(window.start);
+    durationSpin->setValue(window.durationMinutes);
+    for (int day = 0; day < 7; ++day) {
+        weekdayBoxes[day]->setChecked(window.weekdays & (1 << day));
+    }
+    untilBox->setChecked(window.until.isValid());
+    if (window.until.isValid()) {
+        untilEdit->setDate(window.until);
+    }
+    groupEdit->setText(window.group);
+    prioritySpin->setValue(window.priority);
+    updateRepeatControls();
+}
+
+EventCalendar::Window CalendarWindowDialog::window() const
+{
+    EventCalendar::Window window;
+    window.fileName = fileCombo->currentText().trimmed();
+    window.repeat = static_cast<EventCalendar::Repeat>(repeatCombo->currentIndex());
+
+    // Whole minutes, so occurrences line up with what the editor shows
+    QDateTime start = startEdit->dateTime();
+    start.setTime(QTime(start.time().hour(), start.time().minute()));
+    window.start = start;
+
+    window.durationMinutes = durationSpin->value();
+    if (window.repeat == EventCalendar::Weekly) {
+        for (int day = 0; day < 7; ++day) {
+            if (weekdayBoxes[day]->isChecked()) {
+                window.weekdays |= 1 << day;
+            }
+        }
+    }
+    if (window.repeat != EventCalendar::Once && untilBox->isChecked()) {
+        window.until = untilEdit->date();
+    }
+    window.group = groupEdit->text().trimmed();
+    window.priority = prioritySpin->value();
+    return window;
+}
+
+void CalendarWindowDialog::accept()
+{
+    const EventCalendar::Window current = window();
+    if (current.fileName.isEmpty()) {
+        QMessageBox::warning(this, "Error", "Please choose an event file.");
+        return;
+    }
+    if (current.repeat == EventCalendar::Weekly && current.weekdays == 0) {
+        QMessageBox::warning(this, "Error", "Please pick at least one weekday.");
+        return;
+    }
+    QDialog::accept();
+}
+
+void CalendarWindowDialog::updateRepeatControls()
+{
+    const EventCalendar::Repeat repeat = static_cast<EventCalendar::Repeat>(repeatCombo->currentIndex());
+    for (QCheckBox *box : weekdayBoxes) {
+        box->setEnabled(repeat == EventCalendar::Weekly);
+    }
+    untilBox->setEnabled(repeat != EventCalendar::Once);
+    untilEdit->setEnabled(repeat != EventCalendar::Once && untilBox->isChecked());
+}
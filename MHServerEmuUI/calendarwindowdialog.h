@@ -0,0 +1,44 @@
+#ifndef CALENDARWINDOWDIALOG_H
+#define CALENDARWINDOWDIALOG_H
+
+#include <QDialog>
+#include "eventcalendar.h"
+
+class QComboBox;
+class QDateTimeEdit;
+class QDateEdit;
+class QSpinBox;
+class QCheckBox;
+class QLineEdit;
+
+// Edits one EventCalendar window
+class CalendarWindowDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    // eventFiles are offered in the file box, which also takes names typed in
+    CalendarWindowDialog(const QStringList &eventFiles, QWidget *parent = nullptr);
+
+    void setWindow(const EventCalendar::Window &window);
+    EventCalendar::Window window() const;
+
+public slots:
+    void accept() override;
+
+private slots:
+    void updateRepeatControls();
+
+private:
+    QComboBox *fileCombo;
+    QComboBox *repeatCombo;
+    QDateTimeEdit *startEdit;
+    QSpinBox *durationSpin;
+    QCheckBox *weekdayBoxes[7];
+    QCheckBox *untilBox;
+    QDateEdit *untilEdit;
+    QLineEdit *groupEdit;
+    QSpinBox *prioritySpin;
+};
+
+#endif // CALENDARWINDOWDIALOG_H
@@ -0,0 +1,342 @@
+#include "capacityplanner.h"
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QDateTime>
+#include <QStringList>
+#include <cmath>
+
+void LinearFit::add(double x, double y)
+{
+    ++n;
+    sumX += x;
+    sumY += y;
+    sumXX += x * x;
+    sumXY += x * y;
+    sumYY += y * y;
+}
+
+bool LinearFit::isValid() const
+{
+    // Player counts that never moved say nothing about the per-player cost
+    return n >= 3 && n * sumXX - sumX * sumX > 1e-9 * n * n;
+}
+
+double LinearFit::slope() const
+{
+    const double denominator = n * sumXX - sumX * sumX;
+    return denominator != 0.0 ? (n * sumXY - sumX * sumY) / denominator : 0.0;
+}
+
+double LinearFit::intercept() const
+{
+    return n > 0 ? (sumY - slope() * sumX) / n : 0.0;
+}
+
+double LinearFit::rSquared() const
+{
+    const double covariance = n * sumXY - sumX * sumY;
+    const double varianceX = n * sumXX - sumX * sumX;
+    const double varianceY = n * sumYY - sumY * sumY;
+    if (varianceX <= 0.0 || varianceY <= 0.0) {
+        return 0.0;
+    }
+    return (covariance * covariance) / (varianceX * varianceY);
+}
+
+bool CapacityPlanner::setLogPath(const QString &path, QString *errorMessage)
+{
+    logFilePath = path;
+    cpuFit.clear();
+    memoryFit.clear();
+    threadFit.clear();
+    latencyByPlayers.clear();
+    sampleCount = 0;
+    firstMs = lastMs = 0;
+    maxPlayers = 0;
+    primed = false;
+
+    QFile file(path);
+    if (!file.exists()) {
+        return true;
+    }
+    if (!file.open(QIODevice::ReadOnly)) {
+        if (errorMessage) {
+            *errorMessage = file.errorString();
+        }
+        return false;
+    }
+
+    Sample sample;
+    while (!file.atEnd()) {
+        if (parseLine(file.readLine().trimmed(), &sample)) {
+            fold(sample);
+        }
+    }
+    return true;
+}
+
+bool CapacityPlanner::observe(qint64 nowMs, int players, const ProcessStats &stats, quint64 latencyCount, double latencySumSeconds)
+{
+    if (!stats.valid) {
+        primed = false;
+        return false;
+    }
+
+    const bool hadReading = primed && nowMs > lastReadingMs && stats.cpuSeconds >= lastCpuSeconds;
+    Sample sample;
+    if (hadReading) {
+        const quint64 newLatencies = latencyCount - lastLatencyCount;
+        sample.timestampMs = nowMs;
+        sample.players = players;
+        sample.cpuCores = (stats.cpuSeconds - lastCpuSeconds) / ((nowMs - lastReadingMs) / 1000.0);
+        sample.residentMB = stats.residentBytes / (1024.0 * 1024.0);
+        sample.threads = stats.threadCount;
+        sample.latencyMs = newLatencies > 0 ? (latencySumSeconds - lastLatencySum) * 1000.0 / newLatencies : -1.0;
+    }
+
+    primed = true;
+    lastReadingMs = nowMs;
+    lastCpuSeconds = stats.cpuSeconds;
+    lastLatencyCount = latencyCount;
+    lastLatencySum = latencySumSeconds;
+
+    if (hadReading) {
+        addSample(sample);
+    }
+    return hadReading;
+}
+
+void CapacityPlanner::addSample(const Sample &sample)
+{
+    fold(sample);
+
+    if (logFilePath.isEmpty()) {
+        return;
+    }
+    QFile file(logFilePath);
+    if (!file.exists()) {
+        QDir().mkpath(QFileInfo(logFilePath).absolutePath());
+    }
+    if (file.open(QIODevice::Append)) {
+        file.write(formatLine(sample));
+    }
+}
+
+bool CapacityPlanner::reset(QString *errorMessage)
+{
+    if (!logFilePath.isEmpty() && QFile::exists(logFilePath) && !QFile::remove(logFilePath)) {
+        if (errorMessage) {
+            *errorMessage = QString("Couldn't remove %1").arg(logFilePath);
+        }
+        return false;
+    }
+    return setLogPath(logFilePath, errorMessage);
+}
+
+void CapacityPlanner::fold(const Sample &sample)
+{
+    if (sampleCount == 0) {
+        firstMs = sample.timestampMs;
+    }
+    ++sampleCount;
+    lastMs = sample.timestampMs;
+    maxPlayers = qMax(maxPlayers, sample.players);
+
+    cpuFit.add(sample.players, sample.cpuCores);
+    memoryFit.add(sample.players, sample.residentMB);
+    if (sample.threads > 0) {
+        threadFit.add(sample.players, sample.threads);
+    }
+    if (sample.latencyMs >= 0.0) {
+        LatencyBin &bin = latencyByPlayers[sample.players];
+        bin.count++;
+        bin.sumMs += sample.latencyMs;
+    }
+}
+
+CapacityPlanner::Report CapacityPlanner::report() const
+{
+    Report report;
+    report.samples = sampleCount;
+    report.firstMs = firstMs;
+    report.lastMs = lastMs;
+    report.maxPlayersSeen = maxPlayers;
+
+    if (cpuFit.isValid()) {
+        report.cpuPerPlayer = cpuFit.slope();
+        report.cpuBaseline = cpuFit.intercept();
+        report.cpuFit = cpuFit.rSquared();
+        if (report.cpuPerPlayer > 0.0) {
+            report.playersPerCore = 1.0 / report.cpuPerPlayer;
+        }
+    }
+    if (memoryFit.isValid()) {
+        report.mbPerPlayer = memoryFit.slope();
+        report.mbBaseline = memoryFit.intercept();
+        report.memoryFit = memoryFit.rSquared();
+        if (report.mbPerPlayer > 0.0) {
+            report.playersPerGB = 1024.0 / report.mbPerPlayer;
+        }
+    }
+    if (threadFit.isValid()) {
+        report.threadsPerPlayer = threadFit.slope();
+        report.threadBaseline = threadFit.intercept();
+    }
+
+    // Player counts are grouped into at most 20 buckets so single noisy counts don't decide the knee
+    const int width = qMax(1, (maxPlayers + 19) / 20);
+    QVector<QPair<double, double>> points; // (mean players, mean latency)
+    double bucketPlayers = 0.0;
+    double bucketLatency = 0.0;
+    qint64 bucketCount = 0;
+    int bucket = -1;
+    auto flush = [&]() {
+        if (bucketCount >= MinLatencySamples) {
+            points.append({bucketPlayers / bucketCount, bucketLatency / bucketCount});
+        }
+        bucketPlayers = bucketLatency = 0.0;
+        bucketCount = 0;
+    };
+    for (auto it = latencyByPlayers.constBegin(); it != latencyByPlayers.constEnd(); ++it) {
+        if (it.key() / width != bucket) {
+            flush();
+            bucket = it.key() / width;
+        }
+        bucketPlayers += static_cast<double>(it.key()) * it->count;
+        bucketLatency += it->sumMs;
+        bucketCount += it->count;
+    }
+    flush();
+
+    if (points.isEmpty()) {
+        return report;
+    }
+    report.idleLatencyMs = points.first().second;
+    if (points.size() < 3) {
+        return report;
+    }
+
+    // Knee: the point furthest below the line from the first to the last point, once both
+    // axes are scaled to 0..1. Curves that barely rise don't have one.
+    double minLatency = points.first().second;
+    double maxLatency = minLatency;
+    for (const auto &point : points) {
+        minLatency = qMin(minLatency, point.second);
+        maxLatency = qMax(maxLatency, point.second);
+    }
+    const double playerRange = points.last().first - points.first().first;
+    if (playerRange <= 0.0 || maxLatency < minLatency * 1.5) {
+        return report;
+    }
+
+    double bestDistance = 0.1;
+    for (int i = 1; i < points.size() - 1; ++i) {
+        const double x = (points.at(i).first - points.first().first) / playerRange;
+        const double y = (points.at(i).second - minLatency) / (maxLatency - minLatency);
+        if (x - y > bestDistance) {
+            bestDistance = x - y;
+            report.kneePlayers = static_cast<int>(std::lround(points.at(i).first));
+            report.kneeLatencyMs = points.at(i).second;
+        }
+    }
+    return report;
+}
+
+QString CapacityPlanner::Report::toText(int cores, const QString &serverCapacity, const QString &workerThreads) const
+{
+    if (samples == 0) {
+        return "No samples yet. They are taken every 15 seconds while the server is running.";
+    }
+
+    QStringList lines;
+    lines << QString("%1 samples from %2 to %3, up to %4 players online.")
+                 .arg(samples)
+                 .arg(QDateTime::fromMSecsSinceEpoch(firstMs).toString("yyyy-MM-dd HH:mm"))
+                 .arg(QDateTime::fromMSecsSinceEpoch(lastMs).toString("yyyy-MM-dd HH:mm"))
+                 .arg(maxPlayersSeen);
+    lines << QString();
+
+    if (playersPerCore > 0.0) {
+        lines << QString("CPU:     %1 cores idle + %2 cores per player (R² %3)")
+                     .arg(cpuBaseline, 0, 'f', 2).arg(cpuPerPlayer, 0, 'f', 4).arg(cpuFit, 0, 'f', 2);
+        lines << QString("         ~%1 players per core, ~%2 on this machine's %3 cores")
+                     .arg(playersPerCore, 0, 'f', 0)
+                     .arg(qMax(0.0, (cores - cpuBaseline) * playersPerCore), 0, 'f', 0)
+                     .arg(cores);
+    } else {
+        lines << "CPU:     not enough variation in player counts yet.";
+    }
+
+    if (playersPerGB > 0.0) {
+        lines << QString("Memory:  %1 MB idle + %2 MB per player (R² %3)")
+                     .arg(mbBaseline, 0, 'f', 0).arg(mbPerPlayer, 0, 'f', 2).arg(memoryFit, 0, 'f', 2);
+        lines << QString("         ~%1 players per GB").arg(playersPerGB, 0, 'f', 0);
+    } else {
+        lines << "Memory:  not enough variation in player counts yet.";
+    }
+
+    if (threadsPerPlayer != 0.0 || threadBaseline != 0.0) {
+        lines << QString("Threads: %1 idle + %2 per player").arg(threadBaseline, 0, 'f', 0).arg(threadsPerPlayer, 0, 'f', 3);
+    }
+
+    if (idleLatencyMs < 0.0) {
+        lines << "Latency: no command round-trips measured yet.";
+    } else if (kneePlayers >= 0) {
+        lines << QString("Latency: %1 ms at low load, bends at ~%2 players (%3 ms)")
+                     .arg(idleLatencyMs, 0, 'f', 1).arg(kneePlayers).arg(kneeLatencyMs, 0, 'f', 1);
+    } else {
+        lines << QString("Latency: %1 ms at low load, no knee up to %2 players")
+                     .arg(idleLatencyMs, 0, 'f', 1).arg(maxPlayersSeen);
+    }
+
+    lines << QString();
+    lines << QString("Configured: ServerCapacity = %1, NumWorkerThreads = %2")
+                 .arg(serverCapacity.isEmpty() ? QString("(not set)") : serverCapacity)
+                 .arg(workerThreads.isEmpty() ? QString("(not set)") : workerThreads);
+
+    // Whichever runs out first: CPU headroom or the latency knee
+    int suggestion = -1;
+    if (playersPerCore > 0.0) {
+        suggestion = static_cast<int>(qMax(0.0, (cores - cpuBaseline) * playersPerCore * 0.8));
+    }
+    if (kneePlayers >= 0 && (suggestion < 0 || kneePlayers < suggestion)) {
+        suggestion = kneePlayers;
+    }
+    if (suggestion >= 0) {
+        lines << QString("Suggested ServerCapacity: ~%1").arg(suggestion);
+    }
+    return lines.join('\n');
+}
+
+bool CapacityPlanner::parseLine(const QByteArray &line, Sample *sample)
+{
+    const QList<QByteArray> fields = line.split(',');
+    if (fields.size() != 6) {
+        return false;
+    }
+
+    bool ok[6];
+    sample->timestampMs = fields.at(0).toLongLong(&ok[0]);
+    sample->players = fields.at(1).toInt(&ok[1]);
+    sample->cpuCores = fields.at(2).toDouble(&ok[2]);
+    sample->residentMB = fields.at(3).toDouble(&ok[3]);
+    sample->threads = fields.at(4).toInt(&ok[4]);
+    sample->latencyMs = fields.at(5).toDouble(&ok[5]);
+    for (bool fieldOk : ok) {
+        if (!fieldOk) {
+            return false; // Header line or a write cut short by a crash
+        }
+    }
+    return true;
+}
+
+QByteArray CapacityPlanner::formatLine(const Sample &sample)
+{
+    return QByteArray::number(sample.timestampMs) + ','
+           + QByteArray::number(sample.players) + ','
+           + QByteArray::number(sample.cpuCores, 'f', 4) + ','
+           + QByteArray::number(sample.residentMB, 'f', 1) + ','
+           + QByteArray::number(sample.threads) + ','
+           + QByteArray::number(sample.latencyMs, 'f', 2) + '\n';
+}
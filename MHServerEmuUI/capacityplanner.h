@@ -0,0 +1,113 @@
+#ifndef CAPACITYPLANNER_H
+#define CAPACITYPLANNER_H
+
+#include <QString>
+#include <QMap>
+#include <QVector>
+#include "servermetrics.h"
+
+// Least-squares fit of y = intercept + slope * x kept as running sums, O(1) per point
+class LinearFit
+{
+public:
+    void add(double x, double y);
+    void clear() { *this = LinearFit(); }
+
+    qint64 count() const { return n; }
+    bool isValid() const; // Needs a few points with some spread in x
+    double slope() const;
+    double intercept() const;
+    double rSquared() const;
+
+private:
+    qint64 n = 0;
+    double sumX = 0.0;
+    double sumY = 0.0;
+    double sumXX = 0.0;
+    double sumXY = 0.0;
+    double sumYY = 0.0;
+};
+
+// Correlates players online with the server process' CPU, memory, threads and command
+// round-trip times. Samples are appended to a log as they come in and folded into running
+// fits, so it can stay on for weeks without the cost growing.
+class CapacityPlanner
+{
+public:
+    static constexpr int SampleIntervalMs = 15000;
+    static constexpr int MinLatencySamples = 3; // Per player count before it counts towards the knee
+
+    struct Sample {
+        qint64 timestampMs;
+        int players;
+        double cpuCores;    // CPU seconds per wall second over the interval
+        double residentMB;
+        int threads;
+        double latencyMs;   // Mean round-trip over the interval, negative if nothing was sent
+    };
+
+    struct Report {
+        qint64 samples = 0;
+        qint64 firstMs = 0;
+        qint64 lastMs = 0;
+        int maxPlayersSeen = 0;
+        double cpuPerPlayer = 0.0;   // Cores
+        double cpuBaseline = 0.0;
+        double cpuFit = 0.0;         // R^2
+        double mbPerPlayer = 0.0;
+        double mbBaseline = 0.0;
+        double memoryFit = 0.0;
+        double threadsPerPlayer = 0.0;
+        double threadBaseline = 0.0;
+        double playersPerCore = -1.0; // Negative until the fits mean something
+        double playersPerGB = -1.0;
+        double idleLatencyMs = -1.0;
+        int kneePlayers = -1;         // Negative when latency hasn't bent yet
+        double kneeLatencyMs = -1.0;
+
+        QString toText(int cores, const QString &serverCapacity, const QString &workerThreads) const;
+    };
+
+    // Replays an existing log into the fits, later samples are appended to it
+    bool setLogPath(const QString &path, QString *errorMessage = nullptr);
+    QString logPath() const { return logFilePath; }
+
+    // Feeds a reading taken now; deltas against the previous reading become a sample.
+    // Returns false for the first reading after a (re)start, which only primes the deltas.
+    bool observe(qint64 nowMs, int players, const ProcessStats &stats, quint64 latencyCount, double latencySumSeconds);
+    void addSample(const Sample &sample);
+    void restart() { primed = false; } // Server process changed, old deltas are meaningless
+    bool reset(QString *errorMessage = nullptr);
+
+    Report report() const;
+
+private:
+    struct LatencyBin {
+        qint64 count = 0;
+        double sumMs = 0.0;
+    };
+
+    void fold(const Sample &sample);
+    static bool parseLine(const QByteArray &line, Sample *sample);
+    static QByteArray formatLine(const Sample &sample);
+
+    QString logFilePath;
+
+    LinearFit cpuFit;
+    LinearFit memoryFit;
+    LinearFit threadFit;
+    QMap<int, LatencyBin> latencyByPlayers;
+    qint64 sampleCount = 0;
+    qint64 firstMs = 0;
+    qint64 lastMs = 0;
+    int maxPlayers = 0;
+
+    // Previous reading
+    bool primed = false;
+    qint64 lastReadingMs = 0;
+    double lastCpuSeconds = 0.0;
+    quint64 lastLatencyCount = 0;
+    double lastLatencySum = 0.0;
+};
+
+#endif // CAPACITYPLANNER_H
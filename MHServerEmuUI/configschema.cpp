@@ -0,0 +1,143 @@
+#include "configschema.h"
+#include "inifile.h"
+#include <QCheckBox>
+#include <QComboBox>
+#include <QLineEdit>
+#include <QTextEdit>
+#include <QPlainTextEdit>
+
+void ConfigSchema::add(const QString &section, const QString &key, Type type, QWidget *widget, const QString &defaultValue)
+{
+    entries.append({section, key, type, widget, defaultValue, false});
+}
+
+void ConfigSchema::setLive(const QString &section, const QString &key)
+{
+    for (Field &field : entries) {
+        if (field.section == section && field.key == key) {
+            field.live = true;
+        }
+    }
+}
+
+QSet<QString> ConfigSchema::liveKeys() const
+{
+    QSet<QString> keys;
+    for (const Field &field : entries) {
+        if (field.live) {
+            keys.insert(field.section + QLatin1Char('/') + field.key);
+        }
+    }
+    return keys;
+}
+
+QHash<QString, ConfigSchema::Type> ConfigSchema::keyTypes() const
+{
+    QHash<QString, Type> types;
+    types.reserve(entries.size());
+    for (const Field &field : entries) {
+        types.insert(field.section + QLatin1Char('/') + field.key, field.type);
+    }
+    return types;
+}
+
+void ConfigSchema::load(const QVariantMap &base, const QVariantMap &overrides) const
+{
+    for (const Field &field : entries) {
+        const QString path = field.section + QLatin1Char('/') + field.key;
+        QVariant value = overrides.value(path);
+        if (!value.isValid()) {
+            value = base.value(path);
+        }
+        setWidgetValue(field, value.isValid() ? value.toString() : field.defaultValue);
+    }
+}
+
+QStringList ConfigSchema::applyTo(IniFile *overrides, const QVariantMap &base) const
+{
+    QStringList overridden;
+    for (const Field &field : entries) {
+        const QString value = widgetValue(field);
+        const QVariant baseValue = base.value(field.section + QLatin1Char('/') + field.key);
+        const QString reference = baseValue.isValid() ? baseValue.toString() : field.defaultValue;
+
+        if (normalized(value, field.type) == normalized(reference, field.type)) {
+            overrides->remove(field.section, field.key);
+        } else {
+            overrides->setValue(field.section, field.key, value);
+            overridden.append(field.section + QLatin1Char('/') + field.key);
+        }
+    }
+    return overridden;
+}
+
+QStringList ConfigSchema::widgetValues() const
+{
+    QStringList values;
+    values.reserve(entries.size());
+    for (const Field &field : entries) {
+        values.append(normalized(widgetValue(field), field.type));
+    }
+    return values;
+}
+
+QString ConfigSchema::widgetValue(const Field &field)
+{
+    if (QCheckBox *checkBox = qobject_cast<QCheckBox *>(field.widget)) {
+        return checkBox->isChecked() ? QStringLiteral("true") : QStringLiteral("false");
+    }
+    if (QComboBox *comboBox = qobject_cast<QComboBox *>(field.widget)) {
+        return QString::number(comboBox->currentIndex());
+    }
+    if (QLineEdit *lineEdit = qobject_cast<QLineEdit *>(field.widget)) {
+        return lineEdit->text();
+    }
+
+    // The server reads one line per key, so multi-line text is folded
+    QString text;
+    if (QTextEdit *textEdit = qobject_cast<QTextEdit *>(field.widget)) {
+        text = textEdit->toPlainText();
+    } else if (QPlainTextEdit *plainTextEdit = qobject_cast<QPlainTextEdit *>(field.widget)) {
+        text = plainTextEdit->toPlainText();
+    }
+    return text.replace(QLatin1Char('\n'), QLatin1Char(' ')).trimmed();
+}
+
+void ConfigSchema::setWidgetValue(const Field &field, const QString &value)
+{
+    if (QCheckBox *checkBox = qobject_cast<QCheckBox *>(field.widget)) {
+        checkBox->setChecked(normalized(value, Bool) == QLatin1String("true"));
+    } else if (QComboBox *comboBox = qobject_cast<QComboBox *>(field.widget)) {
+        comboBox->setCurrentIndex(value.trimmed().toInt());
+    } else if (QLineEdit *lineEdit = qobject_cast<QLineEdit *>(field.widget)) {
+        lineEdit->setText(value);
+    } else if (QTextEdit *textEdit = qobject_cast<QTextEdit *>(field.widget)) {
+        textEdit->setPlainText(value);
+    } else if (QPlainTextEdit *plainTextEdit = qobject_cast<QPlainTextEdit *>(field.widget)) {
+        plainTextEdit->setPlainText(value);
+    }
+}
+
+QString ConfigSchema::normalized(const QString &value, Type type)
+{
+    const QString trimmed = value.trimmed();
+    bool ok = false;
+
+    switch (type) {
+    case Bool: {
+        const QString lower = trimmed.toLower();
+        return lower == QLatin1String("true") || lower == QLatin1String("1") ? QStringLiteral("true") : QStringLiteral("false");
+    }
+    case Integer: {
+        const qlonglong number = trimmed.toLongLong(&ok);
+        return ok ? QString::number(number) : trimmed;
+    }
+    case Number: {
+        const double number = trimmed.toDouble(&ok);
+        return ok ? QString::number(number, 'g', 15) : trimmed;
+    }
+    case Text:
+        break;
+    }
+    return trimmed;
+}
@@ -0,0 +1,62 @@
+#ifndef CONFIGSCHEMA_H
+#define CONFIGSCHEMA_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QVariantMap>
+#include <QSet>
+#include <QHash>
+
+class QWidget;
+class IniFile;
+
+// Declares which config.ini key each settings widget edits. The same table fills the widgets
+// from config.ini + ConfigOverride.ini and decides what belongs in ConfigOverride.ini on save.
+class ConfigSchema
+{
+public:
+    enum Type {
+        Bool,
+        Integer, // Combo boxes store their index
+        Number,
+        Text
+    };
+
+    struct Field {
+        QString section;
+        QString key;
+        Type type;
+        QWidget *widget;
+        QString defaultValue; // Shown when neither file has the key
+        bool live = false;    // Picked up by a running server, no restart needed
+    };
+
+    void add(const QString &section, const QString &key, Type type, QWidget *widget, const QString &defaultValue = QString());
+    const QVector<Field> &fields() const { return entries; }
+
+    void setLive(const QString &section, const QString &key);
+    QSet<QString> liveKeys() const; // "Section/Key"
+    QHash<QString, Type> keyTypes() const; // "Section/Key"
+
+    // One pass over the fields, override values win over the base ones
+    void load(const QVariantMap &base, const QVariantMap &overrides) const;
+
+    // Values equal to config.ini are dropped from the override, everything else is set.
+    // Keys the schema doesn't know about are left alone. Returns the overridden keys.
+    QStringList applyTo(IniFile *overrides, const QVariantMap &base) const;
+
+    // Every field's widget value, normalized, in schema order; compare two to spot unsaved edits
+    QStringList widgetValues() const;
+
+    static QString widgetValue(const Field &field);
+    static void setWidgetValue(const Field &field, const QString &value);
+
+    // Canonical spelling so "True" vs "true" or "05" vs "5" don't count as a difference
+    static QString normalized(const QString &value, Type type);
+
+private:
+    QVector<Field> entries;
+};
+
+#endif // CONFIGSCHEMA_H
@@ -0,0 +1,177 @@
+#include "effectiveconfig.h"
+#include "inifile.h"
+#include "atomicfilewriter.h"
+#include <QFile>
+#include <algorithm>
+
+EffectiveConfig EffectiveConfig::fromFiles(const QString &basePath, const QString &overridePath)
+{
+    EffectiveConfig config;
+    for (const QString &path : {basePath, overridePath}) {
+        QFile file(path);
+        if (!file.open(QIODevice::ReadOnly)) {
+            continue;
+        }
+        const QByteArray content = file.readAll();
+        IniFile ini;
+        ini.parse(content);
+        if (path == basePath) {
+            config.setBase(ini.toMap(), AtomicFileWriter::contentHash(content));
+        } else {
+            config.setOverrides(ini.toMap(), AtomicFileWriter::contentHash(content));
+        }
+    }
+    return config;
+}
+
+QStringList EffectiveConfig::setBase(const QVariantMap &values, const QByteArray &hash)
+{
+    baseFileHash = hash;
+    const QSet<QString> keys = changedKeys(base, values);
+    base = values;
+    return remerge(keys);
+}
+
+QStringList EffectiveConfig::setOverrides(const QVariantMap &values, const QByteArray &hash)
+{
+    overrideFileHash = hash;
+    const QSet<QString> keys = changedKeys(overrides, values);
+    overrides = values;
+    return remerge(keys);
+}
+
+bool EffectiveConfig::sameSources(const EffectiveConfig &other) const
+{
+    return baseFileHash == other.baseFileHash && overrideFileHash == other.overrideFileHash;
+}
+
+QSet<QString> EffectiveConfig::changedKeys(const QVariantMap &before, const QVariantMap &after)
+{
+    // Both maps are sorted by key, so one merge walk finds additions, removals and edits
+    QSet<QString> keys;
+    auto b = before.constBegin();
+    auto a = after.constBegin();
+    while (b != before.constEnd() || a != after.constEnd()) {
+        if (a == after.constEnd() || (b != before.constEnd() && b.key() < a.key())) {
+            keys.insert(b.key());
+            ++b;
+        } else if (b == before.constEnd() || a.key() < b.key()) {
+            keys.insert(a.key());
+            ++a;
+        } else {
+            if (b.value() != a.value()) {
+                keys.insert(a.key());
+            }
+            ++b;
+            ++a;
+        }
+    }
+    return keys;
+}
+
+QStringList EffectiveConfig::remerge(const QSet<QString> &keys)
+{
+    QStringList moved;
+    for (const QString &key : keys) {
+        QVariant value = overrides.value(key);
+        if (!value.isValid()) {
+            value = base.value(key);
+        }
+
+        const QVariant previous = merged.value(key);
+        if (value == previous) {
+            continue;
+        }
+        if (value.isValid()) {
+            merged.insert(key, value);
+        } else {
+            merged.remove(key);
+        }
+        moved.append(key);
+    }
+    return moved;
+}
+
+void ConfigDrift::reset(const EffectiveConfig &launch, const EffectiveConfig &current)
+{
+    clear();
+    launchConfig = launch;
+    if (launch.sameSources(current)) {
+        return;
+    }
+
+    QSet<QString> keys;
+    for (auto it = launch.values().constBegin(); it != launch.values().constEnd(); ++it) {
+        keys.insert(it.key());
+    }
+    for (auto it = current.values().constBegin(); it != current.values().constEnd(); ++it) {
+        keys.insert(it.key());
+    }
+    for (const QString &key : keys) {
+        compare(key, current);
+    }
+}
+
+void ConfigDrift::update(const QStringList &keys, const EffectiveConfig &current)
+{
+    if (launchConfig.sameSources(current)) {
+        // Edited and then reverted
+        changes.clear();
+        restartChanges = 0;
+        return;
+    }
+    for (const QString &key : keys) {
+        compare(key, current);
+    }
+}
+
+void ConfigDrift::clear()
+{
+    launchConfig = EffectiveConfig();
+    changes.clear();
+    restartChanges = 0;
+}
+
+QVector<ConfigDrift::Change> ConfigDrift::sortedChanges() const
+{
+    QVector<Change> sorted;
+    sorted.reserve(changes.size());
+    for (const Change &change : changes) {
+        sorted.append(change);
+    }
+    std::sort(sorted.begin(), sorted.end(), [](const Change &a, const Change &b) {
+        return a.impact != b.impact ? a.impact > b.impact : a.key < b.key; // Restarts first
+    });
+    return sorted;
+}
+
+void ConfigDrift::compare(const QString &key, const EffectiveConfig &current)
+{
+    auto it = changes.find(key);
+    if (it != changes.end()) {
+        if (it->impact == Restart) {
+            --restartChanges;
+        }
+        changes.erase(it);
+    }
+
+    const bool launchPresent = launchConfig.contains(key);
+    const bool currentPresent = current.contains(key);
+    const QString launchValue = launchConfig.value(key);
+    const QString currentValue = current.value(key);
+    if (launchPresent == currentPresent) {
+        auto type = keyTypes.constFind(key);
+        const bool same = type != keyTypes.constEnd()
+                              ? ConfigSchema::normalized(launchValue, *type) == ConfigSchema::normalized(currentValue, *type)
+                              : launchValue == currentValue;
+        if (same) {
+            return;
+        }
+    }
+
+    const Impact impact = impactOf(key);
+    changes.insert(key, {key, launchValue, currentValue, launchPresent, currentPresent, impact});
+    if (impact == Restart) {
+        ++restartChanges;
+    }
+}
@@ -0,0 +1,91 @@
+#ifndef EFFECTIVECONFIG_H
+#define EFFECTIVECONFIG_H
+
+#include <QString>
+#include <QStringList>
+#include <QByteArray>
+#include <QVariantMap>
+#include <QHash>
+#include <QSet>
+#include <QVector>
+#include "configschema.h"
+
+// config.ini with ConfigOverride.ini applied on top, plus the hash of each file it came from.
+// Replacing one file reports which effective keys moved, so callers only look at those.
+class EffectiveConfig
+{
+public:
+    static EffectiveConfig fromFiles(const QString &basePath, const QString &overridePath);
+
+    // Both return the "Section/Key" names whose effective value changed
+    QStringList setBase(const QVariantMap &values, const QByteArray &hash);
+    QStringList setOverrides(const QVariantMap &values, const QByteArray &hash);
+
+    bool isEmpty() const { return merged.isEmpty(); }
+    bool contains(const QString &key) const { return merged.contains(key); }
+    QString value(const QString &key) const { return merged.value(key).toString(); }
+    const QVariantMap &values() const { return merged; }
+
+    // Same file contents means the same effective config, no key needs comparing
+    bool sameSources(const EffectiveConfig &other) const;
+    QByteArray baseHash() const { return baseFileHash; }
+    QByteArray overrideHash() const { return overrideFileHash; }
+
+private:
+    static QSet<QString> changedKeys(const QVariantMap &before, const QVariantMap &after);
+    QStringList remerge(const QSet<QString> &keys);
+
+    QVariantMap base;
+    QVariantMap overrides;
+    QVariantMap merged;
+    QByteArray baseFileHash;
+    QByteArray overrideFileHash;
+};
+
+// Keys whose effective value differs from the config a server process was launched with,
+// and whether the running server picks each one up or needs a restart for it
+class ConfigDrift
+{
+public:
+    enum Impact {
+        Live,
+        Restart
+    };
+
+    struct Change {
+        QString key;
+        QString launchValue;   // Empty with launchPresent false when the key was added
+        QString currentValue;  // Empty with currentPresent false when the key was removed
+        bool launchPresent;
+        bool currentPresent;
+        Impact impact;
+    };
+
+    void setLiveKeys(const QSet<QString> &keys) { liveKeys = keys; }
+    Impact impactOf(const QString &key) const { return liveKeys.contains(key) ? Live : Restart; }
+    // Keys the schema knows are compared in their normalized spelling, the rest as written
+    void setKeyTypes(const QHash<QString, ConfigSchema::Type> &types) { keyTypes = types; }
+
+    // Compares everything, used when the launch snapshot or the server folder changes
+    void reset(const EffectiveConfig &launch, const EffectiveConfig &current);
+    // Re-checks only the given keys against the launch snapshot
+    void update(const QStringList &keys, const EffectiveConfig &current);
+    void clear();
+
+    bool isEmpty() const { return changes.isEmpty(); }
+    int count() const { return changes.size(); }
+    int restartCount() const { return restartChanges; }
+    int liveCount() const { return changes.size() - restartChanges; }
+    QVector<Change> sortedChanges() const;
+
+private:
+    void compare(const QString &key, const EffectiveConfig &current);
+
+    EffectiveConfig launchConfig;
+    QSet<QString> liveKeys;
+    QHash<QString, ConfigSchema::Type> keyTypes;
+    QHash<QString, Change> changes;
+    int restartChanges = 0;
+};
+
+#endif // EFFECTIVECONFIG_H
@@ -0,0 +1,338 @@
+#include "effectivelivetuning.h"
+#include <QDir>
+#include <QFileInfo>
+#include <QThreadPool>
+#include <QSemaphore>
+#include <QFont>
+#include <algorithm>
+
+bool EffectiveLiveTuning::isActiveFileName(const QString &fileName)
+{
+    // Disabled events are renamed to OFF_LiveTuningData_*.json, which the server doesn't pick up
+    return fileName.startsWith(QLatin1String("LiveTuningData")) && fileName.endsWith(QLatin1String(".json"));
+}
+
+void EffectiveLiveTuning::setDirectory(const QString &path)
+{
+    if (path == folderPath) {
+        return;
+    }
+
+    folderPath = path;
+    reset();
+}
+
+void EffectiveLiveTuning::reset()
+{
+    prototypes.clear();
+    settings.clear();
+    files.clear();
+    contributions.clear();
+    entryKeys.clear();
+    entryRow.clear();
+    conflictKeys.clear();
+}
+
+bool EffectiveLiveTuning::parseFile(const QString &path, LiveTuningStore *store, QString *errorMessage)
+{
+    QString parseError;
+    if (!store->loadFile(path, &parseError)) {
+        *errorMessage = QString("%1: %2").arg(QFileInfo(path).fileName(), parseError);
+        return false;
+    }
+    return true;
+}
+
+bool EffectiveLiveTuning::reloadAll(QStringList *errors)
+{
+    QStringList names;
+    const QStringList candidates = QDir(folderPath).entryList({"LiveTuningData*.json"}, QDir::Files);
+    for (const QString &name : candidates) {
+        if (isActiveFileName(name)) {
+            names.append(name);
+        }
+    }
+    std::sort(names.begin(), names.end()); // Ordinal, independent of QDir's locale-aware sorting
+
+    // Each file parses into its own store on the pool; merging happens afterwards on this thread
+    QVector<LiveTuningStore> parsed(names.size());
+    QVector<QString> parseErrors(names.size());
+    LiveTuningStore *stores = parsed.data();
+    QString *errorSlots = parseErrors.data();
+    QSemaphore finished;
+
+    for (int i = 0; i < names.size(); ++i) {
+        const QString path = QDir(folderPath).filePath(names.at(i));
+        QThreadPool::globalInstance()->start([path, stores, errorSlots, &finished, i]() {
+            parseFile(path, &stores[i], &errorSlots[i]);
+            finished.release();
+        });
+    }
+    finished.acquire(names.size());
+
+    reset();
+
+    QSet<quint64> touched;
+    bool allLoaded = true;
+    for (int i = 0; i < names.size(); ++i) {
+        if (!parseErrors.at(i).isEmpty()) {
+            allLoaded = false;
+            if (errors) {
+                errors->append(parseErrors.at(i));
+            }
+            continue;
+        }
+
+        FileData data = toFileData(parsed.at(i));
+        addContributions(names.at(i), data, touched);
+        files.insert(names.at(i), data);
+    }
+    refreshEntries(touched);
+    return allLoaded;
+}
+
+bool EffectiveLiveTuning::updateFile(const QString &fileName, QString *errorMessage)
+{
+    const QString path = QDir(folderPath).filePath(fileName);
+    const bool active = isActiveFileName(fileName) && QFileInfo::exists(path);
+
+    // Parse before dropping the old contributions so a broken file keeps its last good state
+    LiveTuningStore store;
+    if (active) {
+        QString parseError;
+        if (!parseFile(path, &store, &parseError)) {
+            if (errorMessage) {
+                *errorMessage = parseError;
+            }
+            return false;
+        }
+    }
+
+    applyFile(fileName, active ? &store : nullptr);
+    return true;
+}
+
+void EffectiveLiveTuning::applyFile(const QString &fileName, const LiveTuningStore *parsed)
+{
+    QSet<quint64> touched;
+    auto it = files.find(fileName);
+    if (it != files.end()) {
+        removeContributions(fileName, it.value(), touched);
+        files.erase(it);
+    }
+
+    if (parsed && isActiveFileName(fileName)) {
+        FileData data = toFileData(*parsed);
+        addContributions(fileName, data, touched);
+        files.insert(fileName, data);
+    }
+
+    refreshEntries(touched);
+}
+
+const QString &EffectiveLiveTuning::prototype(int index) const
+{
+    return prototypes.at(static_cast<int>(entryKeys.at(index) >> 32));
+}
+
+const QString &EffectiveLiveTuning::setting(int index) const
+{
+    return settings.at(static_cast<int>(entryKeys.at(index) & 0xFFFFFFFFu));
+}
+
+EffectiveLiveTuning::FileData EffectiveLiveTuning::toFileData(const LiveTuningStore &store)
+{
+    // Translate the file's own string ids once per distinct string, not once per entry
+    QVector<int> prototypeMap(store.prototypePool().size());
+    for (int id = 0; id < prototypeMap.size(); ++id) {
+        prototypeMap[id] = prototypes.intern(store.prototypePool().at(id));
+    }
+    QVector<int> settingMap(store.settingPool().size());
+    for (int id = 0; id < settingMap.size(); ++id) {
+        settingMap[id] = settings.intern(store.settingPool().at(id));
+    }
+
+    FileData data;
+    data.keys.reserve(store.size());
+    data.values.reserve(store.size());
+    for (int i = 0; i < store.size(); ++i) {
+        if (store.indexOfKey(store.key(i)) != i) {
+            continue; // Overridden later in the same file
+        }
+        data.keys.append(LiveTuningStore::makeKey(prototypeMap.at(store.prototypeId(i)), settingMap.at(store.settingId(i))));
+        data.values.append(store.value(i));
+    }
+    return data;
+}
+
+void EffectiveLiveTuning::removeContributions(const QString &fileName, const FileData &data, QSet<quint64> &touched)
+{
+    for (quint64 entryKey : data.keys) {
+        auto it = contributions.find(entryKey);
+        if (it == contributions.end()) {
+            continue;
+        }
+
+        QVector<Contribution> &list = it.value();
+        for (int i = 0; i < list.size(); ++i) {
+            if (list.at(i).fileName == fileName) {
+                list.remove(i);
+                break;
+            }
+        }
+        if (list.isEmpty()) {
+            contributions.erase(it);
+        }
+        touched.insert(entryKey);
+    }
+}
+
+void EffectiveLiveTuning::addContributions(const QString &fileName, const FileData &data, QSet<quint64> &touched)
+{
+    for (int i = 0; i < data.keys.size(); ++i) {
+        QVector<Contribution> &list = contributions[data.keys.at(i)];
+
+        // Usually appends, files added out of order slot in by name
+        int position = list.size();
+        while (position > 0 && fileName < list.at(position - 1).fileName) {
+            --position;
+        }
+        list.insert(position, {fileName, data.values.at(i)});
+        touched.insert(data.keys.at(i));
+    }
+}
+
+void EffectiveLiveTuning::refreshEntries(const QSet<quint64> &touched)
+{
+    for (quint64 entryKey : touched) {
+        auto it = contributions.constFind(entryKey);
+        const bool present = it != contributions.constEnd();
+        const int row = entryRow.value(entryKey, -1);
+
+        if (present && row < 0) {
+            entryRow.insert(entryKey, entryKeys.size());
+            entryKeys.append(entryKey);
+        } else if (!present && row >= 0) {
+            // Swap with the last entry so removal stays O(1)
+            const quint64 lastKey = entryKeys.last();
+            entryKeys[row] = lastKey;
+            entryRow[lastKey] = row;
+            entryKeys.removeLast();
+            entryRow.remove(entryKey);
+        }
+
+        if (present && hasConflict(it.value())) {
+            conflictKeys.insert(entryKey);
+        } else {
+            conflictKeys.remove(entryKey);
+        }
+    }
+}
+
+bool EffectiveLiveTuning::hasConflict(const QVector<Contribution> &list)
+{
+    for (int i = 1; i < list.size(); ++i) {
+        if (list.at(i).value != list.at(0).value) {
+            return true;
+        }
+    }
+    return false;
+}
+
+EffectiveLiveTuningModel::EffectiveLiveTuningModel(QObject *parent)
+    : QAbstractTableModel(parent)
+    , effective(nullptr)
+    , conflictsOnly(false)
+{
+}
+
+void EffectiveLiveTuningModel::setSource(const EffectiveLiveTuning *source)
+{
+    effective = source;
+    reload();
+}
+
+void EffectiveLiveTuningModel::setConflictsOnly(bool enabled)
+{
+    conflictsOnly = enabled;
+    reload();
+}
+
+void EffectiveLiveTuningModel::reload()
+{
+    beginResetModel();
+    rows.clear();
+    if (effective) {
+        rows.reserve(conflictsOnly ? effective->conflictCount() : effective->size());
+        for (int i = 0; i < effective->size(); ++i) {
+            if (!conflictsOnly || effective->isConflict(i)) {
+                rows.append(i);
+            }
+        }
+    }
+    endResetModel();
+}
+
+int EffectiveLiveTuningModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : rows.size();
+}
+
+int EffectiveLiveTuningModel::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : ColumnCount;
+}
+
+QVariant EffectiveLiveTuningModel::data(const QModelIndex &index, int role) const
+{
+    if (!effective || !index.isValid() || index.row() >= rows.size()) {
+        return QVariant();
+    }
+
+    const int entry = rows.at(index.row());
+    if (role == Qt::DisplayRole || role == Qt::ToolTipRole) {
+        switch (index.column()) {
+        case PrototypeColumn:
+            return effective->prototype(entry);
+        case SettingColumn:
+            return effective->setting(entry);
+        case ValueColumn:
+            return role == Qt::DisplayRole ? QVariant(effective->value(entry)) : QVariant();
+        case SourceColumn:
+            return effective->sourceFile(entry);
+        case OverridesColumn: {
+            const QVector<EffectiveLiveTuning::Contribution> &list = effective->contributionsFor(entry);
+            if (list.size() < 2) {
+                return QVariant();
+            }
+            QStringList parts;
+            for (const EffectiveLiveTuning::Contribution &contribution : list) {
+                parts.append(QString("%1 = %2").arg(contribution.fileName).arg(contribution.value));
+            }
+            return parts.join(role == Qt::DisplayRole ? QString(" -> ") : QString("\n"));
+        }
+        }
+    } else if (role == Qt::FontRole && effective->isConflict(entry)) {
+        QFont font;
+        font.setBold(true);
+        return font;
+    }
+
+    return QVariant();
+}
+
+QVariant EffectiveLiveTuningModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (role != Qt::DisplayRole || orientation != Qt::Horizontal) {
+        return QAbstractTableModel::headerData(section, orientation, role);
+    }
+
+    switch (section) {
+    case PrototypeColumn: return QString("Prototype");
+    case SettingColumn:   return QString("Setting");
+    case ValueColumn:     return QString("Effective Value");
+    case SourceColumn:    return QString("From");
+    case OverridesColumn: return QString("Overrides (applied in order)");
+    }
+    return QVariant();
+}
@@ -0,0 +1,105 @@
+#ifndef EFFECTIVELIVETUNING_H
+#define EFFECTIVELIVETUNING_H
+
+#include <QAbstractTableModel>
+#include <QMap>
+#include <QHash>
+#include <QSet>
+#include <QVector>
+#include <QStringList>
+#include "livetuningstore.h"
+
+// Effective (Prototype, Setting) -> Value table across every active LiveTuningData*.json
+// in a LiveTuning folder. Files are applied in ordinal name order and later files win, which is
+// what the "LiveTuningDataz_" prefix of the Pandemonium Protocol file relies on.
+class EffectiveLiveTuning
+{
+public:
+    struct Contribution {
+        QString fileName;
+        double value;
+    };
+
+    static bool isActiveFileName(const QString &fileName);
+
+    void setDirectory(const QString &path);
+    QString directory() const { return folderPath; }
+
+    // Re-reads every active file, parsing them in parallel
+    bool reloadAll(QStringList *errors);
+
+    // Re-reads one file, or drops it if it is missing or no longer active. Other files aren't touched.
+    bool updateFile(const QString &fileName, QString *errorMessage);
+
+    // Same as updateFile with a file that was already parsed elsewhere; null drops the file
+    void applyFile(const QString &fileName, const LiveTuningStore *parsed);
+
+    QStringList activeFiles() const { return files.keys(); }
+
+    int size() const { return entryKeys.size(); }
+    quint64 key(int index) const { return entryKeys.at(index); }
+    const QString &prototype(int index) const;
+    const QString &setting(int index) const;
+    double value(int index) const { return contributionsFor(index).last().value; }
+    const QString &sourceFile(int index) const { return contributionsFor(index).last().fileName; }
+    const QVector<Contribution> &contributionsFor(int index) const { return *contributions.constFind(entryKeys.at(index)); }
+    bool isConflict(int index) const { return conflictKeys.contains(entryKeys.at(index)); }
+    int conflictCount() const { return conflictKeys.size(); }
+
+private:
+    struct FileData {
+        QVector<quint64> keys; // Distinct keys, last occurrence in the file wins
+        QVector<double> values;
+    };
+
+    void reset();
+    FileData toFileData(const LiveTuningStore &store);
+    void removeContributions(const QString &fileName, const FileData &data, QSet<quint64> &touched);
+    void addContributions(const QString &fileName, const FileData &data, QSet<quint64> &touched);
+    void refreshEntries(const QSet<quint64> &touched);
+    static bool hasConflict(const QVector<Contribution> &list);
+    static bool parseFile(const QString &path, LiveTuningStore *store, QString *errorMessage);
+
+    QString folderPath;
+    StringPool prototypes;
+    StringPool settings;
+    QMap<QString, FileData> files; // Ordered like the server applies them
+    QHash<quint64, QVector<Contribution>> contributions; // Sorted by file order
+    QVector<quint64> entryKeys;
+    QHash<quint64, int> entryRow;
+    QSet<quint64> conflictKeys; // Keys set to different values by more than one file
+};
+
+// Read-only table over an EffectiveLiveTuning, optionally limited to conflicting settings
+class EffectiveLiveTuningModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    enum Column {
+        PrototypeColumn,
+        SettingColumn,
+        ValueColumn,
+        SourceColumn,
+        OverridesColumn,
+        ColumnCount
+    };
+
+    explicit EffectiveLiveTuningModel(QObject *parent = nullptr);
+
+    void setSource(const EffectiveLiveTuning *source);
+    void setConflictsOnly(bool enabled);
+    void reload(); // Call after the source changed
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+private:
+    const EffectiveLiveTuning *effective;
+    bool conflictsOnly;
+    QVector<int> rows;
+};
+
+#endif // EFFECTIVELIVETUNING_H
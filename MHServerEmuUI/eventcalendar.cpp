@@ -0,0 +1,266 @@
+#include "eventcalendar.h"
+#include <QJsonDocument>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QHash>
+#include <QLocale>
+#include <algorithm>
+
+namespace {
+
+const char *const RepeatNames[] = {"Once", "Daily", "Weekly"};
+
+} // namespace
+
+QString EventCalendar::eventName(const QString &fileName)
+{
+    QString name = fileName;
+    if (name.startsWith(QLatin1String("LiveTuningData_"))) {
+        name.remove(0, 15);
+    }
+    if (name.endsWith(QLatin1String(".json"))) {
+        name.chop(5);
+    }
+    return name;
+}
+
+QString EventCalendar::describe(const Window &window)
+{
+    const QString time = window.start.time().toString("HH:mm");
+    QString when;
+    switch (window.repeat) {
+    case Once:
+        when = window.start.toString("yyyy-MM-dd HH:mm");
+        break;
+    case Daily:
+        when = QString("Daily at %1").arg(time);
+        break;
+    case Weekly: {
+        QStringList days;
+        for (int day = 1; day <= 7; ++day) {
+            if (window.weekdays & (1 << (day - 1))) {
+                days << QLocale::c().dayName(day, QLocale::ShortFormat);
+            }
+        }
+        when = QString("%1 at %2").arg(days.join(", "), time);
+        break;
+    }
+    }
+
+    const int hours = window.durationMinutes / 60;
+    const int minutes = window.durationMinutes % 60;
+    const QString length = hours > 0 ? QString("%1h%2").arg(hours).arg(minutes > 0 ? QString::number(minutes) + "m" : QString())
+                                     : QString("%1m").arg(minutes);
+    return QString("%1 for %2").arg(when, length);
+}
+
+bool EventCalendar::loadJson(const QByteArray &json, QString *errorMessage)
+{
+    QJsonParseError parseError;
+    const QJsonDocument doc = QJsonDocument::fromJson(json, &parseError);
+    if (!doc.isObject()) {
+        *errorMessage = parseError.error != QJsonParseError::NoError ? parseError.errorString() : QString("Expected a JSON object.");
+        return false;
+    }
+
+    QVector<Window> loaded;
+    for (const QJsonValue &value : doc.object().value("Windows").toArray()) {
+        const QJsonObject object = value.toObject();
+        Window window;
+        window.fileName = object.value("File").toString();
+        const QString repeat = object.value("Repeat").toString("Once");
+        window.repeat = repeat == "Daily" ? Daily : repeat == "Weekly" ? Weekly : Once;
+        window.start = QDateTime::fromString(object.value("Start").toString(), Qt::ISODate);
+        window.durationMinutes = object.value("DurationMinutes").toInt(60);
+        window.weekdays = object.value("Weekdays").toInt(0) & 0x7F;
+        window.until = QDate::fromString(object.value("Until").toString(), Qt::ISODate);
+        window.group = object.value("Group").toString();
+        window.priority = object.value("Priority").toInt(0);
+        window.enabled = object.value("Enabled").toBool(true);
+
+        if (window.fileName.isEmpty() || !window.start.isValid() || window.durationMinutes <= 0) {
+            *errorMessage = QString("Window %1 needs a file, a start time and a positive duration.").arg(loaded.size() + 1);
+            return false;
+        }
+        loaded.append(window);
+    }
+
+    entries = loaded;
+    return true;
+}
+
+QByteArray EventCalendar::toJson() const
+{
+    QJsonArray windows;
+    for (const Window &window : entries) {
+        QJsonObject object;
+        object["File"] = window.fileName;
+        object["Repeat"] = QString(RepeatNames[window.repeat]);
+        object["Start"] = window.start.toString(Qt::ISODate);
+        object["DurationMinutes"] = window.durationMinutes;
+        if (window.repeat == Weekly) {
+            object["Weekdays"] = window.weekdays;
+        }
+        if (window.until.isValid()) {
+            object["Until"] = window.until.toString(Qt::ISODate);
+        }
+        if (!window.group.isEmpty()) {
+            object["Group"] = window.group;
+        }
+        object["Priority"] = window.priority;
+        object["Enabled"] = window.enabled;
+        windows.append(object);
+    }
+
+    QJsonObject root;
+    root["Windows"] = windows;
+    return QJsonDocument(root).toJson(QJsonDocument::Indented);
+}
+
+QStringList EventCalendar::managedFiles() const
+{
+    QStringList files;
+    for (const Window &window : entries) {
+        if (!files.contains(window.fileName)) {
+            files.append(window.fileName);
+        }
+    }
+    return files;
+}
+
+int EventCalendar::longestDurationMinutes() const
+{
+    int longest = 0;
+    for (const Window &window : entries) {
+        longest = qMax(longest, window.durationMinutes);
+    }
+    return longest;
+}
+
+QVector<EventCalendar::Occurrence> EventCalendar::occurrences(const QDateTime &from, const QDateTime &to) const
+{
+    QVector<Occurrence> result;
+    for (int i = 0; i < entries.size(); ++i) {
+        const Window &window = entries.at(i);
+        if (!window.enabled) {
+            continue;
+        }
+
+        auto consider = [&](const QDateTime &start) {
+            const QDateTime end = start.addSecs(qint64(window.durationMinutes) * 60);
+            if (start < to && end > from) {
+                result.append({i, start, end});
+            }
+        };
+
+        if (window.repeat == Once) {
+            consider(window.start);
+            continue;
+        }
+
+        // Only the days whose occurrence can still reach into the range are walked
+        const int spanDays = (window.durationMinutes + 1439) / 1440;
+        QDate day = qMax(window.start.date(), from.date().addDays(-spanDays));
+        QDate last = to.date();
+        if (window.until.isValid()) {
+            last = qMin(last, window.until);
+        }
+        for (; day <= last; day = day.addDays(1)) {
+            if (window.repeat == Weekly && !(window.weekdays & (1 << (day.dayOfWeek() - 1)))) {
+                continue;
+            }
+            const QDateTime start(day, window.start.time());
+            if (start >= window.start) {
+                consider(start);
+            }
+        }
+    }
+
+    std::sort(result.begin(), result.end(), [](const Occurrence &a, const Occurrence &b) {
+        return a.start != b.start ? a.start < b.start : a.window < b.window;
+    });
+    return result;
+}
+
+QSet<QString> EventCalendar::resolve(const QVector<Occurrence> &candidates, const QDateTime &time) const
+{
+    QSet<QString> active;
+    QHash<QString, const Occurrence *> groupWinners;
+
+    // Candidates are sorted by start, so the first one seen wins a priority tie
+    for (const Occurrence &occurrence : candidates) {
+        if (occurrence.start > time || occurrence.end <= time) {
+            continue;
+        }
+        const Window &window = entries.at(occurrence.window);
+        if (window.group.isEmpty()) {
+            active.insert(window.fileName);
+            continue;
+        }
+
+        const Occurrence *&winner = groupWinners[window.group];
+        if (!winner || window.priority > entries.at(winner->window).priority) {
+            winner = &occurrence;
+        }
+    }
+
+    for (const Occurrence *winner : groupWinners) {
+        active.insert(entries.at(winner->window).fileName);
+    }
+    return active;
+}
+
+QSet<QString> EventCalendar::activeAt(const QDateTime &time) const
+{
+    const QDateTime from = time.addSecs(-qint64(longestDurationMinutes()) * 60);
+    return resolve(occurrences(from, time.addSecs(1)), time);
+}
+
+QVector<EventCalendar::Transition> EventCalendar::timeline(const QDateTime &from, const QDateTime &to) const
+{
+    const QVector<Occurrence> candidates = occurrences(from.addSecs(-qint64(longestDurationMinutes()) * 60), to.addSecs(1));
+
+    QVector<QDateTime> boundaries;
+    for (const Occurrence &occurrence : candidates) {
+        for (const QDateTime &edge : {occurrence.start, occurrence.end}) {
+            if (edge > from && edge <= to) {
+                boundaries.append(edge);
+            }
+        }
+    }
+    std::sort(boundaries.begin(), boundaries.end());
+    boundaries.erase(std::unique(boundaries.begin(), boundaries.end()), boundaries.end());
+
+    QVector<Transition> result;
+    QSet<QString> previous = resolve(candidates, from);
+    for (int i = 0; i < boundaries.size(); ++i) {
+        // Fold a run of close boundaries into the last one of the run
+        int last = i;
+        while (last + 1 < boundaries.size() && boundaries.at(last).secsTo(boundaries.at(last + 1)) < MergeSeconds) {
+            ++last;
+        }
+        const QDateTime at = boundaries.at(last);
+        i = last;
+
+        const QSet<QString> current = resolve(candidates, at);
+        Transition transition;
+        transition.at = at;
+        for (const QString &file : current) {
+            if (!previous.contains(file)) {
+                transition.enable.append(file);
+            }
+        }
+        for (const QString &file : previous) {
+            if (!current.contains(file)) {
+                transition.disable.append(file);
+            }
+        }
+        if (!transition.enable.isEmpty() || !transition.disable.isEmpty()) {
+            transition.enable.sort();
+            transition.disable.sort();
+            result.append(transition);
+        }
+        previous = current;
+    }
+    return result;
+}
@@ -0,0 +1,80 @@
+#ifndef EVENTCALENDAR_H
+#define EVENTCALENDAR_H
+
+#include <QDateTime>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+// Scheduled activation windows for event files. Windows repeat once, daily or on chosen weekdays;
+// windows sharing an exclusive group never run together and the highest priority one wins, ties
+// going to the one that started first. All times are local.
+class EventCalendar
+{
+public:
+    // Transitions closer together than this are applied as one, at the later time
+    static constexpr int MergeSeconds = 60;
+
+    enum Repeat {
+        Once,
+        Daily,
+        Weekly
+    };
+
+    struct Window {
+        QString fileName;        // Active name, e.g. LiveTuningData_OdinsBounty.json
+        Repeat repeat = Once;
+        QDateTime start;         // First occurrence; recurring windows reuse its time of day
+        int durationMinutes = 60;
+        int weekdays = 0;        // Bit (dayOfWeek - 1) for Monday..Sunday, Weekly only
+        QDate until;             // Last day an occurrence may start, invalid for no end
+        QString group;           // Exclusive group, empty for none
+        int priority = 0;
+        bool enabled = true;
+    };
+
+    struct Occurrence {
+        int window;
+        QDateTime start;
+        QDateTime end;
+    };
+
+    struct Transition {
+        QDateTime at;
+        QStringList enable;
+        QStringList disable;
+    };
+
+    static QString eventName(const QString &fileName);
+    static QString describe(const Window &window);
+
+    bool loadJson(const QByteArray &json, QString *errorMessage);
+    QByteArray toJson() const;
+
+    const QVector<Window> &windows() const { return entries; }
+    void addWindow(const Window &window) { entries.append(window); }
+    void setWindow(int index, const Window &window) { entries[index] = window; }
+    void removeWindow(int index) { entries.remove(index); }
+    void setWindowEnabled(int index, bool enabled) { entries[index].enabled = enabled; }
+
+    // Every file some window manages, whether or not it is currently scheduled
+    QStringList managedFiles() const;
+
+    // Occurrences overlapping [from, to), sorted by start
+    QVector<Occurrence> occurrences(const QDateTime &from, const QDateTime &to) const;
+
+    // Files that should be active at the given time, after the conflict rules
+    QSet<QString> activeAt(const QDateTime &time) const;
+
+    // State changes in (from, to], with transitions within MergeSeconds folded together
+    QVector<Transition> timeline(const QDateTime &from, const QDateTime &to) const;
+
+private:
+    QSet<QString> resolve(const QVector<Occurrence> &candidates, const QDateTime &time) const;
+    int longestDurationMinutes() const;
+
+    QVector<Window> entries;
+};
+
+#endif // EVENTCALENDAR_H
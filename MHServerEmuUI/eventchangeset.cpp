@@ -0,0 +1,184 @@
+#include "eventchangeset.h"
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+
+void EventChangeSet::setDirectory(const QString &path)
+{
+    if (path != folderPath) {
+        folderPath = path;
+        pending.clear();
+    }
+}
+
+int EventChangeSet::indexOf(const QString &fileName) const
+{
+    for (int i = 0; i < pending.size(); ++i) {
+        if (pending.at(i).fileName == fileName) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+QString EventChangeSet::activePath(const Change &change) const
+{
+    return QDir(folderPath).filePath(change.fileName);
+}
+
+QString EventChangeSet::inactivePath(const Change &change) const
+{
+    return QDir(folderPath).filePath("OFF_" + change.fileName);
+}
+
+void EventChangeSet::stage(const Change &change)
+{
+    const int index = indexOf(change.fileName);
+    if (QFile::exists(activePath(change)) == change.enable) {
+        if (index >= 0) {
+            pending.remove(index);
+        }
+        return;
+    }
+
+    if (index >= 0) {
+        pending[index] = change;
+    } else {
+        pending.append(change);
+    }
+}
+
+QVector<EventChangeSet::ValueChange> EventChangeSet::preview(const EffectiveLiveTuning &current, QStringList *errors) const
+{
+    // The copy extends the current string pools, so keys from both sides compare directly
+    EffectiveLiveTuning after = current;
+    for (const Change &change : pending) {
+        if (!change.enable) {
+            after.applyFile(change.fileName, nullptr);
+            continue;
+        }
+
+        LiveTuningStore store;
+        QString parseError;
+        if (!store.loadFile(inactivePath(change), &parseError)) {
+            if (errors) {
+                errors->append(QString("%1: %2").arg(change.fileName, parseError));
+            }
+            continue;
+        }
+        after.applyFile(change.fileName, &store);
+    }
+
+    QHash<quint64, int> beforeRows;
+    beforeRows.reserve(current.size());
+    for (int i = 0; i < current.size(); ++i) {
+        beforeRows.insert(current.key(i), i);
+    }
+
+    QVector<ValueChange> result;
+    for (int i = 0; i < after.size(); ++i) {
+        int row = -1;
+        auto it = beforeRows.find(after.key(i));
+        if (it != beforeRows.end()) {
+            row = it.value();
+            beforeRows.erase(it);
+        }
+
+        ValueChange change;
+        change.prototype = after.prototype(i);
+        change.setting = after.setting(i);
+        change.hadValue = row >= 0;
+        change.before = row >= 0 ? current.value(row) : 0.0;
+        change.hasValue = true;
+        change.after = after.value(i);
+        change.source = after.sourceFile(i);
+        if (!change.hadValue || change.before != change.after) {
+            result.append(change);
+        }
+    }
+
+    // Whatever is left was only set by files that are being turned off
+    for (auto it = beforeRows.constBegin(); it != beforeRows.constEnd(); ++it) {
+        ValueChange change;
+        change.prototype = current.prototype(it.value());
+        change.setting = current.setting(it.value());
+        change.hadValue = true;
+        change.before = current.value(it.value());
+        result.append(change);
+    }
+    return result;
+}
+
+bool EventChangeSet::commit(QString *errorMessage)
+{
+    // Check everything up front so the common failures don't need a rollback at all
+    for (const Change &change : pending) {
+        const QString from = change.enable ? inactivePath(change) : activePath(change);
+        const QString to = change.enable ? activePath(change) : inactivePath(change);
+        if (!QFile::exists(from)) {
+            *errorMessage = QString("File not found: %1").arg(from);
+            return false;
+        }
+        if (QFile::exists(to)) {
+            *errorMessage = QString("Both %1 and %2 exist, remove one of them first.")
+                                .arg(QFileInfo(from).fileName(), QFileInfo(to).fileName());
+            return false;
+        }
+    }
+
+    for (int i = 0; i < pending.size(); ++i) {
+        const Change &change = pending.at(i);
+        const QString from = change.enable ? inactivePath(change) : activePath(change);
+        const QString to = change.enable ? activePath(change) : inactivePath(change);
+
+        QFile file(from);
+        if (file.rename(to)) {
+            continue;
+        }
+
+        *errorMessage = QString("Failed to rename %1: %2").arg(QFileInfo(from).fileName(), file.errorString());
+        QStringList stuck;
+        for (int j = i - 1; j >= 0; --j) {
+            const Change &done = pending.at(j);
+            const QString renamed = done.enable ? activePath(done) : inactivePath(done);
+            const QString original = done.enable ? inactivePath(done) : activePath(done);
+            if (!QFile::rename(renamed, original)) {
+                stuck.append(QFileInfo(renamed).fileName());
+            }
+        }
+        if (!stuck.isEmpty()) {
+            *errorMessage += QString("\nThese could not be put back: %1").arg(stuck.join(", "));
+        }
+        return false;
+    }
+
+    pending.clear();
+    return true;
+}
+
+QString EventChangeSet::broadcastMessage() const
+{
+    QStringList started;
+    QStringList ended;
+    for (const Change &change : pending) {
+        if (change.announce) {
+            (change.enable ? started : ended).append(change.eventName);
+        }
+    }
+
+    // A single switch keeps the wording players already know
+    if (started.size() + ended.size() == 1) {
+        return started.isEmpty() ? QString("The %1 Event has ended!").arg(ended.first())
+                                 : QString("The %1 Event has started!").arg(started.first());
+    }
+
+    QStringList parts;
+    if (!started.isEmpty()) {
+        parts << QString("Events started: %1!").arg(started.join(", "));
+    }
+    if (!ended.isEmpty()) {
+        parts << QString("Events ended: %1.").arg(ended.join(", "));
+    }
+    return parts.join(" ");
+}
@@ -0,0 +1,62 @@
+#ifndef EVENTCHANGESET_H
+#define EVENTCHANGESET_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include "effectivelivetuning.h"
+
+// Event switches staged against a LiveTuning folder and applied together. Enabling renames
+// OFF_<file> to <file> and disabling does the reverse; commit() performs every rename or none,
+// so the server only has to reload once for the whole set.
+class EventChangeSet
+{
+public:
+    struct Change {
+        QString eventName;  // Used in logs and broadcasts
+        QString fileName;   // Active name, e.g. LiveTuningData_CosmicChaos.json
+        bool enable = false;
+        bool announce = false;
+    };
+
+    struct ValueChange {
+        QString prototype;
+        QString setting;
+        bool hadValue = false;
+        double before = 0.0;
+        bool hasValue = false;
+        double after = 0.0;
+        QString source; // File the new value comes from
+    };
+
+    void setDirectory(const QString &path);
+    QString directory() const { return folderPath; }
+
+    // Staging the state the folder is already in drops the entry instead
+    void stage(const Change &change);
+    void clear() { pending.clear(); }
+
+    bool isEmpty() const { return pending.isEmpty(); }
+    int size() const { return pending.size(); }
+    const QVector<Change> &changes() const { return pending; }
+    bool isStaged(const QString &fileName) const { return indexOf(fileName) >= 0; }
+
+    // Effective settings that would change if the set were committed now
+    QVector<ValueChange> preview(const EffectiveLiveTuning &current, QStringList *errors) const;
+
+    // Renames every file or, if any rename fails, puts back the ones already done
+    bool commit(QString *errorMessage);
+
+    // Empty when none of the changes is announced
+    QString broadcastMessage() const;
+
+private:
+    int indexOf(const QString &fileName) const;
+    QString activePath(const Change &change) const;
+    QString inactivePath(const Change &change) const;
+
+    QString folderPath;
+    QVector<Change> pending;
+};
+
+#endif // EVENTCHANGESET_H
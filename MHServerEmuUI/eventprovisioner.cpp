@@ -0,0 +1,186 @@
+#include "eventprovisioner.h"
+#include "atomicfilewriter.h"
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSet>
+#include <QThreadPool>
+#include <QSemaphore>
+#include <algorithm>
+
+namespace {
+
+QByteArray readAll(const QString &path, bool *ok)
+{
+    QFile file(path);
+    *ok = file.open(QIODevice::ReadOnly);
+    return *ok ? file.readAll() : QByteArray();
+}
+
+} // namespace
+
+QVector<EventFileProvisioner::ManifestEntry> EventFileProvisioner::loadManifest(const QString &manifestPath, QString *errorMessage)
+{
+    QVector<ManifestEntry> entries;
+    QFile file(manifestPath);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        *errorMessage = QString("Cannot read %1: %2").arg(manifestPath, file.errorString());
+        return entries;
+    }
+
+    const QString directory = QFileInfo(manifestPath).path();
+    int lineNumber = 0;
+    while (!file.atEnd()) {
+        const QByteArray line = file.readLine().trimmed();
+        ++lineNumber;
+        if (line.isEmpty() || line.startsWith('#')) {
+            continue;
+        }
+
+        // Same layout sha1sum prints
+        const int split = line.indexOf("  ");
+        const QByteArray hash = QByteArray::fromHex(line.left(split));
+        if (split != 40 || hash.size() != 20) {
+            *errorMessage = QString("%1 line %2 is not \"<sha1>  <file name>\"").arg(manifestPath).arg(lineNumber);
+            return QVector<ManifestEntry>();
+        }
+
+        ManifestEntry entry;
+        entry.fileName = QString::fromUtf8(line.mid(split + 2));
+        entry.hash = hash;
+        entry.sourcePath = directory + "/" + entry.fileName;
+        entries.append(entry);
+    }
+    return entries;
+}
+
+QHash<QString, QByteArray> EventFileProvisioner::readLedger(const QString &path)
+{
+    QHash<QString, QByteArray> ledger;
+    bool ok = false;
+    const QByteArray content = readAll(path, &ok);
+    for (const QByteArray &line : content.split('\n')) {
+        const int split = line.indexOf("  ");
+        if (split == 40) {
+            ledger.insert(QString::fromUtf8(line.mid(split + 2).trimmed()), QByteArray::fromHex(line.left(split)));
+        }
+    }
+    return ledger;
+}
+
+QByteArray EventFileProvisioner::ledgerContent(const QHash<QString, QByteArray> &ledger)
+{
+    QStringList names = ledger.keys();
+    std::sort(names.begin(), names.end());
+
+    QByteArray content = "# Event files as last installed by MHServerEmuUI, used to keep local edits\n";
+    for (const QString &name : names) {
+        content += ledger.value(name).toHex() + "  " + name.toUtf8() + "\n";
+    }
+    return content;
+}
+
+EventFileProvisioner::Result EventFileProvisioner::provision(const QString &liveTuningDir, const QVector<ManifestEntry> &manifest)
+{
+    Result result;
+    QDir dir(liveTuningDir);
+
+    // One listing tells which state every event is in, instead of probing each name
+    const QStringList listing = dir.entryList({"*LiveTuningData*.json"}, QDir::Files);
+    const QSet<QString> present(listing.begin(), listing.end());
+    const QString ledgerPath = dir.filePath(LedgerName);
+    QHash<QString, QByteArray> ledger = readLedger(ledgerPath);
+
+    struct Job {
+        const ManifestEntry *entry;
+        QString activeName;  // Ledger key, the same in either state
+        QString target;      // Name in the folder, active or OFF_
+        bool exists;
+        bool active;
+        // Filled in by the worker
+        QByteArray diskHash;
+        AtomicFileWriter::Result written = AtomicFileWriter::Unchanged;
+        bool keptEdited = false;
+        QString error;
+    };
+
+    QVector<Job> jobs;
+    jobs.reserve(manifest.size());
+    for (const ManifestEntry &entry : manifest) {
+        const QString activeName = entry.fileName.startsWith(QLatin1String("OFF_")) ? entry.fileName.mid(4) : entry.fileName;
+        const QString inactiveName = "OFF_" + activeName;
+
+        Job job;
+        job.entry = &entry;
+        job.activeName = activeName;
+        job.active = present.contains(activeName);
+        job.exists = job.active || present.contains(inactiveName);
+        job.target = job.active ? activeName : inactiveName;
+        jobs.append(job);
+    }
+
+    QThreadPool pool;
+    QSemaphore finished;
+    Job *jobData = jobs.data();
+    for (int i = 0; i < jobs.size(); ++i) {
+        const QString targetPath = dir.filePath(jobs.at(i).target);
+        const QByteArray installedHash = ledger.value(jobs.at(i).activeName);
+        pool.start([jobData, i, targetPath, installedHash, &finished]() {
+            Job &job = jobData[i];
+            bool ok = false;
+            if (job.exists) {
+                const QByteArray disk = readAll(targetPath, &ok);
+                if (!ok) {
+                    job.error = QString("Cannot read %1").arg(job.target);
+                    finished.release();
+                    return;
+                }
+                job.diskHash = AtomicFileWriter::contentHash(disk);
+                if (job.diskHash == job.entry->hash) {
+                    finished.release();
+                    return;
+                }
+                if (!installedHash.isEmpty() && installedHash != job.diskHash) {
+                    job.keptEdited = true; // Changed by someone after we installed it
+                    finished.release();
+                    return;
+                }
+            }
+
+            const QByteArray content = readAll(job.entry->sourcePath, &ok);
+            if (!ok || AtomicFileWriter::contentHash(content) != job.entry->hash) {
+                job.error = QString("Shipped copy of %1 is missing or damaged").arg(job.entry->fileName);
+                finished.release();
+                return;
+            }
+            job.written = AtomicFileWriter::write(targetPath, content, &job.error);
+            finished.release();
+        });
+    }
+    finished.acquire(jobs.size());
+
+    for (const Job &job : jobs) {
+        if (!job.error.isEmpty()) {
+            result.errors.append(job.error);
+            continue;
+        }
+        if (job.keptEdited) {
+            result.keptEdited.append(job.target);
+            continue;
+        }
+        if (job.written == AtomicFileWriter::Written) {
+            (job.exists ? result.updated : result.installed).append(job.target);
+            if (job.exists && job.active) {
+                result.updatedActive.append(job.target);
+            }
+        }
+
+        ledger.insert(job.activeName, job.entry->hash);
+    }
+
+    QString ledgerError;
+    if (AtomicFileWriter::write(ledgerPath, ledgerContent(ledger), &ledgerError) == AtomicFileWriter::Failed) {
+        result.errors.append(ledgerError);
+    }
+    return result;
+}
@@ -0,0 +1,48 @@
+#ifndef EVENTPROVISIONER_H
+#define EVENTPROVISIONER_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+// Installs the event files shipped with the UI into a server's LiveTuning folder. The shipped set
+// is described by a manifest of "<sha1>  <file name>" lines, embedded next to the files under
+// :/events/ at build time. Files are shipped disabled (OFF_...); whichever state a server has an
+// event in is kept.
+//
+// A server copy is refreshed when its content differs from the shipped one, unless it was edited
+// after the UI last installed it. What was installed is remembered in a small ledger file in the
+// LiveTuning folder, which the server ignores.
+class EventFileProvisioner
+{
+public:
+    static constexpr const char *ManifestPath = ":/events/manifest";
+    static constexpr const char *LedgerName = "MHServerEmuUI.events";
+
+    struct ManifestEntry {
+        QString fileName;     // As shipped, OFF_LiveTuningData_<Event>.json
+        QByteArray hash;      // Raw SHA-1
+        QString sourcePath;   // Where to read the content from
+    };
+
+    struct Result {
+        QStringList installed;    // Were missing
+        QStringList updated;      // Were outdated
+        QStringList keptEdited;   // Differ from the shipped version but were edited locally
+        QStringList updatedActive;// Subset of updated that the server currently loads
+        QStringList errors;
+    };
+
+    static QVector<ManifestEntry> loadManifest(const QString &manifestPath, QString *errorMessage);
+
+    // Blocking; meant to run on a worker thread. Reads and copies run in parallel.
+    static Result provision(const QString &liveTuningDir, const QVector<ManifestEntry> &manifest);
+
+private:
+    static QHash<QString, QByteArray> readLedger(const QString &path);
+    static QByteArray ledgerContent(const QHash<QString, QByteArray> &ledger);
+};
+
+#endif // EVENTPROVISIONER_H
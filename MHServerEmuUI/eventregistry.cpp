@@ -0,0 +1,69 @@
+#include "eventregistry.h"
+#include "eventcalendar.h"
+#include <QDir>
+#include <QMap>
+
+bool EventRegistry::isEventFileName(const QString &fileName)
+{
+    const QString active = activeFileName(fileName);
+    return active.startsWith(QLatin1String("LiveTuningData")) && active.endsWith(QLatin1String(".json"))
+           && active != QLatin1String("LiveTuningData.json");
+}
+
+QString EventRegistry::activeFileName(const QString &fileName)
+{
+    return fileName.startsWith(QLatin1String("OFF_")) ? fileName.mid(4) : fileName;
+}
+
+void EventRegistry::clear()
+{
+    events.clear();
+    rows.clear();
+}
+
+void EventRegistry::rebuild(const QString &liveTuningDir, const QStringList &shippedFiles)
+{
+    // Sorted by event name, case-insensitively, for the list
+    QMap<QString, Event> byName;
+    auto entryFor = [&byName](const QString &fileName) -> Event & {
+        const QString active = activeFileName(fileName);
+        const QString name = EventCalendar::eventName(active);
+        Event &event = byName[name.toLower() + QLatin1Char('\0') + active];
+        event.name = name;
+        event.fileName = active;
+        return event;
+    };
+
+    for (const QString &fileName : shippedFiles) {
+        if (isEventFileName(fileName)) {
+            entryFor(fileName).shipped = true;
+        }
+    }
+
+    if (!liveTuningDir.isEmpty()) {
+        const QStringList names = QDir(liveTuningDir).entryList({"*LiveTuningData*.json"}, QDir::Files);
+        for (const QString &fileName : names) {
+            if (!isEventFileName(fileName)) {
+                continue;
+            }
+            Event &event = entryFor(fileName);
+            event.present = true;
+            event.active = event.active || !fileName.startsWith(QLatin1String("OFF_"));
+        }
+    }
+
+    events.clear();
+    rows.clear();
+    events.reserve(byName.size());
+    for (const Event &event : byName) {
+        rows.insert(event.fileName, events.size());
+        events.append(event);
+    }
+}
+
+void EventRegistry::setActive(int index, bool active)
+{
+    Event &event = events[index];
+    event.active = active;
+    event.present = true;
+}
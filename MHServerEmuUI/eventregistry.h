@@ -0,0 +1,42 @@
+#ifndef EVENTREGISTRY_H
+#define EVENTREGISTRY_H
+
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+// Every event a LiveTuning folder offers, whether it ships with the UI or was dropped in by hand.
+// An event is a LiveTuningData_<Name>.json file that may be renamed to OFF_... to switch it off;
+// the base LiveTuningData.json is not an event. Entries are sorted by name and looked up by
+// their active file name in constant time.
+class EventRegistry
+{
+public:
+    struct Event {
+        QString name;       // <Name> part of the file name
+        QString fileName;   // Active file name
+        bool active = false;
+        bool present = false; // Exists in the folder in either state
+        bool shipped = false; // Listed in the event manifest
+    };
+
+    static bool isEventFileName(const QString &fileName);
+    static QString activeFileName(const QString &fileName); // Strips OFF_
+
+    // One listing of the folder; shippedFiles are manifest names in either state
+    void rebuild(const QString &liveTuningDir, const QStringList &shippedFiles);
+    void clear();
+
+    int size() const { return events.size(); }
+    const Event &at(int index) const { return events.at(index); }
+    int indexOf(const QString &fileName) const { return rows.value(activeFileName(fileName), -1); }
+
+    void setActive(int index, bool active);
+
+private:
+    QVector<Event> events;
+    QHash<QString, int> rows; // Active file name -> index
+};
+
+#endif // EVENTREGISTRY_H
@@ -0,0 +1,452 @@
+#include "inflate.h"
+#include <QScopedPointer>
+#include <cstring>
+
+namespace {
+
+constexpr int MaxCodeBits = 15;
+constexpr int LiteralCodes = 288;
+constexpr int DistanceCodes = 32;
+
+const quint16 lengthBase[29] = {
+    3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+    35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258
+};
+const quint8 lengthExtra[29] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+    3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0
+};
+const quint16 distanceBase[30] = {
+    1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+    257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577
+};
+const quint8 distanceExtra[30] = {
+    0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+    7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13
+};
+const quint8 codeLengthOrder[19] = {16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15};
+
+// LSB-first bit reader. Past the end it feeds zeros and counts them, so the hot loop needs
+// no bounds checks; overrun() tells afterwards whether any of those zeros were used.
+class BitReader
+{
+public:
+    BitReader(const quint8 *data, qint64 size) : data(data), size(size) {}
+
+    void refill()
+    {
+        while (count <= 56) {
+            quint64 byte = 0;
+            if (pos < size) {
+                byte = data[pos++];
+            } else {
+                ++padding;
+            }
+            buffer |= byte << count;
+            count += 8;
+        }
+    }
+
+    quint32 peek(int bits)
+    {
+        if (count < bits) {
+            refill();
+        }
+        return quint32(buffer & ((quint64(1) << bits) - 1));
+    }
+
+    void drop(int bits)
+    {
+        buffer >>= bits;
+        count -= bits;
+    }
+
+    quint32 take(int bits)
+    {
+        const quint32 value = peek(bits);
+        drop(bits);
+        return value;
+    }
+
+    void alignToByte() { drop(count % 8); }
+    bool overrun() const { return padding * 8 > count; }
+
+    // Stored blocks copy straight from the input once the buffered bytes are used up
+    bool copyBytes(quint8 *out, qint64 length)
+    {
+        while (length > 0 && count >= 8) {
+            *out++ = quint8(take(8));
+            --length;
+        }
+        if (length > size - pos) {
+            return false;
+        }
+        std::memcpy(out, data + pos, size_t(length));
+        pos += length;
+        return true;
+    }
+
+private:
+    const quint8 *data;
+    qint64 size;
+    qint64 pos = 0;
+    quint64 buffer = 0;
+    int count = 0;
+    int padding = 0;
+};
+
+// Canonical Huffman code as one lookup table indexed by the next maxBits input bits.
+// Entries are (symbol << 4) | code length; a length of 0 marks a bit pattern with no code.
+class HuffmanTable
+{
+public:
+    bool build(const quint8 *lengths, int symbols)
+    {
+        int counts[MaxCodeBits + 1] = {};
+        for (int i = 0; i < symbols; ++i) {
+            ++counts[lengths[i]];
+        }
+        counts[0] = 0;
+
+        maxBits = 0;
+        int left = 1;
+        for (int bits = 1; bits <= MaxCodeBits; ++bits) {
+            left = (left << 1) - counts[bits];
+            if (left < 0) {
+                return false; // Over-subscribed
+            }
+            if (counts[bits]) {
+                maxBits = bits;
+            }
+        }
+        // Incomplete codes are allowed (a single distance code, or none at all); the unused
+        // patterns keep length 0 and fail if the data ever uses them
+
+        int nextCode[MaxCodeBits + 2] = {};
+        for (int bits = 1; bits <= MaxCodeBits; ++bits) {
+            nextCode[bits + 1] = (nextCode[bits] + counts[bits]) << 1;
+        }
+
+        const int tableBits = qMax(maxBits, 1);
+        std::memset(table, 0, sizeof(quint16) << tableBits);
+        for (int symbol = 0; symbol < symbols; ++symbol) {
+            const int length = lengths[symbol];
+            if (!length) {
+                continue;
+            }
+            // Codes are stored MSB first but read LSB first
+            int code = nextCode[length]++;
+            int reversed = 0;
+            for (int i = 0; i < length; ++i) {
+                reversed = (reversed << 1) | (code & 1);
+                code >>= 1;
+            }
+            const quint16 entry = quint16((symbol << 4) | length);
+            for (int index = reversed; index < (1 << tableBits); index += 1 << length) {
+                table[index] = entry;
+            }
+        }
+        maxBits = tableBits;
+        return true;
+    }
+
+    // Negative for a bit pattern without a code
+    int decode(BitReader &bits) const
+    {
+        const quint16 entry = table[bits.peek(maxBits)];
+        const int length = entry & 15;
+        if (!length) {
+            return -1;
+        }
+        bits.drop(length);
+        return entry >> 4;
+    }
+
+private:
+    quint16 table[1 << MaxCodeBits];
+    int maxBits = 0;
+};
+
+struct FixedTables {
+    HuffmanTable literals;
+    HuffmanTable distances;
+
+    FixedTables()
+    {
+        quint8 lengths[LiteralCodes];
+        std::memset(lengths, 8, 144);
+        std::memset(lengths + 144, 9, 112);
+        std::memset(lengths + 256, 7, 24);
+        std::memset(lengths + 280, 8, 8);
+        literals.build(lengths, LiteralCodes);
+        std::memset(lengths, 5, DistanceCodes);
+        distances.build(lengths, DistanceCodes);
+    }
+};
+
+const FixedTables &fixedTables()
+{
+    static const FixedTables tables; // Thread-safe initialisation
+    return tables;
+}
+
+class Decoder
+{
+public:
+    Decoder(const char *input, qint64 inputSize, char *output, qint64 outputSize)
+        : bits(reinterpret_cast<const quint8 *>(input), inputSize)
+        , out(reinterpret_cast<quint8 *>(output))
+        , outSize(outputSize)
+    {
+    }
+
+    bool run(QString *errorMessage)
+    {
+        bool last = false;
+        while (!last) {
+            last = bits.take(1);
+            const int type = bits.take(2);
+            bool ok = false;
+            switch (type) {
+            case 0:
+                ok = storedBlock();
+                break;
+            case 1:
+                ok = codes(fixedTables().literals, fixedTables().distances);
+                break;
+            case 2:
+                ok = dynamicBlock();
+                break;
+            default:
+                error = "invalid block type";
+                break;
+            }
+            if (!ok || bits.overrun()) {
+                if (errorMessage) {
+                    *errorMessage = bits.overrun() ? QString("compressed data ends early") : error;
+                }
+                return false;
+            }
+        }
+
+        if (produced != outSize) {
+            if (errorMessage) {
+                *errorMessage = QString("decompressed to %1 bytes, expected %2").arg(produced).arg(outSize);
+            }
+            return false;
+        }
+        return true;
+    }
+
+private:
+    bool storedBlock()
+    {
+        bits.alignToByte();
+        const quint32 length = bits.take(16);
+        const quint32 complement = bits.take(16);
+        if (length != (~complement & 0xFFFF)) {
+            error = "stored block length mismatch";
+            return false;
+        }
+        if (length > outSize - produced) {
+            error = "output larger than expected";
+            return false;
+        }
+        if (!bits.copyBytes(out + produced, length)) {
+            error = "compressed data ends early";
+            return false;
+        }
+        produced += length;
+        return true;
+    }
+
+    bool dynamicBlock()
+    {
+        const int literalCount = bits.take(5) + 257;
+        const int distanceCount = bits.take(5) + 1;
+        const int codeLengthCount = bits.take(4) + 4;
+        if (literalCount > 286 || distanceCount > 30) {
+            error = "too many codes";
+            return false;
+        }
+
+        quint8 lengths[LiteralCodes + DistanceCodes] = {};
+        for (int i = 0; i < codeLengthCount; ++i) {
+            lengths[codeLengthOrder[i]] = quint8(bits.take(3));
+        }
+        if (!lengthCodes.build(lengths, 19)) {
+            error = "invalid code length code";
+            return false;
+        }
+
+        // Literal/length and distance code lengths form one sequence, repeats may cross over
+        std::memset(lengths, 0, sizeof(lengths));
+        const int total = literalCount + distanceCount;
+        for (int index = 0; index < total;) {
+            const int symbol = lengthCodes.decode(bits);
+            if (symbol < 0) {
+                error = "invalid code length";
+                return false;
+            }
+            if (symbol < 16) {
+                lengths[index++] = quint8(symbol);
+                continue;
+            }
+
+            int repeat;
+            quint8 value = 0;
+            if (symbol == 16) {
+                if (index == 0) {
+                    error = "repeat with no previous length";
+                    return false;
+                }
+                value = lengths[index - 1];
+                repeat = 3 + bits.take(2);
+            } else if (symbol == 17) {
+                repeat = 3 + bits.take(3);
+            } else {
+                repeat = 11 + bits.take(7);
+            }
+            if (index + repeat > total) {
+                error = "too many code lengths";
+                return false;
+            }
+            std::memset(lengths + index, value, repeat);
+            index += repeat;
+        }
+
+        if (!lengths[256]) {
+            error = "no end-of-block code";
+            return false;
+        }
+        if (!literals.build(lengths, literalCount) || !distances.build(lengths + literalCount, distanceCount)) {
+            error = "invalid literal/length or distance code";
+            return false;
+        }
+        return codes(literals, distances);
+    }
+
+    bool codes(const HuffmanTable &literalTable, const HuffmanTable &distanceTable)
+    {
+        for (;;) {
+            // Enough for the longest literal/length + extra + distance + extra (15+5+15+13)
+            bits.refill();
+            if (bits.overrun()) {
+                error = "compressed data ends early";
+                return false;
+            }
+
+            int symbol = literalTable.decode(bits);
+            if (symbol < 0) {
+                error = "invalid literal/length code";
+                return false;
+            }
+            if (symbol < 256) {
+                if (produced == outSize) {
+                    error = "output larger than expected";
+                    return false;
+                }
+                out[produced++] = quint8(symbol);
+                continue;
+            }
+            if (symbol == 256) {
+                return true;
+            }
+
+            symbol -= 257;
+            if (symbol >= 29) {
+                error = "invalid length symbol";
+                return false;
+            }
+            const qint64 length = lengthBase[symbol] + bits.take(lengthExtra[symbol]);
+
+            const int distanceSymbol = distanceTable.decode(bits);
+            if (distanceSymbol < 0 || distanceSymbol >= 30) {
+                error = "invalid distance code";
+                return false;
+            }
+            const qint64 distance = distanceBase[distanceSymbol] + bits.take(distanceExtra[distanceSymbol]);
+            if (distance > produced) {
+                error = "distance too far back";
+                return false;
+            }
+            if (length > outSize - produced) {
+                error = "output larger than expected";
+                return false;
+            }
+
+            quint8 *target = out + produced;
+            const quint8 *source = target - distance;
+            if (distance >= length) {
+                std::memcpy(target, source, size_t(length));
+            } else {
+                for (qint64 i = 0; i < length; ++i) {
+                    target[i] = source[i]; // Overlapping run, repeats the last distance bytes
+                }
+            }
+            produced += length;
+        }
+    }
+
+    BitReader bits;
+    quint8 *out;
+    qint64 outSize;
+    qint64 produced = 0;
+    QString error;
+
+    // Rebuilt per dynamic block; members so they don't sit on the worker's stack
+    HuffmanTable lengthCodes;
+    HuffmanTable literals;
+    HuffmanTable distances;
+};
+
+// Slicing-by-8: eight bytes per step, table k advances a byte through k further zero bytes
+struct CrcTable {
+    quint32 entries[8][256];
+
+    CrcTable()
+    {
+        for (quint32 i = 0; i < 256; ++i) {
+            quint32 value = i;
+            for (int bit = 0; bit < 8; ++bit) {
+                value = value & 1 ? 0xEDB88320u ^ (value >> 1) : value >> 1;
+            }
+            entries[0][i] = value;
+        }
+        for (int k = 1; k < 8; ++k) {
+            for (int i = 0; i < 256; ++i) {
+                entries[k][i] = (entries[k - 1][i] >> 8) ^ entries[0][entries[k - 1][i] & 0xFF];
+            }
+        }
+    }
+};
+
+} // namespace
+
+namespace Inflate {
+
+bool inflate(const char *input, qint64 inputSize, char *output, qint64 outputSize, QString *errorMessage)
+{
+    // The tables are 64 KiB each, too much for a pool thread's stack
+    QScopedPointer<Decoder> decoder(new Decoder(input, inputSize, output, outputSize));
+    return decoder->run(errorMessage);
+}
+
+quint32 crc32(const char *data, qint64 size, quint32 crc)
+{
+    static const CrcTable table;
+    const quint32 (*t)[256] = table.entries;
+    crc = ~crc;
+    const quint8 *bytes = reinterpret_cast<const quint8 *>(data);
+    for (; size >= 8; size -= 8, bytes += 8) {
+        const quint32 low = crc ^ (quint32(bytes[0]) | quint32(bytes[1]) << 8 | quint32(bytes[2]) << 16 | quint32(bytes[3]) << 24);
+        crc = t[7][low & 0xFF] ^ t[6][(low >> 8) & 0xFF] ^ t[5][(low >> 16) & 0xFF] ^ t[4][low >> 24]
+              ^ t[3][bytes[4]] ^ t[2][bytes[5]] ^ t[1][bytes[6]] ^ t[0][bytes[7]];
+    }
+    for (; size > 0; --size) {
+        crc = t[0][(crc ^ *bytes++) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+} // namespace Inflate
@@ -0,0 +1,21 @@
+#ifndef INFLATE_H
+#define INFLATE_H
+
+#include <QtGlobal>
+#include <QString>
+
+// Raw DEFLATE (RFC 1951) decoder for ZIP entries. The central directory gives the
+// uncompressed size up front, so it decodes straight into a buffer of that size.
+// Thread-safe: nothing is shared between calls but the fixed Huffman tables.
+namespace Inflate {
+
+// Fails on malformed input, on output that doesn't fill outputSize exactly, and on
+// input that ends before the final block does
+bool inflate(const char *input, qint64 inputSize, char *output, qint64 outputSize, QString *errorMessage = nullptr);
+
+// CRC-32 as used by ZIP (reflected 0xEDB88320); chain by passing the previous result
+quint32 crc32(const char *data, qint64 size, quint32 crc = 0);
+
+} // namespace Inflate
+
+#endif // INFLATE_H
@@ -0,0 +1,153 @@
+#include "inifile.h"
+#include <QFile>
+
+void IniFile::parse(const QByteArray &content)
+{
+    lines.clear();
+    crlf = content.contains("\r\n");
+
+    QString text = QString::fromUtf8(content);
+    if (text.startsWith(QChar(0xFEFF))) {
+        text.remove(0, 1);
+    }
+    text.remove(QLatin1Char('\r'));
+    if (text.endsWith(QLatin1Char('\n'))) {
+        text.chop(1);
+    }
+
+    QString section;
+    const QStringList rawLines = text.isEmpty() ? QStringList() : text.split(QLatin1Char('\n'));
+    lines.reserve(rawLines.size());
+    for (const QString &raw : rawLines) {
+        Line line;
+        line.text = raw;
+        const QString trimmed = raw.trimmed();
+
+        if (trimmed.startsWith(QLatin1Char('[')) && trimmed.endsWith(QLatin1Char(']'))) {
+            section = trimmed.mid(1, trimmed.size() - 2).trimmed();
+        } else if (!trimmed.isEmpty() && !trimmed.startsWith(QLatin1Char(';')) && !trimmed.startsWith(QLatin1Char('#'))) {
+            const int separator = trimmed.indexOf(QLatin1Char('='));
+            if (separator > 0) {
+                line.key = trimmed.left(separator).trimmed();
+                line.value = trimmed.mid(separator + 1).trimmed();
+                line.entry = true;
+            }
+        }
+        line.section = section;
+        lines.append(line);
+    }
+    reindex();
+}
+
+bool IniFile::load(const QString &path, QString *errorMessage)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        lines.clear();
+        reindex();
+        if (errorMessage) {
+            *errorMessage = file.errorString();
+        }
+        return false;
+    }
+    parse(file.readAll());
+    return true;
+}
+
+QByteArray IniFile::toText() const
+{
+    const QString newline = crlf ? QStringLiteral("\r\n") : QStringLiteral("\n");
+    QString text;
+    for (const Line &line : lines) {
+        text += line.text;
+        text += newline;
+    }
+    return text.toUtf8();
+}
+
+bool IniFile::contains(const QString &section, const QString &key) const
+{
+    return entries.contains(fullKey(section, key));
+}
+
+QString IniFile::value(const QString &section, const QString &key, const QString &defaultValue) const
+{
+    auto it = entries.constFind(fullKey(section, key));
+    return it != entries.constEnd() ? lines.at(it.value()).value : defaultValue;
+}
+
+void IniFile::setValue(const QString &section, const QString &key, const QString &value)
+{
+    Line line;
+    line.text = key + QLatin1Char('=') + value;
+    line.section = section;
+    line.key = key;
+    line.value = value;
+    line.entry = true;
+
+    auto it = entries.constFind(fullKey(section, key));
+    if (it != entries.constEnd()) {
+        lines[it.value()] = line;
+        return;
+    }
+
+    auto end = sectionEnds.constFind(section);
+    if (end != sectionEnds.constEnd()) {
+        lines.insert(end.value() + 1, line);
+    } else {
+        // New section, separated from whatever came before by a blank line
+        if (!lines.isEmpty() && !lines.last().text.trimmed().isEmpty()) {
+            Line blank;
+            blank.section = lines.last().section;
+            lines.append(blank);
+        }
+        Line header;
+        header.text = QLatin1Char('[') + section + QLatin1Char(']');
+        header.section = section;
+        lines.append(header);
+        lines.append(line);
+    }
+    reindex();
+}
+
+bool IniFile::remove(const QString &section, const QString &key)
+{
+    auto it = entries.constFind(fullKey(section, key));
+    if (it == entries.constEnd()) {
+        return false;
+    }
+
+    // Earlier duplicates of the key go too, otherwise they'd become the effective value
+    for (int i = lines.size() - 1; i >= 0; --i) {
+        if (lines.at(i).entry && lines.at(i).section == section && lines.at(i).key == key) {
+            lines.remove(i);
+        }
+    }
+    reindex();
+    return true;
+}
+
+QVariantMap IniFile::toMap() const
+{
+    QVariantMap values;
+    for (auto it = entries.constBegin(); it != entries.constEnd(); ++it) {
+        values.insert(it.key(), lines.at(it.value()).value);
+    }
+    return values;
+}
+
+void IniFile::reindex()
+{
+    entries.clear();
+    sectionEnds.clear();
+    for (int i = 0; i < lines.size(); ++i) {
+        const Line &line = lines.at(i);
+        if (line.entry) {
+            entries.insert(fullKey(line.section, line.key), i);
+        }
+        // Comments above a header describe the next section, so only entries and headers count
+        if (line.entry || line.text.trimmed().startsWith(QLatin1Char('['))) {
+            sectionEnds.insert(line.section, i);
+        }
+    }
+}
@@ -0,0 +1,48 @@
+#ifndef INIFILE_H
+#define INIFILE_H
+
+#include <QString>
+#include <QByteArray>
+#include <QVector>
+#include <QHash>
+#include <QVariantMap>
+
+// Line-preserving view of an ini file in the layout MHServerEmu reads. Comments, blank lines,
+// ordering and keys nobody asked about survive a parse/toText round trip untouched, and values
+// are kept verbatim (QSettings would unquote them and split anything with a comma into a list).
+class IniFile
+{
+public:
+    void parse(const QByteArray &content);
+    bool load(const QString &path, QString *errorMessage = nullptr);
+    QByteArray toText() const;
+
+    bool contains(const QString &section, const QString &key) const;
+    QString value(const QString &section, const QString &key, const QString &defaultValue = QString()) const;
+
+    // Existing entries are rewritten in place, new ones go to the end of their section
+    void setValue(const QString &section, const QString &key, const QString &value);
+    bool remove(const QString &section, const QString &key);
+
+    // "Section/Key" -> value, the shape TuningFileWatcher caches
+    QVariantMap toMap() const;
+
+private:
+    struct Line {
+        QString text;    // Verbatim for anything that isn't a key=value entry
+        QString section;
+        QString key;
+        QString value;
+        bool entry = false;
+    };
+
+    static QString fullKey(const QString &section, const QString &key) { return section + QLatin1Char('/') + key; }
+    void reindex();
+
+    QVector<Line> lines;
+    QHash<QString, int> entries; // fullKey -> line, the last one wins like in the server
+    QHash<QString, int> sectionEnds; // Section -> its header or last entry
+    bool crlf = false;
+};
+
+#endif // INIFILE_H
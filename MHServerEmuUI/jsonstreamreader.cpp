@@ -0,0 +1,367 @@
+#include "jsonstreamreader.h"
+#include <QByteArray>
+#include <cstring>
+
+namespace {
+
+int hexValue(char c)
+{
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+uint readHex4(const char *p)
+{
+    uint value = 0;
+    for (int i = 0; i < 4; ++i) {
+        value = (value << 4) | static_cast<uint>(hexValue(p[i]));
+    }
+    return value;
+}
+
+void appendUtf8(QByteArray &out, uint codePoint)
+{
+    if (codePoint < 0x80) {
+        out += static_cast<char>(codePoint);
+    } else if (codePoint < 0x800) {
+        out += static_cast<char>(0xC0 | (codePoint >> 6));
+        out += static_cast<char>(0x80 | (codePoint & 0x3F));
+    } else if (codePoint < 0x10000) {
+        out += static_cast<char>(0xE0 | (codePoint >> 12));
+        out += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (codePoint & 0x3F));
+    } else {
+        out += static_cast<char>(0xF0 | (codePoint >> 18));
+        out += static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
+        out += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (codePoint & 0x3F));
+    }
+}
+
+} // namespace
+
+JsonStreamReader::JsonStreamReader(const char *data, qint64 size)
+    : begin(data)
+    , position(data)
+    , end(data + size)
+    , expectName(false)
+    , afterValue(false)
+    , started(false)
+    , stringBegin(nullptr)
+    , stringLength(0)
+    , stringHasEscapes(false)
+    , numberBegin(nullptr)
+    , numberLength(0)
+{
+    // Skip a UTF-8 byte order mark
+    if (size >= 3 && static_cast<uchar>(data[0]) == 0xEF && static_cast<uchar>(data[1]) == 0xBB && static_cast<uchar>(data[2]) == 0xBF) {
+        position += 3;
+    }
+}
+
+JsonStreamReader::Token JsonStreamReader::fail(const char *message)
+{
+    if (error.isEmpty()) {
+        error = QString("%1 at offset %2").arg(QLatin1String(message)).arg(offset());
+    }
+    position = end;
+    containers.clear();
+    return Invalid;
+}
+
+void JsonStreamReader::skipWhitespace()
+{
+    while (position < end && (*position == ' ' || *position == '\n' || *position == '\r' || *position == '\t')) {
+        ++position;
+    }
+}
+
+JsonStreamReader::Token JsonStreamReader::next()
+{
+    if (!error.isEmpty()) {
+        return Invalid;
+    }
+
+    skipWhitespace();
+
+    bool separated = false;
+    if (afterValue) {
+        if (containers.isEmpty()) {
+            return position == end ? End : fail("Unexpected data after the document");
+        }
+        if (position == end) {
+            return fail("Unexpected end of data");
+        }
+
+        const char top = containers.last();
+        if (*position == ',') {
+            ++position;
+            afterValue = false;
+            expectName = top == '{';
+            separated = true;
+            skipWhitespace();
+        } else if (*position == '}' && top == '{') {
+            ++position;
+            containers.removeLast();
+            return EndObject;
+        } else if (*position == ']' && top == '[') {
+            ++position;
+            containers.removeLast();
+            return EndArray;
+        } else {
+            return fail("Expected ',' or a closing bracket");
+        }
+    }
+
+    if (position == end) {
+        return started ? fail("Unexpected end of data") : fail("Empty document");
+    }
+    started = true;
+
+    if (expectName) {
+        if (*position == '}' && !separated) {
+            ++position;
+            containers.removeLast();
+            expectName = false;
+            afterValue = true;
+            return EndObject;
+        }
+        if (*position != '"' || !readString()) {
+            return fail("Expected an object key");
+        }
+        skipWhitespace();
+        if (position == end || *position != ':') {
+            return fail("Expected ':'");
+        }
+        ++position;
+        expectName = false;
+        return Name;
+    }
+
+    if (*position == ']' && !separated && !containers.isEmpty() && containers.last() == '[') {
+        ++position;
+        containers.removeLast();
+        afterValue = true;
+        return EndArray;
+    }
+
+    afterValue = true;
+    switch (*position) {
+    case '{':
+        ++position;
+        containers.append('{');
+        expectName = true;
+        afterValue = false;
+        return BeginObject;
+    case '[':
+        ++position;
+        containers.append('[');
+        afterValue = false;
+        return BeginArray;
+    case '"':
+        return readString() ? String : fail("Unterminated string");
+    case 't':
+        return readLiteral("true", 4) ? True : fail("Invalid literal");
+    case 'f':
+        return readLiteral("false", 5) ? False : fail("Invalid literal");
+    case 'n':
+        return readLiteral("null", 4) ? Null : fail("Invalid literal");
+    default:
+        if (readNumber()) {
+            return Number;
+        }
+        return fail(*numberBegin == '-' || (*numberBegin >= '0' && *numberBegin <= '9') ? "Malformed number" : "Unexpected character");
+    }
+}
+
+bool JsonStreamReader::skip(Token token)
+{
+    if (token != BeginObject && token != BeginArray) {
+        return token != Invalid;
+    }
+
+    const int depth = containers.size() - 1;
+    while (containers.size() > depth) {
+        if (next() == Invalid) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool JsonStreamReader::readString()
+{
+    ++position; // Opening quote
+    stringBegin = position;
+    stringHasEscapes = false;
+
+    while (position < end) {
+        const char c = *position;
+        if (c == '"') {
+            stringLength = static_cast<int>(position - stringBegin);
+            ++position;
+            return true;
+        }
+        if (c == '\\') {
+            stringHasEscapes = true;
+            if (position + 1 >= end) {
+                return false;
+            }
+            if (position[1] == 'u') {
+                if (position + 6 > end) {
+                    return false;
+                }
+                for (int i = 2; i < 6; ++i) {
+                    if (hexValue(position[i]) < 0) {
+                        return false;
+                    }
+                }
+                position += 6;
+                continue;
+            }
+            position += 2;
+            continue;
+        }
+        if (static_cast<uchar>(c) < 0x20) {
+            return false;
+        }
+        ++position;
+    }
+    return false;
+}
+
+bool JsonStreamReader::readNumber()
+{
+    // JSON grammar: -?(0|[1-9][0-9]*)(\.[0-9]+)?([eE][+-]?[0-9]+)?, anything else would
+    // reach numberValue() and silently read as 0
+    auto isDigit = [this]() { return position < end && *position >= '0' && *position <= '9'; };
+    auto skipDigits = [&]() {
+        const char *first = position;
+        while (isDigit()) {
+            ++position;
+        }
+        return position > first;
+    };
+
+    numberBegin = position;
+    if (position < end && *position == '-') {
+        ++position;
+    }
+    if (position < end && *position == '0') {
+        ++position;
+    } else if (!skipDigits()) {
+        return false;
+    }
+    if (position < end && *position == '.') {
+        ++position;
+        if (!skipDigits()) {
+            return false;
+        }
+    }
+    if (position < end && (*position == 'e' || *position == 'E')) {
+        ++position;
+        if (position < end && (*position == '+' || *position == '-')) {
+            ++position;
+        }
+        if (!skipDigits()) {
+            return false;
+        }
+    }
+    // "01", "1.2.3" or "1-2" end in another number character
+    if (position < end && ((*position >= '0' && *position <= '9') || *position == '.' || *position == 'e'
+                           || *position == 'E' || *position == '+' || *position == '-')) {
+        return false;
+    }
+    numberLength = static_cast<int>(position - numberBegin);
+    return true;
+}
+
+bool JsonStreamReader::readLiteral(const char *literal, int length)
+{
+    if (end - position < length || std::memcmp(position, literal, length) != 0) {
+        return false;
+    }
+    position += length;
+    return true;
+}
+
+QString JsonStreamReader::stringValue() const
+{
+    if (!stringHasEscapes) {
+        return QString::fromUtf8(stringBegin, stringLength);
+    }
+
+    QByteArray decoded;
+    decoded.reserve(stringLength);
+    const char *p = stringBegin;
+    const char *stringEnd = stringBegin + stringLength;
+    while (p < stringEnd) {
+        if (*p != '\\') {
+            decoded += *p++;
+            continue;
+        }
+
+        const char escape = p[1];
+        p += 2;
+        switch (escape) {
+        case '"':  decoded += '"'; break;
+        case '\\': decoded += '\\'; break;
+        case '/':  decoded += '/'; break;
+        case 'b':  decoded += '\b'; break;
+        case 'f':  decoded += '\f'; break;
+        case 'n':  decoded += '\n'; break;
+        case 'r':  decoded += '\r'; break;
+        case 't':  decoded += '\t'; break;
+        case 'u': {
+            uint codePoint = readHex4(p);
+            p += 4;
+            // Surrogate pair
+            if (codePoint >= 0xD800 && codePoint < 0xDC00 && stringEnd - p >= 6 && p[0] == '\\' && p[1] == 'u') {
+                uint low = readHex4(p + 2);
+                if (low >= 0xDC00 && low < 0xE000) {
+                    codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (low - 0xDC00);
+                    p += 6;
+                }
+            }
+            appendUtf8(decoded, codePoint);
+            break;
+        }
+        default:
+            decoded += escape;
+        }
+    }
+    return QString::fromUtf8(decoded);
+}
+
+bool JsonStreamReader::nameEquals(const char *latin1, int length) const
+{
+    if (stringHasEscapes) {
+        return stringValue() == QLatin1String(latin1, length);
+    }
+    return stringLength == length && std::memcmp(stringBegin, latin1, length) == 0;
+}
+
+double JsonStreamReader::numberValue() const
+{
+    // Plain integers that fit a double exactly skip the general conversion
+    if (numberLength <= 15) {
+        const char *p = numberBegin;
+        const char *numberEnd = numberBegin + numberLength;
+        const bool negative = *p == '-';
+        if (negative) {
+            ++p;
+        }
+        qint64 integer = 0;
+        while (p < numberEnd && *p >= '0' && *p <= '9') {
+            integer = integer * 10 + (*p - '0');
+            ++p;
+        }
+        if (p == numberEnd) {
+            return negative ? -static_cast<double>(integer) : static_cast<double>(integer);
+        }
+    }
+
+    return QByteArray::fromRawData(numberBegin, numberLength).toDouble();
+}
@@ -0,0 +1,73 @@
+#ifndef JSONSTREAMREADER_H
+#define JSONSTREAMREADER_H
+
+#include <QString>
+#include <QVarLengthArray>
+
+// Pull-style JSON tokenizer over a byte range, typically a memory-mapped file. Nothing is
+// allocated while reading; strings and numbers are only decoded when asked for.
+class JsonStreamReader
+{
+public:
+    enum Token {
+        Invalid,
+        BeginObject,
+        EndObject,
+        BeginArray,
+        EndArray,
+        Name,   // Object key, the value follows with the next token
+        String,
+        Number,
+        True,
+        False,
+        Null,
+        End     // Whole document consumed
+    };
+
+    JsonStreamReader(const char *data, qint64 size);
+
+    Token next();
+
+    // Skips the value that starts with the given token, including nested containers
+    bool skip(Token token);
+
+    // Valid after Name or String
+    QString stringValue() const;
+    bool nameEquals(const char *latin1, int length) const;
+    template <int N>
+    bool nameEquals(const char (&literal)[N]) const { return nameEquals(literal, N - 1); }
+    bool hasEscapes() const { return stringHasEscapes; }
+    const char *rawString() const { return stringBegin; }
+    int rawStringSize() const { return stringLength; }
+
+    // Valid after Number
+    double numberValue() const;
+
+    QString errorString() const { return error; }
+    qint64 offset() const { return position - begin; }
+
+private:
+    Token fail(const char *message);
+    void skipWhitespace();
+    bool readString();
+    bool readNumber();
+    bool readLiteral(const char *literal, int length);
+
+    const char *begin;
+    const char *position;
+    const char *end;
+
+    QVarLengthArray<char, 32> containers; // '{' or '['
+    bool expectName;
+    bool afterValue;
+    bool started;
+
+    const char *stringBegin;
+    int stringLength;
+    bool stringHasEscapes;
+    const char *numberBegin;
+    int numberLength;
+    QString error;
+};
+
+#endif // JSONSTREAMREADER_H
@@ -0,0 +1,173 @@
+#include "livetuningjournal.h"
+
+void LiveTuningJournal::reset(const LiveTuningStore &store)
+{
+    QVector<double> values(store.values(), store.values() + store.size());
+    history.clear();
+    history.append({PersistentVector<double>(values), QString("Load")});
+    cursor = 0;
+    checkpoints.clear();
+}
+
+void LiveTuningJournal::record(int index, double value, const QString &description)
+{
+    if (history.isEmpty()) {
+        return;
+    }
+    const PersistentVector<double> next = current().set(index, value);
+    if (next.sharesRootWith(current())) {
+        return; // Same value, nothing to undo
+    }
+    push(next, description);
+}
+
+void LiveTuningJournal::recordBulk(const LiveTuningStore &store, const QString &description)
+{
+    if (history.isEmpty()) {
+        return;
+    }
+
+    // Path-copy only the entries that differ so the new version still shares the rest
+    PersistentVector<double> next = current();
+    const double *values = store.values();
+    for (int i = 0; i < store.size(); ++i) {
+        next = next.set(i, values[i]);
+    }
+    if (!next.sharesRootWith(current())) {
+        push(next, description);
+    }
+}
+
+void LiveTuningJournal::recordAppend(const LiveTuningStore &store)
+{
+    if (history.isEmpty()) {
+        return;
+    }
+
+    // Only the right edge of each version is copied, the rest stays shared
+    const double *values = store.values();
+    for (int i = current().size(); i < store.size(); ++i) {
+        for (Step &step : history) {
+            step.values = step.values.append(values[i]);
+        }
+        for (Checkpoint &checkpoint : checkpoints) {
+            checkpoint.values = checkpoint.values.append(values[i]);
+        }
+    }
+}
+
+void LiveTuningJournal::push(const PersistentVector<double> &values, const QString &description)
+{
+    history.resize(cursor + 1);
+    history.append({values, description});
+    if (history.size() > MaxSteps + 1) {
+        history.remove(0, history.size() - MaxSteps - 1);
+    }
+    cursor = history.size() - 1;
+}
+
+QVector<int> LiveTuningJournal::undo(LiveTuningStore &store)
+{
+    return canUndo() ? moveTo(cursor - 1, store) : QVector<int>();
+}
+
+QVector<int> LiveTuningJournal::redo(LiveTuningStore &store)
+{
+    return canRedo() ? moveTo(cursor + 1, store) : QVector<int>();
+}
+
+QVector<int> LiveTuningJournal::moveTo(int step, LiveTuningStore &store)
+{
+    QVector<int> changed;
+    PersistentVector<double>::diff(current(), history.at(step).values, [&](int index, double, double to) {
+        store.setValue(index, to);
+        changed.append(index);
+    });
+    cursor = step;
+    return changed;
+}
+
+void LiveTuningJournal::addCheckpoint(const QString &name)
+{
+    if (history.isEmpty()) {
+        return;
+    }
+    const int existing = checkpointIndex(name);
+    if (existing >= 0) {
+        checkpoints.remove(existing);
+    }
+    checkpoints.append({name, QDateTime::currentDateTime(), current()});
+}
+
+bool LiveTuningJournal::removeCheckpoint(const QString &name)
+{
+    const int index = checkpointIndex(name);
+    if (index < 0) {
+        return false;
+    }
+    checkpoints.remove(index);
+    return true;
+}
+
+QStringList LiveTuningJournal::checkpointNames() const
+{
+    QStringList names;
+    for (const Checkpoint &checkpoint : checkpoints) {
+        names.append(checkpoint.name);
+    }
+    return names;
+}
+
+int LiveTuningJournal::checkpointIndex(const QString &name) const
+{
+    for (int i = 0; i < checkpoints.size(); ++i) {
+        if (checkpoints.at(i).name == name) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+const PersistentVector<double> *LiveTuningJournal::versionFor(const QString &name) const
+{
+    if (name.isEmpty()) {
+        return history.isEmpty() ? nullptr : &current();
+    }
+    const int index = checkpointIndex(name);
+    return index >= 0 ? &checkpoints.at(index).values : nullptr;
+}
+
+QVector<LiveTuningJournal::Change> LiveTuningJournal::diff(const QString &fromCheckpoint, const QString &toCheckpoint) const
+{
+    QVector<Change> changes;
+    const PersistentVector<double> *from = versionFor(fromCheckpoint);
+    const PersistentVector<double> *to = versionFor(toCheckpoint);
+    if (!from || !to) {
+        return changes;
+    }
+
+    PersistentVector<double>::diff(*from, *to, [&changes](int index, double fromValue, double toValue) {
+        changes.append({index, fromValue, toValue});
+    });
+    return changes;
+}
+
+QVector<LiveTuningJournal::Change> LiveTuningJournal::revertTo(const QString &name, LiveTuningStore &store)
+{
+    const PersistentVector<double> *target = versionFor(name);
+    if (!target || name.isEmpty()) {
+        return QVector<Change>();
+    }
+
+    const QVector<Change> changes = diff(QString(), name);
+    if (changes.isEmpty()) {
+        return changes;
+    }
+    for (const Change &change : changes) {
+        store.setValue(change.index, change.to);
+    }
+
+    // The checkpoint's own version becomes the new step, so later diffs against it are free
+    push(*target, QString("Revert to %1").arg(name));
+    return changes;
+}
@@ -0,0 +1,79 @@
+#ifndef LIVETUNINGJOURNAL_H
+#define LIVETUNINGJOURNAL_H
+
+#include <QString>
+#include <QStringList>
+#include <QDateTime>
+#include <QVector>
+#include "livetuningstore.h"
+#include "persistentvector.h"
+
+// Undo/redo history and named checkpoints for the values of a loaded LiveTuningStore. Every
+// step keeps a full version of the values, sharing all untouched nodes with its neighbours.
+// The journal is tied to the store's entry layout and has to be reset when the store reloads.
+class LiveTuningJournal
+{
+public:
+    static constexpr int MaxSteps = 10000;
+
+    struct Change {
+        int index;
+        double from;
+        double to;
+    };
+
+    void reset(const LiveTuningStore &store);
+    bool matches(const LiveTuningStore &store) const { return !history.isEmpty() && history.last().values.size() == store.size(); }
+
+    // Called after an edit was applied to the store; drops anything that could be redone
+    void record(int index, double value, const QString &description = QString());
+    void recordBulk(const LiveTuningStore &store, const QString &description);
+    // Called after entries were appended to the store. Every step and checkpoint gets them with
+    // their added value, so the history survives the new layout; the add itself isn't undoable.
+    void recordAppend(const LiveTuningStore &store);
+
+    bool canUndo() const { return cursor > 0; }
+    bool canRedo() const { return cursor + 1 < history.size(); }
+    QString undoText() const { return canUndo() ? history.at(cursor).description : QString(); }
+    QString redoText() const { return canRedo() ? history.at(cursor + 1).description : QString(); }
+
+    // Move one step and write the affected values back into the store; returns the changed indices
+    QVector<int> undo(LiveTuningStore &store);
+    QVector<int> redo(LiveTuningStore &store);
+
+    // Checkpoints are kept across undo and redo, and replaced when a name is reused
+    void addCheckpoint(const QString &name);
+    bool removeCheckpoint(const QString &name);
+    QStringList checkpointNames() const;
+    bool hasCheckpoint(const QString &name) const { return checkpointIndex(name) >= 0; }
+
+    // An empty name stands for the current state
+    QVector<Change> diff(const QString &fromCheckpoint, const QString &toCheckpoint) const;
+
+    // Puts the checkpoint's values into the store as a single undoable step
+    QVector<Change> revertTo(const QString &name, LiveTuningStore &store);
+
+private:
+    struct Step {
+        PersistentVector<double> values;
+        QString description;
+    };
+
+    struct Checkpoint {
+        QString name;
+        QDateTime created;
+        PersistentVector<double> values;
+    };
+
+    int checkpointIndex(const QString &name) const;
+    const PersistentVector<double> &current() const { return history.at(cursor).values; }
+    const PersistentVector<double> *versionFor(const QString &name) const;
+    void push(const PersistentVector<double> &values, const QString &description);
+    QVector<int> moveTo(int step, LiveTuningStore &store);
+
+    QVector<Step> history; // history[0] is the state the store was loaded with
+    int cursor = 0;
+    QVector<Checkpoint> checkpoints;
+};
+
+#endif // LIVETUNINGJOURNAL_H
@@ -0,0 +1,289 @@
+#include "livetuningmodel.h"
+#include <QSlider>
+#include <QDoubleSpinBox>
+#include <QHBoxLayout>
+#include <QFont>
+#include <cmath>
+
+LiveTuningModel::LiveTuningModel(QObject *parent)
+    : QAbstractTableModel(parent)
+    , tuningStore(nullptr)
+    , currentCategory(LiveTuningCategory::Uncategorized)
+    , hasCategory(false)
+{
+}
+
+void LiveTuningModel::setStore(LiveTuningStore *store)
+{
+    beginResetModel();
+    tuningStore = store;
+    hasCategory = false;
+    rows.clear();
+    endResetModel();
+}
+
+void LiveTuningModel::setCategory(LiveTuningCategory category)
+{
+    beginResetModel();
+    currentCategory = category;
+    hasCategory = true;
+    rows = tuningStore ? tuningStore->rowsInCategory(category) : QVector<int>(); // Implicitly shared, no copy
+    if (tuningStore && !prototypeFilter.isEmpty()) {
+        QVector<int> filtered;
+        for (int row : rows) {
+            const int id = tuningStore->prototypeId(row);
+            if (id < prototypeFilter.size() && prototypeFilter.at(id)) {
+                filtered.append(row);
+            }
+        }
+        rows = filtered;
+    }
+    endResetModel();
+}
+
+void LiveTuningModel::clearCategory()
+{
+    beginResetModel();
+    hasCategory = false;
+    rows.clear();
+    endResetModel();
+}
+
+void LiveTuningModel::reload()
+{
+    if (hasCategory) {
+        setCategory(currentCategory);
+    } else {
+        clearCategory();
+    }
+}
+
+void LiveTuningModel::refreshValues()
+{
+    if (!rows.isEmpty()) {
+        emit dataChanged(index(0, 0), index(rows.size() - 1, ColumnCount - 1));
+    }
+}
+
+int LiveTuningModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : rows.size();
+}
+
+int LiveTuningModel::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : ColumnCount;
+}
+
+QVariant LiveTuningModel::data(const QModelIndex &index, int role) const
+{
+    if (!tuningStore || !index.isValid() || index.row() >= rows.size()) {
+        return QVariant();
+    }
+
+    const int storeRow = rows.at(index.row());
+    if (role == StoreIndexRole) {
+        return storeRow;
+    }
+
+    if (role == Qt::DisplayRole || role == Qt::EditRole) {
+        switch (index.column()) {
+        case PrototypeColumn:
+            return tuningStore->prototype(storeRow);
+        case SettingColumn:
+            return tuningStore->setting(storeRow);
+        case ValueColumn:
+            return role == Qt::DisplayRole ? QVariant(QString::number(tuningStore->value(storeRow)))
+                                           : QVariant(tuningStore->value(storeRow));
+        }
+    } else if (role == Qt::ToolTipRole && index.column() == PrototypeColumn) {
+        return tuningStore->prototype(storeRow);
+    } else if (role == Qt::FontRole && tuningStore->isDirty(storeRow)) {
+        QFont font;
+        font.setBold(true); // Unsaved edit
+        return font;
+    } else if (role == Qt::TextAlignmentRole && index.column() == ValueColumn) {
+        return int(Qt::AlignCenter);
+    }
+
+    return QVariant();
+}
+
+bool LiveTuningModel::setData(const QModelIndex &index, const QVariant &value, int role)
+{
+    if (!tuningStore || role != Qt::EditRole || !index.isValid() || index.column() != ValueColumn) {
+        return false;
+    }
+
+    bool ok = false;
+    double newValue = value.toDouble(&ok);
+    if (!ok || !std::isfinite(newValue)) {
+        return false;
+    }
+
+    const int storeRow = rows.at(index.row());
+    double oldValue = tuningStore->value(storeRow);
+    if (oldValue == newValue) {
+        return true;
+    }
+
+    tuningStore->setValue(storeRow, newValue);
+    emit dataChanged(this->index(index.row(), 0), this->index(index.row(), ColumnCount - 1));
+    emit valueEdited(storeRow, oldValue, newValue);
+    return true;
+}
+
+QVariant LiveTuningModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (role != Qt::DisplayRole || orientation != Qt::Horizontal) {
+        return QAbstractTableModel::headerData(section, orientation, role);
+    }
+
+    switch (section) {
+    case PrototypeColumn: return QString("Prototype");
+    case SettingColumn:   return QString("Setting");
+    case ValueColumn:     return QString("Value");
+    }
+    return QVariant();
+}
+
+Qt::ItemFlags LiveTuningModel::flags(const QModelIndex &index) const
+{
+    Qt::ItemFlags itemFlags = QAbstractTableModel::flags(index);
+    if (index.isValid() && index.column() == ValueColumn) {
+        itemFlags |= Qt::ItemIsEditable;
+    }
+    return itemFlags;
+}
+
+namespace {
+
+constexpr int SliderSteps = 1000;
+
+// Slider span for a value: at least 0 to 20, otherwise up to the next 1-2-5 step above twice the value
+void sliderRangeFor(double value, double *minimum, double *maximum)
+{
+    double span = 20.0;
+    const double wanted = std::abs(value) * 2.0;
+    while (span < wanted && span < 1e9) {
+        const double magnitude = std::pow(10.0, std::floor(std::log10(span)));
+        const double leading = span / magnitude;
+        span = (leading < 2.0 ? 2.0 : leading < 5.0 ? 5.0 : 10.0) * magnitude;
+    }
+    *maximum = span;
+    *minimum = value < 0 ? -span : 0.0;
+}
+
+int toSliderPosition(QWidget *editor, double value)
+{
+    const double minimum = editor->property("sliderMinimum").toDouble();
+    const double maximum = editor->property("sliderMaximum").toDouble();
+    return static_cast<int>(std::lround((value - minimum) / (maximum - minimum) * SliderSteps));
+}
+
+double fromSliderPosition(QWidget *editor, int position)
+{
+    const double minimum = editor->property("sliderMinimum").toDouble();
+    const double maximum = editor->property("sliderMaximum").toDouble();
+    const double value = minimum + (maximum - minimum) * position / SliderSteps;
+    return std::round(value * 100.0) / 100.0; // Keep drags on readable values
+}
+
+} // namespace
+
+LiveTuningValueDelegate::LiveTuningValueDelegate(QObject *parent)
+    : QStyledItemDelegate(parent)
+{
+}
+
+QWidget *LiveTuningValueDelegate::createEditor(QWidget *parent, const QStyleOptionViewItem &option, const QModelIndex &index) const
+{
+    if (index.column() != LiveTuningModel::ValueColumn) {
+        return QStyledItemDelegate::createEditor(parent, option, index);
+    }
+
+    QWidget *editor = new QWidget(parent);
+    editor->setAutoFillBackground(true);
+
+    QSlider *slider = new QSlider(Qt::Horizontal, editor);
+    slider->setRange(0, SliderSteps); // Mapped onto a span that fits the value, see setEditorData
+
+    QDoubleSpinBox *spinBox = new QDoubleSpinBox(editor);
+    spinBox->setRange(-1e9, 1e9);
+    spinBox->setDecimals(4);
+    spinBox->setSingleStep(0.1);
+    spinBox->setAlignment(Qt::AlignCenter);
+    spinBox->setKeyboardTracking(false);
+
+    QHBoxLayout *layout = new QHBoxLayout(editor);
+    layout->setContentsMargins(0, 0, 0, 0);
+    layout->setSpacing(4);
+    layout->addWidget(slider, 2);
+    layout->addWidget(spinBox, 1);
+    editor->setFocusProxy(spinBox);
+
+    // Keep slider and number box in step, and write back as soon as either settles
+    LiveTuningValueDelegate *self = const_cast<LiveTuningValueDelegate *>(this);
+    connect(slider, &QSlider::valueChanged, spinBox, [spinBox, editor](int sliderValue) {
+        spinBox->setValue(fromSliderPosition(editor, sliderValue));
+    });
+    connect(slider, &QSlider::sliderReleased, self, [self, editor]() {
+        emit self->commitData(editor);
+    });
+    connect(spinBox, QOverload<double>::of(&QDoubleSpinBox::valueChanged), slider, [slider, editor](double value) {
+        QSignalBlocker blocker(slider);
+        slider->setValue(toSliderPosition(editor, value));
+    });
+    connect(spinBox, &QDoubleSpinBox::editingFinished, self, [self, editor]() {
+        emit self->commitData(editor);
+    });
+
+    return editor;
+}
+
+void LiveTuningValueDelegate::setEditorData(QWidget *editor, const QModelIndex &index) const
+{
+    QDoubleSpinBox *spinBox = editor->findChild<QDoubleSpinBox *>();
+    if (!spinBox) {
+        QStyledItemDelegate::setEditorData(editor, index);
+        return;
+    }
+
+    // The span is fixed for the lifetime of the editor so the handle doesn't jump while dragging
+    const double value = index.data(Qt::EditRole).toDouble();
+    double minimum;
+    double maximum;
+    sliderRangeFor(value, &minimum, &maximum);
+    editor->setProperty("sliderMinimum", minimum);
+    editor->setProperty("sliderMaximum", maximum);
+    editor->setToolTip(QString("Slider range %1 to %2").arg(minimum).arg(maximum));
+
+    spinBox->setValue(value);
+    editor->setProperty("initialValue", spinBox->value()); // Rounded to the box's decimals
+    if (QSlider *slider = editor->findChild<QSlider *>()) {
+        QSignalBlocker blocker(slider);
+        slider->setValue(toSliderPosition(editor, value));
+    }
+}
+
+void LiveTuningValueDelegate::setModelData(QWidget *editor, QAbstractItemModel *model, const QModelIndex &index) const
+{
+    QDoubleSpinBox *spinBox = editor->findChild<QDoubleSpinBox *>();
+    if (!spinBox) {
+        QStyledItemDelegate::setModelData(editor, model, index);
+        return;
+    }
+
+    // The box shows 4 decimals; leaving it untouched mustn't write that rounding back
+    spinBox->interpretText();
+    if (spinBox->value() == editor->property("initialValue").toDouble()) {
+        return;
+    }
+    model->setData(index, spinBox->value(), Qt::EditRole);
+}
+
+void LiveTuningValueDelegate::updateEditorGeometry(QWidget *editor, const QStyleOptionViewItem &option, const QModelIndex &index) const
+{
+    Q_UNUSED(index);
+    editor->setGeometry(option.rect);
+}
@@ -0,0 +1,71 @@
+#ifndef LIVETUNINGMODEL_H
+#define LIVETUNINGMODEL_H
+
+#include <QAbstractTableModel>
+#include <QStyledItemDelegate>
+#include "livetuningstore.h"
+
+// Table view over one category of a LiveTuningStore. Rows map straight to store indices,
+// so switching categories only swaps the row list and the view only touches visible rows.
+class LiveTuningModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    enum Column {
+        PrototypeColumn,
+        SettingColumn,
+        ValueColumn,
+        ColumnCount
+    };
+
+    static constexpr int StoreIndexRole = Qt::UserRole + 1;
+
+    explicit LiveTuningModel(QObject *parent = nullptr);
+
+    void setStore(LiveTuningStore *store);
+    LiveTuningStore *store() const { return tuningStore; }
+
+    void setCategory(LiveTuningCategory category);
+    void clearCategory();
+    // Indexed by prototype id, empty shows everything; applies from the next setCategory or reload
+    void setPrototypeFilter(const QVector<bool> &allowed) { prototypeFilter = allowed; }
+    void reload(); // Call after the store was reloaded or appended to
+    void refreshValues(); // Call after values changed outside the model
+
+    int storeIndex(int row) const { return rows.at(row); }
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    bool setData(const QModelIndex &index, const QVariant &value, int role = Qt::EditRole) override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+    Qt::ItemFlags flags(const QModelIndex &index) const override;
+
+signals:
+    void valueEdited(int storeIndex, double oldValue, double newValue);
+
+private:
+    LiveTuningStore *tuningStore;
+    LiveTuningCategory currentCategory;
+    bool hasCategory;
+    QVector<bool> prototypeFilter;
+    QVector<int> rows; // Store indices for the current category
+};
+
+// Edits the Value column in place with a slider and a number box. Editors only exist
+// for the cell being edited.
+class LiveTuningValueDelegate : public QStyledItemDelegate
+{
+    Q_OBJECT
+
+public:
+    explicit LiveTuningValueDelegate(QObject *parent = nullptr);
+
+    QWidget *createEditor(QWidget *parent, const QStyleOptionViewItem &option, const QModelIndex &index) const override;
+    void setEditorData(QWidget *editor, const QModelIndex &index) const override;
+    void setModelData(QWidget *editor, QAbstractItemModel *model, const QModelIndex &index) const override;
+    void updateEditorGeometry(QWidget *editor, const QStyleOptionViewItem &option, const QModelIndex &index) const override;
+};
+
+#endif // LIVETUNINGMODEL_H
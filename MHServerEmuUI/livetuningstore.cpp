@@ -0,0 +1,368 @@
+#include "livetuningstore.h"
+#include "jsonstreamreader.h"
+#include <QFile>
+#include <QLocale>
+#include <cmath>
+#include <algorithm>
+
+namespace {
+
+const char *const categoryNameTable[] = {
+    "Global",
+    "World Entity",
+    "Powers",
+    "Regions",
+    "Loot",
+    "Mission",
+    "Condition",
+    "Avatar Entity",
+    "Area",
+    "Population Object",
+    "Metrics Frequency",
+    "Public Events",
+    "Uncategorized"
+};
+
+// Setting prefixes up to and including the first underscore, built once
+const QHash<QString, LiveTuningCategory> &categoryPrefixTable()
+{
+    static const QHash<QString, LiveTuningCategory> table = {
+        {"eGTV_", LiveTuningCategory::Global},
+        {"eWETV_", LiveTuningCategory::WorldEntity},
+        {"ePTV_", LiveTuningCategory::Powers},
+        {"eRTV_", LiveTuningCategory::Regions},
+        {"eLTV_", LiveTuningCategory::Loot},
+        {"eMTV_", LiveTuningCategory::Mission},
+        {"eCTV_", LiveTuningCategory::Condition},
+        {"eAETV_", LiveTuningCategory::AvatarEntity},
+        {"eATV_", LiveTuningCategory::Area},
+        {"ePOTV_", LiveTuningCategory::PopulationObject},
+        {"eMFTV_", LiveTuningCategory::MetricsFrequency},
+        {"ePETV_", LiveTuningCategory::PublicEvents}
+    };
+    return table;
+}
+
+void appendJsonString(QByteArray &out, const QString &string)
+{
+    out += '"';
+    const QByteArray utf8 = string.toUtf8();
+    for (char c : utf8) {
+        switch (c) {
+        case '"':  out += "\\\""; break;
+        case '\\': out += "\\\\"; break;
+        case '\b': out += "\\b"; break;
+        case '\f': out += "\\f"; break;
+        case '\n': out += "\\n"; break;
+        case '\r': out += "\\r"; break;
+        case '\t': out += "\\t"; break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20) {
+                out += "\\u00";
+                out += QByteArray::number(static_cast<unsigned char>(c), 16).rightJustified(2, '0');
+            } else {
+                out += c;
+            }
+        }
+    }
+    out += '"';
+}
+
+void appendJsonNumber(QByteArray &out, double value)
+{
+    // Same shape as QJsonDocument: integers without a fraction, everything else shortest round-trip
+    if (std::isfinite(value) && value == std::floor(value) && std::fabs(value) < 9007199254740992.0) {
+        out += QByteArray::number(static_cast<qint64>(value));
+    } else {
+        out += QByteArray::number(value, 'g', QLocale::FloatingPointShortest);
+    }
+}
+
+} // namespace
+
+QString liveTuningCategoryName(LiveTuningCategory category)
+{
+    return QString::fromLatin1(categoryNameTable[static_cast<int>(category)]);
+}
+
+LiveTuningCategory liveTuningCategoryFromName(const QString &name)
+{
+    for (int i = 0; i < static_cast<int>(LiveTuningCategory::Count); ++i) {
+        if (name == QLatin1String(categoryNameTable[i])) {
+            return static_cast<LiveTuningCategory>(i);
+        }
+    }
+    return LiveTuningCategory::Uncategorized;
+}
+
+LiveTuningCategory classifyLiveTuningSetting(const QString &setting)
+{
+    const int underscore = setting.indexOf('_');
+    if (underscore < 0) {
+        return LiveTuningCategory::Uncategorized;
+    }
+    return categoryPrefixTable().value(setting.left(underscore + 1), LiveTuningCategory::Uncategorized);
+}
+
+int StringPool::intern(const QString &string)
+{
+    auto it = ids.constFind(string);
+    if (it != ids.constEnd()) {
+        return it.value();
+    }
+
+    const int id = strings.size();
+    strings.append(string);
+    ids.insert(string, id);
+    return id;
+}
+
+int StringPool::internUtf8(const char *data, int size)
+{
+    // Raw-data keys only live for the lookup, the stored key is a deep copy
+    auto it = utf8Ids.constFind(QByteArray::fromRawData(data, size));
+    if (it != utf8Ids.constEnd()) {
+        return it.value();
+    }
+
+    const int id = intern(QString::fromUtf8(data, size));
+    utf8Ids.insert(QByteArray(data, size), id);
+    return id;
+}
+
+void StringPool::clear()
+{
+    ids.clear();
+    utf8Ids.clear();
+    strings.clear();
+}
+
+void StringPool::reserve(int count)
+{
+    ids.reserve(count);
+    utf8Ids.reserve(count);
+    strings.reserve(count);
+}
+
+void LiveTuningStore::clear()
+{
+    prototypes.clear();
+    settings.clear();
+    settingCategories.clear();
+    prototypeIds.clear();
+    settingIds.clear();
+    valueArray.clear();
+    categoryArray.clear();
+    for (QVector<int> &rows : categoryRows) {
+        rows.clear();
+    }
+    keyIndex.clear();
+    dirtyValues.clear();
+}
+
+void LiveTuningStore::reserve(int count)
+{
+    prototypeIds.reserve(count);
+    settingIds.reserve(count);
+    valueArray.reserve(count);
+    categoryArray.reserve(count);
+    keyIndex.reserve(count);
+    prototypes.reserve(count);
+}
+
+bool LiveTuningStore::loadJson(const QByteArray &json, QString *errorMessage)
+{
+    return loadJson(json.constData(), json.size(), errorMessage);
+}
+
+bool LiveTuningStore::loadJson(const char *data, qint64 size, QString *errorMessage)
+{
+    // Streams [{Prototype, Setting, Value}] straight into the columns, no DOM is built
+    JsonStreamReader reader(data, size);
+    if (reader.next() != JsonStreamReader::BeginArray) {
+        if (errorMessage) {
+            *errorMessage = reader.errorString().isEmpty() ? QString("Expected a JSON array.") : reader.errorString();
+        }
+        return false;
+    }
+
+    clear();
+    reserve(static_cast<int>(size / 96)); // Roughly one entry per 96 bytes of indented JSON
+
+    JsonStreamReader::Token token;
+    while ((token = reader.next()) != JsonStreamReader::EndArray) {
+        if (token != JsonStreamReader::BeginObject) {
+            // Non-object entries are skipped, like the server does
+            if (!reader.skip(token)) {
+                break;
+            }
+            continue;
+        }
+
+        int prototypeId = -1;
+        int settingId = -1;
+        double value = 0.0;
+        while ((token = reader.next()) == JsonStreamReader::Name) {
+            const bool isPrototype = reader.nameEquals("Prototype");
+            if (isPrototype || reader.nameEquals("Setting")) {
+                StringPool &pool = isPrototype ? prototypes : settings;
+                int &id = isPrototype ? prototypeId : settingId;
+                token = reader.next();
+                if (token == JsonStreamReader::String) {
+                    id = reader.hasEscapes() ? pool.intern(reader.stringValue())
+                                             : pool.internUtf8(reader.rawString(), reader.rawStringSize());
+                } else if (!reader.skip(token)) {
+                    break;
+                }
+            } else if (reader.nameEquals("Value")) {
+                token = reader.next();
+                if (token == JsonStreamReader::Number) {
+                    value = reader.numberValue();
+                } else if (!reader.skip(token)) {
+                    break;
+                }
+            } else if (!reader.skip(reader.next())) {
+                break;
+            }
+        }
+        if (token != JsonStreamReader::EndObject) {
+            break;
+        }
+
+        // Missing fields read as empty strings, same as QJsonValue::toString()
+        if (prototypeId < 0) {
+            prototypeId = prototypes.intern(QString());
+        }
+        if (settingId < 0) {
+            settingId = settings.intern(QString());
+        }
+        appendInterned(prototypeId, settingId, value);
+    }
+
+    if (token != JsonStreamReader::EndArray || reader.next() != JsonStreamReader::End) {
+        if (errorMessage) {
+            *errorMessage = reader.errorString().isEmpty() ? QString("Malformed JSON.") : reader.errorString();
+        }
+        clear();
+        return false;
+    }
+    return true;
+}
+
+bool LiveTuningStore::loadFile(const QString &path, QString *errorMessage)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        if (errorMessage) {
+            *errorMessage = file.errorString();
+        }
+        return false;
+    }
+
+    if (file.size() == 0) {
+        return loadJson(QByteArray(), errorMessage);
+    }
+
+    // Map the file so the reader works on the page cache directly; fall back to a read if mapping isn't possible
+    if (uchar *mapped = file.map(0, file.size())) {
+        bool ok = loadJson(reinterpret_cast<const char *>(mapped), file.size(), errorMessage);
+        file.unmap(mapped);
+        return ok;
+    }
+    return loadJson(file.readAll(), errorMessage);
+}
+
+QByteArray LiveTuningStore::toJson() const
+{
+    // Written by hand in QJsonDocument::Indented layout so saving doesn't build a DOM
+    QByteArray out;
+    out.reserve(valueArray.size() * 128 + 4);
+    out += "[\n";
+
+    for (int i = 0; i < valueArray.size(); ++i) {
+        out += "    {\n        \"Prototype\": ";
+        appendJsonString(out, prototype(i));
+        out += ",\n        \"Setting\": ";
+        appendJsonString(out, setting(i));
+        out += ",\n        \"Value\": ";
+        appendJsonNumber(out, valueArray.at(i));
+        out += (i + 1 < valueArray.size()) ? "\n    },\n" : "\n    }\n";
+    }
+
+    out += "]\n";
+    return out;
+}
+
+int LiveTuningStore::append(const QString &prototype, const QString &setting, double value)
+{
+    return appendInterned(prototypes.intern(prototype), settings.intern(setting), value);
+}
+
+int LiveTuningStore::appendUtf8(const char *prototype, int prototypeSize, const char *setting, int settingSize, double value)
+{
+    return appendInterned(prototypes.internUtf8(prototype, prototypeSize), settings.internUtf8(setting, settingSize), value);
+}
+
+int LiveTuningStore::appendInterned(int prototypeId, int settingId, double value)
+{
+    const int index = valueArray.size();
+
+    // Settings are few and repeat a lot, so the category is decided once per distinct setting
+    while (settingCategories.size() <= settingId) {
+        settingCategories.append(classifyLiveTuningSetting(settings.at(settingCategories.size())));
+    }
+    const LiveTuningCategory category = settingCategories.at(settingId);
+
+    prototypeIds.append(prototypeId);
+    settingIds.append(settingId);
+    valueArray.append(value);
+    categoryArray.append(category);
+    categoryRows[static_cast<int>(category)].append(index);
+    keyIndex.insert(makeKey(prototypeId, settingId), index);
+    return index;
+}
+
+void LiveTuningStore::setValue(int index, double value)
+{
+    double &current = valueArray[index];
+    if (current == value) {
+        return;
+    }
+
+    // Remember the saved value the first time an entry changes, and forget it once it's back
+    const quint64 entryKey = key(index);
+    auto it = dirtyValues.find(entryKey);
+    if (it == dirtyValues.end()) {
+        dirtyValues.insert(entryKey, current);
+    } else if (it.value() == value) {
+        dirtyValues.erase(it);
+    }
+    current = value;
+}
+
+int LiveTuningStore::indexOf(const QString &prototype, const QString &setting) const
+{
+    const int prototypeId = prototypes.find(prototype);
+    const int settingId = settings.find(setting);
+    if (prototypeId < 0 || settingId < 0) {
+        return -1;
+    }
+    return keyIndex.value(makeKey(prototypeId, settingId), -1);
+}
+
+const QVector<int> &LiveTuningStore::rowsInCategory(LiveTuningCategory category) const
+{
+    return categoryRows[static_cast<int>(category)];
+}
+
+QStringList LiveTuningStore::categoryNames() const
+{
+    QStringList names;
+    for (int i = 0; i < static_cast<int>(LiveTuningCategory::Count); ++i) {
+        if (!categoryRows[i].isEmpty()) {
+            names.append(liveTuningCategoryName(static_cast<LiveTuningCategory>(i)));
+        }
+    }
+    std::sort(names.begin(), names.end());
+    return names;
+}
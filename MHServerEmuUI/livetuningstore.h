@@ -0,0 +1,113 @@
+#ifndef LIVETUNINGSTORE_H
+#define LIVETUNINGSTORE_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QHash>
+#include <QByteArray>
+
+// Categories are decided once when an entry is added, from the Setting prefix
+enum class LiveTuningCategory : quint8 {
+    Global,
+    WorldEntity,
+    Powers,
+    Regions,
+    Loot,
+    Mission,
+    Condition,
+    AvatarEntity,
+    Area,
+    PopulationObject,
+    MetricsFrequency,
+    PublicEvents,
+    Uncategorized,
+    Count
+};
+
+QString liveTuningCategoryName(LiveTuningCategory category);
+LiveTuningCategory liveTuningCategoryFromName(const QString &name);
+LiveTuningCategory classifyLiveTuningSetting(const QString &setting);
+
+// Maps each distinct string to a dense id so entries only carry integers
+class StringPool
+{
+public:
+    int intern(const QString &string);
+    int internUtf8(const char *data, int size); // Only allocates for strings not seen before
+    int find(const QString &string) const { return ids.value(string, -1); }
+    const QString &at(int id) const { return strings.at(id); }
+    int size() const { return strings.size(); }
+    void clear();
+    void reserve(int count);
+
+private:
+    QHash<QString, int> ids;
+    QHash<QByteArray, int> utf8Ids;
+    QVector<QString> strings;
+};
+
+// Typed in-memory copy of a LiveTuningData*.json file. Entries are stored column-wise in
+// file order; (Prototype, Setting) lookups go through a hash of the interned id pair.
+class LiveTuningStore
+{
+public:
+    static quint64 makeKey(int prototypeId, int settingId)
+    {
+        return (static_cast<quint64>(static_cast<quint32>(prototypeId)) << 32) | static_cast<quint32>(settingId);
+    }
+
+    void clear();
+    void reserve(int count);
+
+    bool loadJson(const QByteArray &json, QString *errorMessage);
+    bool loadJson(const char *data, qint64 size, QString *errorMessage);
+    bool loadFile(const QString &path, QString *errorMessage); // Parses straight from a mapping of the file
+    QByteArray toJson() const;
+
+    int append(const QString &prototype, const QString &setting, double value);
+    int appendInterned(int prototypeId, int settingId, double value);
+    int appendUtf8(const char *prototype, int prototypeSize, const char *setting, int settingSize, double value);
+    int indexOf(const QString &prototype, const QString &setting) const;
+    int indexOfKey(quint64 key) const { return keyIndex.value(key, -1); }
+
+    int size() const { return valueArray.size(); }
+    bool isEmpty() const { return valueArray.isEmpty(); }
+
+    const QString &prototype(int index) const { return prototypes.at(prototypeIds.at(index)); }
+    const QString &setting(int index) const { return settings.at(settingIds.at(index)); }
+    int prototypeId(int index) const { return prototypeIds.at(index); }
+    int settingId(int index) const { return settingIds.at(index); }
+    quint64 key(int index) const { return makeKey(prototypeIds.at(index), settingIds.at(index)); }
+    LiveTuningCategory category(int index) const { return categoryArray.at(index); }
+
+    double value(int index) const { return valueArray.at(index); }
+    void setValue(int index, double value);
+    const double *values() const { return valueArray.constData(); }
+
+    // Edits since the last load or save, keyed by (Prototype, Setting) with the saved value
+    int dirtyCount() const { return dirtyValues.size(); }
+    bool isDirty(int index) const { return dirtyValues.contains(key(index)); }
+    const QHash<quint64, double> &dirtyEntries() const { return dirtyValues; }
+    void markClean() { dirtyValues.clear(); }
+
+    const QVector<int> &rowsInCategory(LiveTuningCategory category) const;
+    QStringList categoryNames() const;
+
+    const StringPool &prototypePool() const { return prototypes; }
+    const StringPool &settingPool() const { return settings; }
+
+private:
+    StringPool prototypes;
+    StringPool settings;
+    QVector<int> prototypeIds;
+    QVector<int> settingIds;
+    QVector<double> valueArray;
+    QVector<LiveTuningCategory> categoryArray;
+    QVector<LiveTuningCategory> settingCategories; // Indexed by setting id
+    QVector<int> categoryRows[static_cast<int>(LiveTuningCategory::Count)];
+    QHash<quint64, int> keyIndex; // Last occurrence wins, like the server
+    QHash<quint64, double> dirtyValues;
+};
+
+#endif // LIVETUNINGSTORE_H
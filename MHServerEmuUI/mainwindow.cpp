@@ -2,13 +2,11 @@
 #include "ui_mainwindow.h"
 #include <QFileDialog>
 #include <QDir>
+#include <QFileInfo>
 #include <QSettings>
 #include <QProcess>
 #include <QDesktopServices>
 #include <QUrl>
-#include <QNetworkAccessManager>
-#include <QNetworkRequest>
-#include <QNetworkReply>
 #include <QDate>
 #include <QFile>
 #include <QDir>
@@ -24,14 +22,81 @@
 #include <QSqlError>
 #include <QFontDatabase>
 #include <QRandomGenerator>
+#include <QHeaderView>
+#include <QPointer>
+#include <QTableView>
+#include <QCheckBox>
+#include <QSortFilterProxyModel>
+#include <QGroupBox>
+#include <QShortcut>
+#include <QCompleter>
+#include <QStandardItemModel>
+#include <QThreadPool>
+#include <QRegularExpression>
+#include <QSet>
+#include <QProgressDialog>
+#include <QSharedPointer>
+#include <QPromise>
+#include <QFutureWatcher>
+#include <limits>
+#include <algorithm>
+#include "atomicfilewriter.h"
+#include "tuningfilewatcher.h"
+#include "bulktransformdialog.h"
+#include "tuningpreset.h"
+#include "rotationengine.h"
+#include "eventchangeset.h"
+#include "eventcalendar.h"
+#include "calendarwindowdialog.h"
+#include "eventprovisioner.h"
+#include "eventregistry.h"
+#include "inifile.h"
 
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
     , ui(new Ui::MainWindow)
-    , apacheProcess(new QProcess(this))
-    , serverProcess(new QProcess(this))
-    , playerCount(0)
+    , shardManager(nullptr)
+    , activeInstance(nullptr)
     , statusCheckTimer(new QTimer(this)) // Initialize the timer in the initializer list
+    , shardTable(nullptr)
+    , shardBroadcastEdit(nullptr)
+    , liveTuningModel(nullptr)
+    , liveTuningView(nullptr)
+    , pendingChangesLabel(nullptr)
+    , effectiveTuningModel(nullptr)
+    , effectiveTuningSummary(nullptr)
+    , fileWatcher(nullptr)
+    , configLoaded(false)
+    , configDriftSummary(nullptr)
+    , configDriftTable(nullptr)
+    , undoLiveTuningButton(nullptr)
+    , redoLiveTuningButton(nullptr)
+    , checkpointCombo(nullptr)
+    , prototypeIndexGeneration(0)
+    , prototypeFilterEdit(nullptr)
+    , presetList(nullptr)
+    , presetDiffView(nullptr)
+    , pandemoniumTimer(new QTimer(this))
+    , pandemoniumFailures(0)
+    , stageEventsBox(nullptr)
+    , stagedEventsLabel(nullptr)
+    , previewEventsButton(nullptr)
+    , applyEventsButton(nullptr)
+    , discardEventsButton(nullptr)
+    , calendarTimer(new QTimer(this))
+    , runCalendarBox(nullptr)
+    , calendarStatusLabel(nullptr)
+    , calendarTable(nullptr)
+    , calendarTimelineView(nullptr)
+    , eventProvisionGeneration(0)
+    , customEventEdits{}
+    , eventTable(nullptr)
+    , eventFilterEdit(nullptr)
+    , eventListSummary(nullptr)
+    , capacityTimer(nullptr)
+    , capacityReportView(nullptr)
+    , updateDownloader(nullptr)
+    , updateExtractor(nullptr)
 
 {
     ui->setupUi(this);
@@ -64,10 +129,38 @@ MainWindow::MainWindow(QWidget *parent)
     ui->mhServerStatusLabel->setPixmap(offPixmap);
     ui->apacheServerStatusLabel->setPixmap(offPixmap);
 
-    // Connect the timer to the update function
-    connect(statusCheckTimer, &QTimer::timeout, this, &MainWindow::updateServerStatus);
+    // Serve Prometheus metrics from a worker thread
+    setupMetricsExporter();
+
+    // Managed server instances, the primary one starts out bound to the main tabs
+    shardManager = new ShardManager(metricsExporter, this);
+    shardManager->load();
+    for (ServerInstance *shard : shardManager->instances()) {
+        connectInstance(shard);
+    }
+    setupLiveTuningView();
+    setupLiveTuningHistory();
+    setupPrototypeSearch();
+    setupEffectiveTuningView();
+    setupPresetsView();
+    setupEventStaging();
+    setupEventCalendar();
+    setupEventList();
+    setupConfigSchema();
+    setupConfigDriftView();
+    setupFileWatcher();
+    setActiveInstance(shardManager->primary());
+    setupShardDashboard();
+    setupCapacityPlanning();
+    connect(shardManager, &ShardManager::instancesChanged, this, &MainWindow::refreshShardDashboard);
+    connect(shardManager, &ShardManager::liveTuningPushFinished, this, [this](int succeeded, int failed) {
+        ui->ServerOutputEdit->append(QString("Live tuning pushed to %1 shard(s), %2 failed.").arg(succeeded).arg(failed));
+    });
+
+    // Process state is signal-driven now, the timer only refreshes the dashboard rates
+    connect(statusCheckTimer, &QTimer::timeout, this, &MainWindow::refreshShardDashboard);
 
-    // Start the timer to check status every 1 second
+    // Start the timer to refresh the dashboard every 1 second
     statusCheckTimer->start(1000);
 
     this->setStyleSheet(
@@ -76,24 +169,7 @@ MainWindow::MainWindow(QWidget *parent)
     "QLabel { background: transparent; color: black; }"
     );
 
-    // Link liveTuningLayout
-    liveTuningLayout = qobject_cast<QVBoxLayout *>(ui->liveTuningContainer->layout());
-    if (!liveTuningLayout) {
-        qDebug() << "Error: liveTuningContainer does not have a QVBoxLayout.";
-        return;
-    }
-
-    // Other initializations
-    QSettings settings("PTM", "MHServerEmuUI");
-    QString savedPath = settings.value("serverPath", "").toString();
-    if (!savedPath.isEmpty()) {
-        ui->mhServerPathEdit->setText(savedPath);
-    }
-
-    // Initialize event states based on LiveTuningData.json
-    initializeEventStates();
-
-    // Make sure event files exist
+    // Install missing or outdated event files in the background
     verifyAndCopyEventFiles();
 
     connect(ui->pushButtonShutdown, &QPushButton::clicked, this, &MainWindow::onPushButtonShutdownClicked);
@@ -106,9 +182,6 @@ MainWindow::MainWindow(QWidget *parent)
     connect(ui->updateButton, &QPushButton::clicked, this, &MainWindow::onUpdateButtonClicked);
     connect(ui->startServerButton, &QPushButton::clicked, this, &MainWindow::startServer);
     connect(ui->stopServerButton, &QPushButton::clicked, this, &MainWindow::stopServer);
-    connect(serverProcess, &QProcess::readyReadStandardOutput, this, &MainWindow::readServerOutput);
-    connect(serverProcess, &QProcess::readyReadStandardError, this, &MainWindow::readServerOutput);
-    connect(serverProcess, &QProcess::errorOccurred, this, &MainWindow::handleServerError);
     connect(ui->createAccountButton, &QPushButton::clicked, this, &MainWindow::openAccountCreationPage);
     connect(ui->comboBoxCategory, &QComboBox::currentTextChanged, this, &MainWindow::onCategoryChanged);
     connect(ui->pushButtonAddLTsetting, &QPushButton::clicked, this, &MainWindow::onPushButtonAddLTSettingClicked);
@@ -117,41 +190,39 @@ MainWindow::MainWindow(QWidget *parent)
     connect(ui->pushButtonUnBan, &QPushButton::clicked, this, &MainWindow::onPushButtonUnBanClicked);
     connect(ui->mhServerPathEdit, &QLineEdit::editingFinished, this, &MainWindow::onServerPathEditUpdated);
     connect(ui->pushButtonSendToServer, &QPushButton::clicked, this, &MainWindow::onPushButtonSendToServerClicked);
-    connect(ui->horizontalSliderCosmicChaosSwitch, &QSlider::valueChanged, this, [this](int value) {
-        onEventSwitchChanged("CosmicChaos", value);
-    });
-    connect(ui->horizontalSliderMidtownMadnessSwitch, &QSlider::valueChanged, this, [this](int value) {
-        onEventSwitchChanged("MidtownMadness", value);
-    });
-    connect(ui->horizontalSliderArmorIncursionSwitch, &QSlider::valueChanged, this, [this](int value) {
-        onEventSwitchChanged("ArmorIncursion", value);
-    });
-    connect(ui->horizontalSliderOdinsBountySwitch, &QSlider::valueChanged, this, [this](int value) {
-        onEventSwitchChanged("OdinsBounty", value);
-    });
-    connect(ui->horizontalSliderDefendersXPSwitch, &QSlider::valueChanged, this, [this](int value) {
-        onEventSwitchChanged("Defenders&FriendsXP", value);
-    });
-    connect(ui->horizontalSliderAvengersXPSwitch, &QSlider::valueChanged, this, [this](int value) {
-        onEventSwitchChanged("AvengersXP", value);
-    });
-    connect(ui->horizontalSliderFantastic4XPSwitch, &QSlider::valueChanged, this, [this](int value) {
-        onEventSwitchChanged("FantasticFourXP", value);
-    });
-    connect(ui->horizontalSliderGuardiansXPSwitch, &QSlider::valueChanged, this, [this](int value) {
-        onEventSwitchChanged("Guardians&CosmicXP", value);
-    });
-    connect(ui->horizontalSliderScoundrelsXPSwitch, &QSlider::valueChanged, this, [this](int value) {
-        onEventSwitchChanged("Scoundrels&VillainsXP", value);
-    });
-    connect(ui->horizontalSliderXmenXPSwitch, &QSlider::valueChanged, this, [this](int value) {
-        onEventSwitchChanged("XMenXP", value);
-    });
+    // Built-in event switches, keyed by the file each one controls
+    const QPair<QSlider *, const char *> builtInSwitches[] = {
+        {ui->horizontalSliderCosmicChaosSwitch, "CosmicChaos"},
+        {ui->horizontalSliderMidtownMadnessSwitch, "MidtownMadness"},
+        {ui->horizontalSliderArmorIncursionSwitch, "ArmorIncursion"},
+        {ui->horizontalSliderOdinsBountySwitch, "OdinsBounty"},
+        {ui->horizontalSliderDefendersXPSwitch, "Defenders&FriendsXP"},
+        {ui->horizontalSliderAvengersXPSwitch, "AvengersXP"},
+        {ui->horizontalSliderFantastic4XPSwitch, "FantasticFourXP"},
+        {ui->horizontalSliderGuardiansXPSwitch, "Guardians&CosmicXP"},
+        {ui->horizontalSliderScoundrelsXPSwitch, "Scoundrels&VillainsXP"},
+        {ui->horizontalSliderXmenXPSwitch, "XMenXP"}
+    };
+    for (const auto &entry : builtInSwitches) {
+        const QString eventName = entry.second;
+        eventSwitches.insert("LiveTuningData_" + eventName + ".json", entry.first);
+        connect(entry.first, &QSlider::valueChanged, this, [this, eventName](int value) {
+            onEventSwitchChanged(eventName, value);
+        });
+    }
+    eventSwitches.insert("LiveTuningDataz_PandemoniumProtocol.json", ui->horizontalSliderPandemoniumProtocolSwitch);
     connect(ui->horizontalSliderPandemoniumProtocolSwitch, &QSlider::valueChanged, this, [this](int value) {
         onPandemoniumProtocolToggle(value);
     });
+    pandemoniumTimer->setSingleShot(true);
+    connect(pandemoniumTimer, &QTimer::timeout, this, &MainWindow::runPandemoniumProtocol);
+    QPushButton *simulateButton = new QPushButton("Simulate Month", ui->groupBoxPandemoniumProtocol);
+    simulateButton->setGeometry(200, 150, 101, 27);
+    simulateButton->setToolTip("Run 30 days of seeded rotations with the current settings and show how they play out");
+    connect(simulateButton, &QPushButton::clicked, this, &MainWindow::simulatePandemoniumProtocol);
     connect(ui->pushButtonRefreshUsers, &QPushButton::clicked, this, &MainWindow::refreshLoggedInUsers);
     for (int i = 1; i <= 6; ++i) {
+        customEventEdits[i - 1] = findChild<QLineEdit *>(QString("LineEditCustomEvent%1").arg(i));
         QSlider *eventSwitch = findChild<QSlider *>(QString("horizontalSliderCustom%1Switch").arg(i));
         if (eventSwitch) {
             connect(eventSwitch, &QSlider::valueChanged, this, [this, i](int value) {
@@ -159,20 +230,17 @@ MainWindow::MainWindow(QWidget *parent)
             });
         }
     }
+
+    // Switches and the event list show what the LiveTuning folder has
+    initializeEventStates();
 }
 
 MainWindow::~MainWindow() {
-    if (serverProcess->state() == QProcess::Running) {
-        serverProcess->terminate();
-        serverProcess->waitForFinished();
-    }
-    delete serverProcess;
+    // Shards stop their processes and unregister from the exporter, so they go first
+    delete shardManager;
 
-    if (apacheProcess->state() == QProcess::Running) {
-        apacheProcess->terminate();
-        apacheProcess->waitForFinished();
-    }
-    delete apacheProcess;
+    metricsThread->quit();
+    metricsThread->wait();
 
     delete ui;
 }
@@ -195,131 +263,88 @@ void MainWindow::onServerPathEditUpdated() {
     }
 
     // Save the updated path
-    QSettings settings("PTM", "MHServerEmuUI");
-    settings.setValue("serverPath", newPath);
+    activeInstance->setServerPath(newPath);
+    fileWatcher->setServerPath(newPath);
+    refreshConfigDrift();
+    rebuildPrototypeIndex();
+    shardManager->save();
+    refreshShardDashboard();
 
     qDebug() << "Server path updated to:" << newPath;
 
-    // Call the function to check and copy missing event files
+    // Bring the new path's event files up to date with the shipped ones
     verifyAndCopyEventFiles();
+    initializeEventStates();
 }
 
 void MainWindow::startServer() {
-    QString serverPath = ui->mhServerPathEdit->text();
-
-    if (serverPath.isEmpty()) {
-        QMessageBox::critical(this, "Error", "Please specify the server directory.");
+    // taskkill matches by image name, so strays are only cleaned up while no shard is running
+    QString errorMessage;
+    if (!activeInstance->start(!shardManager->anyRunning(), &errorMessage)) {
+        QMessageBox::critical(this, "Error", errorMessage);
         return;
     }
 
-    QString apachePath = serverPath + "/Apache24/bin/httpd.exe";
-    QString mhServerPath = serverPath + "/MHServerEmu/MHServerEmu.exe";
-    QString apacheRoot = serverPath + "/Apache24";
-
-    // Ensure no existing instances of the server or Apache are running
-    QProcess::execute("taskkill", QStringList() << "/F" << "/IM" << "httpd.exe");
-    QProcess::execute("taskkill", QStringList() << "/F" << "/IM" << "MHServerEmu.exe");
-
-    // Check if executables exist
-    if (!QFile::exists(apachePath)) {
-        QMessageBox::critical(this, "Error", QString("Apache executable (httpd.exe) not found at %1").arg(apachePath));
-        return;
-    }
-
-    if (!QFile::exists(mhServerPath)) {
-        QMessageBox::critical(this, "Error", QString("MHServerEmu executable not found at %1").arg(mhServerPath));
-        return;
-    }
-
-    // Set environment variable for Apache
-    QProcessEnvironment env = QProcessEnvironment::systemEnvironment();
-    env.insert("APACHE_SERVER_ROOT", apacheRoot);
-    apacheProcess->setProcessEnvironment(env);
+    // Log the successful server start
+    ui->ServerOutputEdit->append("Server started successfully.");
+}
 
-    // Start Apache server
-    apacheProcess->setWorkingDirectory(serverPath + "/Apache24/bin");
-    apacheProcess->start(apachePath);
-    if (!apacheProcess->waitForStarted()) {
-        QMessageBox::critical(this, "Error", "Failed to start Apache server. Check your configuration.");
-        return;
-    }
+void MainWindow::setupMetricsExporter() {
+    metricsThread = new QThread(this);
+    metricsExporter = new MetricsExporter();
+    metricsExporter->moveToThread(metricsThread);
+    connect(metricsThread, &QThread::finished, metricsExporter, &QObject::deleteLater);
+    metricsThread->start();
 
-    // Start MHServerEmu
-    serverProcess->setWorkingDirectory(serverPath + "/MHServerEmu");
-    serverProcess->start(mhServerPath);
-    if (!serverProcess->waitForStarted()) {
-        QMessageBox::critical(this, "Error", "Failed to start MHServerEmu.");
-        apacheProcess->kill(); // Stop Apache if MHServerEmu fails to start
-        return;
+    // Port 0 disables the endpoint
+    QSettings settings("PTM", "MHServerEmuUI");
+    quint16 metricsPort = static_cast<quint16>(settings.value("metricsPort", 9184).toUInt());
+    if (metricsPort != 0) {
+        MetricsExporter *exporter = metricsExporter;
+        QMetaObject::invokeMethod(exporter, [exporter, metricsPort]() {
+            exporter->listen(metricsPort);
+        }, Qt::QueuedConnection);
     }
-
-    // Log the successful server start
-    ui->ServerOutputEdit->append("Server started successfully.");
 }
 
 void MainWindow::stopServer() {
     ui->ServerOutputEdit->append("Stopping server...");
 
-    // Disconnect error handling temporarily
-    disconnect(serverProcess, &QProcess::errorOccurred, this, &MainWindow::handleServerError);
-
-    // Stop MHServerEmu process
-    if (serverProcess->state() == QProcess::Running) {
-        serverProcess->terminate();
-        if (!serverProcess->waitForFinished(5000)) { // Wait up to 5 seconds
-            qDebug() << "MHServerEmu.exe did not terminate in time. Forcing kill.";
-            serverProcess->kill(); // Force kill if not finished
-            serverProcess->waitForFinished(); // Ensure it's fully killed
+    activeInstance->stop();
+
+    // Fallback: Ensure both processes are killed using taskkill. This matches by image name,
+    // so it is skipped while other shards are still running.
+    if (!shardManager->anyRunning()) {
+        QProcess taskCheckProcess;
+        taskCheckProcess.start("tasklist", QStringList() << "/FI" << "IMAGENAME eq MHServerEmu.exe");
+        taskCheckProcess.waitForFinished();
+        QString taskCheckOutput = QString::fromLocal8Bit(taskCheckProcess.readAllStandardOutput());
+        if (taskCheckOutput.contains("MHServerEmu.exe")) {
+            QProcess::execute("taskkill", QStringList() << "/F" << "/IM" << "MHServerEmu.exe");
+            qDebug() << "Fallback: MHServerEmu.exe killed.";
+        } else {
+            qDebug() << "Fallback: MHServerEmu.exe is not running.";
         }
-    } else {
-        qDebug() << "MHServerEmu.exe is not running. Skipping terminate.";
-    }
 
-    // Stop Apache process
-    if (apacheProcess->state() == QProcess::Running) {
-        apacheProcess->terminate();
-        if (!apacheProcess->waitForFinished(5000)) { // Wait up to 5 seconds
-            qDebug() << "Apache process did not terminate in time. Forcing kill.";
-            apacheProcess->kill(); // Force kill if not finished
-            apacheProcess->waitForFinished(); // Ensure it's fully killed
+        taskCheckProcess.start("tasklist", QStringList() << "/FI" << "IMAGENAME eq httpd.exe");
+        taskCheckProcess.waitForFinished();
+        taskCheckOutput = QString::fromLocal8Bit(taskCheckProcess.readAllStandardOutput());
+        if (taskCheckOutput.contains("httpd.exe")) {
+            QProcess::execute("taskkill", QStringList() << "/F" << "/IM" << "httpd.exe");
+            qDebug() << "Fallback: httpd.exe killed.";
+        } else {
+            qDebug() << "Fallback: httpd.exe is not running.";
         }
-    } else {
-        qDebug() << "Apache process is not running. Skipping terminate.";
-    }
-
-    // Reconnect error handling
-    connect(serverProcess, &QProcess::errorOccurred, this, &MainWindow::handleServerError);
-
-    // Fallback: Ensure both processes are killed using taskkill
-    QProcess taskCheckProcess;
-    taskCheckProcess.start("tasklist", QStringList() << "/FI" << "IMAGENAME eq MHServerEmu.exe");
-    taskCheckProcess.waitForFinished();
-    QString taskCheckOutput = QString::fromLocal8Bit(taskCheckProcess.readAllStandardOutput());
-    if (taskCheckOutput.contains("MHServerEmu.exe")) {
-        QProcess::execute("taskkill", QStringList() << "/F" << "/IM" << "MHServerEmu.exe");
-        qDebug() << "Fallback: MHServerEmu.exe killed.";
-    } else {
-        qDebug() << "Fallback: MHServerEmu.exe is not running.";
-    }
-
-    taskCheckProcess.start("tasklist", QStringList() << "/FI" << "IMAGENAME eq httpd.exe");
-    taskCheckProcess.waitForFinished();
-    taskCheckOutput = QString::fromLocal8Bit(taskCheckProcess.readAllStandardOutput());
-    if (taskCheckOutput.contains("httpd.exe")) {
-        QProcess::execute("taskkill", QStringList() << "/F" << "/IM" << "httpd.exe");
-        qDebug() << "Fallback: httpd.exe killed.";
-    } else {
-        qDebug() << "Fallback: httpd.exe is not running.";
     }
 
     ui->ServerOutputEdit->append("Server stopped.");
-    playerCount = 0; // Reset player count
+    ui->listWidgetLoggedInUsers->clear();
     updatePlayerCountLabel();
 }
 
 void MainWindow::onPushButtonShutdownClicked() {
     // Ensure the server is running
-    if (serverProcess->state() != QProcess::Running) {
+    if (!activeInstance->isRunning()) {
         QMessageBox::warning(this, "Error", "Server is not running.");
         return;
     }
@@ -338,7 +363,7 @@ void MainWindow::onPushButtonShutdownClicked() {
 
     // Broadcast the initial shutdown message
     QString broadcastCommand = QString("!server broadcast %1\n").arg(shutdownMessage);
-    serverProcess->write(broadcastCommand.toUtf8());
+    activeInstance->sendCommand(broadcastCommand);
     ui->ServerOutputEdit->append("Sent broadcast message: " + shutdownMessage);
 
     // Update the playerShutdownCount label with the initial time
@@ -350,7 +375,16 @@ void MainWindow::onPushButtonShutdownClicked() {
     // Convert shutdown time to seconds
     int totalSeconds = shutdownTime * 60;
 
+    // The countdown stays with this shard even if another one is made active
+    QPointer<ServerInstance> shard = activeInstance;
+
     connect(shutdownTimer, &QTimer::timeout, this, [=]() mutable {
+        if (!shard) {
+            shutdownTimer->stop();
+            shutdownTimer->deleteLater();
+            return;
+        }
+
         // Decrement totalSeconds each second
         totalSeconds--;
 
@@ -366,13 +400,13 @@ void MainWindow::onPushButtonShutdownClicked() {
             // Send the "one minute left" message
             QString oneMinuteMessage = "One minute left until server shutdown. Log out now to save your data!";
             QString oneMinuteCommand = QString("!server broadcast %1\n").arg(oneMinuteMessage);
-            serverProcess->write(oneMinuteCommand.toUtf8());
+            shard->sendCommand(oneMinuteCommand);
             ui->ServerOutputEdit->append("Sent broadcast message: " + oneMinuteMessage);
         }
 
         if (totalSeconds <= 0) {
             // Send the shutdown command and stop the timer
-            serverProcess->write("!server shutdown\n");
+            shard->sendCommand("!server shutdown");
             ui->ServerOutputEdit->append("Sent server shutdown command.");
             ui->playerShutdownCount->setText("Server shutdown in progress...");
             shutdownTimer->stop();
@@ -393,106 +427,8 @@ void MainWindow::openAccountCreationPage() {
     }
 }
 
-void MainWindow::readServerOutput() {
-    static bool isProcessingClientInfo = false;
-    static QString clientInfoBuffer;
-
-    QByteArray output = serverProcess->readAllStandardOutput();
-    QString outputText = QString::fromLocal8Bit(output);
-
-    QByteArray errorOutput = serverProcess->readAllStandardError();
-    QString errorText = QString::fromLocal8Bit(errorOutput);
-
-    // Append output to the ServerOutputEdit
-    if (!outputText.isEmpty()) {
-        ui->ServerOutputEdit->append(outputText);
-    }
-
-    if (!errorText.isEmpty()) {
-        ui->ServerOutputEdit->append("<Error>: " + errorText);
-    }
-
-    QStringList lines = outputText.split('\n', Qt::SkipEmptyParts);
-
-    // ✅ Use indexed access instead of a range-based for-loop to avoid detachment
-    for (int i = 0; i < lines.size(); ++i) {
-        const QString &line = lines.at(i);  // Direct access, prevents detachment
-
-        // Check for the start of client info
-        if (line.contains("SessionId:") && !isProcessingClientInfo) {
-            isProcessingClientInfo = true;
-            clientInfoBuffer.clear();
-        }
-
-        // Accumulate client info lines
-        if (isProcessingClientInfo) {
-            clientInfoBuffer.append(line + '\n');
-
-            // Detect the end of the client info block
-            if (!line.contains(":")) { // End of client info block
-                isProcessingClientInfo = false;
-
-                // Extract the SessionId from the buffer
-                static const QRegularExpression regex(R"(SessionId:\s*(\S+))");
-                QRegularExpressionMatch match = regex.match(clientInfoBuffer);
-
-                QString sessionId;
-                if (match.hasMatch()) {
-                    sessionId = match.captured(1).trimmed();
-                }
-
-                // Retrieve username and email from the map
-                QString username, email;
-                if (userInfoMap.contains(sessionId)) {
-                    username = userInfoMap[sessionId].first;
-                    email = userInfoMap[sessionId].second;
-                    userInfoMap.remove(sessionId); // Cleanup after use
-                }
-
-                // Call displayUserInfo with complete context
-                displayUserInfo(clientInfoBuffer.trimmed(), username, email);
-                qDebug() << "User info block processed:\n" << clientInfoBuffer;
-
-                clientInfoBuffer.clear();
-            }
-        }
-    }
-
-    // Check for player connection logs
-    if (outputText.contains("[PlayerConnectionManager] Accepted and registered client")) {
-        playerCount++; // Increment player count
-        parseLoginEvent(outputText); // Parse the login event to extract user details
-    }
-    // Check for player disconnection logs
-    else if (outputText.contains("[PlayerConnectionManager] Removed client")) {
-        static const QRegularExpression regex(R"(\[Account=(.+) \(.*?\), SessionId=(0x[0-9A-Fa-f]+)\])");
-        QRegularExpressionMatch match = regex.match(outputText);
-        if (match.hasMatch()) {
-            QString username = match.captured(1).trimmed();
-            QString sessionId = match.captured(2).trimmed();
-            removeUserFromList(sessionId); // Remove user from the list
-            removeUserFromLoggedInMap(sessionId); // Remove user from the map
-            qDebug() << "Logged out user removed:" << username << "SessionId:" << sessionId;
-        } else {
-            qDebug() << "Failed to parse logout event.";
-        }
-        playerCount--; // Decrement player count
-        if (playerCount < 0) playerCount = 0; // Ensure count doesn't go negative
-    }
-
-    // Check for server shutdown
-    if (outputText.contains("[ServerManager] Shutdown finished")) {
-        QProcess::execute("taskkill", QStringList() << "/F" << "/IM" << "MHServerEmu.exe");
-        playerCount = 0; // Reset player count
-        updatePlayerCountLabel();
-    }
-
-    // Update the player count label
-    updatePlayerCountLabel();
-}
-
 void MainWindow::updatePlayerCountLabel() {
-    ui->playerCountLabel->setText(QString::number(playerCount));
+    ui->playerCountLabel->setText(QString::number(activeInstance->playerCount()));
 }
 
 void MainWindow::handleServerError() {
@@ -509,26 +445,10 @@ void MainWindow::onStartClientButtonClicked() {
     }
 }
 
-void MainWindow::parseLoginEvent(const QString &logLine) {
-    static const QRegularExpression regex(R"(\[Account=(.+) \(0x[0-9A-Fa-f]+\), SessionId=(0x[0-9A-Fa-f]+)\])");
-    QRegularExpressionMatch match = regex.match(logLine);
-
-    if (match.hasMatch()) {
-        QString accountName = match.captured(1);
-        QString sessionId = match.captured(2);
-
-        // Store the user details
-        loggedInUsers[sessionId] = accountName;
-        qDebug() << "Logged in user added:" << accountName << "SessionId:" << sessionId;
-
-        // Update the list
-        refreshLoggedInUsers();
-    }
-}
-
 void MainWindow::refreshLoggedInUsers() {
     ui->listWidgetLoggedInUsers->clear(); // Clear the current list
 
+    const QMap<QString, QString> &loggedInUsers = activeInstance->loggedInUsers();
     for (auto it = loggedInUsers.begin(); it != loggedInUsers.end(); ++it) {
         QListWidgetItem *item = new QListWidgetItem(it.value(), ui->listWidgetLoggedInUsers); // Use username as text
         item->setData(Qt::UserRole, it.key()); // Set session ID as UserRole data
@@ -578,253 +498,368 @@ void MainWindow::onUpdateButtonClicked() {
         return;
     }
 
-    QString zipFilePath = serverPath + "/MHServerEmu-nightly.zip";
+    // Dated, so a part file left by another night's build is never resumed into this one
+    QString zipFilePath = serverPath + QString("/MHServerEmu-nightly-%1.zip").arg(currentDate);
     QString extractPath = serverPath + "/MHServerEmu";
+    // Unpacked here while the download runs, moved into the install only once everything checked out
+    QString stagingPath = serverPath + "/MHServerEmu-update";
 
-    // Back up files to preserve
-    QStringList filesToBackup;
-    if (ui->checkBoxUpdateConfigFile->isChecked()) {
-        filesToBackup.append("config.ini");
-    }
-    if (ui->checkBoxUpdateSaveLiveTuning->isChecked()) {
-        filesToBackup.append("Data/Game/LiveTuningData.json");
+    if (updateDownloader || updateExtractor) {
+        QMessageBox::information(this, "Update", "An update is already in progress.");
+        return;
     }
 
-    // Add files from the Billing folder if the checkbox is checked
-    if (ui->checkBoxUpdateSaveStore->isChecked()) {
-        filesToBackup.append("Data/Billing/Catalog.json"); // Replace with actual file names
-        filesToBackup.append("Data/Billing/CatalogPatch.json");
-    }
-
-    QMap<QString, QString> backupFiles;
-    for (const QString &file : filesToBackup) {
-        QString originalPath = extractPath + "/" + file;
-        QString backupPath = originalPath + ".bak";
-        if (QFile::exists(originalPath)) {
-            if (QFile::rename(originalPath, backupPath)) {
-                backupFiles.insert(originalPath, backupPath);
-                qDebug() << "Backed up file:" << originalPath << "to" << backupPath;
-            } else {
-                QMessageBox::critical(this, "Error", "Failed to back up file: " + originalPath);
-                return;
-            }
+    const QString partName = QFileInfo(zipFilePath).fileName() + ".part";
+    const QStringList oldParts = QDir(serverPath).entryList({"MHServerEmu-nightly*.part"}, QDir::Files);
+    for (const QString &oldPart : oldParts) {
+        if (oldPart != partName) {
+            QFile::remove(QDir(serverPath).filePath(oldPart));
         }
     }
 
-    // Use curl to download the nightly build
-    QProcess *curlProcess = new QProcess(this);
-    QStringList curlArguments = {"-L", "--silent", "-o", zipFilePath, downloadUrl};
+    QDir(stagingPath).removeRecursively();
+    if (!QDir().mkpath(stagingPath)) {
+        QMessageBox::critical(this, "Error", "Could not create " + stagingPath);
+        return;
+    }
 
-    connect(curlProcess, &QProcess::readyReadStandardOutput, this, [=]() {
-        qDebug() << "Curl Output:" << curlProcess->readAllStandardOutput();
+    updateDownloader = new NightlyDownloader(this);
+    updateExtractor = new ZipExtractor(stagingPath, this);
+    QPointer<QProgressDialog> progressDialog = new QProgressDialog("Downloading the nightly build...", "Cancel", 0, 0, this);
+    progressDialog->setWindowTitle("Update");
+    progressDialog->setAttribute(Qt::WA_DeleteOnClose);
+    progressDialog->setAutoClose(false);
+    progressDialog->setAutoReset(false);
+    progressDialog->setMinimumDuration(0);
+    connect(progressDialog, &QProgressDialog::canceled, this, [this]() {
+        if (updateDownloader) {
+            updateDownloader->abort();
+        } else if (updateExtractor) {
+            updateExtractor->cancel();
+        }
     });
 
-    connect(curlProcess, &QProcess::readyReadStandardError, this, [=]() {
-        qDebug() << "Curl Error:" << curlProcess->readAllStandardError();
-    });
+    // Entries are unpacked as their bytes arrive; the part file is let go before it is renamed
+    updateExtractor->beginStreaming(updateDownloader->partPath());
+    connect(updateDownloader, &NightlyDownloader::bytesWritten, updateExtractor, &ZipExtractor::archiveGrew);
+    connect(updateDownloader, &NightlyDownloader::finalizing, updateExtractor, &ZipExtractor::releaseArchive);
 
-    connect(curlProcess, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished), this, [=](int exitCode, QProcess::ExitStatus exitStatus) {
-        if (exitCode == 0 && exitStatus == QProcess::NormalExit) {
-            if (!QFile::exists(zipFilePath)) {
-                QMessageBox::critical(this, "Error", "The ZIP file does not exist after downloading.");
-                return;
-            }
+    QSharedPointer<QString> downloadText(new QString("Downloading the nightly build..."));
+    QSharedPointer<int> filesUnpacked(new int(0));
+    auto updateLabel = [progressDialog, downloadText, filesUnpacked]() {
+        if (progressDialog) {
+            progressDialog->setLabelText(*filesUnpacked > 0 ? QString("%1\n%2 file(s) unpacked so far").arg(*downloadText).arg(*filesUnpacked) : *downloadText);
+        }
+    };
+
+    connect(updateDownloader, &NightlyDownloader::progress, progressDialog, [progressDialog, downloadText, updateLabel](qint64 received, qint64 total, double bytesPerSecond, qint64 etaSeconds) {
+        // The dialog takes ints, so it counts KiB
+        QString text = QString("Downloading the nightly build...\n%1 MB").arg(received / 1048576.0, 0, 'f', 1);
+        if (total > 0) {
+            progressDialog->setMaximum(int(total / 1024));
+            progressDialog->setValue(int(received / 1024));
+            text += QString(" of %1 MB").arg(total / 1048576.0, 0, 'f', 1);
+        }
+        text += QString(" at %1 MB/s").arg(bytesPerSecond / 1048576.0, 0, 'f', 2);
+        if (etaSeconds >= 0) {
+            text += QString(", %1:%2 left").arg(etaSeconds / 60).arg(etaSeconds % 60, 2, 10, QChar('0'));
+        }
+        *downloadText = text;
+        updateLabel();
+    });
 
-            // Extract the ZIP file
-            QStringList args = {
-                "-NoProfile",
-                "-ExecutionPolicy", "Bypass",
-                "-Command",
-                QString("Expand-Archive -Path '%1' -DestinationPath '%2' -Force").arg(zipFilePath, extractPath)
-            };
+    connect(updateExtractor, &ZipExtractor::fileExtracted, progressDialog, [progressDialog, filesUnpacked, updateLabel](const QString &name, int filesDone, int filesTotal) {
+        if (filesTotal == 0) {
+            *filesUnpacked = filesDone;
+            updateLabel();
+            return;
+        }
+        progressDialog->setMaximum(filesTotal);
+        progressDialog->setValue(filesDone);
+        progressDialog->setLabelText(QString("Unpacking the update...\n%1 of %2 files\n%3").arg(filesDone).arg(filesTotal).arg(name));
+    });
 
-            QProcess *extractProcess = new QProcess(this);
-            extractProcess->setProgram("powershell");
-            extractProcess->setArguments(args);
+    connect(updateDownloader, &NightlyDownloader::finished, this, [this, progressDialog, zipFilePath, stagingPath](bool success, const QString &errorMessage) {
+        const QByteArray sha256 = updateDownloader->sha256();
+        updateDownloader->deleteLater();
+        updateDownloader = nullptr;
+
+        const bool canceled = progressDialog && progressDialog->wasCanceled();
+        if (canceled || !success) {
+            updateExtractor->deleteLater();
+            updateExtractor = nullptr;
+            QDir(stagingPath).removeRecursively();
+            if (progressDialog) {
+                progressDialog->close();
+            }
+            if (canceled) {
+                ui->ServerOutputEdit->append("Update download cancelled, the next update resumes it.");
+            } else {
+                qDebug() << "Update download failed:" << errorMessage;
+                QMessageBox::critical(this, "Error", QString("Failed to download the update.\n%1").arg(errorMessage));
+            }
+            return;
+        }
 
-            connect(extractProcess, &QProcess::readyReadStandardOutput, this, [=]() {
-                qDebug() << "PowerShell Output:" << extractProcess->readAllStandardOutput();
-            });
+        ui->ServerOutputEdit->append(QString("Downloaded %1 (SHA-256 %2).").arg(QFileInfo(zipFilePath).fileName(), QString::fromLatin1(sha256)));
+
+        // Without a published digest, the archive's own end record is what shows the download is whole
+        QString archiveError;
+        if (!ZipExtractor::checkArchiveEnd(zipFilePath, &archiveError)) {
+            updateExtractor->deleteLater();
+            updateExtractor = nullptr;
+            QDir(stagingPath).removeRecursively();
+            QFile::remove(zipFilePath); // Not resumable, the next update downloads it again
+            if (progressDialog) {
+                progressDialog->close();
+            }
+            QMessageBox::critical(this, "Error", QString("The downloaded update is incomplete or damaged.\n%1").arg(archiveError));
+            return;
+        }
 
-            connect(extractProcess, &QProcess::readyReadStandardError, this, [=]() {
-                qDebug() << "PowerShell Error:" << extractProcess->readAllStandardError();
-            });
+        if (progressDialog) {
+            progressDialog->setLabelText("Unpacking the update...");
+        }
+        updateExtractor->extract(zipFilePath);
+    });
 
-            connect(extractProcess, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished), this, [=](int exitCode, QProcess::ExitStatus exitStatus) {
-                if (exitCode == 0 && exitStatus == QProcess::NormalExit) {
-                    // Restore backed-up files
-                    for (auto it = backupFiles.begin(); it != backupFiles.end(); ++it) {
-                        QString originalPath = it.key();
-                        QString backupPath = it.value();
-                        if (QFile::exists(originalPath)) {
-                            QFile::remove(originalPath);
-                        }
-                        if (QFile::rename(backupPath, originalPath)) {
-                            qDebug() << "Restored file:" << backupPath << "to" << originalPath;
-                        } else {
-                            QMessageBox::critical(this, "Error", "Failed to restore file: " + backupPath);
-                        }
-                    }
-
-                    QFile::remove(zipFilePath); // Clean up ZIP file
-                    QMessageBox::information(this, "Update", "Update completed successfully.");
-                } else {
-                    QMessageBox::critical(this, "Error", "Failed to extract update files.");
-                }
-            });
+    connect(updateExtractor, &ZipExtractor::finished, this, [this, progressDialog, zipFilePath, stagingPath, extractPath](bool success, const QString &errorMessage) {
+        const QStringList files = updateExtractor->extractedFiles();
+        updateExtractor->deleteLater();
+        updateExtractor = nullptr;
 
-            extractProcess->start();
-        } else {
-            QMessageBox::critical(this, "Error", "Failed to download update via curl.");
+        const bool canceled = progressDialog && progressDialog->wasCanceled();
+        if (progressDialog) {
+            progressDialog->close();
+        }
+        if (!success) {
+            QDir(stagingPath).removeRecursively();
+            if (canceled) {
+                ui->ServerOutputEdit->append("Update cancelled, the install was not changed.");
+            } else {
+                QMessageBox::critical(this, "Error", QString("Failed to extract update files.\n%1").arg(errorMessage));
+            }
+            return;
         }
+        installUpdate(zipFilePath, stagingPath, extractPath, files);
     });
 
-    curlProcess->start("curl", curlArguments);
+    // nightly.link publishes no digest, so by default the size the server announced and the
+    // archive's end record are what get checked, and every file its CRC-32. A SHA-256 of a build
+    // verified elsewhere can be pinned in the UpdateSha256 setting; other downloads then fail.
+    QSettings settings("PTM", "MHServerEmuUI");
+    const QByteArray expectedSha256 = settings.value("UpdateSha256").toString().toLatin1();
+    if (!expectedSha256.isEmpty()) {
+        ui->ServerOutputEdit->append("Expecting the pinned update SHA-256 " + QString::fromLatin1(expectedSha256.trimmed()) + ".");
+    }
+    QString errorMessage;
+    if (!updateDownloader->start(QUrl(downloadUrl), zipFilePath, -1, expectedSha256, &errorMessage)) {
+        updateDownloader->deleteLater();
+        updateDownloader = nullptr;
+        updateExtractor->deleteLater();
+        updateExtractor = nullptr;
+        if (progressDialog) {
+            progressDialog->close();
+        }
+        QMessageBox::critical(this, "Error", errorMessage);
+        return;
+    }
+    updateExtractor->archiveGrew(updateDownloader->bytesOnDisk()); // A resumed part file may hold whole entries already
 }
 
-void MainWindow::onDownloadFinished(QNetworkReply *reply) {
-    if (reply->error() != QNetworkReply::NoError) {
-        qDebug() << "Download failed:" << reply->errorString();
-        reply->deleteLater();
+void MainWindow::installUpdate(const QString &zipFilePath, const QString &stagingPath, const QString &extractPath, const QStringList &files)
+{
+    // Files to preserve keep the installed copy when there is one
+    QSet<QString> filesToKeep;
+    if (ui->checkBoxUpdateConfigFile->isChecked()) {
+        filesToKeep.insert("config.ini");
+    }
+    if (ui->checkBoxUpdateSaveLiveTuning->isChecked()) {
+        filesToKeep.insert("Data/Game/LiveTuning/LiveTuningData.json");
+    }
+
+    // Add files from the Billing folder if the checkbox is checked
+    if (ui->checkBoxUpdateSaveStore->isChecked()) {
+        filesToKeep.insert("Data/Billing/Catalog.json"); // Replace with actual file names
+        filesToKeep.insert("Data/Billing/CatalogPatch.json");
+    }
+
+    // Replaced files are moved aside first, so a failure partway can put the old install back
+    const QString backupPath = extractPath + "-backup";
+    if (QDir(backupPath).exists()) {
+        QDir(stagingPath).removeRecursively();
+        QMessageBox::critical(this, "Error", QString("A previous update left its backup in %1.\nRestore or remove it before updating again.").arg(backupPath));
+        return;
+    }
+
+    // Staging is on the same volume, so each file is a rename rather than a copy
+    QStringList installed; // In order, for the rollback
+    QSet<QString> backedUp;
+    QString failedFile;
+    for (const QString &file : files) {
+        const QString targetPath = extractPath + "/" + file;
+        if (filesToKeep.contains(file) && QFile::exists(targetPath)) {
+            qDebug() << "Kept file:" << targetPath;
+            continue;
+        }
+        QDir().mkpath(QFileInfo(targetPath).absolutePath());
+        if (QFile::exists(targetPath)) {
+            const QString backupFile = backupPath + "/" + file;
+            QDir().mkpath(QFileInfo(backupFile).absolutePath());
+            if (!QFile::rename(targetPath, backupFile)) {
+                failedFile = file;
+                break;
+            }
+            backedUp.insert(file);
+        }
+        if (!QFile::rename(stagingPath + "/" + file, targetPath)) {
+            failedFile = file;
+            installed.append(file); // Its backup, if any, still has to go back
+            break;
+        }
+        installed.append(file);
+    }
+    QDir(stagingPath).removeRecursively();
+
+    if (!failedFile.isEmpty()) {
+        QStringList notRestored;
+        for (auto it = installed.crbegin(); it != installed.crend(); ++it) {
+            const QString targetPath = extractPath + "/" + *it;
+            if (QFile::exists(targetPath) && !QFile::remove(targetPath)) {
+                notRestored.append(*it);
+                continue;
+            }
+            if (backedUp.contains(*it) && !QFile::rename(backupPath + "/" + *it, targetPath)) {
+                notRestored.append(*it);
+            }
+        }
+
+        // The archive stays so the update can simply be run again
+        if (notRestored.isEmpty()) {
+            QDir(backupPath).removeRecursively();
+            QMessageBox::critical(this, "Error", QString("Failed to install %1, is the server still running?\nThe previous install was restored.").arg(failedFile));
+        } else {
+            QMessageBox::critical(this, "Error", QString("Failed to install %1, and %2 file(s) could not be restored. The previous copies are in %3.\n%4")
+                                                     .arg(failedFile).arg(notRestored.size()).arg(backupPath, notRestored.mid(0, 10).join("\n")));
+        }
         return;
     }
 
-    // Handle the successful download
-    QByteArray fileData = reply->readAll();
-    qDebug() << "Download succeeded. Data size:" << fileData.size();
-    reply->deleteLater();
+    QDir(backupPath).removeRecursively();
+    QFile::remove(zipFilePath); // Clean up ZIP file
+    ui->ServerOutputEdit->append(QString("Installed %1 file(s) from the update.").arg(installed.size()));
+    QMessageBox::information(this, "Update", "Update completed successfully.");
 }
 
 void MainWindow::verifyAndCopyEventFiles() {
-    // Define the server's LiveTuning folder
-    QString serverPath = ui->mhServerPathEdit->text() + "/MHServerEmu/Data/Game/LiveTuning/";
-
-    // Define the source folder (where the program's EXE is located)
-    QString sourcePath = QCoreApplication::applicationDirPath() + "/";
-
-    // List of event file names
-    QStringList eventFiles = {
-        "LiveTuningData_CosmicChaos.json",
-        "OFF_LiveTuningData_CosmicChaos.json",
-        "LiveTuningData_MidtownMadness.json",
-        "OFF_LiveTuningData_MidtownMadness.json",
-        "LiveTuningData_ArmorIncursion.json",
-        "OFF_LiveTuningData_ArmorIncursion.json",
-        "LiveTuningData_OdinsBounty.json",
-        "OFF_LiveTuningData_OdinsBounty.json",
-        "LiveTuningData_Defenders&FriendsXP.json",
-        "OFF_LiveTuningData_Defenders&FriendsXP.json",
-        "LiveTuningData_AvengersXP.json",
-        "OFF_LiveTuningData_AvengersXP.json",
-        "LiveTuningData_FantasticFourXP.json",
-        "OFF_LiveTuningData_FantasticFourXP.json",
-        "LiveTuningData_Guardians&CosmicXP.json",
-        "OFF_LiveTuningData_Guardians&CosmicXP.json",
-        "LiveTuningData_Scoundrels&VillainsXP.json",
-        "OFF_LiveTuningData_Scoundrels&VillainsXP.json",
-        "LiveTuningData_XMenXP.json",
-        "OFF_LiveTuningData_XMenXP.json",
-        "OFF_LiveTuningDataz_PandemoniumProtocol.json",
-        "LiveTuningDataz_PandemoniumProtocol.json"
-    };
-
-    // Ensure the server folder exists
-    QDir serverDir(serverPath);
-    if (!serverDir.exists()) {
-        QMessageBox::critical(this, "Error", "Server folder not found. Please check the server path.");
+    // Runs at startup too, when no path may have been set yet; there is nothing to do then
+    if (activeInstance->serverPath().isEmpty()) {
+        return;
+    }
+    const QString liveTuningDir = activeInstance->liveTuningPath();
+    if (!QDir(liveTuningDir).exists()) {
+        qDebug() << "LiveTuning folder not found, event files not provisioned:" << liveTuningDir;
         return;
     }
 
-    // Copy missing event files
-    for (const QString &fileName : eventFiles) {
-        QString destFilePath = serverPath + fileName;
-        QString sourceFilePath = sourcePath + fileName;
+    QString errorMessage;
+    const QVector<EventFileProvisioner::ManifestEntry> manifest = EventFileProvisioner::loadManifest(EventFileProvisioner::ManifestPath, &errorMessage);
+    if (manifest.isEmpty()) {
+        qDebug() << "No event file manifest:" << errorMessage;
+        return;
+    }
 
-        if (!QFile::exists(destFilePath)) {
-            if (QFile::exists(sourceFilePath)) {
-                if (QFile::copy(sourceFilePath, destFilePath)) {
-                    qDebug() << "Copied missing event file:" << fileName;
-                } else {
-                    qDebug() << "Failed to copy:" << fileName;
-                }
-            } else {
-                qDebug() << "Source event file missing:" << sourceFilePath;
-            }
+    // Hashing and copying happen on the pool, the window doesn't wait for any of it. The worker
+    // only sees plain data; the result comes back through a watcher the window owns.
+    const quint64 generation = ++eventProvisionGeneration;
+    QSharedPointer<QPromise<EventFileProvisioner::Result>> provisioning = QSharedPointer<QPromise<EventFileProvisioner::Result>>::create();
+    QSharedPointer<qint64> elapsedMs = QSharedPointer<qint64>::create(0); // Written before finish()
+    QFutureWatcher<EventFileProvisioner::Result> *watcher = new QFutureWatcher<EventFileProvisioner::Result>(this);
+    connect(watcher, &QFutureWatcher<EventFileProvisioner::Result>::finished, this, [this, watcher, elapsedMs, liveTuningDir, generation]() {
+        watcher->deleteLater();
+        if (eventProvisionGeneration == generation && watcher->future().resultCount() > 0) {
+            onEventFilesProvisioned(liveTuningDir, watcher->result(), *elapsedMs);
         }
+    });
+    provisioning->start();
+    watcher->setFuture(provisioning->future());
+
+    QThreadPool::globalInstance()->start([provisioning, elapsedMs, liveTuningDir, manifest]() {
+        QElapsedTimer timer;
+        timer.start();
+        provisioning->addResult(EventFileProvisioner::provision(liveTuningDir, manifest));
+        *elapsedMs = timer.elapsed();
+        provisioning->finish();
+    });
+}
+
+void MainWindow::onEventFilesProvisioned(const QString &liveTuningDir, const EventFileProvisioner::Result &result, qint64 elapsedMs)
+{
+    qDebug() << "Event files checked in" << elapsedMs << "ms:" << result.installed.size() << "installed,"
+             << result.updated.size() << "updated," << result.keptEdited.size() << "kept with local edits";
+
+    if (!result.installed.isEmpty()) {
+        ui->ServerOutputEdit->append(QString("Installed missing event files: %1").arg(result.installed.join(", ")));
+    }
+    if (!result.updated.isEmpty()) {
+        ui->ServerOutputEdit->append(QString("Updated outdated event files: %1").arg(result.updated.join(", ")));
+    }
+    if (!result.keptEdited.isEmpty()) {
+        ui->ServerOutputEdit->append(QString("Kept locally edited event files: %1").arg(result.keptEdited.join(", ")));
+    }
+    for (const QString &error : result.errors) {
+        ui->ServerOutputEdit->append(QString("Event files: %1").arg(error));
+    }
+    if (!result.installed.isEmpty() && activeInstance->liveTuningPath() == liveTuningDir) {
+        initializeEventStates();
+    }
+
+    // Only files the server currently loads need a reload to take effect
+    if (!result.updatedActive.isEmpty() && activeInstance->liveTuningPath() == liveTuningDir && activeInstance->isRunning()) {
+        activeInstance->sendCommand("!server reloadlivetuning");
+        ui->ServerOutputEdit->append("Sent command: !server reloadlivetuning");
     }
 }
 
 void MainWindow::onLoadLiveTuning()
 {
-    // Retrieve path from the line edit
-    QString mhServerPath = ui->mhServerPathEdit->text();
-    if (mhServerPath.isEmpty()) {
+    if (activeInstance->serverPath().isEmpty()) {
         QMessageBox::warning(this, "Error", "Please specify the MH Server path.");
         return;
     }
 
-    // Construct the full path to livetuningdata.json
-    QString filePath = QDir(mhServerPath).filePath("MHServerEmu/Data/Game/LiveTuning/LiveTuningData.json");
+    // The active shard's file, the same one writeLiveTuningStore saves to
+    QString filePath = activeInstance->liveTuningPath() + "LiveTuningData.json";
 
-    QFile file(filePath);
-    if (!file.open(QIODevice::ReadOnly)) {
+    if (!QFile::exists(filePath)) {
         QMessageBox::warning(this, "Error", QString("Could not open %1").arg(filePath));
         return;
     }
 
-    QByteArray jsonData = file.readAll();
-    file.close();
+    // Entries are interned and categorized once when parsed; the watcher keeps that parse
+    // until the file changes on disk, so loading again is just a copy of the store
+    QElapsedTimer loadTimer;
+    loadTimer.start();
 
-    QJsonDocument doc = QJsonDocument::fromJson(jsonData);
-    if (!doc.isArray()) {
+    LiveTuningStore &store = activeInstance->liveTuning();
+    QSharedPointer<const LiveTuningStore> parsed = fileWatcher->liveTuning(filePath);
+    if (!parsed) {
+        store.clear();
+        activeInstance->liveTuningJournal().reset(store);
+        liveTuningModel->clearCategory();
+        updatePendingChangesLabel();
+        updateLiveTuningHistoryControls();
         QMessageBox::warning(this, "Error", "Invalid JSON format in LiveTuningData.json");
         return;
     }
+    store = *parsed; // Implicitly shared until the first edit
+    activeInstance->liveTuningJournal().reset(store);
+    addToPrototypeIndex(store);
 
-    QJsonArray jsonArray = doc.array();
-
-    // Category rules based on Setting prefixes
-    QMap<QString, QString> categoryRules = {
-        {"eGTV_", "Global"},
-        {"eWETV_", "World Entity"},
-        {"ePTV_", "Powers"},
-        {"eRTV_", "Regions"},
-        {"eLTV_", "Loot"},
-        {"eMTV_", "Mission"},
-        {"eCTV_", "Condition"},
-        {"eAETV_", "Avatar Entity"},
-        {"eATV_", "Area"},
-        {"ePOTV_", "Population Object"},
-        {"eMFTV_", "Metrics Frequency"},
-        {"ePETV_", "Public Events"}
-    };
-
-    // Categorize items dynamically
-    categories.clear();  // Reset the categories
-
-    // ✅ Use indexed access instead of a range-based for-loop to avoid detachment
-    for (int i = 0; i < jsonArray.size(); ++i) {
-        QJsonValue value = jsonArray.at(i);
-
-        if (!value.isObject()) {
-            qDebug() << "Skipping non-object JSON entry:" << value;
-            continue;
-        }
-
-        QJsonObject obj = value.toObject();
-        QString setting = obj["Setting"].toString();
-        QString category = "Uncategorized";
-
-        for (auto it = categoryRules.begin(); it != categoryRules.end(); ++it) {
-            if (setting.startsWith(it.key())) {
-                category = it.value();
-                break;
-            }
-        }
-
-        categories[category].append(obj);
-    }
+    qDebug() << "Loaded" << store.size() << "live tuning entries in" << loadTimer.nsecsElapsed() / 1000 << "us";
 
+    updatePendingChangesLabel();
+    updateLiveTuningHistoryControls();
     populateComboBox();  // Populate categories in the dropdown
 }
 
@@ -832,11 +867,10 @@ void MainWindow::populateComboBox()
 {
     ui->comboBoxCategory->clear();  // Clear any existing items
 
-    for (auto it = categories.constBegin(); it != categories.constEnd(); ++it) {
-        ui->comboBoxCategory->addItem(it.key());
-    }
+    const QStringList categoryNames = activeInstance->liveTuning().categoryNames();
+    ui->comboBoxCategory->addItems(categoryNames);
 
-    if (!categories.isEmpty()) {
+    if (!categoryNames.isEmpty()) {
         onCategoryChanged(ui->comboBoxCategory->currentText());
     }
 }
@@ -848,213 +882,480 @@ void MainWindow::onCategoryChanged(const QString &category)
 
 void MainWindow::displayCategoryItems(const QString &category)
 {
-    // Clear the existing layout
-    clearLayout(liveTuningLayout);
-
-    // Ensure the selected category exists
-    if (!categories.contains(category))
+    // Only the row list is swapped, the view creates nothing per entry
+    const LiveTuningStore &store = activeInstance->liveTuning();
+    if (category.isEmpty() || !store.categoryNames().contains(category)) {
+        liveTuningModel->clearCategory();
         return;
-
-    const QJsonArray &items = categories[category];
-    for (const QJsonValue &value : items) {
-        QJsonObject obj = value.toObject();
-        QString setting = obj["Setting"].toString();
-        QString prototype = obj["Prototype"].toString();
-        double val = obj["Value"].toDouble();
-
-        // Optional: Add prototype label if Prototype is not empty
-        if (!prototype.isEmpty()) {
-            QLabel *prototypeLabel = new QLabel(QString("Prototype: %1").arg(prototype), this);
-            liveTuningLayout->addWidget(prototypeLabel);
-        }
-
-        // Create label for the setting
-        QLabel *label = new QLabel(setting, this);
-
-        // Create slider
-        QSlider *slider = new QSlider(Qt::Horizontal, this);
-        slider->setRange(0, 200); // Range for 0.0 to 10.0 (scaled by 0.5)
-        slider->setValue(static_cast<int>(val * 10)); // Scale value for slider
-
-        // Create line edit
-        QLineEdit *lineEdit = new QLineEdit(QString::number(val, 'f', 1), this);
-        lineEdit->setAlignment(Qt::AlignCenter);
-
-        // Sync slider and line edit
-        connect(slider, &QSlider::valueChanged, this, [lineEdit](int sliderValue) {
-            double scaledValue = sliderValue / 10.0;
-            lineEdit->setText(QString::number(scaledValue, 'f', 1));
-        });
-
-        connect(lineEdit, &QLineEdit::editingFinished, this, [slider, lineEdit]() {
-            double enteredValue = lineEdit->text().toDouble();
-            slider->setValue(static_cast<int>(enteredValue * 10));
-        });
-
-        // Add to layout
-        QHBoxLayout *rowLayout = new QHBoxLayout();
-        rowLayout->addWidget(label);
-        rowLayout->addWidget(slider);
-        rowLayout->addWidget(lineEdit);
-
-        liveTuningLayout->addLayout(rowLayout); // Add the row to the main layout
     }
 
-    // Force the layout to update
-    liveTuningLayout->invalidate();
+    liveTuningModel->setPrototypeFilter(prototypeFilterMask()); // Prototype ids change with every load
+    liveTuningModel->setCategory(liveTuningCategoryFromName(category));
+    liveTuningView->scrollToTop();
 }
 
-void MainWindow::clearLayout(QLayout *layout)
+void MainWindow::setupLiveTuningView()
 {
-    while (QLayoutItem *child = layout->takeAt(0)) {
-        if (QWidget *widget = child->widget()) {
-            qDebug() << "Deleting widget:" << widget;
-            widget->deleteLater();
-        } else if (QLayout *nestedLayout = child->layout()) {
-            qDebug() << "Clearing nested layout.";
-            clearLayout(nestedLayout);
-        }
-        delete child;
-    }
-    qDebug() << "Layout cleared.";
+    liveTuningModel = new LiveTuningModel(this);
+
+    // The table takes the place of the old scroll area of per-row widgets
+    liveTuningView = new QTableView(ui->liveTuningScrollArea->parentWidget());
+    liveTuningView->setGeometry(ui->liveTuningScrollArea->geometry());
+    liveTuningView->setModel(liveTuningModel);
+    liveTuningView->setItemDelegateForColumn(LiveTuningModel::ValueColumn, new LiveTuningValueDelegate(liveTuningView));
+    liveTuningView->setSelectionBehavior(QAbstractItemView::SelectRows);
+    liveTuningView->setSelectionMode(QAbstractItemView::SingleSelection);
+    liveTuningView->setEditTriggers(QAbstractItemView::DoubleClicked | QAbstractItemView::SelectedClicked
+                                    | QAbstractItemView::EditKeyPressed | QAbstractItemView::AnyKeyPressed);
+    liveTuningView->setAlternatingRowColors(true);
+    liveTuningView->setWordWrap(false);
+    liveTuningView->setTextElideMode(Qt::ElideMiddle);
+
+    // Fixed sizes so the view never measures every row
+    liveTuningView->verticalHeader()->setVisible(false);
+    liveTuningView->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+    liveTuningView->verticalHeader()->setDefaultSectionSize(24);
+    liveTuningView->horizontalHeader()->setSectionResizeMode(QHeaderView::Interactive);
+    liveTuningView->horizontalHeader()->setStretchLastSection(true);
+    liveTuningView->setColumnWidth(LiveTuningModel::PrototypeColumn, 220);
+    liveTuningView->setColumnWidth(LiveTuningModel::SettingColumn, 220);
+
+    ui->liveTuningScrollArea->hide();
+    liveTuningView->show();
+
+    // Edits are tracked in the store as they happen, whichever category they were made in
+    pendingChangesLabel = new QLabel(ui->saveLiveTuningButton->parentWidget());
+    pendingChangesLabel->setGeometry(625, 130, 121, 21);
+    pendingChangesLabel->setAlignment(Qt::AlignCenter);
+    pendingChangesLabel->show();
+    connect(liveTuningModel, &LiveTuningModel::valueEdited, this, &MainWindow::updatePendingChangesLabel);
+
+    QPushButton *bulkEditButton = new QPushButton("Bulk Edit...", ui->saveLiveTuningButton->parentWidget());
+    bulkEditButton->setGeometry(625, 160, 121, 31);
+    bulkEditButton->setToolTip("Apply an expression such as v*1.5 to many entries at once");
+    bulkEditButton->show();
+    connect(bulkEditButton, &QPushButton::clicked, this, &MainWindow::openBulkTransform);
 }
 
-void MainWindow::createLiveTuningSliders(const QJsonArray &data) {
-    // Clear existing sliders
-    QLayoutItem *child;
-    while ((child = liveTuningLayout->takeAt(0)) != nullptr) {
-        delete child->widget();
-        delete child;
+void MainWindow::commitOpenLiveTuningEditor()
+{
+    if (liveTuningView->state() == QAbstractItemView::EditingState) {
+        QModelIndex current = liveTuningView->currentIndex();
+        liveTuningView->setCurrentIndex(QModelIndex());
+        liveTuningView->setCurrentIndex(current);
     }
+}
 
-    for (const QJsonValue &value : data) {
-        QJsonObject obj = value.toObject();
-        QString setting = obj["Setting"].toString();
-        double val = obj["Value"].toDouble();
-
-        QLabel *label = new QLabel(setting, this);
-        QSlider *slider = new QSlider(Qt::Horizontal, this);
-        slider->setRange(0, 200); // Scale by 0.5 for range 0.0 to 10.0
-        slider->setValue(static_cast<int>(val * 10));
-        QLineEdit *lineEdit = new QLineEdit(QString::number(val, 'f', 1), this);
-
-        connect(slider, &QSlider::valueChanged, this, [lineEdit](int sliderValue) {
-            double scaledValue = sliderValue / 10.0;
-            lineEdit->setText(QString::number(scaledValue, 'f', 1));
-        });
+void MainWindow::openBulkTransform()
+{
+    LiveTuningStore &store = activeInstance->liveTuning();
+    if (store.isEmpty()) {
+        QMessageBox::warning(this, "Error", "Load Live Tuning data before bulk editing.");
+        return;
+    }
+    commitOpenLiveTuningEditor();
 
-        connect(lineEdit, &QLineEdit::editingFinished, this, [slider, lineEdit]() {
-            double enteredValue = lineEdit->text().toDouble();
-            slider->setValue(static_cast<int>(enteredValue * 10));
-        });
+    BulkTransformDialog dialog(store, this);
+    dialog.setCategory(ui->comboBoxCategory->currentText());
+    dialog.setPrototypePrefix(prototypeFilterEdit->text().trimmed());
+    attachPrototypeCompleter(dialog.prototypeEdit());
+    if (dialog.exec() != QDialog::Accepted || dialog.changes().isEmpty()) {
+        return;
+    }
 
-        QHBoxLayout *rowLayout = new QHBoxLayout();
-        rowLayout->addWidget(label);
-        rowLayout->addWidget(slider);
-        rowLayout->addWidget(lineEdit);
-        liveTuningLayout->addLayout(rowLayout);
+    // Applied as one undo step, one file write and one reload
+    const QVector<LiveTuningJournal::Change> &changes = dialog.changes();
+    for (const LiveTuningJournal::Change &change : changes) {
+        store.setValue(change.index, change.to);
     }
-}
+    activeInstance->liveTuningJournal().recordBulk(store, QString("%1 on %2 entries").arg(dialog.expressionText()).arg(changes.size()));
+    updateLiveTuningHistoryControls();
 
-void MainWindow::onSaveLiveTuning() {
-    // Ensure liveTuningFilePath is set
-    if (liveTuningFilePath.isEmpty()) {
-        liveTuningFilePath = ui->mhServerPathEdit->text() + "/MHServerEmu/Data/Game/LiveTuning/LiveTuningData.json";
+    AtomicFileWriter::Result result;
+    if (!writeLiveTuningStore(&result)) {
+        liveTuningModel->refreshValues();
+        updatePendingChangesLabel();
+        return;
+    }
+    if (result == AtomicFileWriter::Written && activeInstance->isRunning()) {
+        activeInstance->sendCommand("!server reloadlivetuning");
+        ui->ServerOutputEdit->append("Sent command: !server reloadlivetuning");
     }
+    ui->ServerOutputEdit->append(QString("Bulk edit %1 applied to %2 live tuning value(s).").arg(dialog.expressionText()).arg(changes.size()));
+}
 
-    // Prepare JSON array to store the settings
-    QJsonArray savedArray;
+void MainWindow::updatePendingChangesLabel()
+{
+    int pending = activeInstance ? activeInstance->liveTuning().dirtyCount() : 0;
+    pendingChangesLabel->setText(QString("Pending changes: %1").arg(pending));
+    ui->saveLiveTuningButton->setText(pending > 0 ? QString("Save Live Tuning (%1)").arg(pending) : QString("Save Live Tuning"));
+}
 
-    // Iterate through all categories in the map
-    for (auto it = categories.constBegin(); it != categories.constEnd(); ++it) {
-        const QJsonArray &items = it.value();
-
-        for (const QJsonValue &value : items) {
-            QJsonObject obj = value.toObject();
+void MainWindow::setupPrototypeSearch()
+{
+    // Sits left of the category box, above the table
+    prototypeFilterEdit = new QLineEdit(ui->comboBoxCategory->parentWidget());
+    prototypeFilterEdit->setGeometry(10, 5, 231, 26);
+    prototypeFilterEdit->setPlaceholderText("Filter by prototype path, e.g. Loot/Tables/");
+    prototypeFilterEdit->setClearButtonEnabled(true);
+    prototypeFilterEdit->show();
+    connect(prototypeFilterEdit, &QLineEdit::textChanged, this, &MainWindow::applyPrototypeFilter);
+
+    attachPrototypeCompleter(prototypeFilterEdit);
+    attachPrototypeCompleter(ui->lineEditAddLTSettingProto);
+}
 
-            // Retrieve values
-            QString setting = obj["Setting"].toString();
-            QString prototype = obj["Prototype"].toString();
-            double currentValue = obj["Value"].toDouble();
+void MainWindow::attachPrototypeCompleter(QLineEdit *edit)
+{
+    // The trie already narrows the list, the completer only shows it. Suggestions go one path
+    // segment at a time, with the number of prototypes under each.
+    static constexpr int PathRole = Qt::UserRole + 1;
+    QStandardItemModel *suggestions = new QStandardItemModel(edit);
+    QCompleter *completer = new QCompleter(suggestions, edit);
+    completer->setCompletionMode(QCompleter::UnfilteredPopupCompletion);
+    completer->setCompletionRole(PathRole);
+    completer->setMaxVisibleItems(15);
+    edit->setCompleter(completer);
+
+    auto refresh = [this, edit, suggestions, completer](const QString &text) {
+        suggestions->clear();
+        const QVector<QPair<QString, int>> segments = prototypeIndex.nextSegments(text, 200);
+        for (const QPair<QString, int> &segment : segments) {
+            QStandardItem *item = new QStandardItem(segment.second > 1 ? QString("%1  (%2)").arg(segment.first).arg(segment.second)
+                                                                       : segment.first);
+            item->setData(segment.first, PathRole);
+            suggestions->appendRow(item);
+        }
+        if (!segments.isEmpty() && edit->hasFocus()) {
+            completer->complete();
+        }
+    };
+    connect(edit, &QLineEdit::textEdited, this, refresh);
 
-            // Check if the setting exists in the UI and get its updated value
-            double updatedValue = currentValue; // Default to original value
-            for (int i = 0; i < liveTuningLayout->count() - 1; ++i) {
-                QHBoxLayout *rowLayout = qobject_cast<QHBoxLayout *>(liveTuningLayout->itemAt(i)->layout());
-                if (!rowLayout) continue;
+    // Picking a folder drills into it
+    connect(completer, QOverload<const QString &>::of(&QCompleter::activated), this, [edit, refresh](const QString &path) {
+        if (path.endsWith('/')) {
+            QTimer::singleShot(0, edit, [edit, refresh]() { refresh(edit->text()); });
+        }
+    });
+}
 
-                QLabel *label = qobject_cast<QLabel *>(rowLayout->itemAt(0)->widget());
-                QLineEdit *lineEdit = qobject_cast<QLineEdit *>(rowLayout->itemAt(2)->widget());
+void MainWindow::rebuildPrototypeIndex()
+{
+    const QStringList folders = {
+        activeInstance ? activeInstance->liveTuningPath() : QString(),
+        QCoreApplication::applicationDirPath() // Bundled event files
+    };
 
-                if (label && lineEdit && label->text() == setting) {
-                    updatedValue = lineEdit->text().toDouble(); // Get updated value from UI
-                    break;
+    // Every live tuning file counts, OFF_ event files included; parsing happens on the pool and
+    // the trie comes back through a watcher the window owns
+    const quint64 generation = ++prototypeIndexGeneration;
+    QSharedPointer<QPromise<PrototypeTrie>> indexing = QSharedPointer<QPromise<PrototypeTrie>>::create();
+    QFutureWatcher<PrototypeTrie> *watcher = new QFutureWatcher<PrototypeTrie>(this);
+    connect(watcher, &QFutureWatcher<PrototypeTrie>::finished, this, [this, watcher, generation]() {
+        watcher->deleteLater();
+        if (prototypeIndexGeneration != generation || watcher->future().resultCount() == 0) {
+            return;
+        }
+        prototypeIndex = watcher->result();
+        addToPrototypeIndex(activeInstance->liveTuning()); // Unsaved additions aren't on disk yet
+        if (!prototypeFilterEdit->text().trimmed().isEmpty()) {
+            applyPrototypeFilter();
+        }
+    });
+    indexing->start();
+    watcher->setFuture(indexing->future());
+
+    QThreadPool::globalInstance()->start([indexing, folders]() {
+        QElapsedTimer timer;
+        timer.start();
+        PrototypeTrie trie;
+        for (const QString &folder : folders) {
+            if (folder.isEmpty()) {
+                continue;
+            }
+            QDir dir(folder);
+            const QStringList names = dir.entryList({"*LiveTuningData*.json"}, QDir::Files);
+            for (const QString &name : names) {
+                LiveTuningStore store;
+                if (!store.loadFile(dir.filePath(name), nullptr)) {
+                    continue;
+                }
+                for (int id = 0; id < store.prototypePool().size(); ++id) {
+                    trie.insert(store.prototypePool().at(id));
                 }
             }
+        }
+        qDebug() << "Indexed" << trie.size() << "prototype paths in" << timer.elapsed() << "ms";
 
-            // Construct updated JSON object
-            QJsonObject updatedObj;
-            updatedObj["Setting"] = setting;
-            updatedObj["Prototype"] = prototype;
-            updatedObj["Value"] = updatedValue;
+        indexing->addResult(trie);
+        indexing->finish();
+    });
+}
 
-            // Append the updated object to the JSON array
-            savedArray.append(updatedObj);
+void MainWindow::addToPrototypeIndex(const LiveTuningStore &store)
+{
+    const StringPool &pool = store.prototypePool();
+    for (int id = 0; id < pool.size(); ++id) {
+        prototypeIndex.insert(pool.at(id));
+    }
+}
+
+QVector<bool> MainWindow::prototypeFilterMask() const
+{
+    const QString prefix = prototypeFilterEdit ? prototypeFilterEdit->text().trimmed() : QString();
+    if (prefix.isEmpty() || !activeInstance) {
+        return QVector<bool>();
+    }
+
+    // Only the subtree under the prefix is walked, then mapped to the store's prototype ids
+    const StringPool &pool = activeInstance->liveTuning().prototypePool();
+    QVector<bool> mask(pool.size(), false);
+    prototypeIndex.forEachWithPrefix(prefix, [&pool, &mask](const QString &path) {
+        const int id = pool.find(path);
+        if (id >= 0) {
+            mask[id] = true;
         }
+    });
+    return mask;
+}
+
+void MainWindow::applyPrototypeFilter()
+{
+    const QString prefix = prototypeFilterEdit->text().trimmed();
+    prototypeFilterEdit->setToolTip(prefix.isEmpty() ? QString()
+                                                     : QString("%1 known prototype(s) under this prefix").arg(prototypeIndex.countWithPrefix(prefix)));
+    liveTuningModel->setPrototypeFilter(prototypeFilterMask());
+    liveTuningModel->reload();
+}
+
+void MainWindow::setupLiveTuningHistory()
+{
+    QWidget *tab = ui->saveLiveTuningButton->parentWidget();
+    QGroupBox *historyBox = new QGroupBox("Edit History", tab);
+    historyBox->setGeometry(750, 180, 301, 131);
+
+    undoLiveTuningButton = new QPushButton("Undo", historyBox);
+    undoLiveTuningButton->setGeometry(10, 20, 91, 27);
+    redoLiveTuningButton = new QPushButton("Redo", historyBox);
+    redoLiveTuningButton->setGeometry(105, 20, 91, 27);
+    QPushButton *checkpointButton = new QPushButton("Checkpoint...", historyBox);
+    checkpointButton->setGeometry(200, 20, 91, 27);
+
+    checkpointCombo = new QComboBox(historyBox);
+    checkpointCombo->setGeometry(10, 55, 281, 24);
+
+    QPushButton *diffButton = new QPushButton("Diff", historyBox);
+    diffButton->setGeometry(10, 88, 91, 27);
+    diffButton->setToolTip("Show what changed between the selected checkpoint and the current values");
+    QPushButton *revertButton = new QPushButton("Revert", historyBox);
+    revertButton->setGeometry(105, 88, 91, 27);
+    revertButton->setToolTip("Restore the selected checkpoint, save once and reload the server once");
+    QPushButton *removeButton = new QPushButton("Delete", historyBox);
+    removeButton->setGeometry(200, 88, 91, 27);
+    historyBox->show();
+
+    connect(undoLiveTuningButton, &QPushButton::clicked, this, &MainWindow::undoLiveTuning);
+    connect(redoLiveTuningButton, &QPushButton::clicked, this, &MainWindow::redoLiveTuning);
+    connect(checkpointButton, &QPushButton::clicked, this, &MainWindow::addLiveTuningCheckpoint);
+    connect(diffButton, &QPushButton::clicked, this, &MainWindow::showLiveTuningCheckpointDiff);
+    connect(revertButton, &QPushButton::clicked, this, &MainWindow::revertLiveTuningCheckpoint);
+    connect(removeButton, &QPushButton::clicked, this, &MainWindow::removeLiveTuningCheckpoint);
+
+    // Scoped to the tab so text fields keep their own undo
+    QShortcut *undoShortcut = new QShortcut(QKeySequence::Undo, liveTuningView);
+    undoShortcut->setContext(Qt::WidgetWithChildrenShortcut);
+    connect(undoShortcut, &QShortcut::activated, this, &MainWindow::undoLiveTuning);
+    QShortcut *redoShortcut = new QShortcut(QKeySequence::Redo, liveTuningView);
+    redoShortcut->setContext(Qt::WidgetWithChildrenShortcut);
+    connect(redoShortcut, &QShortcut::activated, this, &MainWindow::redoLiveTuning);
+
+    // Every edit that reaches the store becomes one undo step
+    connect(liveTuningModel, &LiveTuningModel::valueEdited, this, [this](int storeIndex, double oldValue, double newValue) {
+        Q_UNUSED(oldValue);
+        const LiveTuningStore &store = activeInstance->liveTuning();
+        activeInstance->liveTuningJournal().record(storeIndex, newValue, QString("%1 = %2").arg(store.setting(storeIndex)).arg(newValue));
+        updateLiveTuningHistoryControls();
+    });
+}
+
+void MainWindow::updateLiveTuningHistoryControls()
+{
+    if (!undoLiveTuningButton || !activeInstance) {
+        return;
     }
 
-    // Save the JSON array to the file
-    QFile file(liveTuningFilePath);
-    if (!file.open(QIODevice::WriteOnly)) {
-        QMessageBox::critical(this, "Error", QString("Failed to save Live Tuning data to %1").arg(liveTuningFilePath));
+    const LiveTuningJournal &journal = activeInstance->liveTuningJournal();
+    undoLiveTuningButton->setEnabled(journal.canUndo());
+    undoLiveTuningButton->setToolTip(journal.canUndo() ? QString("Undo %1").arg(journal.undoText()) : QString());
+    redoLiveTuningButton->setEnabled(journal.canRedo());
+    redoLiveTuningButton->setToolTip(journal.canRedo() ? QString("Redo %1").arg(journal.redoText()) : QString());
+
+    const QString selected = checkpointCombo->currentText();
+    checkpointCombo->clear();
+    checkpointCombo->addItems(journal.checkpointNames());
+    checkpointCombo->setCurrentText(selected);
+}
+
+void MainWindow::undoLiveTuning()
+{
+    if (liveTuningView->state() == QAbstractItemView::EditingState) {
+        return; // Let the open editor finish first
+    }
+    if (activeInstance->liveTuningJournal().undo(activeInstance->liveTuning()).isEmpty()) {
         return;
     }
+    liveTuningModel->refreshValues();
+    updatePendingChangesLabel();
+    updateLiveTuningHistoryControls();
+}
 
-    QJsonDocument doc(savedArray);
-    file.write(doc.toJson(QJsonDocument::Indented));
-    file.close();
+void MainWindow::redoLiveTuning()
+{
+    if (liveTuningView->state() == QAbstractItemView::EditingState) {
+        return;
+    }
+    if (activeInstance->liveTuningJournal().redo(activeInstance->liveTuning()).isEmpty()) {
+        return;
+    }
+    liveTuningModel->refreshValues();
+    updatePendingChangesLabel();
+    updateLiveTuningHistoryControls();
+}
 
-    // Inform the user of the successful save
-    QMessageBox::information(this, "Success", "Live Tuning data saved successfully.");
+void MainWindow::addLiveTuningCheckpoint()
+{
+    LiveTuningJournal &journal = activeInstance->liveTuningJournal();
+    if (!journal.matches(activeInstance->liveTuning()) || activeInstance->liveTuning().isEmpty()) {
+        QMessageBox::warning(this, "Error", "Load Live Tuning data before creating a checkpoint.");
+        return;
+    }
+
+    bool ok;
+    QString name = QInputDialog::getText(this, "Checkpoint", "Checkpoint name:", QLineEdit::Normal,
+                                         QDateTime::currentDateTime().toString("HH:mm:ss"), &ok).trimmed();
+    if (!ok || name.isEmpty()) {
+        return;
+    }
+
+    journal.addCheckpoint(name);
+    updateLiveTuningHistoryControls();
+    checkpointCombo->setCurrentText(name);
 }
 
-void MainWindow::onReloadLiveTuning() {
-    if (serverProcess->state() == QProcess::Running) {
-        serverProcess->write("!server reloadlivetuning\n");
-    } else {
-        QMessageBox::warning(this, "Error", "Server is not running.");
+void MainWindow::showLiveTuningCheckpointDiff()
+{
+    const QString name = checkpointCombo->currentText();
+    if (name.isEmpty()) {
+        return;
+    }
+
+    // Only subtrees that differ between the two versions are visited
+    const LiveTuningStore &store = activeInstance->liveTuning();
+    const QVector<LiveTuningJournal::Change> changes = activeInstance->liveTuningJournal().diff(name, QString());
+
+    QStringList lines;
+    const int shown = qMin(changes.size(), 500);
+    for (int i = 0; i < shown; ++i) {
+        const LiveTuningJournal::Change &change = changes.at(i);
+        lines.append(QString("%1 / %2: %3 -> %4").arg(store.prototype(change.index), store.setting(change.index))
+                         .arg(change.from).arg(change.to));
+    }
+    if (shown < changes.size()) {
+        lines.append(QString("... and %1 more").arg(changes.size() - shown));
     }
+
+    QMessageBox box(QMessageBox::Information, "Checkpoint Diff",
+                    QString("%1 value(s) differ between \"%2\" and the current state.").arg(changes.size()).arg(name),
+                    QMessageBox::Ok, this);
+    if (!lines.isEmpty()) {
+        box.setDetailedText(lines.join("\n"));
+    }
+    box.exec();
 }
 
-void MainWindow::onPushButtonAddLTSettingClicked()
+void MainWindow::revertLiveTuningCheckpoint()
 {
-    // Get the file path for the live tuning data
-    QString mhServerPath = ui->mhServerPathEdit->text();
-    if (mhServerPath.isEmpty()) {
-        QMessageBox::warning(this, "Error", "Please specify the MH Server path.");
+    const QString name = checkpointCombo->currentText();
+    if (name.isEmpty()) {
         return;
     }
 
-    QString filePath = QDir(mhServerPath).filePath("MHServerEmu/Data/Game/LiveTuningData.json");
+    LiveTuningStore &store = activeInstance->liveTuning();
+    const QVector<LiveTuningJournal::Change> changes = activeInstance->liveTuningJournal().revertTo(name, store);
+    updateLiveTuningHistoryControls();
+    if (changes.isEmpty()) {
+        QMessageBox::information(this, "Revert", QString("The current values already match \"%1\".").arg(name));
+        return;
+    }
 
-    QFile file(filePath);
-    if (!file.open(QIODevice::ReadOnly)) {
-        QMessageBox::warning(this, "Error", QString("Could not open %1").arg(filePath));
+    // The whole revert goes out as one file write and one reload
+    AtomicFileWriter::Result result;
+    if (!writeLiveTuningStore(&result)) {
         return;
     }
+    if (result == AtomicFileWriter::Written && activeInstance->isRunning()) {
+        activeInstance->sendCommand("!server reloadlivetuning");
+        ui->ServerOutputEdit->append("Sent command: !server reloadlivetuning");
+    }
+    ui->ServerOutputEdit->append(QString("Reverted %1 live tuning value(s) to checkpoint \"%2\".").arg(changes.size()).arg(name));
+}
 
-    // Load the existing JSON data
-    QByteArray jsonData = file.readAll();
-    file.close();
+void MainWindow::removeLiveTuningCheckpoint()
+{
+    if (activeInstance->liveTuningJournal().removeCheckpoint(checkpointCombo->currentText())) {
+        updateLiveTuningHistoryControls();
+    }
+}
 
-    QJsonDocument doc = QJsonDocument::fromJson(jsonData);
-    if (!doc.isArray()) {
-        QMessageBox::warning(this, "Error", "Invalid JSON format in LiveTuningData.json");
+void MainWindow::onSaveLiveTuning() {
+    // Edits go straight into the store through the model; flush any editor still open
+    LiveTuningStore &store = activeInstance->liveTuning();
+    commitOpenLiveTuningEditor();
+
+    int savedChanges = store.dirtyCount();
+    AtomicFileWriter::Result result;
+    if (!writeLiveTuningStore(&result)) {
         return;
     }
 
-    QJsonArray jsonArray = doc.array();
+    // Inform the user of the successful save
+    QMessageBox::information(this, "Success", QString("Live Tuning data saved successfully (%1 change(s)).").arg(savedChanges));
+}
+
+bool MainWindow::writeLiveTuningStore(AtomicFileWriter::Result *result) {
+    LiveTuningStore &store = activeInstance->liveTuning();
+    // Always the active shard's file, which changes with "Set Active" and the server path
+    const QString filePath = activeInstance->liveTuningPath() + "LiveTuningData.json";
 
+    // Save the JSON array to the file
+    QElapsedTimer saveTimer;
+    saveTimer.start();
+    QString errorMessage;
+    *result = AtomicFileWriter::write(filePath, store.toJson(), &errorMessage);
+    if (*result == AtomicFileWriter::Failed) {
+        QMessageBox::critical(this, "Error", QString("Failed to save Live Tuning data to %1: %2").arg(filePath, errorMessage));
+        return false;
+    }
+    qDebug() << "Saved" << store.size() << "live tuning entries in" << saveTimer.nsecsElapsed() / 1000 << "us"
+             << (*result == AtomicFileWriter::Unchanged ? "(unchanged, not written)" : "");
+
+    store.markClean();
+    updatePendingChangesLabel();
+    liveTuningModel->refreshValues();
+    return true;
+}
+
+void MainWindow::onReloadLiveTuning() {
+    if (activeInstance->isRunning()) {
+        activeInstance->sendCommand("!server reloadlivetuning");
+    } else {
+        QMessageBox::warning(this, "Error", "Server is not running.");
+    }
+}
+
+void MainWindow::onPushButtonAddLTSettingClicked()
+{
     // Get the inputs from the line edits
     QString prototype = ui->lineEditAddLTSettingProto->text().trimmed();
     QString setting = ui->lineEditAddLTsettingName->text().trimmed();
@@ -1072,29 +1373,48 @@ void MainWindow::onPushButtonAddLTSettingClicked()
         return;
     }
 
-    // Create the new entry
-    QJsonObject newSetting;
-    newSetting["Prototype"] = prototype;
-    newSetting["Setting"] = setting;
-    newSetting["Value"] = value;
+    // The new entry goes into the loaded store; load it first so the save keeps what's on disk
+    LiveTuningStore &store = activeInstance->liveTuning();
+    if (store.isEmpty()) {
+        onLoadLiveTuning();
+        if (store.isEmpty()) {
+            return;
+        }
+    }
+    commitOpenLiveTuningEditor();
 
-    // Add the new entry to the JSON array
-    jsonArray.append(newSetting);
+    // An existing (Prototype, Setting) pair is an ordinary edit, anything else a new entry
+    const int otherChanges = store.dirtyCount();
+    LiveTuningJournal &journal = activeInstance->liveTuningJournal();
+    int index = store.indexOf(prototype, setting);
+    if (index >= 0) {
+        store.setValue(index, value);
+        journal.record(index, value, QString("%1 = %2").arg(setting).arg(value));
+    } else {
+        index = store.append(prototype, setting, value);
+        journal.recordAppend(store);
+        addToPrototypeIndex(store);
+    }
 
-    // Write the updated JSON data back to the file
-    if (!file.open(QIODevice::WriteOnly)) {
-        QMessageBox::critical(this, "Error", "Unable to save LiveTuningData.json");
+    AtomicFileWriter::Result result;
+    if (!writeLiveTuningStore(&result)) {
         return;
     }
 
-    QJsonDocument updatedDoc(jsonArray);
-    file.write(updatedDoc.toJson());
-    file.close();
-
-    QMessageBox::information(this, "Success", "New setting added successfully!");
-
-    // Optionally reload the live tuning data to reflect the changes in the UI
-    onLoadLiveTuning();
+    // Only the category list and the rows move, the store and its history stay as they are
+    const QString category = ui->comboBoxCategory->currentText();
+    const QStringList categoryNames = store.categoryNames();
+    ui->comboBoxCategory->blockSignals(true);
+    ui->comboBoxCategory->clear();
+    ui->comboBoxCategory->addItems(categoryNames);
+    ui->comboBoxCategory->setCurrentText(categoryNames.contains(category) ? category : liveTuningCategoryName(store.category(index)));
+    ui->comboBoxCategory->blockSignals(false);
+    displayCategoryItems(ui->comboBoxCategory->currentText());
+    updateLiveTuningHistoryControls();
+
+    QMessageBox::information(this, "Success", otherChanges > 0
+        ? QString("New setting added successfully! %1 other unsaved change(s) were saved with it.").arg(otherChanges)
+        : QString("New setting added successfully!"));
 }
 
 void MainWindow::onPushButtonLoadConfigClicked()
@@ -1113,162 +1433,157 @@ void MainWindow::onPushButtonLoadConfigClicked()
         return;
     }
 
-    // Load base config.ini
-    QSettings baseConfig(basePath, QSettings::IniFormat);
-
-    QVariantMap mergedConfig;
-
-    foreach (const QString &group, baseConfig.childGroups()) {
-        baseConfig.beginGroup(group);
-        foreach (const QString &key, baseConfig.childKeys()) {
-            mergedConfig[group + "/" + key] = baseConfig.value(key);
-        }
-        baseConfig.endGroup();
-    }
-
-    // Load ConfigOverride.ini
-    if (QFile::exists(overridePath)) {
-        QSettings overrideConfig(overridePath, QSettings::IniFormat);
-
-        foreach (const QString &group, overrideConfig.childGroups()) {
-            overrideConfig.beginGroup(group);
-            foreach (const QString &key, overrideConfig.childKeys()) {
-                mergedConfig[group + "/" + key] = overrideConfig.value(key);
-            }
-            overrideConfig.endGroup();
-        }
-    }
+    loadConfigFiles(basePath, overridePath);
+    QMessageBox::information(this, "Success", "Config + Overrides loaded successfully!");
+}
 
-    auto getVal = [&](const QString &fullKey, const QVariant &def = QVariant()) -> QVariant {
-        return mergedConfig.contains(fullKey) ? mergedConfig[fullKey] : def;
-    };
+void MainWindow::setupConfigSchema()
+{
+    // Every key the Config tab edits; load and save both go through this table
+    // Logging
+    configSchema.add("Logging", "EnableLogging", ConfigSchema::Bool, ui->checkBoxEnableLogging);
+    configSchema.add("Logging", "SynchronousMode", ConfigSchema::Bool, ui->checkBoxSynchronousMode);
+    configSchema.add("Logging", "HideSensitiveInformation", ConfigSchema::Bool, ui->checkBoxHideSensitiveInformation);
+    configSchema.add("Logging", "EnableConsole", ConfigSchema::Bool, ui->checkBoxEnableConsole);
+    configSchema.add("Logging", "ConsoleIncludeTimestamps", ConfigSchema::Bool, ui->checkBoxConsoleIncludeTimestamps);
+    configSchema.add("Logging", "ConsoleMinLevel", ConfigSchema::Integer, ui->comboBoxConsoleMinLevel);
+    configSchema.add("Logging", "ConsoleMaxLevel", ConfigSchema::Integer, ui->comboBoxConsoleMaxLevel, "5");
+    configSchema.add("Logging", "ConsoleChannels", ConfigSchema::Text, ui->lineEditConsoleChannels);
+    configSchema.add("Logging", "EnableFile", ConfigSchema::Bool, ui->checkBoxEnableFile);
+    configSchema.add("Logging", "FileIncludeTimestamps", ConfigSchema::Bool, ui->checkBoxFileIncludeTimestamps);
+    configSchema.add("Logging", "FileMinLevel", ConfigSchema::Integer, ui->comboBoxFileMinLevel);
+    configSchema.add("Logging", "FileMaxLevel", ConfigSchema::Integer, ui->comboBoxFileMaxLevel, "5");
+    configSchema.add("Logging", "FileChannels", ConfigSchema::Text, ui->lineEditFileChannels);
+    configSchema.add("Logging", "FileSplitOutput", ConfigSchema::Bool, ui->checkBoxFileSplitOutput);
+
+    // Frontend
+    configSchema.add("Frontend", "BindIP", ConfigSchema::Text, ui->lineEditBindIP);
+    configSchema.add("Frontend", "Port", ConfigSchema::Integer, ui->lineEditPort);
+    configSchema.add("Frontend", "PublicAddress", ConfigSchema::Text, ui->lineEditPublicAddress);
+    configSchema.add("Frontend", "ReceiveTimeoutMS", ConfigSchema::Integer, ui->lineEditReceiveTimeoutMS);
+    configSchema.add("Frontend", "SendTimeoutMS", ConfigSchema::Integer, ui->lineEditSendTimeoutMS);
+
+    // WebFrontend
+    configSchema.add("WebFrontend", "Address", ConfigSchema::Text, ui->lineEditWebFrontendAddress);
+    configSchema.add("WebFrontend", "Port", ConfigSchema::Integer, ui->lineEditWebFrontendPort);
+    configSchema.add("WebFrontend", "EnableLoginRateLimit", ConfigSchema::Bool, ui->checkBoxEnableLoginRateLimit);
+    configSchema.add("WebFrontend", "LoginRateLimitCostMS", ConfigSchema::Integer, ui->lineEditLoginRateLimitCostMS);
+    configSchema.add("WebFrontend", "LoginRateLimitBurst", ConfigSchema::Integer, ui->lineEditLoginRateLimitBurst);
+    configSchema.add("WebFrontend", "EnableWebApi", ConfigSchema::Bool, ui->checkBoxEnableWebApi);
+    configSchema.add("WebFrontend", "EnableDashboard", ConfigSchema::Bool, ui->checkBoxEnableDashboard);
+    configSchema.add("WebFrontend", "DashboardFileDirectory", ConfigSchema::Text, ui->lineEditDashboardFileDirectory);
+    configSchema.add("WebFrontend", "DashboardUrlPath", ConfigSchema::Text, ui->lineEditDashboardUrlPath);
+
+    // PlayerManager
+    configSchema.add("PlayerManager", "EnablePersistence", ConfigSchema::Bool, ui->checkBoxEnablePersistence);
+    configSchema.add("PlayerManager", "UseJsonDBManager", ConfigSchema::Bool, ui->checkBoxUseJsonDBManager);
+    configSchema.add("PlayerManager", "AllowClientVersionMismatch", ConfigSchema::Bool, ui->checkBoxAllowClientVersionMismatch);
+    configSchema.add("PlayerManager", "UseWhitelist", ConfigSchema::Bool, ui->checkBoxUseWhitelist);
+    configSchema.add("PlayerManager", "ShowNewsOnLogin", ConfigSchema::Bool, ui->checkBoxShowNewsOnLogin);
+    configSchema.add("PlayerManager", "NewsUrl", ConfigSchema::Text, ui->lineEditNewsUrl);
+    configSchema.add("PlayerManager", "ServerCapacity", ConfigSchema::Integer, ui->lineEditServerCapacity);
+    configSchema.add("PlayerManager", "MaxLoginQueueClients", ConfigSchema::Integer, ui->lineEditMaxLoginQueueClients);
+
+    // SQLiteDBManager
+    configSchema.add("SQLiteDBManager", "FileName", ConfigSchema::Text, ui->lineEditSQLiteFileName);
+    configSchema.add("SQLiteDBManager", "MaxBackupNumber", ConfigSchema::Integer, ui->lineEditSQLiteMaxBackupNumber);
+    configSchema.add("SQLiteDBManager", "BackupIntervalMinutes", ConfigSchema::Integer, ui->lineEditSQLiteBackupIntervalMinutes);
+
+    // JsonDBManager
+    configSchema.add("JsonDBManager", "FileName", ConfigSchema::Text, ui->lineEditJsonFileName);
+    configSchema.add("JsonDBManager", "MaxBackupNumber", ConfigSchema::Integer, ui->lineEditJsonMaxBackupNumber);
+    configSchema.add("JsonDBManager", "BackupIntervalMinutes", ConfigSchema::Integer, ui->lineEditJsonBackupIntervalMinutes);
+    configSchema.add("JsonDBManager", "PlayerName", ConfigSchema::Text, ui->lineEditJsonPlayerName);
+
+    // GroupingManager
+    configSchema.add("GroupingManager", "ServerName", ConfigSchema::Text, ui->lineEditServerName);
+    configSchema.add("GroupingManager", "MotdText", ConfigSchema::Text, ui->textEditMotdText);
+    configSchema.add("GroupingManager", "ServerPrestigeLevel", ConfigSchema::Integer, ui->comboBoxServerPrestigeLevel);
+    configSchema.add("GroupingManager", "LogTells", ConfigSchema::Bool, ui->checkBoxLogTells);
+
+    // GameInstance
+    configSchema.add("GameInstance", "NumWorkerThreads", ConfigSchema::Integer, ui->lineEditNumWorkerThreads);
+
+    // GameData
+    configSchema.add("GameData", "LoadAllPrototypes", ConfigSchema::Bool, ui->checkBoxLoadAllPrototypes);
+    configSchema.add("GameData", "UseEquipmentSlotTableCache", ConfigSchema::Bool, ui->checkBoxUseEquipmentSlotTableCache);
+    configSchema.add("GameData", "EnablePatchManager", ConfigSchema::Bool, ui->checkBoxEnablePatchManager);
+
+    // GameOptions
+    configSchema.add("GameOptions", "TeamUpSystemEnabled", ConfigSchema::Bool, ui->checkBoxTeamUpSystemEnabled);
+    configSchema.add("GameOptions", "AchievementsEnabled", ConfigSchema::Bool, ui->checkBoxAchievementsEnabled);
+    configSchema.add("GameOptions", "OmegaMissionsEnabled", ConfigSchema::Bool, ui->checkBoxOmegaMissionsEnabled);
+    configSchema.add("GameOptions", "VeteranRewardsEnabled", ConfigSchema::Bool, ui->checkBoxVeteranRewardsEnabled);
+    configSchema.add("GameOptions", "MultiSpecRewardsEnabled", ConfigSchema::Bool, ui->checkBoxMultiSpecRewardsEnabled);
+    configSchema.add("GameOptions", "GiftingEnabled", ConfigSchema::Bool, ui->checkBoxGiftingEnabled);
+    configSchema.add("GameOptions", "CharacterSelectV2Enabled", ConfigSchema::Bool, ui->checkBoxCharacterSelectV2Enabled);
+    configSchema.add("GameOptions", "CommunityNewsV2Enabled", ConfigSchema::Bool, ui->checkBoxCommunityNewsV2Enabled);
+    configSchema.add("GameOptions", "LeaderboardsEnabled", ConfigSchema::Bool, ui->checkBoxLeaderboardsEnabled);
+    configSchema.add("GameOptions", "NewPlayerExperienceEnabled", ConfigSchema::Bool, ui->checkBoxNewPlayerExperienceEnabled);
+    configSchema.add("GameOptions", "MissionTrackerV2Enabled", ConfigSchema::Bool, ui->checkBoxMissionTrackerV2Enabled);
+    configSchema.add("GameOptions", "GiftingAccountAgeInDaysRequired", ConfigSchema::Integer, ui->lineEditGiftingAccountAgeInDaysRequired);
+    configSchema.add("GameOptions", "GiftingAvatarLevelRequired", ConfigSchema::Integer, ui->lineEditGiftingAvatarLevelRequired);
+    configSchema.add("GameOptions", "GiftingLoginCountRequired", ConfigSchema::Integer, ui->lineEditGiftingLoginCountRequired);
+    configSchema.add("GameOptions", "InfinitySystemEnabled", ConfigSchema::Bool, ui->checkBoxInfinitySystemEnabled);
+    configSchema.add("GameOptions", "ChatBanVoteAccountAgeInDaysRequired", ConfigSchema::Integer, ui->lineEditChatBanVoteAccountAgeInDaysRequired);
+    configSchema.add("GameOptions", "ChatBanVoteAvatarLevelRequired", ConfigSchema::Integer, ui->lineEditChatBanVoteAvatarLevelRequired);
+    configSchema.add("GameOptions", "ChatBanVoteLoginCountRequired", ConfigSchema::Integer, ui->lineEditChatBanVoteLoginCountRequired);
+    configSchema.add("GameOptions", "IsDifficultySliderEnabled", ConfigSchema::Bool, ui->checkBoxIsDifficultySliderEnabled);
+    configSchema.add("GameOptions", "OrbisTrophiesEnabled", ConfigSchema::Bool, ui->checkBoxOrbisTrophiesEnabled);
+
+    // CustomGameOptions
+    configSchema.add("CustomGameOptions", "ESCooldownOverrideMinutes", ConfigSchema::Integer, ui->lineEditESCooldownOverrideMinutes);
+    configSchema.add("CustomGameOptions", "CombineESStacks", ConfigSchema::Bool, ui->checkBoxCombineESStacks);
+    configSchema.add("CustomGameOptions", "AutoUnlockAvatars", ConfigSchema::Bool, ui->checkBoxAutoUnlockAvatars);
+    configSchema.add("CustomGameOptions", "AutoUnlockTeamUps", ConfigSchema::Bool, ui->checkBoxAutoUnlockTeamUps);
+    configSchema.add("CustomGameOptions", "DisableMovementPowerChargeCost", ConfigSchema::Bool, ui->checkBoxDisableMovementPowerChargeCost);
+    configSchema.add("CustomGameOptions", "AllowSameGroupTalents", ConfigSchema::Bool, ui->checkBoxAllowSameGroupTalents);
+    configSchema.add("CustomGameOptions", "DisableInstancedLoot", ConfigSchema::Bool, ui->checkBoxDisableInstancedLoot);
+    configSchema.add("CustomGameOptions", "LootSpawnGridCellRadius", ConfigSchema::Number, ui->lineEditLootSpawnGridCellRadius);
+    configSchema.add("CustomGameOptions", "TrashedItemExpirationTimeMultiplier", ConfigSchema::Number, ui->lineEditTrashedItemExpirationTimeMultiplier);
+    configSchema.add("CustomGameOptions", "DisableAccountBinding", ConfigSchema::Bool, ui->checkBoxDisableAccountBinding);
+    configSchema.add("CustomGameOptions", "DisableCharacterBinding", ConfigSchema::Bool, ui->checkBoxDisableCharacterBinding);
+    configSchema.add("CustomGameOptions", "UsePrestigeLootTable", ConfigSchema::Bool, ui->checkBoxUsePrestigeLootTable);
+
+    // MTXStore
+    configSchema.add("MTXStore", "GazillioniteBalanceForNewAccounts", ConfigSchema::Integer, ui->lineEditGazillioniteBalanceForNewAccounts);
+    configSchema.add("MTXStore", "ESToGazillioniteConversionRatio", ConfigSchema::Number, ui->lineEditESToGazillioniteConversionRatio);
+    configSchema.add("MTXStore", "ESToGazillioniteConversionStep", ConfigSchema::Integer, ui->lineEditESToGazillioniteConversionStep);
+    configSchema.add("MTXStore", "GiftingOmegaLevelRequired", ConfigSchema::Integer, ui->lineEditGiftingOmegaLevelRequired);
+    configSchema.add("MTXStore", "GiftingInfinityLevelRequired", ConfigSchema::Integer, ui->lineEditGiftingInfinityLevelRequired);
+    configSchema.add("MTXStore", "HomePageUrl", ConfigSchema::Text, ui->lineEditHomePageUrl);
+    configSchema.add("MTXStore", "HomeBannerPageUrl", ConfigSchema::Text, ui->lineEditHomeBannerPageUrl);
+    configSchema.add("MTXStore", "HeroesBannerPageUrl", ConfigSchema::Text, ui->lineEditHeroesBannerPageUrl);
+    configSchema.add("MTXStore", "CostumesBannerPageUrl", ConfigSchema::Text, ui->lineEditCostumesBannerPageUrl);
+    configSchema.add("MTXStore", "BoostsBannerPageUrl", ConfigSchema::Text, ui->lineEditBoostsBannerPageUrl);
+    configSchema.add("MTXStore", "ChestsBannerPageUrl", ConfigSchema::Text, ui->lineEditChestsBannerPageUrl);
+    configSchema.add("MTXStore", "SpecialsBannerPageUrl", ConfigSchema::Text, ui->lineEditSpecialsBannerPageUrl);
+    configSchema.add("MTXStore", "RealMoneyUrl", ConfigSchema::Text, ui->lineEditRealMoneyUrl);
+    configSchema.add("MTXStore", "RewriteOriginalBundleUrls", ConfigSchema::Bool, ui->checkBoxRewriteOriginalBundleUrls);
+    configSchema.add("MTXStore", "BundleInfoUrl", ConfigSchema::Text, ui->lineEditBundleInfoUrl);
+    configSchema.add("MTXStore", "BundleImageUrl", ConfigSchema::Text, ui->lineEditBundleImageUrl);
+
+    // Leaderboards
+    configSchema.add("Leaderboards", "DatabaseFile", ConfigSchema::Text, ui->lineEditDatabaseFile);
+    configSchema.add("Leaderboards", "ScheduleFile", ConfigSchema::Text, ui->lineEditScheduleFile);
+    configSchema.add("Leaderboards", "AutoSaveIntervalMinutes", ConfigSchema::Integer, ui->lineEditAutoSaveIntervalMinutes);
+
+    // Looked up when a player logs in rather than when the server starts
+    configSchema.setLive("GroupingManager", "MotdText");
+    configSchema.setLive("PlayerManager", "ShowNewsOnLogin");
+    configSchema.setLive("PlayerManager", "NewsUrl");
+    configDrift.setLiveKeys(configSchema.liveKeys());
+    configDrift.setKeyTypes(configSchema.keyTypes());
+}
 
-    // --- Logging ---
-    ui->checkBoxEnableLogging->setChecked(getVal("Logging/EnableLogging", false).toBool());
-    ui->checkBoxSynchronousMode->setChecked(getVal("Logging/SynchronousMode", false).toBool());
-    ui->checkBoxHideSensitiveInformation->setChecked(getVal("Logging/HideSensitiveInformation", false).toBool());
-    ui->checkBoxEnableConsole->setChecked(getVal("Logging/EnableConsole", false).toBool());
-    ui->checkBoxConsoleIncludeTimestamps->setChecked(getVal("Logging/ConsoleIncludeTimestamps", false).toBool());
-    ui->comboBoxConsoleMinLevel->setCurrentIndex(getVal("Logging/ConsoleMinLevel", 0).toInt());
-    ui->comboBoxConsoleMaxLevel->setCurrentIndex(getVal("Logging/ConsoleMaxLevel", 5).toInt());
-    ui->lineEditConsoleChannels->setText(getVal("Logging/ConsoleChannels", "").toString());
-    ui->checkBoxEnableFile->setChecked(getVal("Logging/EnableFile", false).toBool());
-    ui->checkBoxFileIncludeTimestamps->setChecked(getVal("Logging/FileIncludeTimestamps", false).toBool());
-    ui->comboBoxFileMinLevel->setCurrentIndex(getVal("Logging/FileMinLevel", 0).toInt());
-    ui->comboBoxFileMaxLevel->setCurrentIndex(getVal("Logging/FileMaxLevel", 5).toInt());
-    ui->lineEditFileChannels->setText(getVal("Logging/FileChannels", "").toString());
-    ui->checkBoxFileSplitOutput->setChecked(getVal("Logging/FileSplitOutput", false).toBool());
-
-    // --- Frontend ---
-    ui->lineEditBindIP->setText(getVal("Frontend/BindIP").toString());
-    ui->lineEditPort->setText(getVal("Frontend/Port").toString());
-    ui->lineEditPublicAddress->setText(getVal("Frontend/PublicAddress").toString());
-    ui->lineEditReceiveTimeoutMS->setText(getVal("Frontend/ReceiveTimeoutMS").toString());
-    ui->lineEditSendTimeoutMS->setText(getVal("Frontend/SendTimeoutMS").toString());
-
-    // --- WebFrontend ---
-    ui->lineEditWebFrontendAddress->setText(getVal("WebFrontend/Address").toString());
-    ui->lineEditWebFrontendPort->setText(getVal("WebFrontend/Port").toString());
-    ui->checkBoxEnableLoginRateLimit->setChecked(getVal("WebFrontend/EnableLoginRateLimit", false).toBool());
-    ui->lineEditLoginRateLimitCostMS->setText(getVal("WebFrontend/LoginRateLimitCostMS").toString());
-    ui->lineEditLoginRateLimitBurst->setText(getVal("WebFrontend/LoginRateLimitBurst").toString());
-    ui->checkBoxEnableWebApi->setChecked(getVal("WebFrontend/EnableWebApi", false).toBool());
-    ui->checkBoxEnableDashboard->setChecked(getVal("WebFrontend/EnableDashboard", false).toBool());
-    ui->lineEditDashboardFileDirectory->setText(getVal("WebFrontend/DashboardFileDirectory").toString());
-    ui->lineEditDashboardUrlPath->setText(getVal("WebFrontend/DashboardUrlPath").toString());
-
-    // --- PlayerManager ---
-    ui->checkBoxEnablePersistence->setChecked(getVal("PlayerManager/EnablePersistence", false).toBool());
-    ui->checkBoxUseJsonDBManager->setChecked(getVal("PlayerManager/UseJsonDBManager", false).toBool());
-    ui->checkBoxAllowClientVersionMismatch->setChecked(getVal("PlayerManager/AllowClientVersionMismatch", false).toBool());
-    ui->checkBoxUseWhitelist->setChecked(getVal("PlayerManager/UseWhitelist", false).toBool());
-    ui->checkBoxShowNewsOnLogin->setChecked(getVal("PlayerManager/ShowNewsOnLogin", false).toBool());
-    ui->lineEditNewsUrl->setText(getVal("PlayerManager/NewsUrl").toString());
-    ui->lineEditServerCapacity->setText(getVal("PlayerManager/ServerCapacity").toString());
-    ui->lineEditMaxLoginQueueClients->setText(getVal("PlayerManager/MaxLoginQueueClients").toString());
-
-    // --- SQLiteDBManager ---
-    ui->lineEditSQLiteFileName->setText(getVal("SQLiteDBManager/FileName").toString());
-    ui->lineEditSQLiteMaxBackupNumber->setText(getVal("SQLiteDBManager/MaxBackupNumber").toString());
-    ui->lineEditSQLiteBackupIntervalMinutes->setText(getVal("SQLiteDBManager/BackupIntervalMinutes").toString());
-
-    // --- JsonDBManager ---
-    ui->lineEditJsonFileName->setText(getVal("JsonDBManager/FileName").toString());
-    ui->lineEditJsonMaxBackupNumber->setText(getVal("JsonDBManager/MaxBackupNumber").toString());
-    ui->lineEditJsonBackupIntervalMinutes->setText(getVal("JsonDBManager/BackupIntervalMinutes").toString());
-    ui->lineEditJsonPlayerName->setText(getVal("JsonDBManager/PlayerName").toString());
-
-    // --- GroupingManager ---
-    ui->lineEditServerName->setText(getVal("GroupingManager/ServerName").toString());
-    ui->textEditMotdText->setPlainText(getVal("GroupingManager/MotdText").toString());
-    ui->comboBoxServerPrestigeLevel->setCurrentIndex(getVal("GroupingManager/ServerPrestigeLevel", 0).toInt());
-
-    // --- GameInstance ---
-    ui->lineEditNumWorkerThreads->setText(getVal("GameInstance/NumWorkerThreads").toString());
-
-    // --- GameData ---
-    ui->checkBoxLoadAllPrototypes->setChecked(getVal("GameData/LoadAllPrototypes", false).toBool());
-    ui->checkBoxUseEquipmentSlotTableCache->setChecked(getVal("GameData/UseEquipmentSlotTableCache", false).toBool());
-    ui->checkBoxEnablePatchManager->setChecked(getVal("GameData/EnablePatchManager", false).toBool());
-
-    // --- GameOptions ---
-    ui->checkBoxTeamUpSystemEnabled->setChecked(getVal("GameOptions/TeamUpSystemEnabled", false).toBool());
-    ui->checkBoxAchievementsEnabled->setChecked(getVal("GameOptions/AchievementsEnabled", false).toBool());
-    ui->checkBoxOmegaMissionsEnabled->setChecked(getVal("GameOptions/OmegaMissionsEnabled", false).toBool());
-    ui->checkBoxVeteranRewardsEnabled->setChecked(getVal("GameOptions/VeteranRewardsEnabled", false).toBool());
-    ui->checkBoxMultiSpecRewardsEnabled->setChecked(getVal("GameOptions/TeamUpSystemEnabled", false).toBool());
-    ui->checkBoxGiftingEnabled->setChecked(getVal("GameOptions/GiftingEnabled", false).toBool());
-    ui->checkBoxCharacterSelectV2Enabled->setChecked(getVal("GameOptions/CharacterSelectV2Enabled", false).toBool());
-    ui->checkBoxCommunityNewsV2Enabled->setChecked(getVal("GameOptions/CommunityNewsV2Enabled", false).toBool());
-    ui->checkBoxLeaderboardsEnabled->setChecked(getVal("GameOptions/LeaderboardsEnabled", false).toBool());
-    ui->checkBoxNewPlayerExperienceEnabled->setChecked(getVal("GameOptions/NewPlayerExperienceEnabled", false).toBool());
-    ui->checkBoxMissionTrackerV2Enabled->setChecked(getVal("GameOptions/MissionTrackerV2Enabled", false).toBool());
-    ui->lineEditGiftingAccountAgeInDaysRequired->setText(getVal("GameOptions/GiftingAccountAgeInDaysRequired").toString());
-    ui->lineEditGiftingAvatarLevelRequired->setText(getVal("GameOptions/GiftingAvatarLevelRequired").toString());
-    ui->lineEditGiftingLoginCountRequired->setText(getVal("GameOptions/GiftingLoginCountRequired").toString());
-    ui->checkBoxInfinitySystemEnabled->setChecked(getVal("GameOptions/InfinitySystemEnabled", false).toBool());
-    ui->lineEditChatBanVoteAccountAgeInDaysRequired->setText(getVal("GameOptions/ChatBanVoteAccountAgeInDaysRequired").toString());
-    ui->lineEditChatBanVoteAvatarLevelRequired->setText(getVal("GameOptions/ChatBanVoteAvatarLevelRequired").toString());
-    ui->lineEditChatBanVoteLoginCountRequired->setText(getVal("GameOptions/ChatBanVoteLoginCountRequired").toString());
-    ui->checkBoxIsDifficultySliderEnabled->setChecked(getVal("GameOptions/IsDifficultySliderEnabled", false).toBool());
-    ui->checkBoxOrbisTrophiesEnabled->setChecked(getVal("GameOptions/OrbisTrophiesEnabled", false).toBool());
-
-    // --- CustomGameOptions ---
-    ui->lineEditESCooldownOverrideMinutes->setText(getVal("CustomGameOptions/ESCooldownOverrideMinutes").toString());
-    ui->checkBoxCombineESStacks->setChecked(getVal("CustomGameOptions/CombineESStacks", false).toBool());
-    ui->checkBoxAutoUnlockAvatars->setChecked(getVal("CustomGameOptions/AutoUnlockAvatars", false).toBool());
-    ui->checkBoxAutoUnlockTeamUps->setChecked(getVal("CustomGameOptions/AutoUnlockTeamUps", false).toBool());
-    ui->checkBoxDisableMovementPowerChargeCost->setChecked(getVal("CustomGameOptions/DisableMovementPowerChargeCost", false).toBool());
-    ui->checkBoxAllowSameGroupTalents->setChecked(getVal("CustomGameOptions/AllowSameGroupTalents", false).toBool());
-    ui->checkBoxDisableInstancedLoot->setChecked(getVal("CustomGameOptions/DisableInstancedLoot", false).toBool());
-    ui->lineEditLootSpawnGridCellRadius->setText(getVal("CustomGameOptions/LootSpawnGridCellRadius").toString());
-    ui->lineEditTrashedItemExpirationTimeMultiplier->setText(getVal("CustomGameOptions/TrashedItemExpirationTimeMultiplier").toString());
-    ui->checkBoxDisableAccountBinding->setChecked(getVal("CustomGameOptions/DisableAccountBinding", false).toBool());
-    ui->checkBoxDisableCharacterBinding->setChecked(getVal("CustomGameOptions/DisableCharacterBinding", false).toBool());
-    ui->checkBoxUsePrestigeLootTable->setChecked(getVal("CustomGameOptions/UsePrestigeLootTable", false).toBool());
-
-    // --- MTXStore ---
-    ui->lineEditGazillioniteBalanceForNewAccounts->setText(getVal("MTXStore/GazillioniteBalanceForNewAccounts").toString());
-    ui->lineEditESToGazillioniteConversionRatio->setText(getVal("MTXStore/ESToGazillioniteConversionRatio").toString());
-    ui->lineEditESToGazillioniteConversionStep->setText(getVal("MTXStore/ESToGazillioniteConversionStep").toString());
-    ui->lineEditGiftingOmegaLevelRequired->setText(getVal("MTXStore/GiftingOmegaLevelRequired").toString());
-    ui->lineEditGiftingInfinityLevelRequired->setText(getVal("MTXStore/GiftingInfinityLevelRequired").toString());
-    ui->lineEditHomePageUrl->setText(getVal("MTXStore/HomePageUrl").toString());
-    ui->lineEditHomeBannerPageUrl->setText(getVal("MTXStore/HomeBannerPageUrl").toString());
-    ui->lineEditHeroesBannerPageUrl->setText(getVal("MTXStore/HeroesBannerPageUrl").toString());
-    ui->lineEditCostumesBannerPageUrl->setText(getVal("MTXStore/CostumesBannerPageUrl").toString());
-    ui->lineEditBoostsBannerPageUrl->setText(getVal("MTXStore/BoostsBannerPageUrl").toString());
-    ui->lineEditChestsBannerPageUrl->setText(getVal("MTXStore/ChestsBannerPageUrl").toString());
-    ui->lineEditSpecialsBannerPageUrl->setText(getVal("MTXStore/SpecialsBannerPageUrl").toString());
-    ui->lineEditRealMoneyUrl->setText(getVal("MTXStore/RealMoneyUrl").toString());
-    ui->checkBoxRewriteOriginalBundleUrls->setChecked(getVal("MTXStore/RewriteOriginalBundleUrls", false).toBool());
-    ui->lineEditBundleInfoUrl->setText(getVal("MTXStore/BundleInfoUrl").toString());
-    ui->lineEditBundleImageUrl->setText(getVal("MTXStore/BundleImageUrl").toString());
-
-    // --- Leaderboards ---
-    ui->lineEditDatabaseFile->setText(getVal("Leaderboards/DatabaseFile").toString());
-    ui->lineEditScheduleFile->setText(getVal("Leaderboards/ScheduleFile").toString());
-    ui->lineEditAutoSaveIntervalMinutes->setText(getVal("Leaderboards/AutoSaveIntervalMinutes").toString());
+void MainWindow::loadConfigFiles(const QString &basePath, const QString &overridePath)
+{
+    // Parsed ini files are cached by the watcher, only files that changed on disk are read again
+    QSharedPointer<const QVariantMap> baseConfig = fileWatcher->iniValues(basePath);
+    QSharedPointer<const QVariantMap> overrideConfig = QFile::exists(overridePath) ? fileWatcher->iniValues(overridePath) : QSharedPointer<const QVariantMap>();
+    configSchema.load(baseConfig ? *baseConfig : QVariantMap(), overrideConfig ? *overrideConfig : QVariantMap());
+    loadedConfigValues = configSchema.widgetValues();
+    configLoaded = true;
 
     // --- Enable group boxes ---
     ui->groupBoxLogging->setEnabled(true);
@@ -1282,153 +1597,51 @@ void MainWindow::onPushButtonLoadConfigClicked()
     ui->groupBoxGameOptions->setEnabled(true);
     ui->groupBoxCustomGameOptions->setEnabled(true);
     ui->groupBoxMTXStore->setEnabled(true);
-
-    QMessageBox::information(this, "Success", "Config + Overrides loaded successfully!");
 }
 
 void MainWindow::onPushButtonSaveConfigClicked() {
-    QString configFilePath = ui->mhServerPathEdit->text() + "/MHServerEmu/ConfigOverride.ini";
-
-    // All settings the UI can modify
-    QMap<QString, QString> updatedSettings = {
-        {"Logging/EnableLogging", ui->checkBoxEnableLogging->isChecked() ? "true" : "false"},
-        {"Logging/SynchronousMode", ui->checkBoxSynchronousMode->isChecked() ? "true" : "false"},
-        {"Logging/HideSensitiveInformation", ui->checkBoxHideSensitiveInformation->isChecked() ? "true" : "false"},
-        {"Logging/EnableConsole", ui->checkBoxEnableConsole->isChecked() ? "true" : "false"},
-        {"Logging/ConsoleIncludeTimestamps", ui->checkBoxConsoleIncludeTimestamps->isChecked() ? "true" : "false"},
-        {"Logging/ConsoleMinLevel", QString::number(ui->comboBoxConsoleMinLevel->currentIndex())},
-        {"Logging/ConsoleMaxLevel", QString::number(ui->comboBoxConsoleMaxLevel->currentIndex())},
-        {"Logging/ConsoleChannels", ui->lineEditConsoleChannels->text()},
-        {"Logging/EnableFile", ui->checkBoxEnableFile->isChecked() ? "true" : "false"},
-        {"Logging/FileIncludeTimestamps", ui->checkBoxFileIncludeTimestamps->isChecked() ? "true" : "false"},
-        {"Logging/FileMinLevel", QString::number(ui->comboBoxFileMinLevel->currentIndex())},
-        {"Logging/FileMaxLevel", QString::number(ui->comboBoxFileMaxLevel->currentIndex())},
-        {"Logging/FileChannels", ui->lineEditFileChannels->text()},
-        {"Logging/FileSplitOutput", ui->checkBoxFileSplitOutput->isChecked() ? "true" : "false"},
-        {"Frontend/BindIP", ui->lineEditBindIP->text()},
-        {"Frontend/Port", ui->lineEditPort->text()},
-        {"Frontend/PublicAddress", ui->lineEditPublicAddress->text()},
-        {"Frontend/ReceiveTimeoutMS", ui->lineEditReceiveTimeoutMS->text()},
-        {"Frontend/SendTimeoutMS", ui->lineEditSendTimeoutMS->text()},
-        {"WebFrontend/Address", ui->lineEditWebFrontendAddress->text()},
-        {"WebFrontend/Port", ui->lineEditWebFrontendPort->text()},
-        {"WebFrontend/EnableLoginRateLimit", ui->checkBoxEnableLoginRateLimit->isChecked() ? "true" : "false"},
-        {"WebFrontend/LoginRateLimitCostMS", ui->lineEditLoginRateLimitCostMS->text()},
-        {"WebFrontend/LoginRateLimitBurst", ui->lineEditLoginRateLimitBurst->text()},
-        {"WebFrontend/EnableWebApi", ui->checkBoxEnableWebApi->isChecked() ? "true" : "false"},
-        {"WebFrontend/EnableDashboard", ui->checkBoxEnableDashboard->isChecked() ? "true" : "false"},
-        {"WebFrontend/DashboardFileDirectory", ui->lineEditDashboardFileDirectory->text()},
-        {"WebFrontend/DashboardUrlPath", ui->lineEditDashboardUrlPath->text()},
-        {"PlayerManager/EnablePersistence", ui->checkBoxEnablePersistence->isChecked() ? "true" : "false"},
-        {"PlayerManager/UseJsonDBManager", ui->checkBoxUseJsonDBManager->isChecked() ? "true" : "false"},
-        {"PlayerManager/AllowClientVersionMismatch", ui->checkBoxAllowClientVersionMismatch->isChecked() ? "true" : "false"},
-        {"PlayerManager/UseWhitelist", ui->checkBoxUseWhitelist->isChecked() ? "true" : "false"},
-        {"PlayerManager/ShowNewsOnLogin", ui->checkBoxShowNewsOnLogin->isChecked() ? "true" : "false"},
-        {"PlayerManager/NewsUrl", ui->lineEditNewsUrl->text()},
-        {"PlayerManager/ServerCapacity", ui->lineEditServerCapacity->text()},
-        {"PlayerManager/MaxLoginQueueClients", ui->lineEditMaxLoginQueueClients->text()},
-        {"SQLiteDBManager/FileName", ui->lineEditSQLiteFileName->text()},
-        {"SQLiteDBManager/MaxBackupNumber", ui->lineEditSQLiteMaxBackupNumber->text()},
-        {"SQLiteDBManager/BackupIntervalMinutes", ui->lineEditSQLiteBackupIntervalMinutes->text()},
-        {"JsonDBManager/FileName", ui->lineEditJsonFileName->text()},
-        {"JsonDBManager/MaxBackupNumber", ui->lineEditJsonMaxBackupNumber->text()},
-        {"JsonDBManager/BackupIntervalMinutes", ui->lineEditJsonBackupIntervalMinutes->text()},
-        {"JsonDBManager/PlayerName", ui->lineEditJsonPlayerName->text()},
-        {"GroupingManager/ServerName", ui->lineEditServerName->text()},
-        {"GroupingManager/MotdText", ui->textEditMotdText->toPlainText()},
-        {"GroupingManager/ServerPrestigeLevel", QString::number(ui->comboBoxServerPrestigeLevel->currentIndex())},
-        {"GroupingManager/LogTells", ui->checkBoxLogTells->isChecked() ? "true" : "false"},
-        {"GameInstance/NumWorkerThreads", ui->lineEditNumWorkerThreads->text()},
-        {"GameData/LoadAllPrototypes", ui->checkBoxLoadAllPrototypes->isChecked() ? "true" : "false"},
-        {"GameData/UseEquipmentSlotTableCache", ui->checkBoxUseEquipmentSlotTableCache->isChecked() ? "true" : "false"},
-        {"GameData/EnablePatchManager", ui->checkBoxEnablePatchManager->isChecked() ? "true" : "false"},
-        {"GameOptions/TeamUpSystemEnabled", ui->checkBoxTeamUpSystemEnabled->isChecked() ? "true" : "false"},
-        {"GameOptions/AchievementsEnabled", ui->checkBoxAchievementsEnabled->isChecked() ? "true" : "false"},
-        {"GameOptions/OmegaMissionsEnabled", ui->checkBoxOmegaMissionsEnabled->isChecked() ? "true" : "false"},
-        {"GameOptions/VeteranRewardsEnabled", ui->checkBoxVeteranRewardsEnabled->isChecked() ? "true" : "false"},
-        {"GameOptions/MultiSpecRewardsEnabled", ui->checkBoxMultiSpecRewardsEnabled->isChecked() ? "true" : "false"},
-        {"GameOptions/GiftingEnabled", ui->checkBoxGiftingEnabled->isChecked() ? "true" : "false"},
-        {"GameOptions/CharacterSelectV2Enabled", ui->checkBoxCharacterSelectV2Enabled->isChecked() ? "true" : "false"},
-        {"GameOptions/CommunityNewsV2Enabled", ui->checkBoxCommunityNewsV2Enabled->isChecked() ? "true" : "false"},
-        {"GameOptions/LeaderboardsEnabled", ui->checkBoxLeaderboardsEnabled->isChecked() ? "true" : "false"},
-        {"GameOptions/NewPlayerExperienceEnabled", ui->checkBoxNewPlayerExperienceEnabled->isChecked() ? "true" : "false"},
-        {"GameOptions/MissionTrackerV2Enabled", ui->checkBoxMissionTrackerV2Enabled->isChecked() ? "true" : "false"},
-        {"GameOptions/GiftingAccountAgeInDaysRequired", ui->lineEditGiftingAccountAgeInDaysRequired->text()},
-        {"GameOptions/GiftingAvatarLevelRequired", ui->lineEditGiftingAvatarLevelRequired->text()},
-        {"GameOptions/GiftingLoginCountRequired", ui->lineEditGiftingLoginCountRequired->text()},
-        {"GameOptions/InfinitySystemEnabled", ui->checkBoxInfinitySystemEnabled->isChecked() ? "true" : "false"},
-        {"GameOptions/ChatBanVoteAccountAgeInDaysRequired", ui->lineEditChatBanVoteAccountAgeInDaysRequired->text()},
-        {"GameOptions/ChatBanVoteAvatarLevelRequired", ui->lineEditChatBanVoteAvatarLevelRequired->text()},
-        {"GameOptions/ChatBanVoteLoginCountRequired", ui->lineEditChatBanVoteLoginCountRequired->text()},
-        {"GameOptions/IsDifficultySliderEnabled", ui->checkBoxIsDifficultySliderEnabled->isChecked() ? "true" : "false"},
-        {"GameOptions/OrbisTrophiesEnabled", ui->checkBoxOrbisTrophiesEnabled->isChecked() ? "true" : "false"},
-        {"CustomGameOptions/ESCooldownOverrideMinutes", ui->lineEditESCooldownOverrideMinutes->text()},
-        {"CustomGameOptions/CombineESStacks", ui->checkBoxCombineESStacks->isChecked() ? "true" : "false"},
-        {"CustomGameOptions/AutoUnlockAvatars", ui->checkBoxAutoUnlockAvatars->isChecked() ? "true" : "false"},
-        {"CustomGameOptions/AutoUnlockTeamUps", ui->checkBoxAutoUnlockTeamUps->isChecked() ? "true" : "false"},
-        {"CustomGameOptions/DisableMovementPowerChargeCost", ui->checkBoxDisableMovementPowerChargeCost->isChecked() ? "true" : "false"},
-        {"CustomGameOptions/AllowSameGroupTalents", ui->checkBoxAllowSameGroupTalents->isChecked() ? "true" : "false"},
-        {"CustomGameOptions/DisableInstancedLoot", ui->checkBoxDisableInstancedLoot->isChecked() ? "true" : "false"},
-        {"CustomGameOptions/LootSpawnGridCellRadius", ui->lineEditLootSpawnGridCellRadius->text()},
-        {"CustomGameOptions/TrashedItemExpirationTimeMultiplier", ui->lineEditTrashedItemExpirationTimeMultiplier->text()},
-        {"CustomGameOptions/DisableAccountBinding", ui->checkBoxDisableAccountBinding->isChecked() ? "true" : "false"},
-        {"CustomGameOptions/DisableCharacterBinding", ui->checkBoxDisableCharacterBinding->isChecked() ? "true" : "false"},
-        {"CustomGameOptions/UsePrestigeLootTable", ui->checkBoxUsePrestigeLootTable->isChecked() ? "true" : "false"},
-        {"MTXStore/GazillioniteBalanceForNewAccounts", ui->lineEditGazillioniteBalanceForNewAccounts->text()},
-        {"MTXStore/ESToGazillioniteConversionRatio", ui->lineEditESToGazillioniteConversionRatio->text()},
-        {"MTXStore/ESToGazillioniteConversionStep", ui->lineEditESToGazillioniteConversionStep->text()},
-        {"MTXStore/GiftingOmegaLevelRequired", ui->lineEditGiftingOmegaLevelRequired->text()},
-        {"MTXStore/GiftingInfinityLevelRequired", ui->lineEditGiftingInfinityLevelRequired->text()},
-        {"MTXStore/StoreHomePageUrl", ui->lineEditHomePageUrl->text()},
-        {"MTXStore/StoreHomeBannerPageUrl", ui->lineEditHomeBannerPageUrl->text()},
-        {"MTXStore/StoreHeroesBannerPageUrl", ui->lineEditHeroesBannerPageUrl->text()},
-        {"MTXStore/StoreCostumesBannerPageUrl", ui->lineEditCostumesBannerPageUrl->text()},
-        {"MTXStore/StoreBoostsBannerPageUrl", ui->lineEditBoostsBannerPageUrl->text()},
-        {"MTXStore/StoreChestsBannerPageUrl", ui->lineEditChestsBannerPageUrl->text()},
-        {"MTXStore/StoreSpecialsBannerPageUrl", ui->lineEditSpecialsBannerPageUrl->text()},
-        {"MTXStore/StoreRealMoneyUrl", ui->lineEditRealMoneyUrl->text()},
-        {"MTXStore/RewriteOriginalBundleUrls", ui->checkBoxRewriteOriginalBundleUrls->isChecked() ? "true" : "false"},
-        {"MTXStore/BundleInfoUrl", ui->lineEditBundleInfoUrl->text()},
-        {"MTXStore/BundleImageUrl", ui->lineEditBundleImageUrl->text()},
-        {"Leaderboards/DatabaseFile", ui->lineEditDatabaseFile->text()},
-        {"Leaderboards/ScheduleFile", ui->lineEditScheduleFile->text()},
-        {"Leaderboards/AutoSaveIntervalMinutes", ui->lineEditAutoSaveIntervalMinutes->text()},
-        };
-
-    // Write ONLY override values to ConfigOverride.ini
-    QFile outFile(configFilePath);
-    if (!outFile.open(QIODevice::WriteOnly | QIODevice::Text)) {
-        QMessageBox::critical(this, "Error", "Failed to write ConfigOverride.ini");
-        return;
-    }
-
-    QTextStream out(&outFile);
-
-    QString currentSection;
-
-    for (auto it = updatedSettings.begin(); it != updatedSettings.end(); ++it) {
-
-        QString fullKey = it.key();      // e.g. "Logging/EnableLogging"
-        QString value = it.value();
-
-        QString section = fullKey.section('/', 0, 0);      // "Logging"
-        QString key = fullKey.section('/', 1, 1);          // "EnableLogging"
-
-        // If starting a new INI section → write section header
-        if (section != currentSection) {
-            out << "\n[" << section << "]\n";
-            currentSection = section;
-        }
-
-        out << key << "=" << value << "\n";
-    }
-
-    outFile.close();
-    QMessageBox::information(this, "Success", "ConfigOverride.ini saved successfully!");
+    QString mhServerPath = ui->mhServerPathEdit->text();
+    if (mhServerPath.isEmpty()) {
+        QMessageBox::warning(this, "Error", "Please specify the MH Server path.");
+        return;
+    }
+    QString basePath = QDir(mhServerPath).filePath("MHServerEmu/config.ini");
+    QString overridePath = QDir(mhServerPath).filePath("MHServerEmu/ConfigOverride.ini");
+
+    // Values matching config.ini are left out, so later config.ini updates still reach this server
+    QSharedPointer<const QVariantMap> baseConfig = fileWatcher->iniValues(basePath);
+    if (!baseConfig) {
+        QMessageBox::warning(this, "Error", QString("Config file not found at: %1").arg(basePath));
+        return;
+    }
+
+    // Edits made outside the UI, comments and keys we don't know about are kept as they are
+    IniFile overrides;
+    if (QFile::exists(overridePath)) {
+        QString readError;
+        if (!overrides.load(overridePath, &readError)) {
+            QMessageBox::critical(this, "Error", QString("Failed to read ConfigOverride.ini: %1").arg(readError));
+            return;
+        }
+    }
+    const QStringList overridden = configSchema.applyTo(&overrides, *baseConfig);
+
+    QString errorMessage;
+    const QByteArray overrideText = overrides.toText();
+    if (AtomicFileWriter::write(overridePath, overrideText, &errorMessage) == AtomicFileWriter::Failed) {
+        QMessageBox::critical(this, "Error", QString("Failed to write ConfigOverride.ini: %1").arg(errorMessage));
+        return;
+    }
+    // The watcher sees this write too; it must not reload the tab over itself
+    savedOverrideHash = AtomicFileWriter::contentHash(overrideText);
+    loadedConfigValues = configSchema.widgetValues();
+
+    qDebug() << "ConfigOverride.ini overrides:" << overridden;
+    QMessageBox::information(this, "Success", QString("ConfigOverride.ini saved successfully! %1 setting(s) differ from config.ini.").arg(overridden.size()));
 }
 
 void MainWindow::onPushButtonUnBanClicked() {
-    if (serverProcess->state() != QProcess::Running) {
+    if (!activeInstance->isRunning()) {
         QMessageBox::warning(this, "Error", "Server is not running. Start the server first.");
         return;
     }
@@ -1441,30 +1654,765 @@ void MainWindow::onPushButtonUnBanClicked() {
     }
 
     QString command = QString("!account unban %1\n").arg(accountName);
-    serverProcess->write(command.toUtf8());
+    activeInstance->sendCommand(command);
     ui->ServerOutputEdit->append(QString("Sent command: %1").arg(command)); // Optional feedback
 }
 
 void MainWindow::updateServerStatus() {
-    // Check MHServerEmu.exe status
-    QProcess process;
-    process.start("tasklist", {"/fi", "imagename eq MHServerEmu.exe", "/nh"});
-    process.waitForFinished();
-    QString output = process.readAllStandardOutput().trimmed();
-    bool isMHServerRunning = output.contains("MHServerEmu.exe");
-    ui->mhServerStatusLabel->setPixmap(isMHServerRunning ? onPixmap : offPixmap);
-
-    // Check httpd.exe status
-    process.start("tasklist", {"/fi", "imagename eq httpd.exe", "/nh"});
-    process.waitForFinished();
-    output = process.readAllStandardOutput().trimmed();
-    bool isApacheRunning = output.contains("httpd.exe");
-    ui->apacheServerStatusLabel->setPixmap(isApacheRunning ? onPixmap : offPixmap);
+    // The instance owns both processes, so their state is known without polling tasklist
+    ui->mhServerStatusLabel->setPixmap(activeInstance->isRunning() ? onPixmap : offPixmap);
+    ui->apacheServerStatusLabel->setPixmap(activeInstance->isApacheRunning() ? onPixmap : offPixmap);
+}
+
+void MainWindow::connectInstance(ServerInstance *shard) {
+    QString capacityError;
+    if (!shard->capacityPlanner().setLogPath(capacityLogPath(shard), &capacityError)) {
+        qDebug() << "Capacity log for" << shard->name() << "couldn't be read:" << capacityError;
+    }
+
+    // Every shard runs its own console pipeline, only the active one drives the widgets
+    connect(shard, &ServerInstance::outputReceived, this, [this, shard](const QString &text, bool isError) {
+        if (shard != activeInstance) return;
+        ui->ServerOutputEdit->append(isError ? "<Error>: " + text : text);
+    });
+    connect(shard, &ServerInstance::playerLoggedIn, this, [this, shard](const QString &sessionId, const QString &accountName) {
+        if (shard != activeInstance) return;
+        addUserToList(accountName, sessionId);
+    });
+    connect(shard, &ServerInstance::playerLoggedOut, this, [this, shard](const QString &sessionId, const QString &accountName) {
+        if (shard != activeInstance) return;
+        removeUserFromList(sessionId);
+        qDebug() << "Logged out user removed:" << accountName << "SessionId:" << sessionId;
+    });
+    connect(shard, &ServerInstance::playerCountChanged, this, [this, shard]() {
+        if (shard != activeInstance) return;
+        updatePlayerCountLabel();
+    });
+    connect(shard, &ServerInstance::clientInfoReceived, this, [this, shard](const QString &info, const QString &username, const QString &email) {
+        if (shard != activeInstance) return;
+        displayUserInfo(info, username, email);
+    });
+    connect(shard, &ServerInstance::runningChanged, this, [this, shard]() {
+        if (shard != activeInstance) return;
+        updateServerStatus();
+        refreshConfigDrift();
+    });
+    connect(shard, &ServerInstance::processError, this, [this, shard]() {
+        if (shard != activeInstance) {
+            qDebug() << "Server process error on shard" << shard->name();
+            return;
+        }
+        handleServerError();
+    });
+}
+
+void MainWindow::setActiveInstance(ServerInstance *shard) {
+    if (!shard) return;
+
+    activeInstance = shard;
+    liveTuningModel->setStore(&shard->liveTuning());
+    updatePendingChangesLabel();
+    updateLiveTuningHistoryControls();
+    effectiveTuningModel->setSource(&shard->effectiveLiveTuning());
+    fileWatcher->setServerPath(shard->serverPath());
+    refreshConfigDrift();
+    updateCapacityReport();
+    ui->mhServerPathEdit->setText(shard->serverPath());
+    rebuildPrototypeIndex();
+    ui->userInfoDisplay->clear();
+    refreshLoggedInUsers();
+    updatePlayerCountLabel();
+    updateServerStatus();
+}
+
+ServerInstance *MainWindow::selectedShard() const {
+    int row = shardTable->currentRow();
+    if (row < 0 || row >= shardManager->instances().size()) {
+        return nullptr;
+    }
+    return shardManager->instances().at(row);
+}
+
+void MainWindow::setupShardDashboard() {
+    QWidget *shardTab = new QWidget();
+    QVBoxLayout *layout = new QVBoxLayout(shardTab);
+
+    shardTable = new QTableWidget(0, 7, shardTab);
+    shardTable->setHorizontalHeaderLabels({"Shard", "Path", "MHServerEmu", "Apache", "Players", "Lines/s", "Restarts"});
+    shardTable->setSelectionBehavior(QAbstractItemView::SelectRows);
+    shardTable->setSelectionMode(QAbstractItemView::SingleSelection);
+    shardTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    shardTable->horizontalHeader()->setSectionResizeMode(1, QHeaderView::Stretch);
+    shardTable->setStyleSheet("background: white; color: black;");
+    layout->addWidget(shardTable);
+
+    QHBoxLayout *shardButtons = new QHBoxLayout();
+    QPushButton *addButton = new QPushButton("Add Shard", shardTab);
+    QPushButton *removeButton = new QPushButton("Remove Shard", shardTab);
+    QPushButton *activateButton = new QPushButton("Set Active", shardTab);
+    QPushButton *executableButton = new QPushButton("Executable...", shardTab);
+    executableButton->setToolTip("Run another program instead of MHServerEmu.exe, e.g. the mock server for load tests.");
+    QPushButton *startButton = new QPushButton("Start", shardTab);
+    QPushButton *stopButton = new QPushButton("Stop", shardTab);
+    QPushButton *startAllButton = new QPushButton("Start All", shardTab);
+    QPushButton *stopAllButton = new QPushButton("Stop All", shardTab);
+    for (QPushButton *button : {addButton, removeButton, activateButton, executableButton, startButton, stopButton, startAllButton, stopAllButton}) {
+        shardButtons->addWidget(button);
+    }
+    layout->addLayout(shardButtons);
+
+    QHBoxLayout *fanOutLayout = new QHBoxLayout();
+    shardBroadcastEdit = new QLineEdit(shardTab);
+    shardBroadcastEdit->setPlaceholderText("Message to broadcast on every running shard");
+    QPushButton *broadcastButton = new QPushButton("Broadcast All", shardTab);
+    QPushButton *pushLiveTuningButton = new QPushButton("Push Live Tuning to All", shardTab);
+    pushLiveTuningButton->setToolTip("Copy the active shard's LiveTuningData.json to every shard and reload it.");
+    fanOutLayout->addWidget(shardBroadcastEdit);
+    fanOutLayout->addWidget(broadcastButton);
+    fanOutLayout->addWidget(pushLiveTuningButton);
+    layout->addLayout(fanOutLayout);
+
+    connect(addButton, &QPushButton::clicked, this, [this]() {
+        bool ok;
+        QString name = QInputDialog::getText(this, "Add Shard", "Shard name:", QLineEdit::Normal, QString(), &ok).trimmed();
+        if (!ok || name.isEmpty()) return;
+
+        QString dir = QFileDialog::getExistingDirectory(this, tr("Select MH Server Directory"), QDir::homePath(),
+                                                        QFileDialog::ShowDirsOnly | QFileDialog::DontResolveSymlinks);
+        if (dir.isEmpty()) return;
+
+        ServerInstance *shard = shardManager->addInstance(name, dir);
+        if (!shard) {
+            QMessageBox::warning(this, "Error", QString("A shard named %1 already exists.").arg(name));
+            return;
+        }
+        connectInstance(shard);
+        shardManager->save();
+    });
+
+    connect(removeButton, &QPushButton::clicked, this, [this]() {
+        ServerInstance *shard = selectedShard();
+        if (!shard) return;
+        if (shard == shardManager->primary()) {
+            QMessageBox::warning(this, "Error", "The primary shard can't be removed.");
+            return;
+        }
+        if (shard == activeInstance) {
+            setActiveInstance(shardManager->primary());
+        }
+        lastConsoleLines.remove(shard);
+        shardManager->removeInstance(shard);
+        shardManager->save();
+    });
+
+    connect(activateButton, &QPushButton::clicked, this, [this]() {
+        ServerInstance *shard = selectedShard();
+        if (!shard || shard == activeInstance) return;
+
+        setActiveInstance(shard);
+
+        // setActiveInstance already pointed the live tuning view at this shard
+        populateComboBox();
+        initializeEventStates();
+        ui->ServerOutputEdit->append(QString("Active shard: %1").arg(shard->name()));
+    });
+
+    connect(executableButton, &QPushButton::clicked, this, [this]() {
+        ServerInstance *shard = selectedShard();
+        if (!shard) return;
+
+        bool ok;
+        QString commandLine = QInputDialog::getText(this, "Server Executable",
+                                                    QString("Command line to run for %1 instead of MHServerEmu.exe.\nLeave empty to use %2.")
+                                                        .arg(shard->name(), shard->serverPath() + "/MHServerEmu/MHServerEmu.exe"),
+                                                    QLineEdit::Normal, shard->executableOverride(), &ok);
+        if (!ok) return;
+
+        shard->setExecutableOverride(commandLine);
+        shardManager->save();
+        refreshShardDashboard();
+        if (shard->isRunning()) {
+            ui->ServerOutputEdit->append(QString("%1 will run %2 after its next restart.").arg(shard->name(), shard->serverExecutable()));
+        }
+    });
+
+    connect(startButton, &QPushButton::clicked, this, [this]() {
+        ServerInstance *shard = selectedShard();
+        if (!shard) return;
+
+        QString errorMessage;
+        if (!shard->start(!shardManager->anyRunning(), &errorMessage)) {
+            QMessageBox::critical(this, "Error", QString("%1: %2").arg(shard->name(), errorMessage));
+        }
+    });
+
+    connect(stopButton, &QPushButton::clicked, this, [this]() {
+        if (ServerInstance *shard = selectedShard()) {
+            shard->stop();
+            if (shard == activeInstance) {
+                ui->listWidgetLoggedInUsers->clear();
+            }
+        }
+    });
+
+    connect(startAllButton, &QPushButton::clicked, this, [this]() {
+        bool killStrays = !shardManager->anyRunning();
+        QStringList failures;
+        for (ServerInstance *shard : shardManager->instances()) {
+            if (shard->isRunning()) continue;
+
+            QString errorMessage;
+            if (!shard->start(killStrays, &errorMessage)) {
+                failures.append(QString("%1: %2").arg(shard->name(), errorMessage));
+            }
+            killStrays = false;
+        }
+        if (!failures.isEmpty()) {
+            QMessageBox::warning(this, "Error", failures.join("\n"));
+        }
+    });
+
+    connect(stopAllButton, &QPushButton::clicked, this, [this]() {
+        for (ServerInstance *shard : shardManager->instances()) {
+            shard->stop();
+        }
+        ui->listWidgetLoggedInUsers->clear();
+    });
+
+    connect(broadcastButton, &QPushButton::clicked, this, [this]() {
+        QString message = shardBroadcastEdit->text().trimmed();
+        if (message.isEmpty()) return;
+
+        int reached = shardManager->broadcast(message);
+        ui->ServerOutputEdit->append(QString("Broadcast sent to %1 shard(s): %2").arg(reached).arg(message));
+        shardBroadcastEdit->clear();
+    });
+
+    connect(pushLiveTuningButton, &QPushButton::clicked, this, [this]() {
+        QFile file(activeInstance->liveTuningPath() + "LiveTuningData.json");
+        if (!file.open(QIODevice::ReadOnly)) {
+            QMessageBox::warning(this, "Error", QString("Could not open %1").arg(file.fileName()));
+            return;
+        }
+        shardManager->pushLiveTuningFile("LiveTuningData.json", file.readAll(), true);
+    });
+
+    ui->tabWidget->addTab(shardTab, "Shards");
+    dashboardClock.start();
+    refreshShardDashboard();
+}
+
+void MainWindow::setupEffectiveTuningView() {
+    QWidget *effectiveTab = new QWidget();
+    QVBoxLayout *layout = new QVBoxLayout(effectiveTab);
+
+    QHBoxLayout *controls = new QHBoxLayout();
+    QPushButton *refreshButton = new QPushButton("Load Effective Tuning", effectiveTab);
+    QCheckBox *conflictsOnlyBox = new QCheckBox("Conflicts only", effectiveTab);
+    effectiveTuningSummary = new QLabel(effectiveTab);
+    controls->addWidget(refreshButton);
+    controls->addWidget(conflictsOnlyBox);
+    controls->addWidget(effectiveTuningSummary, 1);
+    layout->addLayout(controls);
+
+    effectiveTuningModel = new EffectiveLiveTuningModel(this);
+    QSortFilterProxyModel *sortModel = new QSortFilterProxyModel(this);
+    sortModel->setSourceModel(effectiveTuningModel);
+
+    QTableView *effectiveView = new QTableView(effectiveTab);
+    effectiveView->setModel(sortModel);
+    effectiveView->setSortingEnabled(true);
+    effectiveView->sortByColumn(EffectiveLiveTuningModel::SettingColumn, Qt::AscendingOrder);
+    effectiveView->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    effectiveView->setSelectionBehavior(QAbstractItemView::SelectRows);
+    effectiveView->setWordWrap(false);
+    effectiveView->verticalHeader()->setVisible(false);
+    effectiveView->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+    effectiveView->verticalHeader()->setDefaultSectionSize(22);
+    effectiveView->horizontalHeader()->setStretchLastSection(true);
+    effectiveView->setColumnWidth(EffectiveLiveTuningModel::PrototypeColumn, 260);
+    effectiveView->setColumnWidth(EffectiveLiveTuningModel::SettingColumn, 240);
+    effectiveView->setStyleSheet("background: white; color: black;");
+    layout->addWidget(effectiveView);
+
+    connect(refreshButton, &QPushButton::clicked, this, &MainWindow::reloadEffectiveTuning);
+    connect(conflictsOnlyBox, &QCheckBox::toggled, effectiveTuningModel, &EffectiveLiveTuningModel::setConflictsOnly);
+    connect(effectiveTuningModel, &QAbstractItemModel::modelReset, this, [this]() {
+        const EffectiveLiveTuning &effective = activeInstance->effectiveLiveTuning();
+        effectiveTuningSummary->setText(QString("%1 active file(s), %2 setting(s), %3 conflict(s)")
+                                            .arg(effective.activeFiles().size())
+                                            .arg(effective.size())
+                                            .arg(effective.conflictCount()));
+    });
+
+    ui->tabWidget->addTab(effectiveTab, "Effective Tuning");
+}
+
+void MainWindow::setupPresetsView() {
+    QWidget *presetsTab = new QWidget();
+    QHBoxLayout *layout = new QHBoxLayout(presetsTab);
+
+    QVBoxLayout *listColumn = new QVBoxLayout();
+    presetList = new QListWidget(presetsTab);
+    presetList->setSelectionMode(QAbstractItemView::ExtendedSelection);
+    presetList->setStyleSheet("background: white; color: black;");
+    listColumn->addWidget(presetList, 1);
+
+    QPushButton *saveButton = new QPushButton("Save Current As...", presetsTab);
+    QPushButton *applyButton = new QPushButton("Apply", presetsTab);
+    QPushButton *compareButton = new QPushButton("Compare", presetsTab);
+    compareButton->setToolTip("One preset selected: compare with the live files. Two selected: compare them.");
+    QPushButton *deleteButton = new QPushButton("Delete", presetsTab);
+    listColumn->addWidget(saveButton);
+    listColumn->addWidget(applyButton);
+    listColumn->addWidget(compareButton);
+    listColumn->addWidget(deleteButton);
+    layout->addLayout(listColumn, 1);
+
+    presetDiffView = new QPlainTextEdit(presetsTab);
+    presetDiffView->setReadOnly(true);
+    presetDiffView->setLineWrapMode(QPlainTextEdit::NoWrap);
+    presetDiffView->setStyleSheet("background: white; color: black;");
+    layout->addWidget(presetDiffView, 3);
+
+    connect(saveButton, &QPushButton::clicked, this, &MainWindow::savePreset);
+    connect(applyButton, &QPushButton::clicked, this, &MainWindow::applyPreset);
+    connect(compareButton, &QPushButton::clicked, this, &MainWindow::comparePresets);
+    connect(deleteButton, &QPushButton::clicked, this, &MainWindow::deletePreset);
+    connect(presetList, &QListWidget::itemDoubleClicked, this, &MainWindow::comparePresets);
+
+    ui->tabWidget->addTab(presetsTab, "Presets");
+    refreshPresetList();
+}
+
+QString MainWindow::presetDirectory() const {
+    // Kept next to the executable like the bundled event files, so presets work for every shard
+    return QCoreApplication::applicationDirPath() + "/Presets/";
+}
+
+void MainWindow::refreshPresetList() {
+    presetList->clear();
+    QDir dir(presetDirectory());
+    const QFileInfoList presets = dir.entryInfoList({"*.mhtp"}, QDir::Files, QDir::Name);
+    for (const QFileInfo &info : presets) {
+        QListWidgetItem *item = new QListWidgetItem(info.completeBaseName(), presetList);
+        item->setToolTip(QString("%1, %2 KB").arg(info.lastModified().toString("yyyy-MM-dd HH:mm")).arg((info.size() + 1023) / 1024));
+    }
+}
+
+void MainWindow::savePreset() {
+    if (activeInstance->serverPath().isEmpty()) {
+        QMessageBox::warning(this, "Error", "Please specify the MH Server path.");
+        return;
+    }
+
+    bool ok;
+    QString name = QInputDialog::getText(this, "Save Preset", "Preset name (e.g. weekday, event weekend):",
+                                         QLineEdit::Normal, QString(), &ok).trimmed();
+    if (!ok || name.isEmpty()) {
+        return;
+    }
+    if (name.contains(QRegularExpression("[\\\\/:*?\"<>|]"))) {
+        QMessageBox::warning(this, "Error", "Preset names can't contain \\ / : * ? \" < > |");
+        return;
+    }
+
+    // Captures what is on disk; unsaved edits in the Live Tuning tab are not part of it
+    QByteArray snapshot;
+    QString errorMessage;
+    if (!TuningPreset::capture(activeInstance->liveTuningPath(), &snapshot, &errorMessage)) {
+        QMessageBox::critical(this, "Error", QString("Could not capture the live tuning files: %1").arg(errorMessage));
+        return;
+    }
+
+    QDir().mkpath(presetDirectory());
+    if (AtomicFileWriter::write(presetDirectory() + name + ".mhtp", snapshot, &errorMessage) == AtomicFileWriter::Failed) {
+        QMessageBox::critical(this, "Error", QString("Could not save the preset: %1").arg(errorMessage));
+        return;
+    }
+
+    refreshPresetList();
+    ui->ServerOutputEdit->append(QString("Saved live tuning preset \"%1\" (%2 bytes).").arg(name).arg(snapshot.size()));
+}
+
+void MainWindow::applyPreset() {
+    QListWidgetItem *item = presetList->currentItem();
+    if (!item) {
+        return;
+    }
+    if (activeInstance->serverPath().isEmpty()) {
+        QMessageBox::warning(this, "Error", "Please specify the MH Server path.");
+        return;
+    }
+
+    // The preset replaces the files under the editor, unsaved edits would be lost with them
+    LiveTuningStore &store = activeInstance->liveTuning();
+    if (store.dirtyCount() > 0) {
+        QMessageBox::StandardButton answer = QMessageBox::question(this, "Apply Preset",
+            QString("There are %1 unsaved live tuning change(s) that applying \"%2\" will discard. Continue?").arg(store.dirtyCount()).arg(item->text()));
+        if (answer != QMessageBox::Yes) {
+            return;
+        }
+    }
+
+    QElapsedTimer applyTimer;
+    applyTimer.start();
+
+    TuningPreset preset;
+    QString errorMessage;
+    if (!preset.open(presetDirectory() + item->text() + ".mhtp", &errorMessage)) {
+        QMessageBox::critical(this, "Error", QString("Could not open preset \"%1\": %2").arg(item->text(), errorMessage));
+        return;
+    }
+
+    // Write the preset's files; identical content is skipped by the writer
+    const QString dir = activeInstance->liveTuningPath();
+    QSet<QString> presetFiles;
+    QStringList failures;
+    int changedFiles = 0;
+    for (int i = 0; i < preset.fileCount(); ++i) {
+        const QString fileName = preset.fileName(i);
+        presetFiles.insert(fileName);
+        AtomicFileWriter::Result result = AtomicFileWriter::write(dir + fileName, preset.toStore(i).toJson(), &errorMessage);
+        if (result == AtomicFileWriter::Failed) {
+            failures.append(QString("%1: %2").arg(fileName, errorMessage));
+            continue;
+        }
+        if (result == AtomicFileWriter::Written) {
+            changedFiles++;
+        }
+        // Only one of an event's two files may exist, or toggling it later fails
+        QFile::remove(dir + "OFF_" + fileName);
+    }
+
+    // Files the preset doesn't have are disabled the same way the event switches do it
+    const QStringList activeFiles = QDir(dir).entryList({"LiveTuningData*.json"}, QDir::Files);
+    for (const QString &fileName : activeFiles) {
+        if (presetFiles.contains(fileName) || !EffectiveLiveTuning::isActiveFileName(fileName)) {
+            continue;
+        }
+        QFile::remove(dir + "OFF_" + fileName);
+        if (QFile::rename(dir + fileName, dir + "OFF_" + fileName)) {
+            changedFiles++;
+        } else {
+            failures.append(QString("%1: could not be disabled").arg(fileName));
+        }
+    }
+
+    // A loaded editor now shows the preset's values, with a fresh history
+    if (!store.isEmpty()) {
+        const QString category = ui->comboBoxCategory->currentText();
+        QSharedPointer<const LiveTuningStore> parsed = fileWatcher->liveTuning(dir + "LiveTuningData.json");
+        if (parsed) {
+            store = *parsed;
+            addToPrototypeIndex(store);
+        } else {
+            store.clear();
+            liveTuningModel->clearCategory();
+        }
+        activeInstance->liveTuningJournal().reset(store);
+        updatePendingChangesLabel();
+        updateLiveTuningHistoryControls();
+        populateComboBox();
+        ui->comboBoxCategory->setCurrentText(category);
+    }
+
+    qDebug() << "Applied preset" << item->text() << "in" << applyTimer.elapsed() << "ms," << changedFiles << "file(s) changed";
+
+    // All files are in place before the server is asked to reload, once
+    if (changedFiles > 0 && activeInstance->isRunning()) {
+        activeInstance->sendCommand("!server reloadlivetuning");
+        ui->ServerOutputEdit->append("Sent command: !server reloadlivetuning");
+    }
+    ui->ServerOutputEdit->append(QString("Applied live tuning preset \"%1\": %2 file(s) changed.").arg(item->text()).arg(changedFiles));
+
+    if (!failures.isEmpty()) {
+        QMessageBox::warning(this, "Preset", QString("Some files could not be updated:\n%1").arg(failures.join("\n")));
+    }
+}
+
+void MainWindow::comparePresets() {
+    const QList<QListWidgetItem *> selected = presetList->selectedItems();
+    if (selected.isEmpty() || selected.size() > 2) {
+        presetDiffView->setPlainText("Select one preset to compare with the live files, or two to compare with each other.");
+        return;
+    }
+
+    QElapsedTimer diffTimer;
+    diffTimer.start();
+
+    TuningPreset target;
+    QString errorMessage;
+    if (!target.open(presetDirectory() + selected.last()->text() + ".mhtp", &errorMessage)) {
+        presetDiffView->setPlainText(QString("Could not open preset \"%1\": %2").arg(selected.last()->text(), errorMessage));
+        return;
+    }
+
+    QString heading;
+    QVector<TuningPreset::FileDiff> diffs;
+    if (selected.size() == 2) {
+        TuningPreset source;
+        if (!source.open(presetDirectory() + selected.first()->text() + ".mhtp", &errorMessage)) {
+            presetDiffView->setPlainText(QString("Could not open preset \"%1\": %2").arg(selected.first()->text(), errorMessage));
+            return;
+        }
+        heading = QString("From \"%1\" to \"%2\"").arg(selected.first()->text(), selected.last()->text());
+        diffs = target.diffFrom(source);
+    } else {
+        heading = QString("Applying \"%1\" (saved %2) to the live files")
+                      .arg(selected.last()->text(), target.created().toString("yyyy-MM-dd HH:mm"));
+        diffs = target.diffFromFolder(activeInstance->liveTuningPath());
+    }
+
+    presetDiffView->setPlainText(QString("%1\n\n%2\n\n(compared in %3 ms)")
+                                     .arg(heading, TuningPreset::summarize(diffs))
+                                     .arg(diffTimer.elapsed()));
+}
+
+void MainWindow::deletePreset() {
+    QListWidgetItem *item = presetList->currentItem();
+    if (!item) {
+        return;
+    }
+    if (QMessageBox::question(this, "Delete Preset", QString("Delete preset \"%1\"?").arg(item->text())) != QMessageBox::Yes) {
+        return;
+    }
+
+    QFile::remove(presetDirectory() + item->text() + ".mhtp");
+    AtomicFileWriter::forget(presetDirectory() + item->text() + ".mhtp");
+    refreshPresetList();
+}
+
+void MainWindow::reloadEffectiveTuning() {
+    if (activeInstance->serverPath().isEmpty()) {
+        QMessageBox::warning(this, "Error", "Please specify the MH Server path.");
+        return;
+    }
+
+    EffectiveLiveTuning &effective = activeInstance->effectiveLiveTuning();
+    effective.setDirectory(activeInstance->liveTuningPath());
+
+    QElapsedTimer loadTimer;
+    loadTimer.start();
+    QStringList errors;
+    effective.reloadAll(&errors);
+    qDebug() << "Merged" << effective.activeFiles().size() << "live tuning files in" << loadTimer.elapsed() << "ms";
+
+    for (const QString &error : errors) {
+        ui->ServerOutputEdit->append(QString("Effective tuning: skipped %1").arg(error));
+    }
+    effectiveTuningModel->reload();
+}
+
+void MainWindow::setupFileWatcher() {
+    fileWatcher = new TuningFileWatcher(this);
+    connect(fileWatcher, &TuningFileWatcher::liveTuningFileChanged, this, &MainWindow::onLiveTuningFileChanged);
+    connect(fileWatcher, &TuningFileWatcher::configFileChanged, this, &MainWindow::onConfigFileChanged);
+}
+
+void MainWindow::onLiveTuningFileChanged(const QString &fileName, QSharedPointer<const LiveTuningStore> parsed, const QByteArray &hash) {
+    // The effective view takes the already parsed file, nothing else is re-read
+    EffectiveLiveTuning &effective = activeInstance->effectiveLiveTuning();
+    if (!effective.directory().isEmpty() && effective.directory() == activeInstance->liveTuningPath()) {
+        effective.applyFile(fileName, parsed.data());
+        effectiveTuningModel->reload();
+    }
+
+    if (parsed) {
+        addToPrototypeIndex(*parsed);
+    }
+    if (EventRegistry::isEventFileName(fileName) && !eventChanges.isStaged(fileName)) {
+        if (eventRegistry.indexOf(fileName) >= 0) {
+            syncEventState(fileName, !parsed.isNull());
+        } else if (parsed) {
+            initializeEventStates(); // An event nobody has seen yet
+        }
+    }
+    if (fileName != "LiveTuningData.json" || !parsed) {
+        return;
+    }
+
+    LiveTuningStore &store = activeInstance->liveTuning();
+    if (store.isEmpty()) {
+        return; // Not loaded in the editor
+    }
+    if (store.dirtyCount() > 0) {
+        ui->ServerOutputEdit->append("LiveTuningData.json changed on disk; unsaved edits were kept. Save or reload to resolve.");
+        return;
+    }
+    if (AtomicFileWriter::contentHash(store.toJson()) == hash) {
+        return; // Our own save coming back
+    }
+
+    QString category = ui->comboBoxCategory->currentText();
+    store = *parsed;
+    activeInstance->liveTuningJournal().reset(store);
+    updateLiveTuningHistoryControls();
+    populateComboBox();
+    ui->comboBoxCategory->setCurrentText(category);
+    ui->ServerOutputEdit->append("LiveTuningData.json changed on disk and was reloaded.");
+}
+
+void MainWindow::onConfigFileChanged(const QString &path) {
+    // Only the keys this file moved are compared against the launch snapshot
+    QSharedPointer<const QVariantMap> values = fileWatcher->iniValues(path);
+    const QVariantMap fileValues = values ? *values : QVariantMap();
+    const QStringList moved = path == fileWatcher->configPath()
+        ? currentConfig.setBase(fileValues, fileWatcher->fileHash(path))
+        : currentConfig.setOverrides(fileValues, fileWatcher->fileHash(path));
+    if (activeInstance->isRunning() && !moved.isEmpty()) {
+        const int restartsBefore = configDrift.restartCount();
+        configDrift.update(moved, currentConfig);
+        updateConfigDriftView();
+        if (configDrift.restartCount() > restartsBefore) {
+            ui->ServerOutputEdit->append(QString("%1 setting(s) changed since the server started need a restart to apply.").arg(configDrift.restartCount()));
+        }
+    }
+
+    if (!configLoaded) {
+        return;
+    }
+    if (path == fileWatcher->configOverridePath() && fileWatcher->fileHash(path) == savedOverrideHash) {
+        return; // Our own save coming back
+    }
+
+    const QString fileName = QFileInfo(path).fileName();
+    if (configSchema.widgetValues() != loadedConfigValues) {
+        const QMessageBox::StandardButton answer = QMessageBox::question(
+            this, "Config changed on disk",
+            QString("%1 changed on disk, but the Config tab has unsaved edits.\n\nReload it and discard your edits?").arg(fileName),
+            QMessageBox::Yes | QMessageBox::No, QMessageBox::No);
+        if (answer != QMessageBox::Yes) {
+            ui->ServerOutputEdit->append(QString("%1 changed on disk; unsaved Config tab edits were kept. Saving will write them over it.").arg(fileName));
+            return;
+        }
+    }
+
+    loadConfigFiles(fileWatcher->configPath(), fileWatcher->configOverridePath());
+    ui->ServerOutputEdit->append(QString("%1 changed on disk and the config was reloaded.").arg(fileName));
+}
+
+void MainWindow::setupConfigDriftView() {
+    QWidget *driftTab = new QWidget();
+    QVBoxLayout *layout = new QVBoxLayout(driftTab);
+
+    configDriftSummary = new QLabel(driftTab);
+    configDriftSummary->setWordWrap(true);
+    layout->addWidget(configDriftSummary);
+
+    configDriftTable = new QTableWidget(0, 4, driftTab);
+    configDriftTable->setHorizontalHeaderLabels({"Setting", "At Launch", "Now", "Applies"});
+    configDriftTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    configDriftTable->setSelectionBehavior(QAbstractItemView::SelectRows);
+    configDriftTable->verticalHeader()->setVisible(false);
+    configDriftTable->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    layout->addWidget(configDriftTable);
+
+    ui->tabWidget->addTab(driftTab, "Config Changes");
+    updateConfigDriftView();
+}
+
+void MainWindow::refreshConfigDrift() {
+    // Rebuilt from the watcher's cached parses, the files are only read if they changed
+    currentConfig = EffectiveConfig();
+    const QString basePath = fileWatcher->configPath();
+    const QString overridePath = fileWatcher->configOverridePath();
+    if (!basePath.isEmpty()) {
+        if (QSharedPointer<const QVariantMap> base = fileWatcher->iniValues(basePath)) {
+            currentConfig.setBase(*base, fileWatcher->fileHash(basePath));
+        }
+        if (QSharedPointer<const QVariantMap> overrides = fileWatcher->iniValues(overridePath)) {
+            currentConfig.setOverrides(*overrides, fileWatcher->fileHash(overridePath));
+        }
+    }
+
+    if (activeInstance->isRunning()) {
+        configDrift.reset(activeInstance->launchConfig(), currentConfig);
+    } else {
+        configDrift.clear();
+    }
+    updateConfigDriftView();
+}
+
+void MainWindow::updateConfigDriftView() {
+    if (!configDriftTable) return;
+
+    if (!activeInstance || !activeInstance->isRunning()) {
+        configDriftSummary->setText("The server isn't running; it will start with the config on disk.");
+    } else if (configDrift.isEmpty()) {
+        configDriftSummary->setText("The server is running with the config on disk.");
+    } else {
+        configDriftSummary->setText(QString("%1 setting(s) changed since the server started: %2 need a restart, %3 apply without one.")
+                                        .arg(configDrift.count()).arg(configDrift.restartCount()).arg(configDrift.liveCount()));
+    }
+
+    const QVector<ConfigDrift::Change> changes = configDrift.sortedChanges();
+    configDriftTable->setRowCount(changes.size());
+    for (int row = 0; row < changes.size(); ++row) {
+        const ConfigDrift::Change &change = changes.at(row);
+        configDriftTable->setItem(row, 0, new QTableWidgetItem(change.key));
+        configDriftTable->setItem(row, 1, new QTableWidgetItem(change.launchPresent ? change.launchValue : QString("(not set)")));
+        configDriftTable->setItem(row, 2, new QTableWidgetItem(change.currentPresent ? change.currentValue : QString("(not set)")));
+        configDriftTable->setItem(row, 3, new QTableWidgetItem(change.impact == ConfigDrift::Live ? QString("Live") : QString("Restart")));
+    }
+}
+
+void MainWindow::refreshShardDashboard() {
+    if (!shardTable) return;
+
+    const QList<ServerInstance *> &shards = shardManager->instances();
+    const double elapsedSeconds = qMax<qint64>(dashboardClock.restart(), 1) / 1000.0;
+
+    // One row per shard plus the aggregate row
+    if (shardTable->rowCount() != shards.size() + 1) {
+        shardTable->setRowCount(shards.size() + 1);
+        for (int row = 0; row < shardTable->rowCount(); ++row) {
+            for (int column = 0; column < shardTable->columnCount(); ++column) {
+                if (!shardTable->item(row, column)) {
+                    shardTable->setItem(row, column, new QTableWidgetItem());
+                }
+            }
+        }
+    }
+
+    int totalPlayers = 0;
+    double totalRate = 0.0;
+    int runningCount = 0;
+    for (int row = 0; row < shards.size(); ++row) {
+        ServerInstance *shard = shards.at(row);
+        const ServerMetrics &metrics = shard->metrics();
+
+        quint64 lines = metrics.consoleLinesTotal.load(std::memory_order_relaxed);
+        double rate = (lines - lastConsoleLines.value(shard, lines)) / elapsedSeconds;
+        lastConsoleLines[shard] = lines;
+        quint64 starts = metrics.serverStartsTotal.load(std::memory_order_relaxed);
+
+        totalPlayers += shard->playerCount();
+        totalRate += rate;
+        runningCount += shard->isRunning() ? 1 : 0;
+
+        shardTable->item(row, 0)->setText(shard == activeInstance ? shard->name() + " *" : shard->name());
+        shardTable->item(row, 1)->setText(shard->executableOverride().isEmpty() ? shard->serverPath() : shard->serverPath() + " (" + shard->executableOverride() + ")");
+        shardTable->item(row, 2)->setText(shard->isRunning() ? "Running" : "Stopped");
+        shardTable->item(row, 3)->setText(shard->isApacheRunning() ? "Running" : "Stopped");
+        shardTable->item(row, 4)->setText(QString::number(shard->playerCount()));
+        shardTable->item(row, 5)->setText(QString::number(rate, 'f', 1));
+        shardTable->item(row, 6)->setText(QString::number(starts > 0 ? starts - 1 : 0));
+    }
+
+    int totalRow = shards.size();
+    shardTable->item(totalRow, 0)->setText("Total");
+    shardTable->item(totalRow, 1)->setText(QString("%1 shard(s)").arg(shards.size()));
+    shardTable->item(totalRow, 2)->setText(QString("%1 running").arg(runningCount));
+    shardTable->item(totalRow, 3)->setText(QString());
+    shardTable->item(totalRow, 4)->setText(QString::number(totalPlayers));
+    shardTable->item(totalRow, 5)->setText(QString::number(totalRate, 'f', 1));
+    shardTable->item(totalRow, 6)->setText(QString());
 }
 
 void MainWindow::onPushButtonSendToServerClicked() {
     // Ensure the server is running
-    if (serverProcess->state() != QProcess::Running) {
+    if (!activeInstance->isRunning()) {
         QMessageBox::warning(this, "Error", "Server is not running.");
         return;
     }
@@ -1479,7 +2427,7 @@ void MainWindow::onPushButtonSendToServerClicked() {
     }
 
     // Send the command to the server
-    serverProcess->write(command.toUtf8() + "\n");
+    activeInstance->sendCommand(command);
     ui->ServerOutputEdit->append("Sent command to server: " + command);
 
     // Clear the lineEditSendToServer after sending
@@ -1487,89 +2435,212 @@ void MainWindow::onPushButtonSendToServerClicked() {
 }
 
 void MainWindow::initializeEventStates() {
-    QSettings settings("PTM", "MHServerEmuUI");
-
-    int cosmicChaosState = settings.value("CosmicChaosEvent", 0).toInt();
-    ui->horizontalSliderCosmicChaosSwitch->blockSignals(true);
-    ui->horizontalSliderCosmicChaosSwitch->setValue(cosmicChaosState);
-    ui->horizontalSliderCosmicChaosSwitch->blockSignals(false);
+    // The folder is the source of truth; the saved states only cover a path that isn't set yet
+    eventRegistry.rebuild(activeInstance->serverPath().isEmpty() ? QString() : activeInstance->liveTuningPath(), shippedEventFiles);
 
-    int armorIncursionState = settings.value("ArmorIncursionEvent", 0).toInt();
-    ui->horizontalSliderArmorIncursionSwitch->blockSignals(true);
-    ui->horizontalSliderArmorIncursionSwitch->setValue(armorIncursionState);
-    ui->horizontalSliderArmorIncursionSwitch->blockSignals(false);
-
-    int midtownMadnessState = settings.value("MidtownMadnessEvent", 0).toInt();
-    ui->horizontalSliderMidtownMadnessSwitch->blockSignals(true);
-    ui->horizontalSliderMidtownMadnessSwitch->setValue(midtownMadnessState);
-    ui->horizontalSliderMidtownMadnessSwitch->blockSignals(false);
-
-    int odinsBountyState = settings.value("OdinsBountyEvent", 0).toInt();
-    ui->horizontalSliderOdinsBountySwitch->blockSignals(true);
-    ui->horizontalSliderOdinsBountySwitch->setValue(odinsBountyState);
-    ui->horizontalSliderOdinsBountySwitch->blockSignals(false);
+    QSettings settings("PTM", "MHServerEmuUI");
+    for (auto it = eventSwitches.constBegin(); it != eventSwitches.constEnd(); ++it) {
+        const int index = eventRegistry.indexOf(it.key());
+        const bool active = index >= 0 && eventRegistry.at(index).present
+                                ? eventRegistry.at(index).active
+                                : settings.value(EventCalendar::eventName(it.key()) + "Event", 0).toInt() == 1;
+        it.value()->blockSignals(true);
+        it.value()->setValue(active ? 1 : 0);
+        it.value()->blockSignals(false);
+    }
+    refreshEventList();
+}
 
-    int PandemoniumProtocolState = settings.value("PandemoniumProtocolEvent", 0).toInt();
-    ui->horizontalSliderPandemoniumProtocolSwitch->blockSignals(true);
-    ui->horizontalSliderPandemoniumProtocolSwitch->setValue(PandemoniumProtocolState);
-    ui->horizontalSliderPandemoniumProtocolSwitch->blockSignals(false);
+void MainWindow::onEventSwitchChanged(const QString &eventName, int value) {
+    const QString fileName = "LiveTuningData_" + eventName + ".json";
+    if (stageEventsBox->isChecked()) {
+        stageEventSwitch({eventName, fileName, value == 1, true}, qobject_cast<QSlider *>(sender()));
+        return;
+    }
+    switchEvent(eventName, fileName, value == 1);
 }
 
-void MainWindow::onEventSwitchChanged(const QString &eventName, int value) {
+void MainWindow::switchEvent(const QString &eventName, const QString &fileName, bool enable) {
     // Save the state using QSettings
     QSettings settings("PTM", "MHServerEmuUI");
-    settings.setValue(eventName + "Event", value);
+    settings.setValue(eventName + "Event", enable ? 1 : 0);
 
     // Define the file paths
-    QString serverPath = ui->mhServerPathEdit->text() + "/MHServerEmu/Data/Game/LiveTuning/";
-    QString activeFilePath = serverPath + "LiveTuningData_" + eventName + ".json";
-    QString inactiveFilePath = serverPath + "OFF_LiveTuningData_" + eventName + ".json";
+    QString serverPath = activeInstance->liveTuningPath();
+    QString activeFilePath = serverPath + fileName;
+    QString inactiveFilePath = serverPath + "OFF_" + fileName;
 
     QFile activeFile(activeFilePath);
     QFile inactiveFile(inactiveFilePath);
 
-    if (value == 1) {
+    // Any failure leaves the switch showing what the folder actually has
+    auto fail = [&](QMessageBox::Icon icon, const QString &message) {
+        syncEventState(fileName, QFile::exists(activeFilePath));
+        if (icon == QMessageBox::Critical) {
+            QMessageBox::critical(this, "Error", message);
+        } else {
+            QMessageBox::warning(this, "Error", message);
+        }
+    };
+
+    if (enable) {
         // Enabling event
         if (!inactiveFile.exists()) {
-            QMessageBox::warning(this, "Error", QString("Inactive file not found: %1").arg(inactiveFilePath));
+            fail(QMessageBox::Warning, QString("Inactive file not found: %1").arg(inactiveFilePath));
             return;
         }
         if (!inactiveFile.rename(activeFilePath)) {
-            QMessageBox::critical(this, "Error", QString("Failed to enable the event: %1").arg(inactiveFile.errorString()));
+            fail(QMessageBox::Critical, QString("Failed to enable the event: %1").arg(inactiveFile.errorString()));
             return;
         }
     } else {
         // Disabling event
         if (!activeFile.exists()) {
-            QMessageBox::warning(this, "Error", QString("Active file not found: %1").arg(activeFilePath));
+            fail(QMessageBox::Warning, QString("Active file not found: %1").arg(activeFilePath));
             return;
         }
         if (!activeFile.rename(inactiveFilePath)) {
-            QMessageBox::critical(this, "Error", QString("Failed to disable the event: %1").arg(activeFile.errorString()));
+            fail(QMessageBox::Critical, QString("Failed to disable the event: %1").arg(activeFile.errorString()));
             return;
         }
     }
+    syncEventState(fileName, enable);
 
     // Send broadcast message
-    QString broadcastMessage = (value == 1)
+    QString broadcastMessage = enable
                                    ? QString("The %1 Event has started!").arg(eventName)
                                    : QString("The %1 Event has ended!").arg(eventName);
-    if (serverProcess->state() == QProcess::Running) {
-        serverProcess->write(QString("!server broadcast %1\n").arg(broadcastMessage).toUtf8());
+    if (activeInstance->isRunning()) {
+        activeInstance->sendCommand(QString("!server broadcast %1").arg(broadcastMessage));
         ui->ServerOutputEdit->append(QString("Sent broadcast message: %1").arg(broadcastMessage));
-        serverProcess->write("!server reloadlivetuning\n");
+        activeInstance->sendCommand("!server reloadlivetuning");
         ui->ServerOutputEdit->append("Sent command: !server reloadlivetuning");
     } else {
         QMessageBox::warning(this, "Error", "Server is not running.");
     }
 
     // Log the status
-    ui->ServerOutputEdit->append(QString("%1 event %2.").arg(eventName, (value == 1) ? "enabled" : "disabled"));
+    ui->ServerOutputEdit->append(QString("%1 event %2.").arg(eventName, enable ? "enabled" : "disabled"));
+}
+
+void MainWindow::syncEventState(const QString &fileName, bool active) {
+    const int index = eventRegistry.indexOf(fileName);
+    if (index >= 0) {
+        eventRegistry.setActive(index, active);
+        if (eventTable && index < eventTable->rowCount()) {
+            eventTable->blockSignals(true);
+            eventTable->item(index, 0)->setCheckState(active ? Qt::Checked : Qt::Unchecked);
+            eventTable->blockSignals(false);
+        }
+    }
+
+    QSlider *eventSwitch = eventSwitches.value(EventRegistry::activeFileName(fileName));
+    if (eventSwitch) {
+        eventSwitch->blockSignals(true);
+        eventSwitch->setValue(active ? 1 : 0);
+        eventSwitch->blockSignals(false);
+    }
+}
+
+void MainWindow::setupEventList() {
+    QString manifestError;
+    for (const EventFileProvisioner::ManifestEntry &entry : EventFileProvisioner::loadManifest(EventFileProvisioner::ManifestPath, &manifestError)) {
+        shippedEventFiles.append(entry.fileName);
+    }
+
+    QWidget *eventsTab = new QWidget();
+    QVBoxLayout *layout = new QVBoxLayout(eventsTab);
+
+    QHBoxLayout *controls = new QHBoxLayout();
+    eventFilterEdit = new QLineEdit(eventsTab);
+    eventFilterEdit->setPlaceholderText("Filter events");
+    eventFilterEdit->setClearButtonEnabled(true);
+    QPushButton *rescanButton = new QPushButton("Rescan Folder", eventsTab);
+    eventListSummary = new QLabel(eventsTab);
+    controls->addWidget(eventFilterEdit);
+    controls->addWidget(rescanButton);
+    controls->addWidget(eventListSummary, 1);
+    layout->addLayout(controls);
+
+    eventTable = new QTableWidget(0, 4, eventsTab);
+    eventTable->setHorizontalHeaderLabels({"On", "Event", "File", "Source"});
+    eventTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    eventTable->setSelectionBehavior(QAbstractItemView::SelectRows);
+    eventTable->verticalHeader()->setVisible(false);
+    eventTable->verticalHeader()->setDefaultSectionSize(22);
+    eventTable->horizontalHeader()->setStretchLastSection(true);
+    eventTable->setColumnWidth(0, 40);
+    eventTable->setColumnWidth(1, 240);
+    eventTable->setColumnWidth(2, 360);
+    eventTable->setStyleSheet("background: white; color: black;");
+    layout->addWidget(eventTable);
+
+    // Rows are in registry order, so the row is the registry index
+    connect(eventTable, &QTableWidget::itemChanged, this, [this](QTableWidgetItem *item) {
+        if (item->column() == 0 && item->row() < eventRegistry.size()) {
+            toggleRegistryEvent(item->row(), item->checkState() == Qt::Checked);
+        }
+    });
+    connect(eventFilterEdit, &QLineEdit::textChanged, this, &MainWindow::applyEventFilter);
+    connect(rescanButton, &QPushButton::clicked, this, &MainWindow::initializeEventStates);
+
+    ui->tabWidget->addTab(eventsTab, "All Events");
+}
+
+void MainWindow::refreshEventList() {
+    if (!eventTable) {
+        return;
+    }
+
+    eventTable->blockSignals(true);
+    eventTable->setRowCount(eventRegistry.size());
+    int activeCount = 0;
+    for (int row = 0; row < eventRegistry.size(); ++row) {
+        const EventRegistry::Event &event = eventRegistry.at(row);
+        QTableWidgetItem *stateItem = new QTableWidgetItem();
+        stateItem->setFlags(event.present ? Qt::ItemIsEnabled | Qt::ItemIsSelectable | Qt::ItemIsUserCheckable : Qt::ItemIsSelectable);
+        stateItem->setCheckState(event.active ? Qt::Checked : Qt::Unchecked);
+        eventTable->setItem(row, 0, stateItem);
+        eventTable->setItem(row, 1, new QTableWidgetItem(event.name));
+        eventTable->setItem(row, 2, new QTableWidgetItem(event.fileName));
+        eventTable->setItem(row, 3, new QTableWidgetItem(!event.present ? QString("Shipped, not installed")
+                                                         : event.shipped ? QString("Shipped")
+                                                                         : QString("Folder")));
+        activeCount += event.active ? 1 : 0;
+    }
+    eventTable->blockSignals(false);
+
+    eventListSummary->setText(QString("%1 event(s), %2 active").arg(eventRegistry.size()).arg(activeCount));
+    applyEventFilter();
+}
+
+void MainWindow::applyEventFilter() {
+    const QString filter = eventFilterEdit->text().trimmed();
+    for (int row = 0; row < eventTable->rowCount(); ++row) {
+        eventTable->setRowHidden(row, !filter.isEmpty() && !eventRegistry.at(row).name.contains(filter, Qt::CaseInsensitive));
+    }
+}
+
+void MainWindow::toggleRegistryEvent(int index, bool enable) {
+    const EventRegistry::Event &event = eventRegistry.at(index);
+
+    // Events with a dedicated switch go through it, so they keep their own behaviour
+    QSlider *eventSwitch = eventSwitches.value(event.fileName);
+    if (eventSwitch) {
+        eventSwitch->setValue(enable ? 1 : 0);
+        return;
+    }
+
+    if (stageEventsBox->isChecked()) {
+        stageEventSwitch({event.name, event.fileName, enable, true}, nullptr);
+        return;
+    }
+    switchEvent(event.name, event.fileName, enable);
 }
 
 void MainWindow::onCustomEventSwitchChanged(int eventIndex, int value) {
     // Get the corresponding line edit based on eventIndex
-    QLineEdit *eventLineEdit = findChild<QLineEdit *>(QString("LineEditCustomEvent%1").arg(eventIndex));
+    QLineEdit *eventLineEdit = customEventEdits[eventIndex - 1];
     if (!eventLineEdit) {
         QMessageBox::warning(this, "Error", "Failed to find the event name input field.");
         return;
@@ -1581,8 +2652,13 @@ void MainWindow::onCustomEventSwitchChanged(int eventIndex, int value) {
         return;
     }
 
+    if (stageEventsBox->isChecked()) {
+        stageEventSwitch({eventFileName, eventFileName, value == 1, false}, qobject_cast<QSlider *>(sender()));
+        return;
+    }
+
     // Define the server folder
-    QString serverPath = ui->mhServerPathEdit->text() + "/MHServerEmu/Data/Game/LiveTuning/";
+    QString serverPath = activeInstance->liveTuningPath();
     QString activeFilePath = serverPath + eventFileName;
     QString inactiveFilePath = serverPath + "OFF_" + eventFileName;
 
@@ -1611,19 +2687,464 @@ void MainWindow::onCustomEventSwitchChanged(int eventIndex, int value) {
         }
     }
 
+    syncEventState(eventFileName, value == 1);
+
     // Notify user and update log
     QString status = (value == 1) ? "enabled" : "disabled";
     ui->ServerOutputEdit->append(QString("Custom Event %1 %2.").arg(eventFileName, status));
 
     // Reload live tuning if server is running
-    if (serverProcess->state() == QProcess::Running) {
-        serverProcess->write("!server reloadlivetuning\n");
+    if (activeInstance->isRunning()) {
+        activeInstance->sendCommand("!server reloadlivetuning");
+        ui->ServerOutputEdit->append("Sent command: !server reloadlivetuning");
+    } else {
+        QMessageBox::warning(this, "Error", "Server is not running.");
+    }
+}
+
+void MainWindow::setupEventStaging()
+{
+    QGroupBox *stagingBox = new QGroupBox("Staged Changes", ui->tab_4);
+    stagingBox->setGeometry(510, 520, 531, 81);
+
+    stageEventsBox = new QCheckBox("Stage switch changes", stagingBox);
+    stageEventsBox->setGeometry(10, 22, 171, 20);
+    stageEventsBox->setToolTip("Collect event switches and apply them together with a single live tuning reload");
+    stagedEventsLabel = new QLabel(stagingBox);
+    stagedEventsLabel->setGeometry(10, 48, 171, 20);
+
+    previewEventsButton = new QPushButton("Preview...", stagingBox);
+    previewEventsButton->setGeometry(190, 30, 101, 31);
+    applyEventsButton = new QPushButton("Apply", stagingBox);
+    applyEventsButton->setGeometry(300, 30, 101, 31);
+    discardEventsButton = new QPushButton("Discard", stagingBox);
+    discardEventsButton->setGeometry(410, 30, 101, 31);
+
+    QSettings settings("PTM", "MHServerEmuUI");
+    stageEventsBox->setChecked(settings.value("StageEventChanges", false).toBool());
+
+    connect(stageEventsBox, &QCheckBox::toggled, this, [this](bool checked) {
+        QSettings("PTM", "MHServerEmuUI").setValue("StageEventChanges", checked);
+        if (!checked && !eventChanges.isEmpty()) {
+            discardEventChanges();
+            ui->ServerOutputEdit->append("Staged event changes discarded.");
+        }
+    });
+    connect(previewEventsButton, &QPushButton::clicked, this, &MainWindow::previewEventChanges);
+    connect(applyEventsButton, &QPushButton::clicked, this, &MainWindow::applyEventChanges);
+    connect(discardEventsButton, &QPushButton::clicked, this, &MainWindow::discardEventChanges);
+    updateEventStagingControls();
+}
+
+void MainWindow::updateEventStagingControls()
+{
+    const bool pending = !eventChanges.isEmpty();
+    stagedEventsLabel->setText(pending ? QString("%1 change(s) staged").arg(eventChanges.size()) : QString("No changes staged"));
+    previewEventsButton->setEnabled(pending);
+    applyEventsButton->setEnabled(pending);
+    discardEventsButton->setEnabled(pending);
+}
+
+void MainWindow::stageEventSwitch(const EventChangeSet::Change &change, QSlider *eventSwitch)
+{
+    // Changes staged for another server would be renamed in the wrong folder
+    if (eventChanges.directory() != activeInstance->liveTuningPath()) {
+        discardEventChanges();
+        eventChanges.setDirectory(activeInstance->liveTuningPath());
+    }
+
+    eventChanges.stage(change);
+    if (eventChanges.isStaged(change.fileName)) {
+        if (eventSwitch) {
+            stagedEventSwitches.insert(change.fileName, eventSwitch);
+        }
+    } else {
+        stagedEventSwitches.remove(change.fileName);
+    }
+    updateEventStagingControls();
+}
+
+void MainWindow::discardEventChanges()
+{
+    // Put the switches back to what the folder still has
+    for (const EventChangeSet::Change &change : eventChanges.changes()) {
+        QSlider *eventSwitch = stagedEventSwitches.value(change.fileName);
+        if (eventSwitch) {
+            eventSwitch->blockSignals(true);
+            eventSwitch->setValue(change.enable ? 0 : 1);
+            eventSwitch->blockSignals(false);
+        }
+        syncEventState(change.fileName, !change.enable);
+    }
+    eventChanges.clear();
+    stagedEventSwitches.clear();
+    updateEventStagingControls();
+}
+
+void MainWindow::previewEventChanges()
+{
+    if (eventChanges.isEmpty()) {
+        return;
+    }
+
+    // The instance's table is kept current by the file watcher once it has been loaded
+    EffectiveLiveTuning current = activeInstance->effectiveLiveTuning();
+    QStringList errors;
+    if (current.directory() != eventChanges.directory()) {
+        current.setDirectory(eventChanges.directory());
+        current.reloadAll(&errors);
+    }
+    const QVector<EventChangeSet::ValueChange> changes = eventChanges.preview(current, &errors);
+
+    QStringList renames;
+    for (const EventChangeSet::Change &change : eventChanges.changes()) {
+        renames << QString("%1 %2").arg(change.enable ? "Enable" : "Disable", change.eventName);
+    }
+
+    QStringList lines;
+    for (const EventChangeSet::ValueChange &change : changes) {
+        const QString name = change.prototype.isEmpty() ? change.setting : QString("%1 / %2").arg(change.prototype, change.setting);
+        const QString before = change.hadValue ? QString::number(change.before) : QString("(unset)");
+        const QString after = change.hasValue ? QString("%1 (%2)").arg(change.after).arg(change.source) : QString("(unset)");
+        lines << QString("%1: %2 -> %3").arg(name, before, after);
+    }
+    std::sort(lines.begin(), lines.end());
+    for (const QString &error : errors) {
+        lines.prepend("Skipped " + error);
+    }
+
+    QMessageBox box(this);
+    box.setWindowTitle("Staged Event Changes");
+    box.setText(QString("%1\n\n%2 effective setting(s) change, followed by one live tuning reload.")
+                    .arg(renames.join("\n")).arg(changes.size()));
+    const QString broadcast = eventChanges.broadcastMessage();
+    if (!broadcast.isEmpty()) {
+        box.setInformativeText("Broadcast: " + broadcast);
+    }
+    if (!lines.isEmpty()) {
+        box.setDetailedText(lines.join("\n"));
+    }
+    box.exec();
+}
+
+void MainWindow::applyEventChanges()
+{
+    if (eventChanges.isEmpty()) {
+        return;
+    }
+
+    const QVector<EventChangeSet::Change> changes = eventChanges.changes();
+    const QString broadcastMessage = eventChanges.broadcastMessage();
+
+    QString errorMessage;
+    if (!eventChanges.commit(&errorMessage)) {
+        discardEventChanges();
+        QMessageBox::critical(this, "Error", QString("No event was changed.\n%1").arg(errorMessage));
+        return;
+    }
+    stagedEventSwitches.clear();
+    updateEventStagingControls();
+
+    QSettings settings("PTM", "MHServerEmuUI");
+    for (const EventChangeSet::Change &change : changes) {
+        if (change.announce) {
+            settings.setValue(change.eventName + "Event", change.enable ? 1 : 0);
+        }
+        ui->ServerOutputEdit->append(QString("%1 event %2.").arg(change.eventName, change.enable ? "enabled" : "disabled"));
+        syncEventState(change.fileName, change.enable);
+    }
+
+    if (activeInstance->isRunning()) {
+        if (!broadcastMessage.isEmpty()) {
+            activeInstance->sendCommand(QString("!server broadcast %1").arg(broadcastMessage));
+            ui->ServerOutputEdit->append(QString("Sent broadcast message: %1").arg(broadcastMessage));
+        }
+        activeInstance->sendCommand("!server reloadlivetuning");
         ui->ServerOutputEdit->append("Sent command: !server reloadlivetuning");
     } else {
         QMessageBox::warning(this, "Error", "Server is not running.");
     }
 }
 
+QString MainWindow::eventCalendarPath() const
+{
+    return QCoreApplication::applicationDirPath() + "/EventCalendar.json";
+}
+
+void MainWindow::setupEventCalendar()
+{
+    QWidget *calendarTab = new QWidget();
+    QVBoxLayout *layout = new QVBoxLayout(calendarTab);
+
+    QHBoxLayout *controls = new QHBoxLayout();
+    runCalendarBox = new QCheckBox("Run calendar", calendarTab);
+    runCalendarBox->setToolTip("Switch event files on and off at the scheduled times");
+    QPushButton *addButton = new QPushButton("Add Window...", calendarTab);
+    QPushButton *editButton = new QPushButton("Edit...", calendarTab);
+    QPushButton *removeButton = new QPushButton("Remove", calendarTab);
+    calendarStatusLabel = new QLabel(calendarTab);
+    controls->addWidget(runCalendarBox);
+    controls->addWidget(addButton);
+    controls->addWidget(editButton);
+    controls->addWidget(removeButton);
+    controls->addWidget(calendarStatusLabel, 1);
+    layout->addLayout(controls);
+
+    calendarTable = new QTableWidget(0, 5, calendarTab);
+    calendarTable->setHorizontalHeaderLabels({"On", "Event", "Schedule", "Group", "Priority"});
+    calendarTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    calendarTable->setSelectionBehavior(QAbstractItemView::SelectRows);
+    calendarTable->setSelectionMode(QAbstractItemView::SingleSelection);
+    calendarTable->verticalHeader()->setVisible(false);
+    calendarTable->verticalHeader()->setDefaultSectionSize(22);
+    calendarTable->horizontalHeader()->setStretchLastSection(true);
+    calendarTable->setColumnWidth(0, 40);
+    calendarTable->setColumnWidth(1, 220);
+    calendarTable->setColumnWidth(2, 320);
+    calendarTable->setColumnWidth(3, 120);
+    calendarTable->setStyleSheet("background: white; color: black;");
+    layout->addWidget(calendarTable, 2);
+
+    layout->addWidget(new QLabel("Next 7 days:", calendarTab));
+    calendarTimelineView = new QPlainTextEdit(calendarTab);
+    calendarTimelineView->setReadOnly(true);
+    calendarTimelineView->setStyleSheet("background: white; color: black;");
+    layout->addWidget(calendarTimelineView, 1);
+
+    // Fires at the next transition only, there is no polling in between
+    calendarTimer->setSingleShot(true);
+    calendarTimer->setTimerType(Qt::PreciseTimer);
+    connect(calendarTimer, &QTimer::timeout, this, &MainWindow::runEventCalendar);
+
+    QFile file(eventCalendarPath());
+    if (file.open(QIODevice::ReadOnly)) {
+        QString errorMessage;
+        if (!eventCalendar.loadJson(file.readAll(), &errorMessage)) {
+            qDebug() << "Failed to load the event calendar:" << errorMessage;
+        }
+    }
+
+    connect(addButton, &QPushButton::clicked, this, &MainWindow::addCalendarWindow);
+    connect(editButton, &QPushButton::clicked, this, &MainWindow::editCalendarWindow);
+    connect(calendarTable, &QTableWidget::cellDoubleClicked, this, &MainWindow::editCalendarWindow);
+    connect(removeButton, &QPushButton::clicked, this, &MainWindow::removeCalendarWindow);
+    connect(calendarTable, &QTableWidget::itemChanged, this, [this](QTableWidgetItem *item) {
+        if (item->column() != 0 || item->row() >= eventCalendar.windows().size()) {
+            return;
+        }
+        const bool enabled = item->checkState() == Qt::Checked;
+        if (eventCalendar.windows().at(item->row()).enabled != enabled) {
+            eventCalendar.setWindowEnabled(item->row(), enabled);
+            saveEventCalendar();
+        }
+    });
+    connect(runCalendarBox, &QCheckBox::toggled, this, [this](bool checked) {
+        QSettings("PTM", "MHServerEmuUI").setValue("EventCalendarRunning", checked);
+        if (checked) {
+            runEventCalendar();
+        } else {
+            scheduleEventCalendar();
+        }
+    });
+
+    ui->tabWidget->addTab(calendarTab, "Event Calendar");
+    refreshEventCalendarView();
+
+    // Catch up with whatever should be active now once the window is up, then carry on
+    QSettings settings("PTM", "MHServerEmuUI");
+    runCalendarBox->blockSignals(true);
+    runCalendarBox->setChecked(settings.value("EventCalendarRunning", false).toBool());
+    runCalendarBox->blockSignals(false);
+    if (runCalendarBox->isChecked()) {
+        QTimer::singleShot(0, this, &MainWindow::runEventCalendar);
+    } else {
+        scheduleEventCalendar();
+    }
+}
+
+QStringList MainWindow::availableEventFiles() const
+{
+    QStringList files;
+    ServerInstance *instance = shardManager->primary();
+    if (!instance || instance->serverPath().isEmpty()) {
+        return files;
+    }
+
+    const QStringList names = QDir(instance->liveTuningPath()).entryList({"LiveTuningData_*.json", "OFF_LiveTuningData_*.json"}, QDir::Files);
+    for (const QString &name : names) {
+        const QString active = name.startsWith("OFF_") ? name.mid(4) : name;
+        if (!files.contains(active)) {
+            files.append(active);
+        }
+    }
+    files.sort();
+    return files;
+}
+
+void MainWindow::saveEventCalendar()
+{
+    QString errorMessage;
+    if (AtomicFileWriter::write(eventCalendarPath(), eventCalendar.toJson(), &errorMessage) == AtomicFileWriter::Failed) {
+        QMessageBox::warning(this, "Error", QString("Failed to save the event calendar: %1").arg(errorMessage));
+    }
+    refreshEventCalendarView();
+    scheduleEventCalendar();
+}
+
+void MainWindow::refreshEventCalendarView()
+{
+    const QVector<EventCalendar::Window> &windows = eventCalendar.windows();
+    calendarTable->blockSignals(true);
+    calendarTable->setRowCount(windows.size());
+    for (int row = 0; row < windows.size(); ++row) {
+        const EventCalendar::Window &window = windows.at(row);
+        QTableWidgetItem *enabledItem = new QTableWidgetItem();
+        enabledItem->setFlags(Qt::ItemIsEnabled | Qt::ItemIsSelectable | Qt::ItemIsUserCheckable);
+        enabledItem->setCheckState(window.enabled ? Qt::Checked : Qt::Unchecked);
+        calendarTable->setItem(row, 0, enabledItem);
+        calendarTable->setItem(row, 1, new QTableWidgetItem(EventCalendar::eventName(window.fileName)));
+        calendarTable->setItem(row, 2, new QTableWidgetItem(EventCalendar::describe(window)));
+        calendarTable->setItem(row, 3, new QTableWidgetItem(window.group));
+        calendarTable->setItem(row, 4, new QTableWidgetItem(QString::number(window.priority)));
+    }
+    calendarTable->blockSignals(false);
+
+    const QDateTime now = QDateTime::currentDateTime();
+    QStringList lines;
+    for (const EventCalendar::Transition &transition : eventCalendar.timeline(now, now.addDays(7))) {
+        QStringList changes;
+        for (const QString &file : transition.enable) {
+            changes << "+" + EventCalendar::eventName(file);
+        }
+        for (const QString &file : transition.disable) {
+            changes << "-" + EventCalendar::eventName(file);
+        }
+        lines << QString("%1   %2").arg(transition.at.toString("ddd yyyy-MM-dd HH:mm"), changes.join("  "));
+    }
+    calendarTimelineView->setPlainText(lines.isEmpty() ? QString("No scheduled changes.") : lines.join("\n"));
+}
+
+void MainWindow::addCalendarWindow()
+{
+    CalendarWindowDialog dialog(availableEventFiles(), this);
+    if (dialog.exec() != QDialog::Accepted) {
+        return;
+    }
+    eventCalendar.addWindow(dialog.window());
+    saveEventCalendar();
+}
+
+void MainWindow::editCalendarWindow()
+{
+    const int row = calendarTable->currentRow();
+    if (row < 0 || row >= eventCalendar.windows().size()) {
+        return;
+    }
+
+    CalendarWindowDialog dialog(availableEventFiles(), this);
+    dialog.setWindow(eventCalendar.windows().at(row));
+    if (dialog.exec() != QDialog::Accepted) {
+        return;
+    }
+
+    EventCalendar::Window window = dialog.window();
+    window.enabled = eventCalendar.windows().at(row).enabled;
+    eventCalendar.setWindow(row, window);
+    saveEventCalendar();
+}
+
+void MainWindow::removeCalendarWindow()
+{
+    const int row = calendarTable->currentRow();
+    if (row < 0 || row >= eventCalendar.windows().size()) {
+        return;
+    }
+    eventCalendar.removeWindow(row);
+    saveEventCalendar();
+}
+
+void MainWindow::runEventCalendar()
+{
+    ServerInstance *instance = shardManager->primary();
+    if (!runCalendarBox->isChecked() || !instance || instance->serverPath().isEmpty()) {
+        scheduleEventCalendar();
+        return;
+    }
+
+    // Reconcile with the state the calendar wants right now, which also covers any transitions
+    // missed while the UI or the host was down
+    const QDateTime now = QDateTime::currentDateTime();
+    const QSet<QString> wanted = eventCalendar.activeAt(now);
+    EventChangeSet changes;
+    changes.setDirectory(instance->liveTuningPath());
+    for (const QString &fileName : eventCalendar.managedFiles()) {
+        const bool enable = wanted.contains(fileName);
+        if (enable && !QFile::exists(instance->liveTuningPath() + fileName) && !QFile::exists(instance->liveTuningPath() + "OFF_" + fileName)) {
+            ui->ServerOutputEdit->append(QString("Event calendar: %1 not found, skipped.").arg(fileName));
+            continue;
+        }
+        changes.stage({EventCalendar::eventName(fileName), fileName, enable, true});
+    }
+
+    if (!changes.isEmpty()) {
+        const QVector<EventChangeSet::Change> applied = changes.changes();
+        const QString broadcastMessage = changes.broadcastMessage();
+        QString errorMessage;
+        if (!changes.commit(&errorMessage)) {
+            ui->ServerOutputEdit->append(QString("Event calendar: no event was changed. %1").arg(errorMessage));
+        } else {
+            // The Events tab and the saved states belong to the active shard, which needn't be the primary
+            const bool targetIsActive = instance == activeInstance;
+            QSettings settings("PTM", "MHServerEmuUI");
+            for (const EventChangeSet::Change &change : applied) {
+                ui->ServerOutputEdit->append(QString("Event calendar: %1 event %2 on %3.")
+                                                 .arg(change.eventName, change.enable ? "enabled" : "disabled", instance->name()));
+                if (targetIsActive) {
+                    settings.setValue(change.eventName + "Event", change.enable ? 1 : 0);
+                    syncEventState(change.fileName, change.enable);
+                }
+            }
+
+            // Everything that changed at this point goes out with one reload
+            if (instance->isRunning()) {
+                instance->sendCommand(QString("!server broadcast %1").arg(broadcastMessage));
+                ui->ServerOutputEdit->append(QString("Sent broadcast message: %1").arg(broadcastMessage));
+                instance->sendCommand("!server reloadlivetuning");
+                ui->ServerOutputEdit->append("Sent command: !server reloadlivetuning");
+            }
+        }
+    }
+
+    refreshEventCalendarView();
+    scheduleEventCalendar();
+}
+
+void MainWindow::scheduleEventCalendar()
+{
+    calendarTimer->stop();
+    if (!runCalendarBox->isChecked()) {
+        calendarStatusLabel->setText("Calendar is not running.");
+        return;
+    }
+
+    // Long sleeps are cut short so clock changes and DST shifts are picked up within a few hours
+    const int maxSleepMs = 6 * 60 * 60 * 1000;
+    const QDateTime now = QDateTime::currentDateTime();
+    const QVector<EventCalendar::Transition> upcoming = eventCalendar.timeline(now, now.addDays(7));
+    if (upcoming.isEmpty()) {
+        calendarStatusLabel->setText("No changes scheduled in the next 7 days.");
+        calendarTimer->start(maxSleepMs);
+        return;
+    }
+
+    const EventCalendar::Transition &next = upcoming.first();
+    calendarStatusLabel->setText(QString("Next change %1 (%2 event(s) on, %3 off).")
+                                     .arg(next.at.toString("ddd yyyy-MM-dd HH:mm"))
+                                     .arg(next.enable.size())
+                                     .arg(next.disable.size()));
+    calendarTimer->start(static_cast<int>(qBound<qint64>(0, now.msecsTo(next.at), maxSleepMs)));
+}
+
 void MainWindow::setupUserListContextMenu() {
     // Enable the context menu on the QListWidget
     ui->listWidgetLoggedInUsers->setContextMenuPolicy(Qt::CustomContextMenu);
@@ -1678,7 +3199,7 @@ void MainWindow::showUserContextMenu(const QPoint &pos) {
 }
 
 void MainWindow::showUpdateLevelDialog(const QString &username) {
-    if (serverProcess->state() != QProcess::Running) {
+    if (!activeInstance->isRunning()) {
         QMessageBox::warning(this, "Error", "Server is not running. Start the server first.");
         return;
     }
@@ -1733,7 +3254,7 @@ void MainWindow::showUpdateLevelDialog(const QString &username) {
 
         // Send the command to the server
         QString command = QString("!account userlevel %1 %2\n").arg(email).arg(levelValue);
-        serverProcess->write(command.toUtf8());
+        activeInstance->sendCommand(command);
         ui->ServerOutputEdit->append(QString("Sent command: %1").arg(command));
     }
 }
@@ -1756,15 +3277,7 @@ void MainWindow::removeUserFromList(const QString &sessionId) {
         }
     }
     qDebug() << "No user found with SessionId:" << sessionId;
-    removeUserFromLoggedInMap(sessionId);
-}
-
-void MainWindow::removeUserFromLoggedInMap(const QString &sessionId) {
-    if (loggedInUsers.remove(sessionId)) {
-        qDebug() << "Removed user from map with SessionId:" << sessionId;
-    } else {
-        qDebug() << "SessionId not found in map:" << sessionId;
-    }
+    activeInstance->removeSession(sessionId);
 }
 
 void MainWindow::sendClientInfoCommand(const QString &sessionId, const QString &username, const QString &email) {
@@ -1773,12 +3286,9 @@ void MainWindow::sendClientInfoCommand(const QString &sessionId, const QString &
         return;
     }
 
-    // Store username and email for later use
-    userInfoMap[sessionId] = {username, email}; // userInfoMap is a QMap<QString, QPair<QString, QString>>
-
-    QString command = QString("!client info %1\n").arg(sessionId);
-    serverProcess->write(command.toUtf8());
-    qDebug() << "Sent command:" << command << "for Username:" << username << ", Email:" << email;
+    // The instance keeps username and email until the info block comes back
+    activeInstance->requestClientInfo(sessionId, username, email);
+    qDebug() << "Sent client info command for SessionId:" << sessionId << "Username:" << username << ", Email:" << email;
 }
 
 void MainWindow::displayUserInfo(const QString &info, const QString &username, const QString &email) {
@@ -1804,7 +3314,7 @@ void MainWindow::kickUser() {
     // Construct and send the kick command
     QString command = QString("!client kick %1\n").arg(playerName);
 
-    serverProcess->write(command.toUtf8());
+    activeInstance->sendCommand(command);
     ui->ServerOutputEdit->append(QString("Kicked user: %1").arg(playerName));
 }
 
@@ -1824,7 +3334,7 @@ void MainWindow::banUser() {
 
     // Send the ban command using the email
     QString banCommand = QString("!account ban %1\n").arg(email);
-    serverProcess->write(banCommand.toUtf8());
+    activeInstance->sendCommand(banCommand);
     ui->ServerOutputEdit->append(QString("Banned user: %1 (%2)").arg(username, email));
 
     // Automatically kick the banned user using their username
@@ -1839,9 +3349,10 @@ QString MainWindow::getEmailFromDatabase(const QString &username) {
         return QString();
     }
 
-    // Ensure the database connection
-    if (!QSqlDatabase::contains("AppConnection")) {
-        QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", "AppConnection");
+    // Ensure the database connection, one per shard since each has its own account.db
+    QString connectionName = "AppConnection_" + activeInstance->name();
+    if (!QSqlDatabase::contains(connectionName)) {
+        QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", connectionName);
         QString serverPath = ui->mhServerPathEdit->text().trimmed();
         QString dbPath = serverPath + "/MHServerEmu/Data/account.db";
         db.setDatabaseName(dbPath);
@@ -1852,7 +3363,7 @@ QString MainWindow::getEmailFromDatabase(const QString &username) {
         }
     }
 
-    QSqlDatabase db = QSqlDatabase::database("AppConnection");
+    QSqlDatabase db = QSqlDatabase::database(connectionName);
 
     if (!db.isOpen()) {
         qDebug() << "Database is not open.";
@@ -1881,7 +3392,7 @@ QString MainWindow::getEmailFromDatabase(const QString &username) {
 }
 
 void MainWindow::onPandemoniumProtocolToggle(int value) {
-    QString serverPath = ui->mhServerPathEdit->text() + "/MHServerEmu/Data/Game/LiveTuning/";
+    QString serverPath = activeInstance->liveTuningPath();
     QString activeFilePath = serverPath + "LiveTuningDataz_PandemoniumProtocol.json";
     QString inactiveFilePath = serverPath + "OFF_LiveTuningDataz_PandemoniumProtocol.json";
 
@@ -1899,10 +3410,27 @@ void MainWindow::onPandemoniumProtocolToggle(int value) {
             return;
         }
 
-        qDebug() << "Pandemonium Protocol enabled.";
+        // Only one rotation runs at a time, the shard it was running on is switched off
+        if (pandemoniumShard && pandemoniumShard != activeInstance) {
+            ui->ServerOutputEdit->append(QString("Pandemonium Protocol moved from %1 to %2.").arg(pandemoniumShard->name(), activeInstance->name()));
+            stopPandemoniumRotation(pandemoniumShard);
+        }
+        pandemoniumShard = activeInstance;
+        pandemoniumFailures = 0;
+        pandemoniumStorePath.clear();
+
+        qDebug() << "Pandemonium Protocol enabled on" << activeInstance->name();
         runPandemoniumProtocol(); // Start the event cycle
 
     } else {
+        // A pending rotation would otherwise fire and rewrite the file after it was disabled
+        if (pandemoniumShard == activeInstance) {
+            pandemoniumTimer->stop();
+            endPandemoniumSubEvent(activeInstance);
+            pandemoniumShard = nullptr;
+            pandemoniumStorePath.clear();
+        }
+
         // Disable event: Rename active file to OFF_ file
         if (!activeFile.exists()) {
             QMessageBox::warning(this, "Error", "Pandemonium Protocol file not found!");
@@ -1913,136 +3441,266 @@ void MainWindow::onPandemoniumProtocolToggle(int value) {
             return;
         }
 
-        qDebug() << "Pandemonium Protocol disabled.";
+        qDebug() << "Pandemonium Protocol disabled on" << activeInstance->name();
     }
 }
 
-void MainWindow::runPandemoniumProtocol() {
-    QString filePath = ui->mhServerPathEdit->text() + "/MHServerEmu/Data/Game/LiveTuningDataz_PandemoniumProtocol.json";
-    QFile file(filePath);
+RotationConfig MainWindow::pandemoniumRotationConfig()
+{
+    RotationConfig config = RotationConfig::pandemoniumDefaults();
+
+    // Optional override of the built-in settings and sub-event pool
+    QFile file(QCoreApplication::applicationDirPath() + "/PandemoniumRotation.json");
+    if (file.exists()) {
+        QString errorMessage;
+        if (!file.open(QIODevice::ReadOnly) || !RotationConfig::fromJson(file.readAll(), &config, &errorMessage)) {
+            qDebug() << "Ignoring PandemoniumRotation.json:" << (errorMessage.isEmpty() ? file.errorString() : errorMessage);
+            config = RotationConfig::pandemoniumDefaults();
+        }
+    }
+
+    config.detailedBroadcast = ui->checkBoxPandemoniumBroadcast->isChecked();
+    config.applyRanges(ui->LineEditPandemoniumBoostRangeMin->text().toDouble(),
+                       ui->LineEditPandemoniumBoostRangeMax->text().toDouble(),
+                       ui->LineEditPandemoniumDurationMin->text().toInt(),
+                       ui->LineEditPandemoniumDurationMax->text().toInt());
+    return config;
+}
 
-    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
-        QMessageBox::critical(this, "Error", "Failed to open Pandemonium Protocol file.");
+void MainWindow::runPandemoniumProtocol() {
+    // Each cycle works on the shard the rotation was started on, not the one currently shown
+    ServerInstance *shard = pandemoniumShard.data();
+    if (!shard) {
+        pandemoniumTimer->stop();
         return;
     }
 
-    QJsonDocument doc = QJsonDocument::fromJson(file.readAll());
-    file.close();
+    pandemoniumEngine.setConfig(pandemoniumRotationConfig());
+    const RotationConfig &config = pandemoniumEngine.config();
+    QString serverPath = shard->liveTuningPath();
+    QString filePath = serverPath + config.fileName;
 
-    if (!doc.isArray()) {
-        QMessageBox::critical(this, "Error", "Invalid JSON format in Pandemonium Protocol file.");
+    // The parsed file is kept between cycles, it is only parsed again when the content on disk
+    // no longer matches what the rotation last wrote so edits made meanwhile aren't overwritten
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        retryPandemoniumProtocol(QString("Failed to open Pandemonium Protocol file: %1").arg(file.errorString()));
         return;
     }
+    const QByteArray content = file.readAll();
+    file.close();
 
-    QJsonArray dataArray = doc.array();
-    QMap<QString, QString> settingNames = {
-        {"eGTV_VendorXPGain", "Vendor XP"},
-        {"eGTV_XPGain", "XP Boost"},
-        {"eGTV_LootSpecialDropRate", "SiF"},
-        {"eGTV_LootRarity", "RiF"}
-    };
+    const QByteArray contentHash = AtomicFileWriter::contentHash(content);
+    if (pandemoniumStorePath != filePath || pandemoniumStoreHash != contentHash) {
+        QString errorMessage;
+        pandemoniumStore.clear();
+        if (!pandemoniumStore.loadJson(content, &errorMessage)) {
+            pandemoniumStorePath.clear();
+            retryPandemoniumProtocol(QString("Failed to parse Pandemonium Protocol file: %1").arg(errorMessage));
+            return;
+        }
+        pandemoniumStorePath = filePath;
+        pandemoniumStoreHash = contentHash;
+    }
 
-    // Get min/max values from line edits, ensuring min is less than max
-    double minBoost = ui->LineEditPandemoniumBoostRangeMin->text().toDouble();
-    double maxBoost = ui->LineEditPandemoniumBoostRangeMax->text().toDouble();
+    const RotationCycle cycle = pandemoniumEngine.next();
+    pandemoniumEngine.applyTo(cycle, pandemoniumStore);
 
-    if (minBoost > maxBoost) {
-        std::swap(minBoost, maxBoost); // Ensure valid range
+    QString errorMessage;
+    const QByteArray json = pandemoniumStore.toJson();
+    AtomicFileWriter::Result writeResult = AtomicFileWriter::write(filePath, json, &errorMessage);
+    if (writeResult == AtomicFileWriter::Failed) {
+        // The store now holds values that never reached the file
+        pandemoniumStorePath.clear();
+        retryPandemoniumProtocol(QString("Failed to save updated Pandemonium Protocol file: %1").arg(errorMessage));
+        return;
     }
+    pandemoniumStore.markClean();
+    pandemoniumStoreHash = AtomicFileWriter::contentHash(json);
+    pandemoniumFailures = 0;
+    bool tuningChanged = writeResult == AtomicFileWriter::Written;
 
-    QStringList broadcastParts;
-    bool detailedBroadcast = ui->checkBoxPandemoniumBroadcast->isChecked();
+    QString &currentSubEvent = shard->currentSubEvent();
+    const QString nextSubEvent = cycle.subEvent >= 0 ? config.subEvents.at(cycle.subEvent).name : QString();
+    if (currentSubEvent != nextSubEvent) {
+        if (endPandemoniumSubEvent(shard)) {
+            tuningChanged = true;
+        }
 
-    if (detailedBroadcast) {
-        broadcastParts << "The Pandemonium shifts!";
-    } else {
-        broadcastParts << "The chaos shifts once more...";
+        if (!nextSubEvent.isEmpty()) {
+            QFile inactiveFile(serverPath + "OFF_LiveTuningData_" + nextSubEvent + ".json");
+            if (inactiveFile.exists() && inactiveFile.rename(serverPath + "LiveTuningData_" + nextSubEvent + ".json")) {
+                tuningChanged = true;
+            }
+            currentSubEvent = nextSubEvent;
+        }
     }
 
-    for (int i = 0; i < dataArray.size(); ++i) {
-        QJsonObject obj = dataArray[i].toObject();
-        QString settingKey = obj["Setting"].toString();
+    // Reload live tuning and broadcast, the reload is skipped if no file actually changed
+    if (shard->isRunning()) {
+        if (tuningChanged) {
+            shard->sendCommand("!server reloadlivetuning");
+            ui->ServerOutputEdit->append(QString("Sent command to %1: !server reloadlivetuning").arg(shard->name()));
+        }
 
-        if (settingNames.contains(settingKey)) {
-            double randomValue = minBoost + QRandomGenerator::global()->bounded(maxBoost - minBoost);
-            randomValue = QString::number(randomValue, 'f', 2).toDouble(); // Keep 2 decimal places
+        QString broadcastMessage = pandemoniumEngine.broadcastFor(cycle);
+        shard->sendCommand(QString("!server broadcast %1").arg(broadcastMessage));
+        ui->ServerOutputEdit->append(QString("Sent broadcast to %1: %2").arg(shard->name(), broadcastMessage));
+    }
 
-            obj["Value"] = randomValue;
-            dataArray[i] = obj;
+    // QTimer takes int milliseconds, cycles longer than ~24 days are cut short
+    const qint64 durationMs = qint64(cycle.durationMinutes) * 60 * 1000;
+    pandemoniumTimer->start(static_cast<int>(qBound<qint64>(60 * 1000, durationMs, std::numeric_limits<int>::max())));
+}
 
-            if (detailedBroadcast) {
-                broadcastParts << QString("%1: %2x").arg(settingNames[settingKey]).arg(randomValue, 0, 'f', 2);
-            }
-        }
+bool MainWindow::endPandemoniumSubEvent(ServerInstance *shard)
+{
+    QString &currentSubEvent = shard->currentSubEvent();
+    if (currentSubEvent.isEmpty()) {
+        return false;
+    }
+
+    const QString serverPath = shard->liveTuningPath();
+    QFile activeFile(serverPath + "LiveTuningData_" + currentSubEvent + ".json");
+    const bool renamed = activeFile.exists() && activeFile.rename(serverPath + "OFF_LiveTuningData_" + currentSubEvent + ".json");
+    currentSubEvent.clear();
+    return renamed;
+}
+
+void MainWindow::retryPandemoniumProtocol(const QString &errorMessage)
+{
+    // Runs from the timer, so failures are logged rather than shown in a dialog; a locked
+    // file usually clears up by the next attempt
+    qDebug() << "Pandemonium Protocol:" << errorMessage;
+    ui->ServerOutputEdit->append(QString("Pandemonium Protocol on %1: %2").arg(pandemoniumShard->name(), errorMessage));
+
+    if (++pandemoniumFailures >= MaxPandemoniumFailures) {
+        ui->ServerOutputEdit->append(QString("Pandemonium Protocol stopped on %1 after %2 failed attempts.").arg(pandemoniumShard->name()).arg(pandemoniumFailures));
+        stopPandemoniumRotation(pandemoniumShard);
+        return;
     }
+    pandemoniumTimer->start(PandemoniumRetryMs);
+}
 
-    // Save updated JSON
-    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
-        QMessageBox::critical(this, "Error", "Failed to save updated Pandemonium Protocol file.");
+void MainWindow::stopPandemoniumRotation(ServerInstance *shard)
+{
+    pandemoniumTimer->stop();
+    pandemoniumShard = nullptr;
+    pandemoniumStorePath.clear();
+    pandemoniumFailures = 0;
+
+    // Leave the shard with the event switched off rather than stuck on its last cycle
+    endPandemoniumSubEvent(shard);
+    const QString serverPath = shard->liveTuningPath();
+    QFile activeFile(serverPath + "LiveTuningDataz_PandemoniumProtocol.json");
+    if (activeFile.exists() && !activeFile.rename(serverPath + "OFF_LiveTuningDataz_PandemoniumProtocol.json")) {
+        qDebug() << "Failed to deactivate Pandemonium Protocol on" << shard->name();
         return;
     }
-    doc.setArray(dataArray);
-    file.write(doc.toJson(QJsonDocument::Indented));
-    file.close();
+    if (shard == activeInstance) {
+        syncEventState("LiveTuningDataz_PandemoniumProtocol.json", false);
+    }
+}
 
-    // Pick a random sub-event (1-4 for an event, 5 for none)
-    static QStringList subEvents = {
-        "ArmorIncursion",
-        "CosmicChaos",
-        "MidtownMadness",
-        "OdinsBounty"
-    };
+void MainWindow::simulatePandemoniumProtocol()
+{
+    bool ok = false;
+    const int seed = QInputDialog::getInt(this, "Simulate Rotation", "Seed (the same seed gives the same rotations):", 1, 0, std::numeric_limits<int>::max(), 1, &ok);
+    if (!ok) {
+        return;
+    }
 
-    QString serverPath = ui->mhServerPathEdit->text() + "/MHServerEmu/Data/Game/";
+    const RotationConfig config = pandemoniumRotationConfig();
+    const RotationEngine::SimulationReport report = RotationEngine::simulate(config, static_cast<quint64>(seed), 30);
 
-    if (!currentSubEvent.isEmpty()) {
-        QString activePath = serverPath + "LiveTuningData_" + currentSubEvent + ".json";
-        QString inactivePath = serverPath + "OFF_LiveTuningData_" + currentSubEvent + ".json";
+    QMessageBox box(this);
+    box.setWindowTitle("Pandemonium Protocol Simulation");
+    box.setText(QString("Simulated 30 days of rotations with seed %1 in %2 ms.")
+                    .arg(seed).arg(report.elapsedNs / 1000000.0, 0, 'f', 2));
+    box.setDetailedText(report.toText(config));
+    box.exec();
+}
 
-        QFile activeFile(activePath);
-        if (activeFile.exists()) {
-            activeFile.rename(inactivePath);
+void MainWindow::setupCapacityPlanning() {
+    QWidget *capacityTab = new QWidget();
+    QVBoxLayout *layout = new QVBoxLayout(capacityTab);
+
+    capacityReportView = new QPlainTextEdit(capacityTab);
+    capacityReportView->setReadOnly(true);
+    capacityReportView->setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+    capacityReportView->setStyleSheet("background: white; color: black;");
+    layout->addWidget(capacityReportView);
+
+    QHBoxLayout *buttons = new QHBoxLayout();
+    QPushButton *refreshButton = new QPushButton("Refresh Report", capacityTab);
+    QPushButton *resetButton = new QPushButton("Reset Samples", capacityTab);
+    buttons->addWidget(refreshButton);
+    buttons->addWidget(resetButton);
+    buttons->addStretch(1);
+    layout->addLayout(buttons);
+
+    connect(refreshButton, &QPushButton::clicked, this, &MainWindow::updateCapacityReport);
+    connect(resetButton, &QPushButton::clicked, this, [this]() {
+        if (QMessageBox::question(this, "Reset Samples", QString("Discard every capacity sample collected for %1?").arg(activeInstance->name())) != QMessageBox::Yes) {
+            return;
         }
-        currentSubEvent.clear();
-    }
+        QString errorMessage;
+        if (!activeInstance->capacityPlanner().reset(&errorMessage)) {
+            QMessageBox::warning(this, "Error", errorMessage);
+        }
+        updateCapacityReport();
+    });
 
-    int roll = QRandomGenerator::global()->bounded(1, 6);
-    if (roll <= 4) {
-        currentSubEvent = subEvents[roll - 1];
-        QString activePath = serverPath + "LiveTuningData_" + currentSubEvent + ".json";
-        QString inactivePath = serverPath + "OFF_LiveTuningData_" + currentSubEvent + ".json";
+    ui->tabWidget->addTab(capacityTab, "Capacity");
 
-        QFile inactiveFile(inactivePath);
-        if (inactiveFile.exists()) {
-            inactiveFile.rename(activePath);
-            if (detailedBroadcast) {
-                broadcastParts << QString("Bonus Event: %1!").arg(currentSubEvent);
-            }
+    // Deltas over a long interval keep the sampling cost negligible next to the server
+    capacityTimer = new QTimer(this);
+    capacityTimer->setInterval(CapacityPlanner::SampleIntervalMs);
+    connect(capacityTimer, &QTimer::timeout, this, &MainWindow::sampleCapacity);
+    capacityTimer->start();
+    updateCapacityReport();
+}
+
+QString MainWindow::capacityLogPath(const ServerInstance *shard) const {
+    return QCoreApplication::applicationDirPath() + "/Capacity/" + shard->name() + ".csv";
+}
+
+void MainWindow::sampleCapacity() {
+    const qint64 nowMs = QDateTime::currentMSecsSinceEpoch();
+    bool activeSampled = false;
+
+    for (ServerInstance *shard : shardManager->instances()) {
+        CapacityPlanner &planner = shard->capacityPlanner();
+        if (!shard->isRunning()) {
+            planner.restart();
+            continue;
         }
-    } else if (detailedBroadcast) {
-        broadcastParts << "No additional event this time...";
-    }
 
-    // Reload live tuning and broadcast
-    if (serverProcess->state() == QProcess::Running) {
-        serverProcess->write("!server reloadlivetuning\n");
-        ui->ServerOutputEdit->append("Sent command: !server reloadlivetuning");
+        const ServerMetrics &metrics = shard->metrics();
+        quint64 latencyCount = 0;
+        double latencySum = 0.0;
+        for (const LatencyHistogram &histogram : metrics.commandLatency) {
+            latencyCount += histogram.count();
+            latencySum += histogram.sumSeconds();
+        }
 
-        QString broadcastMessage = broadcastParts.join(" ");
-        serverProcess->write(QString("!server broadcast %1\n").arg(broadcastMessage).toUtf8());
-        ui->ServerOutputEdit->append("Sent broadcast: " + broadcastMessage);
+        const ProcessStats stats = readProcessStats(metrics.serverPid.load(std::memory_order_relaxed), true);
+        if (planner.observe(nowMs, shard->playerCount(), stats, latencyCount, latencySum) && shard == activeInstance) {
+            activeSampled = true;
+        }
     }
 
-    // Get min/max duration from line edits, ensuring min < max
-    int minDuration = ui->LineEditPandemoniumDurationMin->text().toInt();
-    int maxDuration = ui->LineEditPandemoniumDurationMax->text().toInt();
-
-    if (minDuration > maxDuration) {
-        std::swap(minDuration, maxDuration);
+    if (activeSampled) {
+        updateCapacityReport();
     }
+}
 
-    int durationMinutes = QRandomGenerator::global()->bounded(minDuration, maxDuration + 1);
-    int durationMs = durationMinutes * 60 * 1000;
+void MainWindow::updateCapacityReport() {
+    if (!capacityReportView || !activeInstance) return;
 
-    QTimer::singleShot(durationMs, this, &MainWindow::runPandemoniumProtocol);
+    // Compared against what's configured on disk for the active shard
+    const CapacityPlanner::Report report = activeInstance->capacityPlanner().report();
+    capacityReportView->setPlainText(QString("%1\n\n%2")
+        .arg(activeInstance->name())
+        .arg(report.toText(QThread::idealThreadCount(), currentConfig.value("PlayerManager/ServerCapacity"), currentConfig.value("GameInstance/NumWorkerThreads"))));
 }
@@ -14,6 +14,32 @@
 #include <QSlider>
 #include <QLineEdit>
 #include <QVBoxLayout>
+#include <QThread>
+#include <QElapsedTimer>
+#include <QPointer>
+#include <QTableWidget>
+#include <QTableView>
+#include <QLabel>
+#include <QPushButton>
+#include <QComboBox>
+#include <QListWidget>
+#include <QPlainTextEdit>
+#include <QCheckBox>
+#include "servermetrics.h"
+#include "shardmanager.h"
+#include "livetuningmodel.h"
+#include "tuningfilewatcher.h"
+#include "atomicfilewriter.h"
+#include "prototypetrie.h"
+#include "rotationengine.h"
+#include "eventchangeset.h"
+#include "eventcalendar.h"
+#include "eventprovisioner.h"
+#include "eventregistry.h"
+#include "configschema.h"
+#include "effectiveconfig.h"
+#include "nightlydownloader.h"
+#include "zipextractor.h"
 
 QT_BEGIN_NAMESPACE
 namespace Ui { class MainWindow; }
@@ -31,10 +57,8 @@ private slots:
     void onBrowseButtonClicked();  // Slot for the Browse button
     void onStartClientButtonClicked();
     void onUpdateButtonClicked();
-    void onDownloadFinished(QNetworkReply *reply);
     void startServer();
     void stopServer();
-    void readServerOutput();
     void handleServerError();
     void openAccountCreationPage();
     void onLoadLiveTuning();       // Load Live Tuning values
@@ -57,38 +81,196 @@ private slots:
 
 private:
     Ui::MainWindow *ui;
-    QProcess *apacheProcess;
-    QProcess *serverProcess;
-    int playerCount;               // Tracks the number of logged-in players
+    ShardManager *shardManager;     // Owns every managed server instance
+    ServerInstance *activeInstance; // Instance bound to the Server Control, Live Tuning and Events tabs
     void updatePlayerCountLabel(); // Updates the player count label
-    QVBoxLayout *liveTuningLayout; // Layout to hold sliders dynamically
-    QString liveTuningFilePath;    // Path to LiveTuningData.json
-    void createLiveTuningSliders(const QJsonArray &data); // Create sliders from JSON
-    QMap<QString, QJsonArray> categories;  // Holds categorized data
+    LiveTuningModel *liveTuningModel; // Active shard's live tuning, filtered to one category
+    QTableView *liveTuningView;
+    QLabel *pendingChangesLabel;
+    void updatePendingChangesLabel();
+    void setupLiveTuningView();
     void populateComboBox();
     void displayCategoryItems(const QString &category);
-    void clearLayout(QLayout *layout);
     QPixmap onPixmap;  // Image for the "on" state
     QPixmap offPixmap; // Image for the "off" state
     QTimer *statusCheckTimer; // Timer to periodically check status
     void updateServerStatus();
     void initializeEventStates();
-    void parseLoginEvent(const QString &logLine);
-    QMap<QString, QString> loggedInUsers; // Map SessionId -> Account Name
     void refreshLoggedInUsers();
     void setupUserListContextMenu(); // Sets up the context menu for the user list
     void addUserToList(const QString &username, const QString &sessionId);
     void removeUserFromList(const QString &sessionId);
-    void removeUserFromLoggedInMap(const QString &sessionId);
     void sendClientInfoCommand(const QString &sessionId, const QString &username, const QString &email);
     void displayUserInfo(const QString &info, const QString &username, const QString &email);
     void showUpdateLevelDialog(const QString &username);
     QString getEmailFromDatabase(const QString &username);
-    QMap<QString, QPair<QString, QString>> userInfoMap;
     void onPandemoniumProtocolToggle(int value);
     void runPandemoniumProtocol();
 
-    QString currentSubEvent; // Tracks the currently active sub-event
+    // Metrics endpoint
+    QThread *metricsThread;
+    MetricsExporter *metricsExporter;
+    void setupMetricsExporter();
+
+    // Shard dashboard
+    QTableWidget *shardTable;
+    QLineEdit *shardBroadcastEdit;
+    QElapsedTimer dashboardClock;
+    QHash<ServerInstance *, quint64> lastConsoleLines; // Console line totals at the previous refresh
+    void setupShardDashboard();
+    void refreshShardDashboard();
+    void connectInstance(ServerInstance *shard);
+    void setActiveInstance(ServerInstance *shard);
+    ServerInstance *selectedShard() const;
+
+    // Effective live tuning across every active file
+    EffectiveLiveTuningModel *effectiveTuningModel;
+    QLabel *effectiveTuningSummary;
+    void setupEffectiveTuningView();
+    void reloadEffectiveTuning();
+
+    // Watches the LiveTuning folder and config files of the active shard
+    TuningFileWatcher *fileWatcher;
+    bool configLoaded;
+    QStringList loadedConfigValues; // Config tab as last loaded or saved, to tell unsaved edits apart
+    QByteArray savedOverrideHash;   // ConfigOverride.ini as the Config tab last wrote it
+    ConfigSchema configSchema;
+    void setupConfigSchema();
+
+    // Config on disk vs the config the active shard's server was started with
+    EffectiveConfig currentConfig;
+    ConfigDrift configDrift;
+    QLabel *configDriftSummary;
+    QTableWidget *configDriftTable;
+    void setupConfigDriftView();
+    void refreshConfigDrift();
+    void updateConfigDriftView();
+    void setupFileWatcher();
+    void loadConfigFiles(const QString &basePath, const QString &overridePath);
+    void onLiveTuningFileChanged(const QString &fileName, QSharedPointer<const LiveTuningStore> parsed, const QByteArray &hash);
+    void onConfigFileChanged(const QString &path);
+
+    // Undo history and checkpoints for live tuning edits
+    QPushButton *undoLiveTuningButton;
+    QPushButton *redoLiveTuningButton;
+    QComboBox *checkpointCombo;
+    void setupLiveTuningHistory();
+    void updateLiveTuningHistoryControls();
+    void undoLiveTuning();
+    void redoLiveTuning();
+    void addLiveTuningCheckpoint();
+    void showLiveTuningCheckpointDiff();
+    void revertLiveTuningCheckpoint();
+    void removeLiveTuningCheckpoint();
+    bool writeLiveTuningStore(AtomicFileWriter::Result *result);
+
+    // Prototype path index for filtering and autocomplete
+    PrototypeTrie prototypeIndex;
+    quint64 prototypeIndexGeneration;
+    QLineEdit *prototypeFilterEdit;
+    void setupPrototypeSearch();
+    void attachPrototypeCompleter(QLineEdit *edit);
+    void rebuildPrototypeIndex();
+    void addToPrototypeIndex(const LiveTuningStore &store);
+    QVector<bool> prototypeFilterMask() const;
+    void applyPrototypeFilter();
+
+    // Expression edits over many entries at once
+    void openBulkTransform();
+    void commitOpenLiveTuningEditor();
+
+    // Binary live tuning presets
+    QListWidget *presetList;
+    QPlainTextEdit *presetDiffView;
+    void setupPresetsView();
+    QString presetDirectory() const;
+    void refreshPresetList();
+    void savePreset();
+    void applyPreset();
+    void comparePresets();
+    void deletePreset();
+
+    // Pandemonium Protocol rotation, the event file stays loaded between cycles
+    RotationEngine pandemoniumEngine;
+    QTimer *pandemoniumTimer;
+    LiveTuningStore pandemoniumStore;
+    QString pandemoniumStorePath;
+    QByteArray pandemoniumStoreHash; // Content the cached store matches on disk
+    QPointer<ServerInstance> pandemoniumShard; // Shard the rotation was started on
+    int pandemoniumFailures;
+    static constexpr int PandemoniumRetryMs = 60 * 1000;
+    static constexpr int MaxPandemoniumFailures = 5;
+    RotationConfig pandemoniumRotationConfig();
+    void simulatePandemoniumProtocol();
+    bool endPandemoniumSubEvent(ServerInstance *shard);
+    void retryPandemoniumProtocol(const QString &errorMessage);
+    void stopPandemoniumRotation(ServerInstance *shard);
+
+    // Event switches collected and applied as one change set
+    EventChangeSet eventChanges;
+    QHash<QString, QSlider *> stagedEventSwitches; // By active file name
+    QCheckBox *stageEventsBox;
+    QLabel *stagedEventsLabel;
+    QPushButton *previewEventsButton;
+    QPushButton *applyEventsButton;
+    QPushButton *discardEventsButton;
+    void setupEventStaging();
+    void updateEventStagingControls();
+    void stageEventSwitch(const EventChangeSet::Change &change, QSlider *eventSwitch);
+    void discardEventChanges();
+    void previewEventChanges();
+    void applyEventChanges();
+
+    // Scheduled event windows
+    EventCalendar eventCalendar;
+    QTimer *calendarTimer;
+    QCheckBox *runCalendarBox;
+    QLabel *calendarStatusLabel;
+    QTableWidget *calendarTable;
+    QPlainTextEdit *calendarTimelineView;
+    void setupEventCalendar();
+    QString eventCalendarPath() const;
+    QStringList availableEventFiles() const;
+    void saveEventCalendar();
+    void refreshEventCalendarView();
+    void addCalendarWindow();
+    void editCalendarWindow();
+    void removeCalendarWindow();
+    void runEventCalendar();
+    void scheduleEventCalendar();
+
+    // Shipped event files checked against the manifest off the GUI thread
+    quint64 eventProvisionGeneration;
+    void onEventFilesProvisioned(const QString &liveTuningDir, const EventFileProvisioner::Result &result, qint64 elapsedMs);
+
+    // Every event in the LiveTuning folder or the manifest, with its switch if it has one
+    EventRegistry eventRegistry;
+    QStringList shippedEventFiles;
+    QHash<QString, QSlider *> eventSwitches; // By active file name
+    QLineEdit *customEventEdits[6];
+    QTableWidget *eventTable;
+    QLineEdit *eventFilterEdit;
+    QLabel *eventListSummary;
+    void setupEventList();
+    void refreshEventList();
+    void applyEventFilter();
+    void toggleRegistryEvent(int index, bool enable);
+    void switchEvent(const QString &eventName, const QString &fileName, bool enable);
+    void syncEventState(const QString &fileName, bool active);
+
+    // Resource use vs players online, sampled for every running shard
+    QTimer *capacityTimer;
+    QPlainTextEdit *capacityReportView;
+    void setupCapacityPlanning();
+    QString capacityLogPath(const ServerInstance *shard) const;
+    void sampleCapacity();
+    void updateCapacityReport();
+
+    // Nightly update, downloaded in-process so it can resume and be verified, and unpacked
+    // into a staging folder while it downloads
+    NightlyDownloader *updateDownloader;
+    ZipExtractor *updateExtractor;
+    void installUpdate(const QString &zipFilePath, const QString &stagingPath, const QString &extractPath, const QStringList &files);
 };
 
 #endif // MAINWINDOW_H
@@ -0,0 +1,375 @@
+// Stand-in for MHServerEmu.exe that produces the console traffic the UI parses at configurable
+// rates and answers !server, !client and !account commands after a configurable delay.
+// Point a shard's executable override at it to exercise the UI without a server or clients.
+// Usage: mhserveremu_mock --help
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QRandomGenerator>
+#include <QThread>
+#include <QTimer>
+#include <QVector>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+namespace {
+
+struct Options {
+    double chatterPerSecond = 20.0;
+    double errorsPerSecond = 0.0;
+    double loginsPerSecond = 0.2;
+    int targetPlayers = 50;
+    int stormEverySeconds = 0;
+    int stormSize = 0;
+    int latencyMs = 20;
+    int jitterMs = 10;
+    int shutdownAfterSeconds = 0;
+    quint32 seed = 1;
+};
+
+struct Session {
+    QByteArray account;
+    quint64 accountId;
+    quint64 sessionId;
+    qint64 connectedAtMs;
+};
+
+class MockServer : public QObject
+{
+public:
+    static constexpr int TickMs = 10;
+
+    explicit MockServer(const Options &options, QObject *parent = nullptr)
+        : QObject(parent)
+        , options(options)
+        , random(options.seed)
+    {
+        clock.start();
+        lastTickMs = 0;
+        nextStormMs = options.stormEverySeconds > 0 ? options.stormEverySeconds * 1000LL : -1;
+        connect(&ticker, &QTimer::timeout, this, [this]() { tick(); });
+    }
+
+    void start()
+    {
+        info("Program", "MHServerEmu (mock) starting");
+        info("GameDatabase", "Loaded 172540 prototypes in 850 ms");
+        info("PlayerConnectionManager", "Listening on 127.0.0.1 4306");
+        info("ServerManager", "Server is running");
+        flush();
+        ticker.start(TickMs);
+    }
+
+    void handleCommand(const QString &line)
+    {
+        // Responses go out after the configured latency, in the order commands came in
+        const int delay = options.latencyMs + (options.jitterMs > 0 ? static_cast<int>(random.bounded(options.jitterMs + 1)) : 0);
+        replyAtMs = qMax(replyAtMs, clock.elapsed() + delay);
+        QTimer::singleShot(static_cast<int>(replyAtMs - clock.elapsed()), this, [this, line]() {
+            respond(line.trimmed());
+            flush();
+        });
+    }
+
+private:
+    void tick()
+    {
+        const qint64 nowMs = clock.elapsed();
+        const double seconds = (nowMs - lastTickMs) / 1000.0;
+        lastTickMs = nowMs;
+        timestamp = QDateTime::currentDateTime().toString("yyyy.MM.dd HH:mm:ss.zzz").toLatin1();
+
+        if (options.shutdownAfterSeconds > 0 && nowMs >= options.shutdownAfterSeconds * 1000LL) {
+            shutdown();
+            return;
+        }
+
+        // Logouts scale with how far above the target we are, so the population hovers around it
+        loginBudget += options.loginsPerSecond * seconds;
+        const double logoutRate = options.targetPlayers > 0 ? options.loginsPerSecond * sessions.size() / options.targetPlayers : 0.0;
+        logoutBudget += logoutRate * seconds;
+        for (; loginBudget >= 1.0; loginBudget -= 1.0) {
+            login();
+        }
+        for (; logoutBudget >= 1.0 && !sessions.isEmpty(); logoutBudget -= 1.0) {
+            logout(static_cast<int>(random.bounded(static_cast<quint32>(sessions.size()))));
+        }
+        if (sessions.isEmpty()) {
+            logoutBudget = 0.0;
+        }
+
+        // Storms: a burst of logins, and the same players leaving half an interval later
+        if (nextStormMs >= 0 && nowMs >= nextStormMs) {
+            for (int i = 0; i < options.stormSize; ++i) {
+                login();
+                stormSessions.append(sessions.last().sessionId);
+            }
+            stormEndMs = nowMs + options.stormEverySeconds * 500LL;
+            nextStormMs += options.stormEverySeconds * 1000LL;
+        }
+        if (stormEndMs >= 0 && nowMs >= stormEndMs) {
+            for (quint64 sessionId : stormSessions) {
+                const int index = indexOfSession(sessionId);
+                if (index >= 0) {
+                    logout(index);
+                }
+            }
+            stormSessions.clear();
+            stormEndMs = -1;
+        }
+
+        chatterBudget += options.chatterPerSecond * seconds;
+        for (; chatterBudget >= 1.0; chatterBudget -= 1.0) {
+            chatter();
+        }
+        errorBudget += options.errorsPerSecond * seconds;
+        for (; errorBudget >= 1.0; errorBudget -= 1.0) {
+            appendLine(err, "Error", "Game", QByteArray("Simulated failure #") + QByteArray::number(++errorCount)
+                                                 + " in region update, entity " + QByteArray::number(random.bounded(100000u)));
+        }
+
+        flush();
+    }
+
+    void respond(const QString &command)
+    {
+        const QStringList parts = command.split(' ', Qt::SkipEmptyParts);
+        const QString verb = parts.value(0) + ' ' + parts.value(1);
+        const QByteArray argument = command.section(' ', 2).toUtf8();
+
+        if (verb == "!server broadcast") {
+            info("ChatManager", "Broadcast: " + argument);
+        } else if (verb == "!server reloadlivetuning") {
+            info("LiveTuningManager", "Reloaded live tuning data (" + QByteArray::number(random.bounded(50u, 400u)) + " settings)");
+        } else if (verb == "!server status") {
+            info("ServerManager", "Players online " + QByteArray::number(sessions.size()) + ", uptime "
+                                      + QByteArray::number(clock.elapsed() / 1000) + " s");
+        } else if (verb == "!server shutdown") {
+            shutdown();
+        } else if (verb == "!client info") {
+            clientInfo(argument);
+        } else if (verb == "!client kick") {
+            const int index = indexOfAccount(argument);
+            if (index >= 0) {
+                logout(index);
+            } else {
+                info("CommandManager", "Player " + argument + " not found.");
+            }
+        } else if (parts.value(0) == "!account" && parts.size() >= 3) {
+            info("AccountManager", "Account " + parts.value(2).toUtf8() + ": " + parts.value(1).toUtf8() + " done.");
+        } else {
+            info("CommandManager", "Unknown command: " + command.toUtf8());
+        }
+    }
+
+    void clientInfo(const QByteArray &sessionText)
+    {
+        bool ok = false;
+        const quint64 sessionId = QByteArray(sessionText).replace("0x", "").toULongLong(&ok, 16);
+        const int index = ok ? indexOfSession(sessionId) : -1;
+        if (index < 0) {
+            info("CommandManager", "Client " + sessionText + " not found.");
+            return;
+        }
+
+        // Written in one go so no other line lands inside the block; it ends at the first line without a colon
+        const Session &session = sessions.at(index);
+        out += "SessionId: " + hex(session.sessionId) + '\n';
+        out += "Account: " + session.account + " (" + hex(session.accountId) + ")\n";
+        out += "Address: 127.0.0.1 port " + QByteArray::number(40000 + index % 20000) + '\n';
+        out += "Connected: " + QByteArray::number((clock.elapsed() - session.connectedAtMs) / 1000) + " s\n";
+        out += "Region: Avengers Tower Hub\n";
+        out += "End of client info\n";
+    }
+
+    void login()
+    {
+        Session session;
+        session.account = "Player" + QByteArray::number(++loginCount);
+        session.accountId = random.generate64();
+        session.sessionId = random.generate64();
+        session.connectedAtMs = clock.elapsed();
+        sessions.append(session);
+        info("PlayerConnectionManager", "Accepted and registered client [Account=" + session.account + " (" + hex(session.accountId)
+                                            + "), SessionId=" + hex(session.sessionId) + "]");
+    }
+
+    void logout(int index)
+    {
+        const Session session = sessions.at(index);
+        sessions[index] = sessions.last(); // Order doesn't matter, keep removal O(1)
+        sessions.removeLast();
+        info("PlayerConnectionManager", "Removed client [Account=" + session.account + " (" + hex(session.accountId)
+                                            + "), SessionId=" + hex(session.sessionId) + "]");
+    }
+
+    void chatter()
+    {
+        static const char *const components[] = {"Game", "RegionManager", "EntityManager", "LootManager", "MissionManager", "ChatManager"};
+        static const char *const messages[] = {
+            "Region update took 4 ms",
+            "Spawned population marker in Midtown Patrol",
+            "Rolled loot table for defeated mob",
+            "Mission state changed to Completed",
+            "Saved player data",
+            "Area of interest updated"
+        };
+        const quint32 pick = random.bounded(6u);
+        appendLine(out, "Info", components[pick], QByteArray(messages[pick]) + " (" + QByteArray::number(++chatterCount) + ')');
+    }
+
+    void shutdown()
+    {
+        ticker.stop();
+        info("ServerManager", "Shutting down...");
+        while (!sessions.isEmpty()) {
+            logout(sessions.size() - 1);
+        }
+        info("ServerManager", "Shutdown finished");
+        flush();
+        QCoreApplication::quit();
+    }
+
+    int indexOfSession(quint64 sessionId) const
+    {
+        for (int i = 0; i < sessions.size(); ++i) {
+            if (sessions.at(i).sessionId == sessionId) {
+                return i;
+            }
+        }
+        return -1;
+    }
+
+    int indexOfAccount(const QByteArray &account) const
+    {
+        for (int i = 0; i < sessions.size(); ++i) {
+            if (sessions.at(i).account == account) {
+                return i;
+            }
+        }
+        return -1;
+    }
+
+    static QByteArray hex(quint64 value)
+    {
+        return "0x" + QByteArray::number(value, 16).toUpper().rightJustified(16, '0');
+    }
+
+    void info(const char *component, const QByteArray &message)
+    {
+        appendLine(out, "Info", component, message);
+    }
+
+    void appendLine(QByteArray &buffer, const char *level, const char *component, const QByteArray &message)
+    {
+        if (timestamp.isEmpty()) {
+            timestamp = QDateTime::currentDateTime().toString("yyyy.MM.dd HH:mm:ss.zzz").toLatin1();
+        }
+        buffer += '[';
+        buffer += timestamp;
+        buffer += "] [";
+        buffer += level;
+        buffer += "] [";
+        buffer += component;
+        buffer += "] ";
+        buffer += message;
+        buffer += '\n';
+    }
+
+    // One write per tick keeps 10k+ lines/s cheap
+    void flush()
+    {
+        if (!out.isEmpty()) {
+            std::fwrite(out.constData(), 1, static_cast<size_t>(out.size()), stdout);
+            std::fflush(stdout);
+            out.clear();
+        }
+        if (!err.isEmpty()) {
+            std::fwrite(err.constData(), 1, static_cast<size_t>(err.size()), stderr);
+            std::fflush(stderr);
+            err.clear();
+        }
+    }
+
+    Options options;
+    QRandomGenerator random;
+    QTimer ticker;
+    QElapsedTimer clock;
+    qint64 lastTickMs;
+    qint64 replyAtMs = 0;
+    qint64 nextStormMs;
+    qint64 stormEndMs = -1;
+    QByteArray timestamp;
+    QByteArray out;
+    QByteArray err;
+
+    QVector<Session> sessions;
+    QVector<quint64> stormSessions;
+    double loginBudget = 0.0;
+    double logoutBudget = 0.0;
+    double chatterBudget = 0.0;
+    double errorBudget = 0.0;
+    quint64 loginCount = 0;
+    quint64 chatterCount = 0;
+    quint64 errorCount = 0;
+};
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("mhserveremu_mock");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Emits MHServerEmu-style console traffic for testing MHServerEmuUI.");
+    parser.addHelpOption();
+    const QCommandLineOption chatter("chatter", "Background log lines per second.", "lines/s", "20");
+    const QCommandLineOption errors("errors", "Error lines per second on stderr.", "lines/s", "0");
+    const QCommandLineOption logins("logins", "Logins per second.", "count/s", "0.2");
+    const QCommandLineOption players("players", "Population the logouts steer towards.", "count", "50");
+    const QCommandLineOption stormEvery("storm-every", "Seconds between login storms, 0 for none.", "seconds", "0");
+    const QCommandLineOption stormSize("storm-size", "Players logging in per storm.", "count", "200");
+    const QCommandLineOption latency("latency", "Delay before a command is answered.", "ms", "20");
+    const QCommandLineOption jitter("jitter", "Random extra delay added to the latency.", "ms", "10");
+    const QCommandLineOption shutdownAfter("shutdown-after", "Run the shutdown sequence after this long, 0 for never.", "seconds", "0");
+    const QCommandLineOption seed("seed", "Random seed.", "number", "1");
+    parser.addOptions({chatter, errors, logins, players, stormEvery, stormSize, latency, jitter, shutdownAfter, seed});
+    parser.process(app);
+
+    Options options;
+    options.chatterPerSecond = parser.value(chatter).toDouble();
+    options.errorsPerSecond = parser.value(errors).toDouble();
+    options.loginsPerSecond = parser.value(logins).toDouble();
+    options.targetPlayers = parser.value(players).toInt();
+    options.stormEverySeconds = parser.value(stormEvery).toInt();
+    options.stormSize = parser.value(stormSize).toInt();
+    options.latencyMs = parser.value(latency).toInt();
+    options.jitterMs = parser.value(jitter).toInt();
+    options.shutdownAfterSeconds = parser.value(shutdownAfter).toInt();
+    options.seed = parser.value(seed).toUInt();
+
+    MockServer server(options);
+    server.start();
+
+    // Blocking reads stay off the event loop; a closed stdin means the UI went away
+    QThread *reader = QThread::create([&server]() {
+        std::string line;
+        while (std::getline(std::cin, line)) {
+            const QString command = QString::fromStdString(line);
+            QMetaObject::invokeMethod(&server, [&server, command]() { server.handleCommand(command); }, Qt::QueuedConnection);
+        }
+        QMetaObject::invokeMethod(QCoreApplication::instance(), &QCoreApplication::quit, Qt::QueuedConnection);
+    });
+    reader->start();
+
+    const int result = app.exec();
+
+    // The reader may still be blocked on stdin; the process is exiting anyway
+    std::_Exit(result);
+}
@@ -0,0 +1,345 @@
+#include "nightlydownloader.h"
+#include <QNetworkAccessManager>
+#include <QNetworkRequest>
+#include <QNetworkReply>
+#include <QRegularExpression>
+#include <QTimer>
+#include <QDebug>
+
+namespace {
+
+// "bytes 100-999/1000" or "bytes */1000"; the total is -1 when the server sent "*"
+bool parseContentRange(const QByteArray &header, qint64 *start, qint64 *totalSize)
+{
+    static const QRegularExpression regex(R"(^bytes\s+(?:(\d+)-\d+|\*)/(\d+|\*)$)");
+    const QRegularExpressionMatch match = regex.match(QString::fromLatin1(header.trimmed()));
+    if (!match.hasMatch()) {
+        return false;
+    }
+    *start = match.captured(1).isEmpty() ? -1 : match.captured(1).toLongLong();
+    *totalSize = match.captured(2) == QLatin1String("*") ? -1 : match.captured(2).toLongLong();
+    return true;
+}
+
+} // namespace
+
+NightlyDownloader::NightlyDownloader(QObject *parent)
+    : QObject(parent)
+    , manager(new QNetworkAccessManager(this))
+    , retryTimer(new QTimer(this))
+    , hash(QCryptographicHash::Sha256)
+{
+    retryTimer->setSingleShot(true);
+    connect(retryTimer, &QTimer::timeout, this, &NightlyDownloader::sendRequest);
+}
+
+NightlyDownloader::~NightlyDownloader()
+{
+    dropReply();
+}
+
+bool NightlyDownloader::isRunning() const
+{
+    return reply || retryTimer->isActive();
+}
+
+bool NightlyDownloader::start(const QUrl &url, const QString &destinationPath, qint64 expectedSize,
+                              const QByteArray &expectedSha256, QString *errorMessage)
+{
+    if (isRunning()) {
+        if (errorMessage) {
+            *errorMessage = "A download is already running.";
+        }
+        return false;
+    }
+
+    sourceUrl = url;
+    destination = destinationPath;
+    expectedBytes = expectedSize;
+    expectedDigest = expectedSha256.trimmed().toLower();
+    digest.clear();
+    total = -1;
+    attempt = 0;
+
+    partFile.setFileName(partPath());
+    if (!partFile.open(QIODevice::ReadWrite)) {
+        if (errorMessage) {
+            *errorMessage = QString("Could not open %1: %2").arg(partPath(), partFile.errorString());
+        }
+        return false;
+    }
+
+    // Whatever an earlier run left is kept, it only has to be hashed again
+    hash.reset();
+    if (expectedBytes >= 0 && partFile.size() > expectedBytes) {
+        partFile.resize(0);
+    }
+    if (!hash.addData(&partFile)) {
+        partFile.close();
+        if (errorMessage) {
+            *errorMessage = QString("Could not read %1: %2").arg(partPath(), partFile.errorString());
+        }
+        return false;
+    }
+    received = partFile.size();
+    partFile.seek(received);
+    if (received > 0) {
+        qDebug() << "Resuming download of" << url.toString() << "at" << received << "bytes";
+    }
+
+    rateClock.start();
+    rateMark = received;
+    rateMarkMs = 0;
+    bytesPerSecond = 0.0;
+
+    sendRequest();
+    return true;
+}
+
+void NightlyDownloader::abort()
+{
+    if (!isRunning()) {
+        return;
+    }
+    retryTimer->stop();
+    dropReply();
+    finish(false, "Download cancelled.");
+}
+
+void NightlyDownloader::sendRequest()
+{
+    QNetworkRequest request(sourceUrl);
+    request.setAttribute(QNetworkRequest::RedirectPolicyAttribute, QNetworkRequest::NoLessSafeRedirectPolicy);
+    // Byte offsets only mean something on the raw body, so no transparent decompression
+    request.setRawHeader("Accept-Encoding", "identity");
+    if (received > 0) {
+        request.setRawHeader("Range", QByteArray("bytes=") + QByteArray::number(received) + '-');
+    }
+    requestOffset = received;
+    attemptBytes = 0;
+    accepting = false;
+
+    reply = manager->get(request);
+    reply->setReadBufferSize(4 * ChunkSize); // Backpressure instead of holding the whole file in memory
+    connect(reply, &QNetworkReply::metaDataChanged, this, &NightlyDownloader::onMetaDataChanged);
+    connect(reply, &QNetworkReply::readyRead, this, &NightlyDownloader::onReadyRead);
+    connect(reply, &QNetworkReply::finished, this, &NightlyDownloader::onFinished);
+}
+
+void NightlyDownloader::dropReply()
+{
+    if (reply) {
+        QNetworkReply *current = reply;
+        reply = nullptr;
+        current->disconnect(this);
+        current->abort();
+        current->deleteLater();
+    }
+}
+
+bool NightlyDownloader::truncatePart()
+{
+    hash.reset();
+    received = 0;
+    rateMark = 0;
+    if (!partFile.resize(0) || !partFile.seek(0)) {
+        return false;
+    }
+    emit bytesWritten(0);
+    return true;
+}
+
+void NightlyDownloader::restartFromScratch()
+{
+    dropReply();
+    if (!truncatePart()) {
+        finish(false, QString("Could not truncate %1: %2").arg(partPath(), partFile.errorString()));
+        return;
+    }
+    sendRequest();
+}
+
+void NightlyDownloader::onMetaDataChanged()
+{
+    const int status = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    if (status >= 300 && status < 400) {
+        return; // Redirects are followed, the final response comes later
+    }
+
+    accepting = false;
+    qint64 rangeStart = -1;
+    qint64 rangeTotal = -1;
+    const bool hasRange = parseContentRange(reply->rawHeader("Content-Range"), &rangeStart, &rangeTotal);
+
+    if (status == 206) {
+        if (!hasRange || rangeStart != requestOffset) {
+            qDebug() << "Unexpected Content-Range" << reply->rawHeader("Content-Range") << "for offset" << requestOffset;
+            restartFromScratch();
+            return;
+        }
+        total = rangeTotal;
+        accepting = true;
+    } else if (status == 200) {
+        // Servers that don't do ranges send everything again
+        if (requestOffset > 0) {
+            qDebug() << "Server ignored the Range request, starting over";
+            if (!truncatePart()) {
+                dropReply();
+                finish(false, QString("Could not truncate %1: %2").arg(partPath(), partFile.errorString()));
+                return;
+            }
+            requestOffset = 0;
+        }
+        const QVariant length = reply->header(QNetworkRequest::ContentLengthHeader);
+        total = length.isValid() ? length.toLongLong() : -1;
+        accepting = true;
+    } else if (status == 416) {
+        // Nothing past our offset: either the part file is already complete or it's stale
+        if (hasRange && rangeTotal == received) {
+            total = rangeTotal;
+            dropReply();
+            complete();
+        } else {
+            restartFromScratch();
+        }
+    }
+}
+
+void NightlyDownloader::onReadyRead()
+{
+    if (!reply) {
+        return;
+    }
+    if (!accepting) {
+        reply->readAll(); // Error page or redirect body
+        return;
+    }
+
+    qint64 written = 0;
+    while (reply->bytesAvailable() > 0) {
+        const QByteArray chunk = reply->read(ChunkSize);
+        if (partFile.write(chunk) != chunk.size()) {
+            dropReply();
+            finish(false, QString("Could not write %1: %2").arg(partPath(), partFile.errorString()));
+            return;
+        }
+        hash.addData(chunk);
+        written += chunk.size();
+    }
+    if (written == 0) {
+        return;
+    }
+
+    received += written;
+    attemptBytes += written;
+    partFile.flush();
+    emit bytesWritten(received);
+    reportProgress(false);
+}
+
+void NightlyDownloader::onFinished()
+{
+    if (!reply) {
+        return;
+    }
+    onReadyRead();
+    if (!reply) {
+        return; // A write failed and the download already finished
+    }
+
+    QNetworkReply *current = reply;
+    reply = nullptr;
+    current->deleteLater();
+
+    const int status = current->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    if (status >= 400 && status < 500 && status != 408 && status != 429) {
+        finish(false, QString("The server answered HTTP %1 for %2.").arg(status).arg(sourceUrl.toString()));
+        return;
+    }
+    if (current->error() != QNetworkReply::NoError) {
+        retryOrFail(current->errorString());
+        return;
+    }
+    if (!accepting) {
+        retryOrFail(QString("Unexpected HTTP %1 response.").arg(status));
+        return;
+    }
+    if (total >= 0 && received < total) {
+        retryOrFail(QString("Connection closed at %1 of %2 bytes.").arg(received).arg(total));
+        return;
+    }
+    complete();
+}
+
+void NightlyDownloader::retryOrFail(const QString &errorMessage)
+{
+    // Only requests that got nowhere count against the limit
+    if (attemptBytes > 0) {
+        attempt = 0;
+    }
+    if (++attempt > maxRetries) {
+        finish(false, QString("%1 Gave up after %2 attempts.").arg(errorMessage).arg(attempt));
+        return;
+    }
+
+    qDebug() << "Download interrupted at" << received << "bytes:" << errorMessage << "- retrying";
+    retryTimer->start(retryDelayMs * attempt);
+}
+
+void NightlyDownloader::complete()
+{
+    emit finalizing();
+    reportProgress(true);
+    digest = hash.result().toHex();
+    partFile.close();
+
+    // A part file that fails the checks would fail them again on resume, so it goes
+    QString problem;
+    if (total >= 0 && received != total) {
+        problem = QString("Downloaded %1 bytes but the server announced %2.").arg(received).arg(total);
+    } else if (expectedBytes >= 0 && received != expectedBytes) {
+        problem = QString("Downloaded %1 bytes, expected %2.").arg(received).arg(expectedBytes);
+    } else if (!expectedDigest.isEmpty() && digest != expectedDigest) {
+        problem = QString("SHA-256 mismatch: got %1, expected %2.").arg(QString::fromLatin1(digest), QString::fromLatin1(expectedDigest));
+    }
+    if (!problem.isEmpty()) {
+        QFile::remove(partPath());
+        finish(false, problem);
+        return;
+    }
+
+    if (QFile::exists(destination) && !QFile::remove(destination)) {
+        finish(false, QString("Could not replace %1.").arg(destination));
+        return;
+    }
+    if (!QFile::rename(partPath(), destination)) {
+        finish(false, QString("Could not rename %1 to %2.").arg(partPath(), destination));
+        return;
+    }
+    finish(true, QString());
+}
+
+void NightlyDownloader::finish(bool success, const QString &errorMessage)
+{
+    partFile.close();
+    emit finished(success, errorMessage);
+}
+
+void NightlyDownloader::reportProgress(bool force)
+{
+    const qint64 nowMs = rateClock.elapsed();
+    const qint64 elapsedMs = nowMs - rateMarkMs;
+    if (!force && elapsedMs < 250) {
+        return;
+    }
+
+    if (elapsedMs > 0) {
+        const double sample = (received - rateMark) * 1000.0 / elapsedMs;
+        bytesPerSecond = bytesPerSecond > 0.0 ? 0.7 * bytesPerSecond + 0.3 * sample : sample;
+        rateMark = received;
+        rateMarkMs = nowMs;
+    }
+
+    const qint64 eta = total >= 0 && bytesPerSecond > 0.0 ? qint64((total - received) / bytesPerSecond) : -1;
+    emit progress(received, total, bytesPerSecond, eta);
+}
@@ -0,0 +1,97 @@
+#ifndef NIGHTLYDOWNLOADER_H
+#define NIGHTLYDOWNLOADER_H
+
+#include <QObject>
+#include <QUrl>
+#include <QFile>
+#include <QPointer>
+#include <QElapsedTimer>
+#include <QCryptographicHash>
+
+class QNetworkAccessManager;
+class QNetworkReply;
+class QTimer;
+
+// Streams a download to <destination>.part in chunks, resuming with an HTTP Range request
+// after an interruption or from a part file an earlier run left behind. The part file only
+// becomes <destination> once its size, and its SHA-256 when one is expected, check out.
+class NightlyDownloader : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr qint64 ChunkSize = 256 * 1024;
+
+    explicit NightlyDownloader(QObject *parent = nullptr);
+    ~NightlyDownloader() override;
+
+    // expectedSha256 is hex; empty skips the hash check, a negative size skips the size check
+    bool start(const QUrl &url, const QString &destinationPath, qint64 expectedSize = -1,
+               const QByteArray &expectedSha256 = QByteArray(), QString *errorMessage = nullptr);
+    void abort(); // The part file stays for the next start()
+    bool isRunning() const;
+
+    void setMaxRetries(int count) { maxRetries = count; }
+    void setRetryDelay(int ms) { retryDelayMs = ms; }
+
+    QString destinationPath() const { return destination; }
+    QString partPath() const { return destination + QLatin1String(".part"); }
+    qint64 bytesOnDisk() const { return received; }
+    qint64 totalBytes() const { return total; } // Negative until the server said
+    QByteArray sha256() const { return digest; } // Hex, once finished
+
+signals:
+    // Total and ETA are negative while unknown
+    void progress(qint64 received, qint64 total, double bytesPerSecond, qint64 etaSeconds);
+    // Everything up to bytesOnDisk is flushed to the part file and won't change, unless the
+    // server ignores a Range request and the download starts over (then it drops to 0)
+    void bytesWritten(qint64 bytesOnDisk);
+    // The part file is about to be checked and then renamed or removed; anything still reading
+    // it has to let go now (Windows won't rename a file that is open)
+    void finalizing();
+    void finished(bool success, const QString &errorMessage);
+
+private slots:
+    void onMetaDataChanged();
+    void onReadyRead();
+    void onFinished();
+
+private:
+    void sendRequest();
+    void dropReply();
+    bool truncatePart();
+    void restartFromScratch();
+    void retryOrFail(const QString &errorMessage);
+    void complete();
+    void finish(bool success, const QString &errorMessage);
+    void reportProgress(bool force);
+
+    QNetworkAccessManager *manager;
+    QPointer<QNetworkReply> reply;
+    QTimer *retryTimer;
+    QFile partFile;
+    QCryptographicHash hash;
+
+    QUrl sourceUrl;
+    QString destination;
+    qint64 expectedBytes = -1;
+    QByteArray expectedDigest;
+    QByteArray digest;
+
+    qint64 received = 0;
+    qint64 total = -1;
+    qint64 requestOffset = 0;  // Where the current request's body starts
+    qint64 attemptBytes = 0;   // Received by the current request
+    bool accepting = false;    // The current response body belongs in the part file
+    int attempt = 0;           // Consecutive requests that got nothing
+    int maxRetries = 5;
+    int retryDelayMs = 2000;
+
+    // Throughput, smoothed so the ETA doesn't jump around
+    QElapsedTimer rateClock;
+    qint64 rateMark = 0;
+    qint64 rateMarkMs = 0;
+    double bytesPerSecond = 0.0;
+};
+
+#endif // NIGHTLYDOWNLOADER_H
@@ -0,0 +1,198 @@
+#ifndef PERSISTENTVECTOR_H
+#define PERSISTENTVECTOR_H
+
+#include <QSharedPointer>
+#include <QVector>
+
+// Immutable vector stored as a radix tree with 32-way nodes. set() copies only the path to the
+// changed leaf and shares every other node with the original, so keeping many versions costs
+// memory proportional to what changed between them. Versions derived from each other can be
+// compared quickly because shared subtrees are pointer-equal and skipped.
+template <typename T>
+class PersistentVector
+{
+public:
+    static constexpr int Bits = 5;
+    static constexpr int Width = 1 << Bits;
+    static constexpr int Mask = Width - 1;
+
+    PersistentVector() : count(0), shift(0) {}
+
+    explicit PersistentVector(const QVector<T> &values)
+        : count(values.size())
+        , shift(0)
+    {
+        // Build the leaves, then group 32 nodes at a time until a single root is left
+        QVector<NodePointer> level;
+        level.reserve((count + Mask) / Width);
+        for (int offset = 0; offset < count; offset += Width) {
+            QSharedPointer<Node> leaf = QSharedPointer<Node>::create();
+            const int end = qMin(offset + Width, count);
+            leaf->values.reserve(end - offset);
+            for (int i = offset; i < end; ++i) {
+                leaf->values.append(values.at(i));
+            }
+            level.append(leaf);
+        }
+
+        while (level.size() > 1) {
+            QVector<NodePointer> parents;
+            parents.reserve((level.size() + Mask) / Width);
+            for (int offset = 0; offset < level.size(); offset += Width) {
+                QSharedPointer<Node> parent = QSharedPointer<Node>::create();
+                parent->children = level.mid(offset, Width);
+                parents.append(parent);
+            }
+            level = parents;
+            shift += Bits;
+        }
+        root = level.isEmpty() ? NodePointer() : level.first();
+    }
+
+    int size() const { return count; }
+    bool isEmpty() const { return count == 0; }
+
+    const T &at(int index) const
+    {
+        const Node *node = root.data();
+        for (int level = shift; level > 0; level -= Bits) {
+            node = node->children.at((index >> level) & Mask).data();
+        }
+        return node->values.at(index & Mask);
+    }
+
+    PersistentVector set(int index, const T &value) const
+    {
+        if (at(index) == value) {
+            return *this;
+        }
+        PersistentVector result(*this);
+        result.root = setIn(root, shift, index, value);
+        return result;
+    }
+
+    // Copies only the right edge; a full tree gets a new root with the old one as first child
+    PersistentVector append(const T &value) const
+    {
+        PersistentVector result(*this);
+        result.count = count + 1;
+        if (!root) {
+            result.root = newPath(0, value);
+        } else if (count == (1 << (shift + Bits))) {
+            QSharedPointer<Node> newRoot = QSharedPointer<Node>::create();
+            newRoot->children.append(root);
+            newRoot->children.append(newPath(shift, value));
+            result.root = newRoot;
+            result.shift = shift + Bits;
+        } else {
+            result.root = appendIn(root, shift, count, value);
+        }
+        return result;
+    }
+
+    QVector<T> toVector() const
+    {
+        QVector<T> values;
+        values.reserve(count);
+        collect(root, shift, values);
+        return values;
+    }
+
+    // Calls visit(index, fromValue, toValue) for every index whose value differs. Both versions
+    // must have the same size.
+    template <typename Visitor>
+    static void diff(const PersistentVector &from, const PersistentVector &to, Visitor visit)
+    {
+        Q_ASSERT(from.count == to.count && from.shift == to.shift);
+        diffNodes(from.root, to.root, from.shift, 0, visit);
+    }
+
+    bool sharesRootWith(const PersistentVector &other) const { return root == other.root; }
+
+private:
+    struct Node;
+    using NodePointer = QSharedPointer<const Node>;
+
+    struct Node {
+        QVector<NodePointer> children; // Inner nodes
+        QVector<T> values;             // Leaves
+    };
+
+    static NodePointer setIn(const NodePointer &node, int level, int index, const T &value)
+    {
+        QSharedPointer<Node> copy = QSharedPointer<Node>::create(*node);
+        if (level == 0) {
+            copy->values[index & Mask] = value;
+        } else {
+            const int slot = (index >> level) & Mask;
+            copy->children[slot] = setIn(node->children.at(slot), level - Bits, index, value);
+        }
+        return copy;
+    }
+
+    static NodePointer newPath(int level, const T &value)
+    {
+        QSharedPointer<Node> node = QSharedPointer<Node>::create();
+        if (level == 0) {
+            node->values.append(value);
+        } else {
+            node->children.append(newPath(level - Bits, value));
+        }
+        return node;
+    }
+
+    static NodePointer appendIn(const NodePointer &node, int level, int index, const T &value)
+    {
+        QSharedPointer<Node> copy = QSharedPointer<Node>::create(*node);
+        if (level == 0) {
+            copy->values.append(value);
+        } else {
+            const int slot = (index >> level) & Mask;
+            if (slot < copy->children.size()) {
+                copy->children[slot] = appendIn(node->children.at(slot), level - Bits, index, value);
+            } else {
+                copy->children.append(newPath(level - Bits, value));
+            }
+        }
+        return copy;
+    }
+
+    static void collect(const NodePointer &node, int level, QVector<T> &values)
+    {
+        if (!node) {
+            return;
+        }
+        if (level == 0) {
+            values.append(node->values);
+            return;
+        }
+        for (const NodePointer &child : node->children) {
+            collect(child, level - Bits, values);
+        }
+    }
+
+    template <typename Visitor>
+    static void diffNodes(const NodePointer &a, const NodePointer &b, int level, int offset, Visitor &visit)
+    {
+        if (a == b || !a || !b) {
+            return;
+        }
+        if (level == 0) {
+            for (int i = 0; i < a->values.size(); ++i) {
+                if (!(a->values.at(i) == b->values.at(i))) {
+                    visit(offset + i, a->values.at(i), b->values.at(i));
+                }
+            }
+            return;
+        }
+        for (int i = 0; i < a->children.size(); ++i) {
+            diffNodes(a->children.at(i), b->children.at(i), level - Bits, offset + (i << level), visit);
+        }
+    }
+
+    NodePointer root;
+    int count;
+    int shift;
+};
+
+#endif // PERSISTENTVECTOR_H
@@ -0,0 +1,206 @@
+#include "prototypetrie.h"
+
+PrototypeTrie::PrototypeTrie()
+{
+    clear();
+}
+
+void PrototypeTrie::clear()
+{
+    nodes.clear();
+    nodes.append(Node());
+}
+
+int PrototypeTrie::findChild(const Node &node, QChar first) const
+{
+    // Binary search over the sorted first characters
+    int low = 0;
+    int high = node.children.size() - 1;
+    while (low <= high) {
+        const int middle = (low + high) / 2;
+        const QChar c = nodes.at(node.children.at(middle)).label.at(0);
+        if (c == first) {
+            return middle;
+        }
+        if (c < first) {
+            low = middle + 1;
+        } else {
+            high = middle - 1;
+        }
+    }
+    return -(low + 1); // Insertion point
+}
+
+bool PrototypeTrie::contains(const QString &path) const
+{
+    const Position position = locate(path);
+    return position.node >= 0 && position.offset == nodes.at(position.node).label.size() && nodes.at(position.node).terminal;
+}
+
+bool PrototypeTrie::insert(const QString &path)
+{
+    if (path.isEmpty() || contains(path)) {
+        return false;
+    }
+
+    int node = 0;
+    int position = 0;
+    for (;;) {
+        nodes[node].count++;
+        if (position == path.size()) {
+            nodes[node].terminal = true;
+            return true;
+        }
+
+        const int slot = findChild(nodes.at(node), path.at(position));
+        if (slot < 0) {
+            Node leaf;
+            leaf.label = path.mid(position);
+            leaf.count = 1;
+            leaf.terminal = true;
+            nodes.append(leaf);
+            nodes[node].children.insert(-slot - 1, nodes.size() - 1);
+            return true;
+        }
+
+        const int child = nodes.at(node).children.at(slot);
+        const QString &label = nodes.at(child).label;
+        int common = 0;
+        while (common < label.size() && position + common < path.size() && label.at(common) == path.at(position + common)) {
+            ++common;
+        }
+
+        if (common < label.size()) {
+            // Split the edge; the new node takes the shared part and the old child keeps the rest
+            Node middle;
+            middle.label = label.left(common);
+            middle.count = nodes.at(child).count;
+            middle.children.append(child);
+            nodes[child].label = label.mid(common);
+            nodes.append(middle);
+            nodes[node].children[slot] = nodes.size() - 1;
+            node = nodes.size() - 1;
+        } else {
+            node = child;
+        }
+        position += common;
+    }
+}
+
+PrototypeTrie::Position PrototypeTrie::locate(const QString &prefix) const
+{
+    Position result;
+    int node = 0;
+    int position = 0;
+    while (position < prefix.size()) {
+        const int slot = findChild(nodes.at(node), prefix.at(position));
+        if (slot < 0) {
+            return Position();
+        }
+
+        node = nodes.at(node).children.at(slot);
+        const QString &label = nodes.at(node).label;
+        int matched = 0;
+        while (matched < label.size() && position + matched < prefix.size()) {
+            if (label.at(matched) != prefix.at(position + matched)) {
+                return Position();
+            }
+            ++matched;
+        }
+        result.path += label;
+        result.offset = matched;
+        position += matched;
+    }
+
+    result.node = node;
+    if (node == 0) {
+        result.offset = 0;
+    }
+    return result;
+}
+
+int PrototypeTrie::countWithPrefix(const QString &prefix) const
+{
+    const Position position = locate(prefix);
+    return position.node >= 0 ? nodes.at(position.node).count : 0;
+}
+
+bool PrototypeTrie::collect(int node, const QString &path, int &remaining, const std::function<void(const QString &)> &visit) const
+{
+    const Node &current = nodes.at(node);
+    if (current.terminal) {
+        if (remaining == 0) {
+            return false;
+        }
+        visit(path);
+        --remaining;
+    }
+    for (int child : current.children) {
+        if (!collect(child, path + nodes.at(child).label, remaining, visit)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+QStringList PrototypeTrie::completions(const QString &prefix, int limit) const
+{
+    QStringList paths;
+    const Position position = locate(prefix);
+    if (position.node < 0) {
+        return paths;
+    }
+
+    int remaining = limit;
+    collect(position.node, position.path, remaining, [&paths](const QString &path) {
+        paths.append(path);
+    });
+    return paths;
+}
+
+void PrototypeTrie::forEachWithPrefix(const QString &prefix, const std::function<void(const QString &)> &visit) const
+{
+    const Position position = locate(prefix);
+    if (position.node < 0) {
+        return;
+    }
+
+    int remaining = nodes.at(position.node).count;
+    collect(position.node, position.path, remaining, visit);
+}
+
+void PrototypeTrie::collectSegments(int node, const QString &base, int from, int limit, QVector<QPair<QString, int>> &out) const
+{
+    if (out.size() >= limit) {
+        return;
+    }
+
+    const Node &current = nodes.at(node);
+    const int slash = current.label.indexOf('/', from);
+    if (slash >= 0) {
+        out.append({base + current.label.left(slash + 1), current.count});
+        return;
+    }
+
+    const QString path = base + current.label;
+    if (current.terminal) {
+        out.append({path, 1});
+    }
+    for (int child : current.children) {
+        collectSegments(child, path, 0, limit, out);
+    }
+}
+
+QVector<QPair<QString, int>> PrototypeTrie::nextSegments(const QString &prefix, int limit) const
+{
+    QVector<QPair<QString, int>> segments;
+    const Position position = locate(prefix);
+    if (position.node < 0) {
+        return segments;
+    }
+
+    // The prefix may end in the middle of an edge, the search for '/' starts right after it
+    const QString base = position.path.left(position.path.size() - nodes.at(position.node).label.size());
+    collectSegments(position.node, base, position.offset, limit, segments);
+    return segments;
+}
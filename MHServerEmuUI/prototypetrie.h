@@ -0,0 +1,58 @@
+#ifndef PROTOTYPETRIE_H
+#define PROTOTYPETRIE_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QPair>
+#include <functional>
+
+// Compressed (radix) trie over prototype paths such as
+// Loot/Tables/Events/CosmicChaosEvent/BrooklynChaos.prototype. Each node keeps the number of
+// distinct paths below it, so prefix counts are a single descent and completions only visit
+// the part of the tree they return.
+class PrototypeTrie
+{
+public:
+    PrototypeTrie();
+
+    void clear();
+    bool insert(const QString &path); // false if the path was already present
+    bool contains(const QString &path) const;
+    int size() const { return nodes.first().count; }
+
+    int countWithPrefix(const QString &prefix) const;
+
+    // Full paths under the prefix in sorted order
+    QStringList completions(const QString &prefix, int limit) const;
+
+    // The prefix extended up to and including the next '/', or to the end of a path, with the
+    // number of paths under each; "Loot/Ta" gives {"Loot/Tables/", 1234}, ...
+    QVector<QPair<QString, int>> nextSegments(const QString &prefix, int limit) const;
+
+    // Calls visit for every path under the prefix, in sorted order
+    void forEachWithPrefix(const QString &prefix, const std::function<void(const QString &)> &visit) const;
+
+private:
+    struct Node {
+        QString label;        // Edge label from the parent
+        QVector<int> children; // Sorted by the first character of their labels
+        int count = 0;        // Distinct paths ending in this subtree
+        bool terminal = false;
+    };
+
+    struct Position {
+        int node = -1;
+        QString path;   // Text from the root up to the end of node's label
+        int offset = 0; // Characters of node's label covered by the prefix
+    };
+
+    int findChild(const Node &node, QChar first) const;
+    Position locate(const QString &prefix) const;
+    bool collect(int node, const QString &path, int &remaining, const std::function<void(const QString &)> &visit) const;
+    void collectSegments(int node, const QString &base, int from, int limit, QVector<QPair<QString, int>> &out) const;
+
+    QVector<Node> nodes; // nodes[0] is the root
+};
+
+#endif // PROTOTYPETRIE_H
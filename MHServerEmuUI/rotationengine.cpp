@@ -0,0 +1,336 @@
+#include "rotationengine.h"
+#include <QJsonDocument>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QElapsedTimer>
+#include <cmath>
+#include <algorithm>
+#include <limits>
+
+namespace {
+
+constexpr double Pi = 3.14159265358979323846;
+
+} // namespace
+
+RotationConfig RotationConfig::pandemoniumDefaults()
+{
+    RotationConfig config;
+    const QPair<const char *, const char *> settings[] = {
+        {"eGTV_VendorXPGain", "Vendor XP"},
+        {"eGTV_XPGain", "XP Boost"},
+        {"eGTV_LootSpecialDropRate", "SiF"},
+        {"eGTV_LootRarity", "RiF"}
+    };
+    for (const auto &entry : settings) {
+        RotationSetting setting;
+        setting.setting = entry.first;
+        setting.label = entry.second;
+        config.settings.append(setting);
+    }
+
+    // Four events and "none" at equal odds, as before
+    for (const char *name : {"ArmorIncursion", "CosmicChaos", "MidtownMadness", "OdinsBounty"}) {
+        config.subEvents.append({name, 1.0});
+    }
+    config.noEventWeight = 1.0;
+    return config;
+}
+
+bool RotationConfig::fromJson(const QByteArray &json, RotationConfig *config, QString *errorMessage)
+{
+    QJsonParseError parseError;
+    const QJsonDocument doc = QJsonDocument::fromJson(json, &parseError);
+    if (!doc.isObject()) {
+        if (errorMessage) {
+            *errorMessage = parseError.error != QJsonParseError::NoError ? parseError.errorString() : QString("Expected a JSON object.");
+        }
+        return false;
+    }
+
+    const QJsonObject root = doc.object();
+    RotationConfig result = pandemoniumDefaults();
+    result.fileName = root.value("FileName").toString(result.fileName);
+    result.noEventWeight = root.value("NoEventWeight").toDouble(result.noEventWeight);
+
+    if (root.contains("Settings")) {
+        result.settings.clear();
+        for (const QJsonValue &value : root.value("Settings").toArray()) {
+            const QJsonObject object = value.toObject();
+            RotationSetting setting;
+            setting.prototype = object.value("Prototype").toString();
+            setting.setting = object.value("Setting").toString();
+            setting.label = object.value("Label").toString(setting.setting);
+            if (setting.setting.isEmpty()) {
+                continue;
+            }
+
+            const QString distribution = object.value("Distribution").toString("Uniform").toLower();
+            if (distribution == "normal") {
+                setting.distribution = RotationSetting::Normal;
+            } else if (distribution == "triangular") {
+                setting.distribution = RotationSetting::Triangular;
+            } else if (distribution == "choice") {
+                setting.distribution = RotationSetting::Choice;
+            } else if (distribution != "uniform") {
+                if (errorMessage) {
+                    *errorMessage = QString("Unknown distribution \"%1\" for %2.").arg(distribution, setting.setting);
+                }
+                return false;
+            }
+
+            setting.hasRange = object.contains("Min") && object.contains("Max");
+            setting.minimum = object.value("Min").toDouble(setting.minimum);
+            setting.maximum = object.value("Max").toDouble(setting.maximum);
+            setting.mean = object.value("Mean").toDouble(std::numeric_limits<double>::quiet_NaN());
+            setting.standardDeviation = object.value("StdDev").toDouble(0.0);
+            setting.decimals = qBound(0, object.value("Decimals").toInt(2), 6);
+            for (const QJsonValue &choice : object.value("Choices").toArray()) {
+                setting.choices.append(choice.toDouble());
+            }
+            if (setting.distribution == RotationSetting::Choice && setting.choices.isEmpty()) {
+                if (errorMessage) {
+                    *errorMessage = QString("%1 uses Choice but lists no Choices.").arg(setting.setting);
+                }
+                return false;
+            }
+            result.settings.append(setting);
+        }
+    }
+
+    if (root.contains("SubEvents")) {
+        result.subEvents.clear();
+        for (const QJsonValue &value : root.value("SubEvents").toArray()) {
+            const QJsonObject object = value.toObject();
+            RotationSubEvent subEvent;
+            subEvent.name = object.value("Name").toString();
+            subEvent.weight = qMax(0.0, object.value("Weight").toDouble(1.0));
+            if (!subEvent.name.isEmpty()) {
+                result.subEvents.append(subEvent);
+            }
+        }
+    }
+
+    *config = result;
+    return true;
+}
+
+void RotationConfig::applyRanges(double minBoost, double maxBoost, int minDuration, int maxDuration)
+{
+    if (minBoost > maxBoost) {
+        std::swap(minBoost, maxBoost); // Ensure valid range
+    }
+    for (RotationSetting &setting : settings) {
+        if (!setting.hasRange) {
+            setting.minimum = minBoost;
+            setting.maximum = maxBoost;
+        } else if (setting.minimum > setting.maximum) {
+            std::swap(setting.minimum, setting.maximum);
+        }
+        if (std::isnan(setting.mean)) {
+            setting.mean = (setting.minimum + setting.maximum) / 2.0;
+        }
+        if (setting.standardDeviation <= 0.0) {
+            setting.standardDeviation = (setting.maximum - setting.minimum) / 4.0;
+        }
+    }
+
+    if (minDuration > maxDuration) {
+        std::swap(minDuration, maxDuration);
+    }
+    minDurationMinutes = qMax(1, minDuration);
+    maxDurationMinutes = qMax(minDurationMinutes, maxDuration);
+}
+
+RotationEngine::RotationEngine()
+    : generator(QRandomGenerator::global()->generate())
+{
+}
+
+void RotationEngine::setConfig(const RotationConfig &config)
+{
+    rotation = config;
+}
+
+void RotationEngine::setSeed(quint64 seed)
+{
+    generator.seed(static_cast<quint32>(seed ^ (seed >> 32)));
+}
+
+double RotationEngine::roll(const RotationSetting &setting)
+{
+    const double low = setting.minimum;
+    const double high = setting.maximum;
+    double value = low;
+
+    switch (setting.distribution) {
+    case RotationSetting::Uniform:
+        value = low + generator.generateDouble() * (high - low);
+        break;
+    case RotationSetting::Normal: {
+        // Box-Muller; 1 - u keeps the logarithm finite
+        const double u1 = 1.0 - generator.generateDouble();
+        const double u2 = generator.generateDouble();
+        const double z = std::sqrt(-2.0 * std::log(u1)) * std::cos(2.0 * Pi * u2);
+        value = qBound(low, setting.mean + z * setting.standardDeviation, high);
+        break;
+    }
+    case RotationSetting::Triangular: {
+        const double mode = qBound(low, setting.mean, high);
+        const double u = generator.generateDouble();
+        const double split = high > low ? (mode - low) / (high - low) : 0.0;
+        value = u < split ? low + std::sqrt(u * (high - low) * (mode - low))
+                          : high - std::sqrt((1.0 - u) * (high - low) * (high - mode));
+        break;
+    }
+    case RotationSetting::Choice:
+        value = setting.choices.at(static_cast<int>(generator.bounded(static_cast<quint32>(setting.choices.size()))));
+        break;
+    }
+
+    const double scale = std::pow(10.0, setting.decimals);
+    return std::round(value * scale) / scale;
+}
+
+int RotationEngine::pickSubEvent()
+{
+    double total = rotation.noEventWeight;
+    for (const RotationSubEvent &subEvent : rotation.subEvents) {
+        total += subEvent.weight;
+    }
+    if (total <= 0.0) {
+        return -1;
+    }
+
+    double pick = generator.generateDouble() * total;
+    for (int i = 0; i < rotation.subEvents.size(); ++i) {
+        pick -= rotation.subEvents.at(i).weight;
+        if (pick < 0.0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+RotationCycle RotationEngine::next()
+{
+    RotationCycle cycle;
+    cycle.values.reserve(rotation.settings.size());
+    for (const RotationSetting &setting : rotation.settings) {
+        cycle.values.append(roll(setting));
+    }
+    cycle.subEvent = pickSubEvent();
+    cycle.durationMinutes = rotation.minDurationMinutes
+                            + static_cast<int>(generator.bounded(static_cast<quint32>(rotation.maxDurationMinutes - rotation.minDurationMinutes + 1)));
+    return cycle;
+}
+
+void RotationEngine::applyTo(const RotationCycle &cycle, LiveTuningStore &store) const
+{
+    for (int i = 0; i < rotation.settings.size(); ++i) {
+        const RotationSetting &setting = rotation.settings.at(i);
+        const int index = store.indexOf(setting.prototype, setting.setting);
+        if (index >= 0) {
+            store.setValue(index, cycle.values.at(i));
+        } else {
+            store.append(setting.prototype, setting.setting, cycle.values.at(i));
+        }
+    }
+}
+
+QString RotationEngine::broadcastFor(const RotationCycle &cycle) const
+{
+    if (!rotation.detailedBroadcast) {
+        return "The chaos shifts once more...";
+    }
+
+    QStringList parts;
+    parts << "The Pandemonium shifts!";
+    for (int i = 0; i < rotation.settings.size(); ++i) {
+        const RotationSetting &setting = rotation.settings.at(i);
+        parts << QString("%1: %2x").arg(setting.label).arg(cycle.values.at(i), 0, 'f', setting.decimals);
+    }
+    if (cycle.subEvent >= 0) {
+        parts << QString("Bonus Event: %1!").arg(rotation.subEvents.at(cycle.subEvent).name);
+    } else {
+        parts << "No additional event this time...";
+    }
+    return parts.join(" ");
+}
+
+RotationEngine::SimulationReport RotationEngine::simulate(const RotationConfig &config, quint64 seed, int days)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    RotationEngine engine;
+    engine.setConfig(config);
+    engine.setSeed(seed);
+
+    SimulationReport report;
+    const int settingCount = config.settings.size();
+    report.subEventCycles.fill(0, config.subEvents.size() + 1);
+    report.subEventMinutes.fill(0, config.subEvents.size() + 1);
+    report.settingMeans.fill(0.0, settingCount);
+    report.settingMinimums.fill(std::numeric_limits<double>::max(), settingCount);
+    report.settingMaximums.fill(std::numeric_limits<double>::lowest(), settingCount);
+
+    const qint64 horizon = qint64(days) * 24 * 60;
+    int gap = 0;
+    while (report.minutes < horizon) {
+        const RotationCycle cycle = engine.next();
+        const qint64 minutes = qMin<qint64>(cycle.durationMinutes, horizon - report.minutes);
+        const int slot = cycle.subEvent >= 0 ? cycle.subEvent : config.subEvents.size();
+
+        report.cycles++;
+        report.minutes += minutes;
+        report.subEventCycles[slot]++;
+        report.subEventMinutes[slot] += minutes;
+        for (int i = 0; i < settingCount; ++i) {
+            const double value = cycle.values.at(i);
+            report.settingMeans[i] += value * minutes;
+            report.settingMinimums[i] = qMin(report.settingMinimums.at(i), value);
+            report.settingMaximums[i] = qMax(report.settingMaximums.at(i), value);
+        }
+
+        gap = cycle.subEvent >= 0 ? 0 : gap + 1;
+        report.longestGapCycles = qMax(report.longestGapCycles, gap);
+    }
+
+    for (double &mean : report.settingMeans) {
+        mean /= qMax<qint64>(report.minutes, 1);
+    }
+    report.elapsedNs = timer.nsecsElapsed();
+    return report;
+}
+
+QString RotationEngine::SimulationReport::toText(const RotationConfig &config) const
+{
+    QStringList lines;
+    const double days = minutes / 1440.0;
+    lines << QString("%1 rotations over %2 days, %3 minutes per rotation on average.")
+                 .arg(cycles).arg(days, 0, 'f', 1).arg(cycles > 0 ? double(minutes) / cycles : 0.0, 0, 'f', 1);
+    lines << QString();
+
+    lines << "Sub-events:";
+    for (int i = 0; i < subEventCycles.size(); ++i) {
+        const QString name = i < config.subEvents.size() ? config.subEvents.at(i).name : QString("(none)");
+        lines << QString("  %1: %2 times, %3% of the time, about %4 per day")
+                     .arg(name)
+                     .arg(subEventCycles.at(i))
+                     .arg(minutes > 0 ? 100.0 * subEventMinutes.at(i) / minutes : 0.0, 0, 'f', 1)
+                     .arg(days > 0 ? subEventCycles.at(i) / days : 0.0, 0, 'f', 1);
+    }
+    lines << QString("  Longest run without a sub-event: %1 rotations").arg(longestGapCycles);
+    lines << QString();
+
+    lines << "Settings (time-weighted mean, min, max):";
+    for (int i = 0; i < settingMeans.size(); ++i) {
+        lines << QString("  %1: %2, %3, %4")
+                     .arg(config.settings.at(i).label)
+                     .arg(settingMeans.at(i), 0, 'f', 3)
+                     .arg(settingMinimums.at(i))
+                     .arg(settingMaximums.at(i));
+    }
+    return lines.join("\n");
+}
@@ -0,0 +1,112 @@
+#ifndef ROTATIONENGINE_H
+#define ROTATIONENGINE_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QRandomGenerator>
+#include "livetuningstore.h"
+
+// Describes one randomized event rotation, Pandemonium Protocol being the built-in one. The
+// defaults reproduce the original behaviour; a JSON file can replace the settings, their
+// distributions, the sub-event pool and the weights:
+//
+//   {
+//     "FileName": "LiveTuningDataz_PandemoniumProtocol.json",
+//     "Settings": [ { "Setting": "eGTV_XPGain", "Label": "XP Boost", "Distribution": "Normal",
+//                     "Min": 1.5, "Max": 3.0, "Mean": 2.0, "StdDev": 0.4, "Decimals": 2 } ],
+//     "SubEvents": [ { "Name": "CosmicChaos", "Weight": 2 } ],
+//     "NoEventWeight": 1
+//   }
+//
+// Min/Max left out of a setting fall back to the boost range given in the UI.
+struct RotationSetting {
+    enum Distribution {
+        Uniform,
+        Normal,     // Clamped to [min, max]
+        Triangular, // Peaks at mean
+        Choice      // One of choices, uniformly
+    };
+
+    QString prototype;
+    QString setting;
+    QString label;
+    Distribution distribution = Uniform;
+    double minimum = 1.0;
+    double maximum = 2.0;
+    bool hasRange = false;
+    double mean = 0.0;
+    double standardDeviation = 0.0;
+    int decimals = 2;
+    QVector<double> choices;
+};
+
+struct RotationSubEvent {
+    QString name; // LiveTuningData_<name>.json / OFF_LiveTuningData_<name>.json
+    double weight = 1.0;
+};
+
+struct RotationConfig {
+    QString fileName = "LiveTuningDataz_PandemoniumProtocol.json";
+    QVector<RotationSetting> settings;
+    QVector<RotationSubEvent> subEvents;
+    double noEventWeight = 1.0;
+    int minDurationMinutes = 30;
+    int maxDurationMinutes = 60;
+    bool detailedBroadcast = true;
+
+    static RotationConfig pandemoniumDefaults();
+    static bool fromJson(const QByteArray &json, RotationConfig *config, QString *errorMessage);
+
+    // Fills in ranges the config left open and orders min/max pairs
+    void applyRanges(double minBoost, double maxBoost, int minDuration, int maxDuration);
+};
+
+struct RotationCycle {
+    QVector<double> values;  // One per config setting
+    int subEvent = -1;       // Index into the sub-event pool, -1 for none
+    int durationMinutes = 0;
+};
+
+class RotationEngine
+{
+public:
+    RotationEngine();
+
+    void setConfig(const RotationConfig &config);
+    const RotationConfig &config() const { return rotation; }
+
+    // Same seed, same sequence of cycles
+    void setSeed(quint64 seed);
+
+    RotationCycle next();
+
+    // Writes the cycle's values into the event file's entries, adding any that are missing
+    void applyTo(const RotationCycle &cycle, LiveTuningStore &store) const;
+    QString broadcastFor(const RotationCycle &cycle) const;
+
+    struct SimulationReport {
+        int cycles = 0;
+        qint64 minutes = 0;
+        QVector<int> subEventCycles;    // Per sub-event, plus one slot at the end for "none"
+        QVector<qint64> subEventMinutes;
+        QVector<double> settingMeans;   // Time-weighted
+        QVector<double> settingMinimums;
+        QVector<double> settingMaximums;
+        int longestGapCycles = 0;       // Most consecutive cycles without a sub-event
+        qint64 elapsedNs = 0;
+
+        QString toText(const RotationConfig &config) const;
+    };
+
+    static SimulationReport simulate(const RotationConfig &config, quint64 seed, int days);
+
+private:
+    double roll(const RotationSetting &setting);
+    int pickSubEvent();
+
+    RotationConfig rotation;
+    QRandomGenerator generator;
+};
+
+#endif // ROTATIONENGINE_H
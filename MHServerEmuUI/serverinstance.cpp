@@ -0,0 +1,413 @@
+#include "serverinstance.h"
+#include <QFile>
+#include <QDir>
+#include <QFileInfo>
+#include <QRegularExpression>
+#include <QDebug>
+
+ServerInstance::ServerInstance(const QString &name, const QString &serverPath, QObject *parent)
+    : QObject(parent)
+    , instanceName(name)
+    , rootPath(serverPath)
+    , apacheProcess(new QProcess(this))
+    , serverProcess(new QProcess(this))
+    , stopping(false)
+    , isProcessingClientInfo(false)
+    , rateTimer(new QTimer(this))
+    , rateSampleLines(0)
+    , rateSampleNs(0)
+    , players(0)
+{
+    commandClock.start();
+    rateTimer->setInterval(RateSampleIntervalMs);
+    connect(rateTimer, &QTimer::timeout, this, &ServerInstance::sampleConsoleRate);
+
+    connect(serverProcess, &QProcess::readyReadStandardOutput, this, &ServerInstance::readOutput);
+    connect(serverProcess, &QProcess::readyReadStandardError, this, &ServerInstance::readOutput);
+    connect(serverProcess, &QProcess::errorOccurred, this, [this]() {
+        if (!stopping) {
+            emit processError();
+        }
+    });
+    connect(serverProcess, &QProcess::stateChanged, this, [this](QProcess::ProcessState state) {
+        if (state == QProcess::Running) {
+            rateSampleLines = serverMetrics.consoleLinesTotal.load(std::memory_order_relaxed);
+            rateSampleNs = commandClock.nsecsElapsed();
+            rateTimer->start();
+        } else if (state == QProcess::NotRunning) {
+            serverMetrics.serverPid.store(0, std::memory_order_relaxed);
+            flushPartialLine(); // The last line may have had no newline
+            pendingCommands.clear();
+            setPlayerCount(0);
+            rateTimer->stop();
+            serverMetrics.consoleLinesPerSecond.store(0.0, std::memory_order_relaxed);
+        }
+        if (state != QProcess::Starting) {
+            emit runningChanged(state == QProcess::Running);
+        }
+    });
+    connect(apacheProcess, &QProcess::stateChanged, this, [this](QProcess::ProcessState state) {
+        if (state != QProcess::Starting) {
+            emit runningChanged(isRunning());
+        }
+    });
+}
+
+ServerInstance::~ServerInstance()
+{
+    stopping = true;
+
+    if (serverProcess->state() == QProcess::Running) {
+        serverProcess->terminate();
+        serverProcess->waitForFinished();
+    }
+
+    if (apacheProcess->state() == QProcess::Running) {
+        apacheProcess->terminate();
+        apacheProcess->waitForFinished();
+    }
+}
+
+QString ServerInstance::serverExecutable() const
+{
+    return serverExecutableOverride.isEmpty() ? rootPath + "/MHServerEmu/MHServerEmu.exe" : QProcess::splitCommand(serverExecutableOverride).value(0);
+}
+
+bool ServerInstance::start(bool killStrayProcesses, QString *errorMessage)
+{
+    if (rootPath.isEmpty() && serverExecutableOverride.isEmpty()) {
+        *errorMessage = "Please specify the server directory.";
+        return false;
+    }
+
+    QString apachePath = rootPath + "/Apache24/bin/httpd.exe";
+    QString mhServerPath = serverExecutable();
+    QString apacheRoot = rootPath + "/Apache24";
+    const bool useApache = serverExecutableOverride.isEmpty() || QFile::exists(apachePath);
+
+    // Clean up instances left over from a previous session. Skipped while sibling shards
+    // are running because taskkill matches by image name.
+    if (killStrayProcesses) {
+        QProcess::execute("taskkill", QStringList() << "/F" << "/IM" << "httpd.exe");
+        QProcess::execute("taskkill", QStringList() << "/F" << "/IM" << "MHServerEmu.exe");
+    }
+
+    // Check if executables exist
+    if (useApache && !QFile::exists(apachePath)) {
+        *errorMessage = QString("Apache executable (httpd.exe) not found at %1").arg(apachePath);
+        return false;
+    }
+
+    if (!QFile::exists(mhServerPath)) {
+        *errorMessage = QString("MHServerEmu executable not found at %1").arg(mhServerPath);
+        return false;
+    }
+
+    if (useApache) {
+        // Set environment variable for Apache
+        QProcessEnvironment env = QProcessEnvironment::systemEnvironment();
+        env.insert("APACHE_SERVER_ROOT", apacheRoot);
+        apacheProcess->setProcessEnvironment(env);
+
+        // Start Apache server
+        apacheProcess->setWorkingDirectory(rootPath + "/Apache24/bin");
+        apacheProcess->start(apachePath);
+        if (!apacheProcess->waitForStarted()) {
+            *errorMessage = "Failed to start Apache server. Check your configuration.";
+            return false;
+        }
+    } else {
+        qDebug() << instanceName << "Running" << mhServerPath << "without Apache";
+    }
+
+    // Start MHServerEmu; it reads its config once at startup
+    launchConfiguration = EffectiveConfig::fromFiles(rootPath + "/MHServerEmu/config.ini", rootPath + "/MHServerEmu/ConfigOverride.ini");
+    stopping = false;
+    serverProcess->setWorkingDirectory(QDir(rootPath + "/MHServerEmu").exists() ? rootPath + "/MHServerEmu" : QFileInfo(mhServerPath).absolutePath());
+    serverProcess->start(mhServerPath, QProcess::splitCommand(serverExecutableOverride).mid(1));
+    if (!serverProcess->waitForStarted()) {
+        *errorMessage = "Failed to start MHServerEmu.";
+        apacheProcess->kill(); // Stop Apache if MHServerEmu fails to start
+        return false;
+    }
+
+    serverMetrics.serverStartsTotal.fetch_add(1, std::memory_order_relaxed);
+    serverMetrics.serverPid.store(serverProcess->processId(), std::memory_order_relaxed);
+    return true;
+}
+
+void ServerInstance::stop()
+{
+    // Errors raised by our own terminate/kill are expected
+    stopping = true;
+
+    // Stop MHServerEmu process
+    if (serverProcess->state() == QProcess::Running) {
+        serverProcess->terminate();
+        if (!serverProcess->waitForFinished(5000)) { // Wait up to 5 seconds
+            qDebug() << instanceName << "MHServerEmu.exe did not terminate in time. Forcing kill.";
+            serverProcess->kill(); // Force kill if not finished
+            serverProcess->waitForFinished(); // Ensure it's fully killed
+        }
+    } else {
+        qDebug() << instanceName << "MHServerEmu.exe is not running. Skipping terminate.";
+    }
+
+    // Stop Apache process
+    if (apacheProcess->state() == QProcess::Running) {
+        apacheProcess->terminate();
+        if (!apacheProcess->waitForFinished(5000)) { // Wait up to 5 seconds
+            qDebug() << instanceName << "Apache process did not terminate in time. Forcing kill.";
+            apacheProcess->kill(); // Force kill if not finished
+            apacheProcess->waitForFinished(); // Ensure it's fully killed
+        }
+    } else {
+        qDebug() << instanceName << "Apache process is not running. Skipping terminate.";
+    }
+
+    stopping = false;
+    sessions.clear();
+    setPlayerCount(0);
+}
+
+bool ServerInstance::isRunning() const
+{
+    return serverProcess->state() == QProcess::Running;
+}
+
+bool ServerInstance::isApacheRunning() const
+{
+    return apacheProcess->state() == QProcess::Running;
+}
+
+void ServerInstance::sendCommand(const QString &command)
+{
+    QString line = command;
+    while (line.endsWith('\n')) {
+        line.chop(1);
+    }
+
+    if (line.startsWith("!server reloadlivetuning")) {
+        serverMetrics.liveTuningReloadsTotal.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    QString argument;
+    const CommandReply reply = replyFor(line, &argument);
+    if (reply != CommandReply::None) {
+        expireCommands();
+        pendingCommands.enqueue({serverCommandKind(line), reply, argument, commandClock.nsecsElapsed()});
+    }
+    serverProcess->write(line.toUtf8() + '\n');
+}
+
+ServerInstance::CommandReply ServerInstance::replyFor(const QString &command, QString *argument)
+{
+    const QStringList parts = command.split(' ', Qt::SkipEmptyParts);
+    const QString verb = parts.value(0) + ' ' + parts.value(1);
+    if (verb == "!server reloadlivetuning") {
+        return CommandReply::LiveTuningReload;
+    }
+    if (verb == "!server broadcast") {
+        return CommandReply::Broadcast;
+    }
+    if (verb == "!client info" && parts.size() >= 3) {
+        *argument = parts.at(2);
+        return CommandReply::ClientInfo;
+    }
+    return CommandReply::None;
+}
+
+void ServerInstance::completeCommand(CommandReply reply, const QString &argument)
+{
+    // The oldest command waiting for this reply, other commands may still be outstanding
+    for (int i = 0; i < pendingCommands.size(); ++i) {
+        const PendingCommand &command = pendingCommands.at(i);
+        if (command.reply == reply && (argument.isEmpty() || command.argument.compare(argument, Qt::CaseInsensitive) == 0)) {
+            serverMetrics.commandLatency[static_cast<int>(command.kind)].observe(commandClock.nsecsElapsed() - command.sentAtNs);
+            pendingCommands.removeAt(i);
+            return;
+        }
+    }
+}
+
+void ServerInstance::expireCommands()
+{
+    const qint64 nowNs = commandClock.nsecsElapsed();
+    while (!pendingCommands.isEmpty() && nowNs - pendingCommands.head().sentAtNs > CommandReplyTimeoutNs) {
+        pendingCommands.dequeue();
+    }
+}
+
+void ServerInstance::requestClientInfo(const QString &sessionId, const QString &username, const QString &email)
+{
+    // Remember who asked so the reply block can be labelled
+    userInfoMap[sessionId] = {username, email};
+    sendCommand(QString("!client info %1").arg(sessionId));
+}
+
+void ServerInstance::removeSession(const QString &sessionId)
+{
+    if (sessions.remove(sessionId)) {
+        qDebug() << "Removed user from map with SessionId:" << sessionId;
+    } else {
+        qDebug() << "SessionId not found in map:" << sessionId;
+    }
+}
+
+void ServerInstance::setPlayerCount(int count)
+{
+    count = qMax(count, 0); // Ensure count doesn't go negative
+    serverMetrics.playersOnline.store(count, std::memory_order_relaxed);
+    if (count != players) {
+        players = count;
+        emit playerCountChanged(players);
+    }
+}
+
+void ServerInstance::readOutput()
+{
+    handleOutput(serverProcess->readAllStandardOutput(), serverProcess->readAllStandardError());
+}
+
+void ServerInstance::handleOutput(const QByteArray &output, const QByteArray &errorOutput)
+{
+    expireCommands();
+    serverMetrics.consoleLinesTotal.fetch_add(output.count('\n') + errorOutput.count('\n'), std::memory_order_relaxed);
+
+    QString outputText = QString::fromLocal8Bit(output);
+    if (!outputText.isEmpty()) {
+        emit outputReceived(outputText, false);
+    }
+
+    if (!errorOutput.isEmpty()) {
+        emit outputReceived(QString::fromLocal8Bit(errorOutput), true);
+    }
+
+    // A read can end mid-line; the tail waits for the rest so no line is parsed in two halves
+    QString lineText;
+    if (outputRemainder.isEmpty() && output.endsWith('\n')) {
+        lineText = outputText;
+    } else {
+        outputRemainder += output;
+        const int end = outputRemainder.lastIndexOf('\n');
+        if (end >= 0) {
+            lineText = QString::fromLocal8Bit(outputRemainder.constData(), end + 1);
+            outputRemainder.remove(0, end + 1);
+        } else if (outputRemainder.size() > MaxPartialLineBytes) {
+            flushPartialLine(); // Not a console line, don't buffer it forever
+        }
+    }
+
+    QStringList lines = lineText.split('\n', Qt::SkipEmptyParts);
+    for (int i = 0; i < lines.size(); ++i) {
+        processLine(lines.at(i));
+    }
+}
+
+void ServerInstance::sampleConsoleRate()
+{
+    // One rate per interval, however many scrapers read it
+    const quint64 lines = serverMetrics.consoleLinesTotal.load(std::memory_order_relaxed);
+    const qint64 nowNs = commandClock.nsecsElapsed();
+    if (nowNs > rateSampleNs && lines >= rateSampleLines) {
+        serverMetrics.consoleLinesPerSecond.store((lines - rateSampleLines) * 1e9 / (nowNs - rateSampleNs), std::memory_order_relaxed);
+    }
+    rateSampleLines = lines;
+    rateSampleNs = nowNs;
+}
+
+void ServerInstance::flushPartialLine()
+{
+    if (!outputRemainder.isEmpty()) {
+        const QString line = QString::fromLocal8Bit(outputRemainder);
+        outputRemainder.clear();
+        processLine(line);
+    }
+}
+
+void ServerInstance::processLine(const QString &line)
+{
+    // Check for the start of client info
+    if (line.contains("SessionId:") && !isProcessingClientInfo) {
+        isProcessingClientInfo = true;
+        clientInfoBuffer.clear();
+
+        static const QRegularExpression sessionRegex(R"(SessionId:\s*(\S+))");
+        const QString sessionId = sessionRegex.match(line).captured(1);
+        if (!sessionId.isEmpty()) {
+            completeCommand(CommandReply::ClientInfo, sessionId);
+        }
+    }
+
+    // Accumulate client info lines
+    if (isProcessingClientInfo) {
+        clientInfoBuffer.append(line + '\n');
+
+        // Detect the end of the client info block
+        if (!line.contains(":")) {
+            isProcessingClientInfo = false;
+
+            // Extract the SessionId from the buffer
+            static const QRegularExpression regex(R"(SessionId:\s*(\S+))");
+            QRegularExpressionMatch match = regex.match(clientInfoBuffer);
+
+            QString sessionId;
+            if (match.hasMatch()) {
+                sessionId = match.captured(1).trimmed();
+            }
+
+            // Retrieve username and email from the map
+            QPair<QString, QString> userInfo = userInfoMap.take(sessionId);
+            emit clientInfoReceived(clientInfoBuffer.trimmed(), userInfo.first, userInfo.second);
+            clientInfoBuffer.clear();
+        }
+        return;
+    }
+
+    // Replies to timed commands
+    if (!pendingCommands.isEmpty()) {
+        if (line.contains("[LiveTuningManager]")) {
+            completeCommand(CommandReply::LiveTuningReload);
+        } else if (line.contains("Broadcast", Qt::CaseInsensitive)) {
+            completeCommand(CommandReply::Broadcast);
+        }
+    }
+
+    // Check for player connection logs
+    if (line.contains("[PlayerConnectionManager] Accepted and registered client")) {
+        serverMetrics.loginsTotal.fetch_add(1, std::memory_order_relaxed);
+
+        static const QRegularExpression regex(R"(\[Account=(.+) \(0x[0-9A-Fa-f]+\), SessionId=(0x[0-9A-Fa-f]+)\])");
+        QRegularExpressionMatch match = regex.match(line);
+        if (match.hasMatch()) {
+            QString accountName = match.captured(1);
+            QString sessionId = match.captured(2);
+            sessions[sessionId] = accountName;
+            emit playerLoggedIn(sessionId, accountName);
+        }
+        setPlayerCount(players + 1);
+    }
+    // Check for player disconnection logs
+    else if (line.contains("[PlayerConnectionManager] Removed client")) {
+        serverMetrics.logoutsTotal.fetch_add(1, std::memory_order_relaxed);
+
+        static const QRegularExpression regex(R"(\[Account=(.+) \(.*?\), SessionId=(0x[0-9A-Fa-f]+)\])");
+        QRegularExpressionMatch match = regex.match(line);
+        if (match.hasMatch()) {
+            QString username = match.captured(1).trimmed();
+            QString sessionId = match.captured(2).trimmed();
+            sessions.remove(sessionId);
+            emit playerLoggedOut(sessionId, username);
+        } else {
+            qDebug() << "Failed to parse logout event.";
+        }
+        setPlayerCount(players - 1);
+    }
+    // Check for server shutdown
+    else if (line.contains("[ServerManager] Shutdown finished")) {
+        // Only this instance's process, sibling shards share the image name
+        serverProcess->kill();
+        sessions.clear();
+        setPlayerCount(0);
+    }
+}
@@ -0,0 +1,142 @@
+#ifndef SERVERINSTANCE_H
+#define SERVERINSTANCE_H
+
+#include <QObject>
+#include <QProcess>
+#include <QMap>
+#include <QPair>
+#include <QQueue>
+#include <QElapsedTimer>
+#include <QTimer>
+#include "servermetrics.h"
+#include "livetuningstore.h"
+#include "effectivelivetuning.h"
+#include "livetuningjournal.h"
+#include "effectiveconfig.h"
+#include "capacityplanner.h"
+
+// One MHServerEmu install: its Apache/MHServerEmu process pair, console pipeline,
+// session registry and live tuning state.
+class ServerInstance : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit ServerInstance(const QString &name, const QString &serverPath, QObject *parent = nullptr);
+    ~ServerInstance() override;
+
+    QString name() const { return instanceName; }
+    QString serverPath() const { return rootPath; }
+    void setServerPath(const QString &path) { rootPath = path; }
+    QString liveTuningPath() const { return rootPath + "/MHServerEmu/Data/Game/LiveTuning/"; }
+
+    // Command line to run instead of MHServerEmu.exe, e.g. the mock server with its options;
+    // empty for the real one. Apache becomes optional while an override is set.
+    QString executableOverride() const { return serverExecutableOverride; }
+    void setExecutableOverride(const QString &commandLine) { serverExecutableOverride = commandLine.trimmed(); }
+    QString serverExecutable() const;
+
+    bool start(bool killStrayProcesses, QString *errorMessage);
+    void stop();
+    bool isRunning() const;
+    bool isApacheRunning() const;
+
+    void sendCommand(const QString &command);
+    void requestClientInfo(const QString &sessionId, const QString &username, const QString &email);
+
+    int playerCount() const { return players; }
+    const QMap<QString, QString> &loggedInUsers() const { return sessions; } // SessionId -> Account Name
+    void removeSession(const QString &sessionId);
+
+    // Runs one read of console output through the pipeline; readOutput() feeds it from the process
+    void handleOutput(const QByteArray &output, const QByteArray &errorOutput = QByteArray());
+
+    LiveTuningStore &liveTuning() { return liveTuningStore; }
+    EffectiveLiveTuning &effectiveLiveTuning() { return effectiveTuning; }
+    LiveTuningJournal &liveTuningJournal() { return tuningJournal; }
+    QString &currentSubEvent() { return pandemoniumSubEvent; }
+
+    // config.ini + ConfigOverride.ini as they were when the server process was last started
+    const EffectiveConfig &launchConfig() const { return launchConfiguration; }
+
+    ServerMetrics &metrics() { return serverMetrics; }
+    const ServerMetrics &metrics() const { return serverMetrics; }
+    CapacityPlanner &capacityPlanner() { return capacity; }
+
+signals:
+    void outputReceived(const QString &text, bool isError);
+    void playerLoggedIn(const QString &sessionId, const QString &accountName);
+    void playerLoggedOut(const QString &sessionId, const QString &accountName);
+    void playerCountChanged(int count);
+    void clientInfoReceived(const QString &info, const QString &username, const QString &email);
+    void runningChanged(bool running);
+    void processError();
+
+private slots:
+    void readOutput();
+
+private:
+    // What the server prints back for a command; only these are timed
+    enum class CommandReply {
+        None,
+        LiveTuningReload, // [LiveTuningManager] line
+        Broadcast,        // Line mentioning the broadcast
+        ClientInfo        // "SessionId: <id>" block for the requested session
+    };
+
+    struct PendingCommand {
+        ServerCommandKind kind;
+        CommandReply reply;
+        QString argument; // Session id for client info
+        qint64 sentAtNs;
+    };
+
+    // Commands whose reply never shows up are dropped instead of timed against unrelated output
+    static constexpr qint64 CommandReplyTimeoutNs = 30000000000LL;
+
+    static CommandReply replyFor(const QString &command, QString *argument);
+    void completeCommand(CommandReply reply, const QString &argument = QString());
+    void expireCommands();
+
+    static constexpr int MaxPartialLineBytes = 1024 * 1024; // A "line" this long is flushed as is
+    static constexpr int RateSampleIntervalMs = 5000;
+    void flushPartialLine();
+    void sampleConsoleRate();
+    void processLine(const QString &line);
+    void setPlayerCount(int count);
+
+    QString instanceName;
+    QString rootPath;
+    QString serverExecutableOverride;
+    QProcess *apacheProcess;
+    QProcess *serverProcess;
+    bool stopping;
+
+    // Console pipeline
+    bool isProcessingClientInfo;
+    QString clientInfoBuffer;
+    QByteArray outputRemainder;              // Unterminated last line of the previous read
+    QElapsedTimer commandClock;              // Timebase for command round-trips
+    QQueue<PendingCommand> pendingCommands;  // Commands still waiting for their reply, oldest first
+    QTimer *rateTimer;                       // Samples the console line rate while the server runs
+    quint64 rateSampleLines;
+    qint64 rateSampleNs;
+
+    // Session registry
+    int players;
+    QMap<QString, QString> sessions;
+    QMap<QString, QPair<QString, QString>> userInfoMap; // SessionId -> (Username, Email) for pending client info
+
+    // Live tuning state
+    LiveTuningStore liveTuningStore;
+    EffectiveLiveTuning effectiveTuning; // Merged view of every active LiveTuning file
+    LiveTuningJournal tuningJournal;     // Undo history of edits to liveTuningStore
+    QString pandemoniumSubEvent;
+
+    EffectiveConfig launchConfiguration;
+
+    ServerMetrics serverMetrics;
+    CapacityPlanner capacity;
+};
+
+#endif // SERVERINSTANCE_H
@@ -0,0 +1,341 @@
+#include "servermetrics.h"
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QHostAddress>
+#include <QMutexLocker>
+#include <QFile>
+#include <QDebug>
+
+#if defined(Q_OS_WIN)
+#include <windows.h>
+#include <psapi.h>
+#include <tlhelp32.h>
+#elif defined(Q_OS_LINUX)
+#include <unistd.h>
+#endif
+
+const double LatencyHistogram::bucketBoundsSeconds[LatencyHistogram::BucketCount] = {
+    0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1.0, 2.5, 5.0, 10.0
+};
+
+LatencyHistogram::LatencyHistogram()
+{
+    for (int i = 0; i < BucketCount; ++i) {
+        buckets[i].store(0, std::memory_order_relaxed);
+    }
+    total.store(0, std::memory_order_relaxed);
+    sumNanoseconds.store(0, std::memory_order_relaxed);
+}
+
+void LatencyHistogram::observe(qint64 nanoseconds)
+{
+    const double seconds = nanoseconds / 1e9;
+
+    // Buckets are stored non-cumulative, the exporter sums them up on render
+    for (int i = 0; i < BucketCount; ++i) {
+        if (seconds <= bucketBoundsSeconds[i]) {
+            buckets[i].fetch_add(1, std::memory_order_relaxed);
+            break;
+        }
+    }
+
+    total.fetch_add(1, std::memory_order_relaxed);
+    sumNanoseconds.fetch_add(static_cast<quint64>(qMax<qint64>(nanoseconds, 0)), std::memory_order_relaxed);
+}
+
+ServerCommandKind serverCommandKind(const QString &command)
+{
+    if (command.startsWith("!server"))
+        return ServerCommandKind::Server;
+    if (command.startsWith("!client"))
+        return ServerCommandKind::Client;
+    if (command.startsWith("!account"))
+        return ServerCommandKind::Account;
+    return ServerCommandKind::Other;
+}
+
+const char *serverCommandKindName(ServerCommandKind kind)
+{
+    switch (kind) {
+    case ServerCommandKind::Server:  return "server";
+    case ServerCommandKind::Client:  return "client";
+    case ServerCommandKind::Account: return "account";
+    default:                         return "other";
+    }
+}
+
+ProcessStats readProcessStats(qint64 pid, bool includeThreads)
+{
+    ProcessStats stats;
+    if (pid <= 0)
+        return stats;
+
+#if defined(Q_OS_WIN)
+    HANDLE process = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, static_cast<DWORD>(pid));
+    if (!process)
+        return stats;
+
+    FILETIME creationTime, exitTime, kernelTime, userTime;
+    if (GetProcessTimes(process, &creationTime, &exitTime, &kernelTime, &userTime)) {
+        auto toTicks = [](const FILETIME &ft) {
+            return (static_cast<quint64>(ft.dwHighDateTime) << 32) | ft.dwLowDateTime;
+        };
+        // FILETIME is in 100ns units
+        stats.cpuSeconds = (toTicks(kernelTime) + toTicks(userTime)) / 1e7;
+        stats.valid = true;
+    }
+
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(process, &counters, sizeof(counters))) {
+        stats.residentBytes = counters.WorkingSetSize;
+    }
+
+    CloseHandle(process);
+
+    // Windows has no per-process thread counter, a snapshot of all threads is the cheapest option
+    if (includeThreads) {
+        HANDLE snapshot = CreateToolhelp32Snapshot(TH32CS_SNAPTHREAD, 0);
+        if (snapshot != INVALID_HANDLE_VALUE) {
+            THREADENTRY32 entry;
+            entry.dwSize = sizeof(entry);
+            for (BOOL more = Thread32First(snapshot, &entry); more; more = Thread32Next(snapshot, &entry)) {
+                if (entry.th32OwnerProcessID == static_cast<DWORD>(pid)) {
+                    stats.threadCount++;
+                }
+            }
+            CloseHandle(snapshot);
+        }
+    }
+#elif defined(Q_OS_LINUX)
+    QFile statFile(QString("/proc/%1/stat").arg(pid));
+    if (!statFile.open(QIODevice::ReadOnly))
+        return stats;
+
+    // The command name may contain spaces, so fields are counted from the closing paren
+    const QByteArray stat = statFile.readAll();
+    const int commEnd = stat.lastIndexOf(')');
+    if (commEnd < 0)
+        return stats;
+
+    const QList<QByteArray> fields = stat.mid(commEnd + 2).split(' ');
+    // utime and stime are fields 14 and 15, num_threads is 20, rss is 24 (1-based, state is field 3)
+    if (fields.size() > 21) {
+        const double ticksPerSecond = static_cast<double>(sysconf(_SC_CLK_TCK));
+        stats.cpuSeconds = (fields.at(11).toULongLong() + fields.at(12).toULongLong()) / ticksPerSecond;
+        stats.threadCount = fields.at(17).toInt();
+        stats.residentBytes = fields.at(21).toULongLong() * static_cast<quint64>(sysconf(_SC_PAGESIZE));
+        stats.valid = true;
+    }
+#else
+    Q_UNUSED(includeThreads);
+#endif
+
+    return stats;
+}
+
+namespace {
+
+void appendMetricHeader(QByteArray &out, const char *name, const char *type, const char *help)
+{
+    out += "# HELP ";
+    out += name;
+    out += ' ';
+    out += help;
+    out += "\n# TYPE ";
+    out += name;
+    out += ' ';
+    out += type;
+    out += '\n';
+}
+
+// Label values are quoted, so backslash, double quote and line feed have to be escaped
+QByteArray escapeLabelValue(const QString &value)
+{
+    const QByteArray utf8 = value.toUtf8();
+    QByteArray escaped;
+    escaped.reserve(utf8.size());
+    for (char c : utf8) {
+        switch (c) {
+        case '\\': escaped += "\\\\"; break;
+        case '"':  escaped += "\\\""; break;
+        case '\n': escaped += "\\n"; break;
+        default:   escaped += c; break;
+        }
+    }
+    return escaped;
+}
+
+void appendSample(QByteArray &out, const char *name, const QByteArray &labels, double value)
+{
+    out += name;
+    out += '{';
+    out += labels;
+    out += "} ";
+    out += QByteArray::number(value, 'g', 12);
+    out += '\n';
+}
+
+} // namespace
+
+MetricsExporter::MetricsExporter(QObject *parent)
+    : QObject(parent)
+    , server(nullptr)
+{
+}
+
+void MetricsExporter::addSource(const QString &instance, const ServerMetrics *metrics)
+{
+    QMutexLocker locker(&sourcesMutex);
+    sources.append({instance, metrics});
+}
+
+void MetricsExporter::removeSource(const ServerMetrics *metrics)
+{
+    QMutexLocker locker(&sourcesMutex);
+    for (int i = 0; i < sources.size(); ++i) {
+        if (sources.at(i).metrics == metrics) {
+            sources.removeAt(i);
+            break;
+        }
+    }
+}
+
+void MetricsExporter::listen(quint16 port)
+{
+    if (!server) {
+        server = new QTcpServer(this);
+        connect(server, &QTcpServer::newConnection, this, &MetricsExporter::onNewConnection);
+    }
+
+    if (!server->listen(QHostAddress::LocalHost, port)) {
+        qDebug() << "Metrics endpoint failed to listen on port" << port << ":" << server->errorString();
+        return;
+    }
+
+    qDebug() << "Metrics endpoint listening on http://127.0.0.1:" << port << "/metrics";
+}
+
+void MetricsExporter::close()
+{
+    if (server) {
+        server->close();
+    }
+}
+
+void MetricsExporter::onNewConnection()
+{
+    while (QTcpSocket *socket = server->nextPendingConnection()) {
+        connect(socket, &QTcpSocket::readyRead, this, &MetricsExporter::onReadyRead);
+        connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+    }
+}
+
+void MetricsExporter::onReadyRead()
+{
+    QTcpSocket *socket = qobject_cast<QTcpSocket *>(sender());
+    if (!socket || !socket->canReadLine())
+        return;
+
+    // Only the request line matters, headers are ignored
+    const QList<QByteArray> requestLine = socket->readLine().trimmed().split(' ');
+    socket->readAll();
+
+    QByteArray status = "200 OK";
+    QByteArray body;
+    if (requestLine.size() < 2 || requestLine.at(0) != "GET") {
+        status = "405 Method Not Allowed";
+    } else if (requestLine.at(1) != "/metrics" && requestLine.at(1) != "/") {
+        status = "404 Not Found";
+    } else {
+        body = render();
+    }
+
+    QByteArray response = "HTTP/1.0 " + status + "\r\n"
+                          "Content-Type: text/plain; version=0.0.4; charset=utf-8\r\n"
+                          "Content-Length: " + QByteArray::number(body.size()) + "\r\n"
+                          "Connection: close\r\n\r\n" + body;
+    socket->write(response);
+    socket->disconnectFromHost();
+}
+
+QByteArray MetricsExporter::render()
+{
+    // Held for the whole render so a shard can't be removed while its counters are read
+    QMutexLocker locker(&sourcesMutex);
+    const QList<Source> &snapshot = sources;
+
+    QByteArray out;
+    out.reserve(4096 * qMax<qsizetype>(1, snapshot.size()));
+
+    auto labelsFor = [](const Source &source) {
+        return QByteArray("instance=\"") + escapeLabelValue(source.instance) + '"';
+    };
+
+    appendMetricHeader(out, "mhserveremu_players_online", "gauge", "Players currently logged in.");
+    for (const Source &source : snapshot)
+        appendSample(out, "mhserveremu_players_online", labelsFor(source), source.metrics->playersOnline.load(std::memory_order_relaxed));
+
+    appendMetricHeader(out, "mhserveremu_logins_total", "counter", "Client logins seen on the server console.");
+    for (const Source &source : snapshot)
+        appendSample(out, "mhserveremu_logins_total", labelsFor(source), source.metrics->loginsTotal.load(std::memory_order_relaxed));
+
+    appendMetricHeader(out, "mhserveremu_logouts_total", "counter", "Client logouts seen on the server console.");
+    for (const Source &source : snapshot)
+        appendSample(out, "mhserveremu_logouts_total", labelsFor(source), source.metrics->logoutsTotal.load(std::memory_order_relaxed));
+
+    appendMetricHeader(out, "mhserveremu_console_lines_total", "counter", "Console lines read from the server process.");
+    for (const Source &source : snapshot)
+        appendSample(out, "mhserveremu_console_lines_total", labelsFor(source), source.metrics->consoleLinesTotal.load(std::memory_order_relaxed));
+
+    // Sampled by each shard at a fixed interval, so every scraper sees the same rate
+    appendMetricHeader(out, "mhserveremu_console_lines_per_second", "gauge", "Console line rate over the shard's last sampling interval.");
+    for (const Source &source : snapshot)
+        appendSample(out, "mhserveremu_console_lines_per_second", labelsFor(source), source.metrics->consoleLinesPerSecond.load(std::memory_order_relaxed));
+
+    appendMetricHeader(out, "mhserveremu_command_latency_seconds", "histogram", "Time from writing a console command to its reply on the server console.");
+    for (const Source &source : snapshot) {
+        for (int kind = 0; kind < static_cast<int>(ServerCommandKind::Count); ++kind) {
+            const LatencyHistogram &histogram = source.metrics->commandLatency[kind];
+            const QByteArray labels = labelsFor(source) + ",command=\"" + serverCommandKindName(static_cast<ServerCommandKind>(kind)) + '"';
+
+            quint64 cumulative = 0;
+            for (int i = 0; i < LatencyHistogram::BucketCount; ++i) {
+                cumulative += histogram.bucket(i);
+                appendSample(out, "mhserveremu_command_latency_seconds_bucket",
+                             labels + ",le=\"" + QByteArray::number(LatencyHistogram::bucketBoundsSeconds[i]) + '"', cumulative);
+            }
+            appendSample(out, "mhserveremu_command_latency_seconds_bucket", labels + ",le=\"+Inf\"", histogram.count());
+            appendSample(out, "mhserveremu_command_latency_seconds_sum", labels, histogram.sumSeconds());
+            appendSample(out, "mhserveremu_command_latency_seconds_count", labels, histogram.count());
+        }
+    }
+
+    appendMetricHeader(out, "mhserveremu_restarts_total", "counter", "Server starts after the first one in this UI session.");
+    for (const Source &source : snapshot) {
+        const quint64 starts = source.metrics->serverStartsTotal.load(std::memory_order_relaxed);
+        appendSample(out, "mhserveremu_restarts_total", labelsFor(source), starts > 0 ? starts - 1 : 0);
+    }
+
+    appendMetricHeader(out, "mhserveremu_livetuning_reloads_total", "counter", "Live tuning reload commands sent to the server.");
+    for (const Source &source : snapshot)
+        appendSample(out, "mhserveremu_livetuning_reloads_total", labelsFor(source), source.metrics->liveTuningReloadsTotal.load(std::memory_order_relaxed));
+
+    // Process stats are sampled at scrape time so there is no polling while nobody is scraping
+    QList<QPair<QByteArray, ProcessStats>> processStats;
+    for (const Source &source : snapshot)
+        processStats.append({labelsFor(source), readProcessStats(source.metrics->serverPid.load(std::memory_order_relaxed))});
+
+    appendMetricHeader(out, "mhserveremu_process_cpu_seconds_total", "counter", "User and system CPU time of the server process.");
+    for (const auto &stats : processStats) {
+        if (stats.second.valid)
+            appendSample(out, "mhserveremu_process_cpu_seconds_total", stats.first, stats.second.cpuSeconds);
+    }
+
+    appendMetricHeader(out, "mhserveremu_process_resident_memory_bytes", "gauge", "Resident memory of the server process.");
+    for (const auto &stats : processStats) {
+        if (stats.second.valid)
+            appendSample(out, "mhserveremu_process_resident_memory_bytes", stats.first, static_cast<double>(stats.second.residentBytes));
+    }
+
+    return out;
+}
@@ -0,0 +1,101 @@
+#ifndef SERVERMETRICS_H
+#define SERVERMETRICS_H
+
+#include <QObject>
+#include <QMutex>
+#include <QList>
+#include <atomic>
+
+class QTcpServer;
+class QTcpSocket;
+
+// Command families we track round-trip latency for
+enum class ServerCommandKind {
+    Server,
+    Client,
+    Account,
+    Other,
+    Count
+};
+
+ServerCommandKind serverCommandKind(const QString &command);
+const char *serverCommandKindName(ServerCommandKind kind);
+
+// Fixed-bucket latency histogram, safe to update from any thread without locking
+class LatencyHistogram
+{
+public:
+    static constexpr int BucketCount = 11;
+    static const double bucketBoundsSeconds[BucketCount];
+
+    LatencyHistogram();
+
+    void observe(qint64 nanoseconds);
+
+    quint64 bucket(int index) const { return buckets[index].load(std::memory_order_relaxed); }
+    quint64 count() const { return total.load(std::memory_order_relaxed); }
+    double sumSeconds() const { return sumNanoseconds.load(std::memory_order_relaxed) / 1e9; }
+
+private:
+    std::atomic<quint64> buckets[BucketCount];
+    std::atomic<quint64> total;
+    std::atomic<quint64> sumNanoseconds;
+};
+
+// CPU time, resident memory and thread count of a running process, from procfs on Linux
+struct ProcessStats {
+    bool valid = false;
+    double cpuSeconds = 0.0;
+    quint64 residentBytes = 0;
+    int threadCount = 0;
+};
+
+// Thread counts are free on Linux but need a system-wide snapshot on Windows, so they're opt-in
+ProcessStats readProcessStats(qint64 pid, bool includeThreads = false);
+
+// Counters for one managed server. Written on the GUI thread hot paths, read by the exporter thread.
+struct ServerMetrics
+{
+    std::atomic<qint64> playersOnline{0};
+    std::atomic<quint64> loginsTotal{0};
+    std::atomic<quint64> logoutsTotal{0};
+    std::atomic<quint64> consoleLinesTotal{0};
+    std::atomic<double> consoleLinesPerSecond{0.0}; // Sampled on the shard's own timer
+    std::atomic<quint64> serverStartsTotal{0};
+    std::atomic<quint64> liveTuningReloadsTotal{0};
+    std::atomic<qint64> serverPid{0};
+    LatencyHistogram commandLatency[static_cast<int>(ServerCommandKind::Count)];
+};
+
+// Serves the registered ServerMetrics in Prometheus text format from its own thread
+class MetricsExporter : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit MetricsExporter(QObject *parent = nullptr);
+
+    void addSource(const QString &instance, const ServerMetrics *metrics);
+    void removeSource(const ServerMetrics *metrics);
+    QByteArray render();
+
+public slots:
+    void listen(quint16 port);
+    void close();
+
+private slots:
+    void onNewConnection();
+    void onReadyRead();
+
+private:
+    struct Source {
+        QString instance;
+        const ServerMetrics *metrics;
+    };
+
+    QMutex sourcesMutex; // Only taken when sources change and during a scrape
+    QList<Source> sources;
+    QTcpServer *server;
+};
+
+#endif // SERVERMETRICS_H
@@ -0,0 +1,206 @@
+#include "shardmanager.h"
+#include "servermetrics.h"
+#include <QSettings>
+#include <QThreadPool>
+#include <QSharedPointer>
+#include <QPromise>
+#include <QFutureWatcher>
+#include <QVector>
+#include "atomicfilewriter.h"
+#include <QDebug>
+#include <atomic>
+
+ShardManager::ShardManager(MetricsExporter *exporter, QObject *parent)
+    : QObject(parent)
+    , metricsExporter(exporter)
+{
+}
+
+ShardManager::~ShardManager()
+{
+    for (ServerInstance *shard : shardList) {
+        metricsExporter->removeSource(&shard->metrics());
+    }
+}
+
+void ShardManager::load()
+{
+    QSettings settings("PTM", "MHServerEmuUI");
+
+    // The primary shard keeps using the original serverPath key
+    if (ServerInstance *first = addInstance("Primary", settings.value("serverPath", "").toString())) {
+        first->setExecutableOverride(settings.value("serverExecutable").toString());
+    }
+
+    int count = settings.beginReadArray("shards");
+    for (int i = 0; i < count; ++i) {
+        settings.setArrayIndex(i);
+        QString name = settings.value("name").toString();
+        if (!name.isEmpty() && !shardsByName.contains(name)) {
+            ServerInstance *shard = addInstance(name, settings.value("path").toString());
+            shard->setExecutableOverride(settings.value("executable").toString());
+        }
+    }
+    settings.endArray();
+}
+
+void ShardManager::save() const
+{
+    QSettings settings("PTM", "MHServerEmuUI");
+
+    if (ServerInstance *first = primary()) {
+        settings.setValue("serverPath", first->serverPath());
+        settings.setValue("serverExecutable", first->executableOverride());
+    }
+
+    settings.remove("shards");
+    settings.beginWriteArray("shards", qMax(0, static_cast<int>(shardList.size()) - 1));
+    for (int i = 1; i < shardList.size(); ++i) {
+        settings.setArrayIndex(i - 1);
+        settings.setValue("name", shardList.at(i)->name());
+        settings.setValue("path", shardList.at(i)->serverPath());
+        settings.setValue("executable", shardList.at(i)->executableOverride());
+    }
+    settings.endArray();
+}
+
+ServerInstance *ShardManager::addInstance(const QString &name, const QString &serverPath)
+{
+    if (shardsByName.contains(name)) {
+        return nullptr;
+    }
+
+    ServerInstance *shard = new ServerInstance(name, serverPath, this);
+    shardList.append(shard);
+    shardsByName.insert(name, shard);
+    metricsExporter->addSource(name, &shard->metrics());
+
+    emit instancesChanged();
+    return shard;
+}
+
+void ShardManager::removeInstance(ServerInstance *shard)
+{
+    // The primary shard is bound to the main tabs and can't be removed
+    if (!shard || shard == primary()) {
+        return;
+    }
+
+    metricsExporter->removeSource(&shard->metrics());
+    shardList.removeOne(shard);
+    shardsByName.remove(shard->name());
+    shard->stop();
+    shard->deleteLater();
+
+    emit instancesChanged();
+}
+
+ServerInstance *ShardManager::instance(const QString &name) const
+{
+    return shardsByName.value(name, nullptr);
+}
+
+bool ShardManager::anyRunning() const
+{
+    for (ServerInstance *shard : shardList) {
+        if (shard->isRunning() || shard->isApacheRunning()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+int ShardManager::broadcast(const QString &message)
+{
+    // Console writes are buffered by QProcess, so this never waits on a shard
+    int reached = 0;
+    for (ServerInstance *shard : shardList) {
+        if (shard->isRunning()) {
+            shard->sendCommand(QString("!server broadcast %1").arg(message));
+            reached++;
+        }
+    }
+    return reached;
+}
+
+int ShardManager::reloadLiveTuning()
+{
+    int reached = 0;
+    for (ServerInstance *shard : shardList) {
+        if (shard->isRunning()) {
+            shard->sendCommand("!server reloadlivetuning");
+            reached++;
+        }
+    }
+    return reached;
+}
+
+void ShardManager::pushLiveTuningFile(const QString &fileName, const QByteArray &content, bool reload)
+{
+    struct PushState {
+        std::atomic<int> remaining{0};
+        QVector<bool> succeeded;
+        QVector<bool> changed; // Unchanged files don't need a reload
+        QStringList names;
+    };
+
+    QSharedPointer<PushState> state = QSharedPointer<PushState>::create();
+    QStringList targetPaths;
+    for (ServerInstance *shard : shardList) {
+        if (shard->serverPath().isEmpty()) {
+            continue;
+        }
+        state->names.append(shard->name());
+        targetPaths.append(shard->liveTuningPath() + fileName);
+    }
+
+    if (targetPaths.isEmpty()) {
+        emit liveTuningPushFinished(0, 0);
+        return;
+    }
+
+    state->succeeded.fill(false, targetPaths.size());
+    state->changed.fill(false, targetPaths.size());
+    state->remaining.store(targetPaths.size());
+
+    // Each shard's file is written on the thread pool, the reloads go out once every write is done.
+    // Workers only get the path, the bytes and their own result slot; the manager is touched from
+    // the watcher's finished signal on the GUI thread, and the watcher goes away with the manager.
+    QSharedPointer<QPromise<void>> writesDone = QSharedPointer<QPromise<void>>::create();
+    QFutureWatcher<void> *watcher = new QFutureWatcher<void>(this);
+    connect(watcher, &QFutureWatcher<void>::finished, this, [this, watcher, state, reload]() {
+        watcher->deleteLater();
+
+        int succeeded = 0;
+        for (int j = 0; j < state->names.size(); ++j) {
+            if (!state->succeeded.at(j)) {
+                qDebug() << "Live tuning push failed for shard" << state->names.at(j);
+                continue;
+            }
+            succeeded++;
+
+            ServerInstance *shard = instance(state->names.at(j));
+            if (reload && state->changed.at(j) && shard && shard->isRunning()) {
+                shard->sendCommand("!server reloadlivetuning");
+            }
+        }
+        emit liveTuningPushFinished(succeeded, state->names.size() - succeeded);
+    });
+    writesDone->start();
+    watcher->setFuture(writesDone->future());
+
+    bool *results = state->succeeded.data();
+    bool *changed = state->changed.data();
+    for (int i = 0; i < targetPaths.size(); ++i) {
+        const QString path = targetPaths.at(i);
+        QThreadPool::globalInstance()->start([state, writesDone, results, changed, path, content, i]() {
+            AtomicFileWriter::Result result = AtomicFileWriter::write(path, content);
+            results[i] = result != AtomicFileWriter::Failed;
+            changed[i] = result == AtomicFileWriter::Written;
+
+            if (state->remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                writesDone->finish();
+            }
+        });
+    }
+}
@@ -0,0 +1,44 @@
+#ifndef SHARDMANAGER_H
+#define SHARDMANAGER_H
+
+#include <QObject>
+#include <QList>
+#include <QHash>
+#include "serverinstance.h"
+
+class MetricsExporter;
+
+// Owns every managed ServerInstance and fans commands and live tuning pushes out across them
+class ShardManager : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit ShardManager(MetricsExporter *exporter, QObject *parent = nullptr);
+    ~ShardManager() override;
+
+    void load();
+    void save() const;
+
+    ServerInstance *addInstance(const QString &name, const QString &serverPath);
+    void removeInstance(ServerInstance *instance);
+    ServerInstance *instance(const QString &name) const;
+    const QList<ServerInstance *> &instances() const { return shardList; }
+    ServerInstance *primary() const { return shardList.isEmpty() ? nullptr : shardList.first(); }
+    bool anyRunning() const;
+
+    int broadcast(const QString &message);
+    int reloadLiveTuning();
+    void pushLiveTuningFile(const QString &fileName, const QByteArray &content, bool reload);
+
+signals:
+    void instancesChanged();
+    void liveTuningPushFinished(int succeeded, int failed);
+
+private:
+    MetricsExporter *metricsExporter;
+    QList<ServerInstance *> shardList;
+    QHash<QString, ServerInstance *> shardsByName;
+};
+
+#endif // SHARDMANAGER_H
@@ -0,0 +1,265 @@
+// NightlyDownloader against a local HTTP stand-in that can drop connections, ignore Range
+// requests or answer with an error, so resume and verification run without the network.
+
+#include <QtTest>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QTemporaryDir>
+#include <QCryptographicHash>
+#include <QRandomGenerator>
+#include <QRegularExpression>
+#include "../nightlydownloader.h"
+
+namespace {
+
+// Just enough HTTP/1.1 for one GET per connection
+class HttpStandIn : public QTcpServer
+{
+public:
+    QByteArray payload;
+    int status = 200;           // Anything but 200 is sent as an empty error response
+    bool ignoreRange = false;
+    qint64 dropAfter = -1;      // Body bytes sent before the first response is cut short
+    QVector<qint64> rangeStarts; // -1 for requests without a Range header
+
+protected:
+    void incomingConnection(qintptr descriptor) override
+    {
+        QTcpSocket *socket = new QTcpSocket(this);
+        socket->setSocketDescriptor(descriptor);
+        connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+        connect(socket, &QTcpSocket::readyRead, this, [this, socket]() {
+            request += socket->readAll();
+            if (request.contains("\r\n\r\n")) {
+                respond(socket);
+            }
+        });
+    }
+
+private:
+    void respond(QTcpSocket *socket)
+    {
+        static const QRegularExpression rangeRegex(R"(Range:\s*bytes=(\d+)-)", QRegularExpression::CaseInsensitiveOption);
+        const QRegularExpressionMatch match = rangeRegex.match(QString::fromLatin1(request));
+        request.clear();
+        const qint64 start = match.hasMatch() ? match.captured(1).toLongLong() : -1;
+        rangeStarts.append(start);
+
+        QByteArray head;
+        QByteArray body;
+        if (status != 200) {
+            head = "HTTP/1.1 " + QByteArray::number(status) + " Error\r\nContent-Length: 0\r\n";
+        } else if (start > 0 && !ignoreRange) {
+            body = payload.mid(start);
+            head = "HTTP/1.1 206 Partial Content\r\nContent-Length: " + QByteArray::number(body.size())
+                 + "\r\nContent-Range: bytes " + QByteArray::number(start) + '-' + QByteArray::number(payload.size() - 1)
+                 + '/' + QByteArray::number(payload.size()) + "\r\n";
+        } else {
+            body = payload;
+            head = "HTTP/1.1 200 OK\r\nContent-Length: " + QByteArray::number(body.size()) + "\r\nAccept-Ranges: bytes\r\n";
+        }
+        socket->write(head + "Connection: close\r\n\r\n");
+
+        // Closing early leaves the client short of Content-Length
+        if (dropAfter >= 0) {
+            body = body.left(dropAfter);
+            dropAfter = -1;
+        }
+        socket->write(body);
+        socket->disconnectFromHost();
+    }
+
+    QByteArray request;
+};
+
+QByteArray makePayload(int size)
+{
+    QByteArray data(size, Qt::Uninitialized);
+    QRandomGenerator generator(1337);
+    for (int i = 0; i < size; ++i) {
+        data[i] = char(generator.bounded(256));
+    }
+    return data;
+}
+
+QByteArray readFile(const QString &path)
+{
+    QFile file(path);
+    return file.open(QIODevice::ReadOnly) ? file.readAll() : QByteArray();
+}
+
+} // namespace
+
+class NightlyDownloaderTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+
+    void downloadsAndVerifies();
+    void resumesAfterDroppedConnection();
+    void resumesExistingPartFile();
+    void startsOverWhenRangeIsIgnored();
+    void rejectsHashMismatch();
+    void rejectsSizeMismatch();
+    void failsWithoutRetryOnNotFound();
+    void keepsPartFileOnAbort();
+
+private:
+    // Starts the download and waits for finished; returns its success flag
+    bool download(NightlyDownloader *downloader, qint64 expectedSize, const QByteArray &expectedSha256, QString *errorMessage = nullptr);
+    QUrl url() const { return QUrl(QString("http://127.0.0.1:%1/nightly.zip").arg(server->serverPort())); }
+
+    QTemporaryDir *dir = nullptr;
+    HttpStandIn *server = nullptr;
+    QString destination;
+};
+
+void NightlyDownloaderTest::init()
+{
+    dir = new QTemporaryDir();
+    QVERIFY(dir->isValid());
+    destination = dir->filePath("nightly.zip");
+
+    server = new HttpStandIn();
+    server->payload = makePayload(3 * 1024 * 1024 + 123);
+    QVERIFY(server->listen(QHostAddress::LocalHost));
+}
+
+void NightlyDownloaderTest::cleanup()
+{
+    delete server;
+    delete dir;
+}
+
+bool NightlyDownloaderTest::download(NightlyDownloader *downloader, qint64 expectedSize, const QByteArray &expectedSha256, QString *errorMessage)
+{
+    QSignalSpy spy(downloader, &NightlyDownloader::finished);
+    QString startError;
+    if (!downloader->start(url(), destination, expectedSize, expectedSha256, &startError)) {
+        qWarning() << startError;
+        return false;
+    }
+    if (!spy.wait(20000)) {
+        qWarning() << "Download didn't finish";
+        return false;
+    }
+    if (errorMessage) {
+        *errorMessage = spy.first().at(1).toString();
+    }
+    return spy.first().at(0).toBool();
+}
+
+void NightlyDownloaderTest::downloadsAndVerifies()
+{
+    NightlyDownloader downloader;
+    QSignalSpy progress(&downloader, &NightlyDownloader::progress);
+    const QByteArray sha256 = QCryptographicHash::hash(server->payload, QCryptographicHash::Sha256).toHex();
+
+    QVERIFY(download(&downloader, server->payload.size(), sha256));
+    QCOMPARE(readFile(destination), server->payload);
+    QVERIFY(!QFile::exists(downloader.partPath()));
+    QCOMPARE(downloader.sha256(), sha256);
+    QVERIFY(!progress.isEmpty());
+    QCOMPARE(progress.last().at(0).toLongLong(), qint64(server->payload.size()));
+    QCOMPARE(progress.last().at(1).toLongLong(), qint64(server->payload.size()));
+}
+
+void NightlyDownloaderTest::resumesAfterDroppedConnection()
+{
+    server->dropAfter = 1024 * 1024;
+    NightlyDownloader downloader;
+    downloader.setRetryDelay(10);
+    const QByteArray sha256 = QCryptographicHash::hash(server->payload, QCryptographicHash::Sha256).toHex();
+
+    QString errorMessage;
+    QVERIFY2(download(&downloader, -1, sha256, &errorMessage), qPrintable(errorMessage));
+    QCOMPARE(readFile(destination), server->payload);
+    QCOMPARE(server->rangeStarts.size(), 2);
+    QCOMPARE(server->rangeStarts.at(0), qint64(-1));
+    QVERIFY(server->rangeStarts.at(1) > 0); // Resumed, not started over
+}
+
+void NightlyDownloaderTest::resumesExistingPartFile()
+{
+    QFile part(destination + ".part");
+    QVERIFY(part.open(QIODevice::WriteOnly));
+    part.write(server->payload.left(500000));
+    part.close();
+
+    NightlyDownloader downloader;
+    const QByteArray sha256 = QCryptographicHash::hash(server->payload, QCryptographicHash::Sha256).toHex();
+    QVERIFY(download(&downloader, server->payload.size(), sha256));
+    QCOMPARE(readFile(destination), server->payload);
+    QCOMPARE(server->rangeStarts, QVector<qint64>({500000}));
+}
+
+void NightlyDownloaderTest::startsOverWhenRangeIsIgnored()
+{
+    // Garbage in the part file must not survive a full response
+    QFile part(destination + ".part");
+    QVERIFY(part.open(QIODevice::WriteOnly));
+    part.write(QByteArray(4096, 'x'));
+    part.close();
+    server->ignoreRange = true;
+
+    NightlyDownloader downloader;
+    const QByteArray sha256 = QCryptographicHash::hash(server->payload, QCryptographicHash::Sha256).toHex();
+    QVERIFY(download(&downloader, server->payload.size(), sha256));
+    QCOMPARE(readFile(destination), server->payload);
+}
+
+void NightlyDownloaderTest::rejectsHashMismatch()
+{
+    NightlyDownloader downloader;
+    QString errorMessage;
+    QVERIFY(!download(&downloader, -1, QByteArray(64, '0'), &errorMessage));
+    QVERIFY(errorMessage.contains("SHA-256"));
+    QVERIFY(!QFile::exists(destination));
+    QVERIFY(!QFile::exists(downloader.partPath()));
+}
+
+void NightlyDownloaderTest::rejectsSizeMismatch()
+{
+    NightlyDownloader downloader;
+    QVERIFY(!download(&downloader, server->payload.size() + 1, QByteArray()));
+    QVERIFY(!QFile::exists(destination));
+}
+
+void NightlyDownloaderTest::failsWithoutRetryOnNotFound()
+{
+    server->status = 404;
+    NightlyDownloader downloader;
+    downloader.setRetryDelay(10);
+    QString errorMessage;
+    QVERIFY(!download(&downloader, -1, QByteArray(), &errorMessage));
+    QVERIFY(errorMessage.contains("404"));
+    QCOMPARE(server->rangeStarts.size(), 1);
+    QVERIFY(!QFile::exists(destination));
+}
+
+void NightlyDownloaderTest::keepsPartFileOnAbort()
+{
+    server->dropAfter = 1024 * 1024;
+    NightlyDownloader downloader;
+    downloader.setRetryDelay(60000); // Stays in the retry wait until aborted
+
+    QSignalSpy written(&downloader, &NightlyDownloader::bytesWritten);
+    QSignalSpy finished(&downloader, &NightlyDownloader::finished);
+    QVERIFY(downloader.start(url(), destination));
+    QTRY_COMPARE_WITH_TIMEOUT(downloader.bytesOnDisk(), qint64(1024 * 1024), 10000);
+    QVERIFY(finished.isEmpty());
+
+    downloader.abort();
+    QCOMPARE(finished.size(), 1);
+    QVERIFY(!finished.first().at(0).toBool());
+    QVERIFY(!downloader.isRunning());
+    QCOMPARE(readFile(downloader.partPath()), server->payload.left(1024 * 1024));
+    QVERIFY(!written.isEmpty());
+}
+
+QTEST_GUILESS_MAIN(NightlyDownloaderTest)
+
+#include "nightlydownloader_test.moc"
@@ -0,0 +1,333 @@
+// Inflate and ZipExtractor on archives built in the test: deflate data comes from qCompress
+// with the zlib wrapper stripped, so no external tools or fixtures are needed.
+
+#include <QtTest>
+#include <QTemporaryDir>
+#include <QRandomGenerator>
+#include <QtEndian>
+#include "../inflate.h"
+#include "../zipextractor.h"
+
+namespace {
+
+// qCompress is a 4-byte size, a 2-byte zlib header, raw deflate and a 4-byte Adler-32
+QByteArray rawDeflate(const QByteArray &data, int level = -1)
+{
+    const QByteArray zlib = qCompress(data, level);
+    return zlib.mid(6, zlib.size() - 10);
+}
+
+QByteArray makeData(int size, int seed, bool compressible)
+{
+    QByteArray data(size, Qt::Uninitialized);
+    QRandomGenerator generator(seed);
+    static const char words[] = "Entity/Characters/Mobs Loot Region Avatar Power ";
+    for (int i = 0; i < size; ++i) {
+        data[i] = compressible ? words[generator.bounded(int(sizeof(words) - 1))] : char(generator.bounded(256));
+    }
+    return data;
+}
+
+void appendLe16(QByteArray *out, quint16 value)
+{
+    char bytes[2];
+    qToLittleEndian(value, bytes);
+    out->append(bytes, 2);
+}
+
+void appendLe32(QByteArray *out, quint32 value)
+{
+    char bytes[4];
+    qToLittleEndian(value, bytes);
+    out->append(bytes, 4);
+}
+
+struct TestFile {
+    QString name;
+    QByteArray data;
+    bool deflate = true;
+    bool corruptCrc = false;
+};
+
+// Sizes in the local headers, no data descriptors, like most archivers that aren't streaming
+QByteArray makeZip(const QVector<TestFile> &testFiles)
+{
+    QByteArray zip;
+    QByteArray directory;
+    for (const TestFile &file : testFiles) {
+        const QByteArray name = file.name.toUtf8();
+        const QByteArray stored = file.deflate ? rawDeflate(file.data) : file.data;
+        const quint32 crc = Inflate::crc32(file.data.constData(), file.data.size()) ^ (file.corruptCrc ? 1u : 0u);
+        const quint16 method = file.deflate ? 8 : 0;
+        const quint32 offset = quint32(zip.size());
+
+        appendLe32(&zip, 0x04034b50);
+        appendLe16(&zip, 20);
+        appendLe16(&zip, 0x0800);
+        appendLe16(&zip, method);
+        appendLe32(&zip, 0); // Time and date
+        appendLe32(&zip, crc);
+        appendLe32(&zip, quint32(stored.size()));
+        appendLe32(&zip, quint32(file.data.size()));
+        appendLe16(&zip, quint16(name.size()));
+        appendLe16(&zip, 0);
+        zip += name;
+        zip += stored;
+
+        appendLe32(&directory, 0x02014b50);
+        appendLe16(&directory, 20);
+        appendLe16(&directory, 20);
+        appendLe16(&directory, 0x0800);
+        appendLe16(&directory, method);
+        appendLe32(&directory, 0);
+        appendLe32(&directory, crc);
+        appendLe32(&directory, quint32(stored.size()));
+        appendLe32(&directory, quint32(file.data.size()));
+        appendLe16(&directory, quint16(name.size()));
+        appendLe16(&directory, 0); // Extra
+        appendLe16(&directory, 0); // Comment
+        appendLe16(&directory, 0); // Disk
+        appendLe16(&directory, 0); // Internal attributes
+        appendLe32(&directory, 0); // External attributes
+        appendLe32(&directory, offset);
+        directory += name;
+    }
+
+    const quint32 directoryOffset = quint32(zip.size());
+    zip += directory;
+    appendLe32(&zip, 0x06054b50);
+    appendLe16(&zip, 0);
+    appendLe16(&zip, 0);
+    appendLe16(&zip, quint16(testFiles.size()));
+    appendLe16(&zip, quint16(testFiles.size()));
+    appendLe32(&zip, quint32(directory.size()));
+    appendLe32(&zip, directoryOffset);
+    appendLe16(&zip, 0);
+    return zip;
+}
+
+QVector<TestFile> sampleFiles()
+{
+    return {
+        {"MHServerEmu.exe", makeData(700000, 1, false), true, false},
+        {"Data/Game/Calligraphy.sip", makeData(2500000, 2, true), true, false},
+        {"Data/", QByteArray(), false, false},
+        {"Data/Billing/Catalog.json", makeData(40000, 3, true), false, false},
+        {"config.ini", QByteArray("[Frontend]\nBindIP=127.0.0.1\n"), true, false},
+        {"Empty.txt", QByteArray(), false, false},
+    };
+}
+
+bool writeFile(const QString &path, const QByteArray &data)
+{
+    QFile file(path);
+    return file.open(QIODevice::WriteOnly) && file.write(data) == data.size();
+}
+
+QByteArray readFile(const QString &path)
+{
+    QFile file(path);
+    return file.open(QIODevice::ReadOnly) ? file.readAll() : QByteArray();
+}
+
+} // namespace
+
+class ZipExtractorTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void inflatesEveryLevel_data();
+    void inflatesEveryLevel();
+    void rejectsTruncatedDeflate();
+    void crcMatchesKnownValue();
+
+    void extractsArchive();
+    void failsOnCrcMismatch();
+    void refusesPathsOutsideDestination();
+    void checksArchiveEnd();
+    void refusesOversizedEntries();
+    void extractsWhileDownloading();
+};
+
+void ZipExtractorTest::inflatesEveryLevel_data()
+{
+    QTest::addColumn<int>("level");
+    QTest::addColumn<bool>("compressible");
+    for (int level : {0, 1, 6, 9}) {
+        QTest::addRow("level %d text", level) << level << true;
+        QTest::addRow("level %d random", level) << level << false;
+    }
+}
+
+void ZipExtractorTest::inflatesEveryLevel()
+{
+    QFETCH(int, level);
+    QFETCH(bool, compressible);
+
+    // Level 0 gives stored blocks, short inputs fixed Huffman blocks, the rest dynamic ones
+    for (int size : {1, 100, 70000, 1000000}) {
+        const QByteArray data = makeData(size, size + level, compressible);
+        const QByteArray deflated = rawDeflate(data, level);
+        QByteArray output(size, Qt::Uninitialized);
+        QString errorMessage;
+        QVERIFY2(Inflate::inflate(deflated.constData(), deflated.size(), output.data(), output.size(), &errorMessage), qPrintable(errorMessage));
+        QCOMPARE(output, data);
+    }
+}
+
+void ZipExtractorTest::rejectsTruncatedDeflate()
+{
+    const QByteArray data = makeData(100000, 7, true);
+    const QByteArray deflated = rawDeflate(data);
+    QByteArray output(data.size(), Qt::Uninitialized);
+    QVERIFY(!Inflate::inflate(deflated.constData(), deflated.size() - 10, output.data(), output.size()));
+    QVERIFY(!Inflate::inflate(deflated.constData(), deflated.size(), output.data(), output.size() - 1));
+}
+
+void ZipExtractorTest::crcMatchesKnownValue()
+{
+    QCOMPARE(Inflate::crc32("123456789", 9), 0xCBF43926u);
+    const QByteArray data = makeData(1000, 9, false);
+    QCOMPARE(Inflate::crc32(data.constData() + 300, 700, Inflate::crc32(data.constData(), 300)), Inflate::crc32(data.constData(), 1000));
+}
+
+void ZipExtractorTest::extractsArchive()
+{
+    QTemporaryDir dir;
+    const QString archivePath = dir.filePath("update.zip");
+    const QVector<TestFile> files = sampleFiles();
+    QVERIFY(writeFile(archivePath, makeZip(files)));
+
+    ZipExtractor extractor(dir.filePath("out"));
+    QSignalSpy finished(&extractor, &ZipExtractor::finished);
+    QSignalSpy extracted(&extractor, &ZipExtractor::fileExtracted);
+    extractor.extract(archivePath);
+    QTRY_COMPARE_WITH_TIMEOUT(finished.size(), 1, 20000);
+    QVERIFY2(finished.first().at(0).toBool(), qPrintable(finished.first().at(1).toString()));
+
+    for (const TestFile &file : files) {
+        if (!file.name.endsWith('/')) {
+            QCOMPARE(readFile(dir.filePath("out/" + file.name)), file.data);
+        }
+    }
+    QCOMPARE(extractor.extractedFiles().size(), files.size() - 1);
+    QCOMPARE(extracted.size(), files.size() - 1);
+    QCOMPARE(extracted.last().at(1).toInt(), files.size() - 1);
+    QCOMPARE(extracted.last().at(2).toInt(), files.size() - 1);
+}
+
+void ZipExtractorTest::failsOnCrcMismatch()
+{
+    QTemporaryDir dir;
+    const QString archivePath = dir.filePath("update.zip");
+    QVector<TestFile> files = sampleFiles();
+    files[1].corruptCrc = true;
+    QVERIFY(writeFile(archivePath, makeZip(files)));
+
+    ZipExtractor extractor(dir.filePath("out"));
+    QSignalSpy finished(&extractor, &ZipExtractor::finished);
+    extractor.extract(archivePath);
+    QTRY_COMPARE_WITH_TIMEOUT(finished.size(), 1, 20000);
+    QVERIFY(!finished.first().at(0).toBool());
+    QVERIFY(finished.first().at(1).toString().contains("CRC"));
+}
+
+void ZipExtractorTest::refusesPathsOutsideDestination()
+{
+    QTemporaryDir dir;
+    const QString archivePath = dir.filePath("update.zip");
+    QVERIFY(writeFile(archivePath, makeZip({{"../escaped.txt", QByteArray("nope"), true, false}})));
+
+    ZipExtractor extractor(dir.filePath("out"));
+    QSignalSpy finished(&extractor, &ZipExtractor::finished);
+    extractor.extract(archivePath);
+    QCOMPARE(finished.size(), 1);
+    QVERIFY(!finished.first().at(0).toBool());
+    QVERIFY(!QFile::exists(dir.filePath("escaped.txt")));
+}
+
+void ZipExtractorTest::checksArchiveEnd()
+{
+    QTemporaryDir dir;
+    const QString archivePath = dir.filePath("update.zip");
+    const QByteArray zip = makeZip(sampleFiles());
+    QString errorMessage;
+
+    QVERIFY(writeFile(archivePath, zip));
+    QVERIFY2(ZipExtractor::checkArchiveEnd(archivePath, &errorMessage), qPrintable(errorMessage));
+
+    // Cut short, padded, and missing a byte before the central directory
+    QVERIFY(writeFile(archivePath, zip.left(zip.size() - 1)));
+    QVERIFY(!ZipExtractor::checkArchiveEnd(archivePath, &errorMessage));
+    QVERIFY(writeFile(archivePath, zip + QByteArray(16, '\0')));
+    QVERIFY(!ZipExtractor::checkArchiveEnd(archivePath, &errorMessage));
+    QVERIFY(writeFile(archivePath, zip.left(1000) + zip.mid(1001)));
+    QVERIFY(!ZipExtractor::checkArchiveEnd(archivePath, &errorMessage));
+}
+
+void ZipExtractorTest::refusesOversizedEntries()
+{
+    QTemporaryDir dir;
+    const QString archivePath = dir.filePath("update.zip");
+    QByteArray zip = makeZip({{"Huge.bin", QByteArray("tiny"), false, false}});
+
+    // Both headers claim an uncompressed size just under 4 GiB
+    const quint32 directoryOffset = qFromLittleEndian<quint32>(zip.constData() + zip.size() - 6);
+    qToLittleEndian<quint32>(0xFFFFFFFE, zip.data() + 22);
+    qToLittleEndian<quint32>(0xFFFFFFFE, zip.data() + directoryOffset + 24);
+    QVERIFY(writeFile(archivePath, zip));
+
+    ZipExtractor extractor(dir.filePath("out"));
+    QSignalSpy finished(&extractor, &ZipExtractor::finished);
+    extractor.extract(archivePath);
+    QTRY_COMPARE_WITH_TIMEOUT(finished.size(), 1, 20000);
+    QVERIFY(!finished.first().at(0).toBool());
+    QVERIFY(finished.first().at(1).toString().contains("Huge.bin"));
+    QVERIFY(!QFile::exists(dir.filePath("out/Huge.bin")));
+}
+
+void ZipExtractorTest::extractsWhileDownloading()
+{
+    QTemporaryDir dir;
+    const QVector<TestFile> files = sampleFiles();
+    const QByteArray zip = makeZip(files);
+    const QString partPath = dir.filePath("update.zip.part");
+    const QString archivePath = dir.filePath("update.zip");
+
+    ZipExtractor extractor(dir.filePath("out"));
+    QSignalSpy extracted(&extractor, &ZipExtractor::fileExtracted);
+    QSignalSpy finished(&extractor, &ZipExtractor::finished);
+    extractor.beginStreaming(partPath);
+
+    // Arrives in 64 KiB pieces, like a download
+    QFile part(partPath);
+    QVERIFY(part.open(QIODevice::WriteOnly));
+    for (qint64 offset = 0; offset < zip.size(); offset += 65536) {
+        part.write(zip.mid(offset, 65536));
+        part.flush();
+        extractor.archiveGrew(part.size());
+    }
+    part.close();
+
+    // Every file entry was complete before the central directory arrived
+    QTRY_COMPARE_WITH_TIMEOUT(extracted.size(), files.size() - 1, 20000); // Everything but the directory
+    for (const QList<QVariant> &signal : extracted) {
+        QCOMPARE(signal.at(2).toInt(), 0);
+    }
+
+    extractor.releaseArchive();
+    QVERIFY(QFile::rename(partPath, archivePath));
+    extractor.extract(archivePath);
+    QTRY_COMPARE_WITH_TIMEOUT(finished.size(), 1, 20000);
+    QVERIFY2(finished.first().at(0).toBool(), qPrintable(finished.first().at(1).toString()));
+    for (const TestFile &file : files) {
+        if (!file.name.endsWith('/')) {
+            QCOMPARE(readFile(dir.filePath("out/" + file.name)), file.data);
+        }
+    }
+}
+
+QTEST_GUILESS_MAIN(ZipExtractorTest)
+
+#include "zipextractor_test.moc"
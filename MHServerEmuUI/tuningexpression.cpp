@@ -0,0 +1,359 @@
+#include "tuningexpression.h"
+#include <cmath>
+
+namespace {
+
+// One stack slot: either a single constant or a full column of values
+struct Slot {
+    bool scalar = true;
+    double constant = 0.0;
+    QVector<double> column;
+};
+
+template <typename Function>
+void applyUnary(Slot &slot, Function function)
+{
+    if (slot.scalar) {
+        slot.constant = function(slot.constant);
+        return;
+    }
+    double *values = slot.column.data();
+    const int count = slot.column.size();
+    for (int i = 0; i < count; ++i) {
+        values[i] = function(values[i]);
+    }
+}
+
+template <typename Function>
+void applyBinary(Slot &left, const Slot &right, Function function)
+{
+    if (left.scalar && right.scalar) {
+        left.constant = function(left.constant, right.constant);
+    } else if (right.scalar) {
+        double *values = left.column.data();
+        const double constant = right.constant;
+        const int count = left.column.size();
+        for (int i = 0; i < count; ++i) {
+            values[i] = function(values[i], constant);
+        }
+    } else if (left.scalar) {
+        const double constant = left.constant;
+        left.scalar = false;
+        left.column = right.column;
+        double *values = left.column.data();
+        const int count = left.column.size();
+        for (int i = 0; i < count; ++i) {
+            values[i] = function(constant, values[i]);
+        }
+    } else {
+        double *values = left.column.data();
+        const double *others = right.column.constData();
+        const int count = left.column.size();
+        for (int i = 0; i < count; ++i) {
+            values[i] = function(values[i], others[i]);
+        }
+    }
+}
+
+double roundTo(double value, double decimals)
+{
+    const double scale = std::pow(10.0, std::round(decimals));
+    return std::round(value * scale) / scale;
+}
+
+} // namespace
+
+bool TuningExpression::parse(const QString &text, QString *errorMessage)
+{
+    source = text.trimmed();
+    code.clear();
+    readsValue = false;
+    position = 0;
+    error.clear();
+
+    if (source.startsWith('=')) {
+        position = 1;
+    }
+
+    bool ok = parseSum();
+    skipSpaces();
+    if (ok && position < source.size()) {
+        ok = fail(QString("Unexpected '%1'").arg(source.at(position)));
+    }
+    if (ok && code.isEmpty()) {
+        ok = fail("Empty expression");
+    }
+
+    if (!ok) {
+        code.clear();
+        if (errorMessage) {
+            *errorMessage = error;
+        }
+    }
+    return ok;
+}
+
+bool TuningExpression::fail(const QString &message)
+{
+    if (error.isEmpty()) {
+        error = QString("%1 at position %2").arg(message).arg(position + 1);
+    }
+    return false;
+}
+
+void TuningExpression::skipSpaces()
+{
+    while (position < source.size() && source.at(position).isSpace()) {
+        ++position;
+    }
+}
+
+bool TuningExpression::parseSum()
+{
+    if (!parseProduct()) {
+        return false;
+    }
+    for (;;) {
+        skipSpaces();
+        if (position >= source.size() || (source.at(position) != '+' && source.at(position) != '-')) {
+            return true;
+        }
+        const Op op = source.at(position) == '+' ? Add : Subtract;
+        ++position;
+        if (!parseProduct()) {
+            return false;
+        }
+        code.append({op, 0.0});
+    }
+}
+
+bool TuningExpression::parseProduct()
+{
+    if (!parseUnary()) {
+        return false;
+    }
+    for (;;) {
+        skipSpaces();
+        if (position >= source.size() || (source.at(position) != '*' && source.at(position) != '/')) {
+            return true;
+        }
+        const Op op = source.at(position) == '*' ? Multiply : Divide;
+        ++position;
+        if (!parseUnary()) {
+            return false;
+        }
+        code.append({op, 0.0});
+    }
+}
+
+bool TuningExpression::parseUnary()
+{
+    skipSpaces();
+    if (position < source.size() && (source.at(position) == '-' || source.at(position) == '+')) {
+        const bool negate = source.at(position) == '-';
+        ++position;
+        if (!parseUnary()) {
+            return false;
+        }
+        if (negate) {
+            code.append({Negate, 0.0});
+        }
+        return true;
+    }
+    return parsePrimary();
+}
+
+bool TuningExpression::parsePrimary()
+{
+    skipSpaces();
+    if (position >= source.size()) {
+        return fail("Expected a value");
+    }
+
+    const QChar c = source.at(position);
+    if (c == '(') {
+        ++position;
+        if (!parseSum()) {
+            return false;
+        }
+        skipSpaces();
+        if (position >= source.size() || source.at(position) != ')') {
+            return fail("Expected ')'");
+        }
+        ++position;
+        return true;
+    }
+
+    if (c.isDigit() || c == '.') {
+        const int start = position;
+        while (position < source.size() && (source.at(position).isDigit() || source.at(position) == '.')) {
+            ++position;
+        }
+        // Exponent, e.g. 1e-3
+        if (position < source.size() && (source.at(position) == 'e' || source.at(position) == 'E')) {
+            int end = position + 1;
+            if (end < source.size() && (source.at(end) == '+' || source.at(end) == '-')) {
+                ++end;
+            }
+            if (end < source.size() && source.at(end).isDigit()) {
+                position = end;
+                while (position < source.size() && source.at(position).isDigit()) {
+                    ++position;
+                }
+            }
+        }
+        bool ok = false;
+        const double constant = source.mid(start, position - start).toDouble(&ok);
+        if (!ok) {
+            position = start;
+            return fail("Invalid number");
+        }
+        code.append({PushConstant, constant});
+        return true;
+    }
+
+    if (c.isLetter()) {
+        const int start = position;
+        while (position < source.size() && source.at(position).isLetterOrNumber()) {
+            ++position;
+        }
+        const QString name = source.mid(start, position - start).toLower();
+        if (name == "v" || name == "value") {
+            code.append({PushValue, 0.0});
+            readsValue = true;
+            return true;
+        }
+        skipSpaces();
+        if (position < source.size() && source.at(position) == '(') {
+            ++position;
+            return parseCall(name);
+        }
+        position = start;
+        return fail(QString("Unknown name '%1'").arg(name));
+    }
+
+    return fail(QString("Unexpected '%1'").arg(c));
+}
+
+bool TuningExpression::parseCall(const QString &name)
+{
+    const int nameStart = position;
+    int arguments = 0;
+    skipSpaces();
+    if (position < source.size() && source.at(position) != ')') {
+        for (;;) {
+            if (!parseSum()) {
+                return false;
+            }
+            ++arguments;
+            skipSpaces();
+            if (position < source.size() && source.at(position) == ',') {
+                ++position;
+                continue;
+            }
+            break;
+        }
+    }
+    if (position >= source.size() || source.at(position) != ')') {
+        return fail("Expected ')'");
+    }
+    ++position;
+
+    struct Function {
+        const char *name;
+        int arguments;
+        Op op;
+    };
+    static const Function functions[] = {
+        {"min", 2, Min},
+        {"max", 2, Max},
+        {"clamp", 3, Clamp},
+        {"abs", 1, Abs},
+        {"floor", 1, Floor},
+        {"ceil", 1, Ceil},
+        {"round", 1, Round},
+        {"round", 2, RoundDigits},
+    };
+
+    bool known = false;
+    for (const Function &function : functions) {
+        if (name != QLatin1String(function.name)) {
+            continue;
+        }
+        known = true;
+        if (function.arguments == arguments) {
+            code.append({function.op, 0.0});
+            return true;
+        }
+    }
+
+    position = nameStart;
+    return fail(known ? QString("Wrong number of arguments for %1()").arg(name) : QString("Unknown function '%1'").arg(name));
+}
+
+void TuningExpression::evaluate(const double *in, double *out, int count) const
+{
+    QVector<Slot> stack;
+    stack.reserve(8);
+
+    for (const Instruction &instruction : code) {
+        switch (instruction.op) {
+        case PushValue: {
+            Slot slot;
+            slot.scalar = false;
+            slot.column = QVector<double>(in, in + count);
+            stack.append(slot);
+            break;
+        }
+        case PushConstant: {
+            Slot slot;
+            slot.constant = instruction.constant;
+            stack.append(slot);
+            break;
+        }
+        case Negate:
+            applyUnary(stack.last(), [](double x) { return -x; });
+            break;
+        case Abs:
+            applyUnary(stack.last(), [](double x) { return std::abs(x); });
+            break;
+        case Floor:
+            applyUnary(stack.last(), [](double x) { return std::floor(x); });
+            break;
+        case Ceil:
+            applyUnary(stack.last(), [](double x) { return std::ceil(x); });
+            break;
+        case Round:
+            applyUnary(stack.last(), [](double x) { return std::round(x); });
+            break;
+        case Clamp: {
+            // clamp(x, lo, hi) is max(min(x, hi), lo)
+            Slot high = stack.takeLast();
+            Slot low = stack.takeLast();
+            applyBinary(stack.last(), high, [](double a, double b) { return a < b ? a : b; });
+            applyBinary(stack.last(), low, [](double a, double b) { return a > b ? a : b; });
+            break;
+        }
+        default: {
+            Slot right = stack.takeLast();
+            Slot &left = stack.last();
+            switch (instruction.op) {
+            case Add:         applyBinary(left, right, [](double a, double b) { return a + b; }); break;
+            case Subtract:    applyBinary(left, right, [](double a, double b) { return a - b; }); break;
+            case Multiply:    applyBinary(left, right, [](double a, double b) { return a * b; }); break;
+            case Divide:      applyBinary(left, right, [](double a, double b) { return a / b; }); break;
+            case Min:         applyBinary(left, right, [](double a, double b) { return a < b ? a : b; }); break;
+            case Max:         applyBinary(left, right, [](double a, double b) { return a > b ? a : b; }); break;
+            case RoundDigits: applyBinary(left, right, roundTo); break;
+            default: break;
+            }
+        }
+        }
+    }
+
+    const Slot &result = stack.last();
+    for (int i = 0; i < count; ++i) {
+        const double value = result.scalar ? result.constant : result.column.at(i);
+        out[i] = std::isfinite(value) ? value : in[i];
+    }
+}
@@ -0,0 +1,64 @@
+#ifndef TUNINGEXPRESSION_H
+#define TUNINGEXPRESSION_H
+
+#include <QString>
+#include <QVector>
+
+// Small arithmetic language for bulk edits of live tuning values, where v is the current value:
+//   v*1.5    clamp(v, 0, 5)    =2    round(v*1.1, 2)    max(v, 1) + 0.5
+// A leading '=' is optional. The expression is compiled once to postfix code and evaluated a
+// whole column at a time, so each operation is one tight loop over the selected values.
+class TuningExpression
+{
+public:
+    bool parse(const QString &text, QString *errorMessage);
+    bool isValid() const { return !code.isEmpty(); }
+    QString text() const { return source; }
+    bool usesValue() const { return readsValue; } // False for plain assignments like =2
+
+    // out may alias in; non-finite results are left as the input value
+    void evaluate(const double *in, double *out, int count) const;
+
+private:
+    enum Op : quint8 {
+        PushValue,
+        PushConstant,
+        Add,
+        Subtract,
+        Multiply,
+        Divide,
+        Negate,
+        Min,
+        Max,
+        Clamp,
+        Abs,
+        Floor,
+        Ceil,
+        Round,      // round(x) or round(x, decimals)
+        RoundDigits
+    };
+
+    struct Instruction {
+        Op op;
+        double constant;
+    };
+
+    // Recursive descent over source, appending to code
+    bool parseSum();
+    bool parseProduct();
+    bool parseUnary();
+    bool parsePrimary();
+    bool parseCall(const QString &name);
+    void skipSpaces();
+    bool fail(const QString &message);
+
+    QString source;
+    QVector<Instruction> code;
+    bool readsValue = false;
+
+    // Parser state
+    int position = 0;
+    QString error;
+};
+
+#endif // TUNINGEXPRESSION_H
@@ -0,0 +1,324 @@
+#include "tuningfilewatcher.h"
+#include "atomicfilewriter.h"
+#include "inifile.h"
+#include <QFileSystemWatcher>
+#include <QTimer>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSet>
+#include <QThreadPool>
+#include <QPromise>
+#include <QFutureWatcher>
+#include <QDebug>
+
+TuningFileWatcher::TuningFileWatcher(QObject *parent)
+    : QObject(parent)
+    , watcher(new QFileSystemWatcher(this))
+    , debounceTimer(new QTimer(this))
+    , generation(0)
+    , scanInFlight(false)
+    , rescanPending(false)
+{
+    // Editors tend to save in several steps (truncate, write, rename), one update covers them all
+    debounceTimer->setSingleShot(true);
+    debounceTimer->setInterval(DebounceMs);
+
+    connect(watcher, &QFileSystemWatcher::fileChanged, this, &TuningFileWatcher::onPathChanged);
+    connect(watcher, &QFileSystemWatcher::directoryChanged, this, &TuningFileWatcher::onPathChanged);
+    connect(debounceTimer, &QTimer::timeout, this, &TuningFileWatcher::rescan);
+}
+
+void TuningFileWatcher::setServerPath(const QString &serverPath)
+{
+    QString root = serverPath.isEmpty() ? QString() : QDir::cleanPath(QDir(serverPath).filePath("MHServerEmu"));
+    QString newLiveTuningDir = root.isEmpty() ? QString() : QDir(root).filePath("Data/Game/LiveTuning");
+    if (newLiveTuningDir == liveTuningDir) {
+        return;
+    }
+
+    if (!watcher->files().isEmpty()) {
+        watcher->removePaths(watcher->files());
+    }
+    if (!watcher->directories().isEmpty()) {
+        watcher->removePaths(watcher->directories());
+    }
+
+    liveTuningDir = newLiveTuningDir;
+    baseConfigPath = root.isEmpty() ? QString() : QDir(root).filePath("config.ini");
+    overrideConfigPath = root.isEmpty() ? QString() : QDir(root).filePath("ConfigOverride.ini");
+    cache.clear();
+    debounceTimer->stop();
+
+    // Results of a scan for the previous path are dropped when they arrive
+    generation++;
+    scanInFlight = false;
+    rescanPending = false;
+
+    // Prime the cache without announcing anything, everything is "new" at this point
+    startScan(false);
+}
+
+QSharedPointer<const LiveTuningStore> TuningFileWatcher::liveTuning(const QString &filePath)
+{
+    const QString path = QDir::cleanPath(filePath);
+    QFileInfo info(path);
+    auto it = cache.constFind(path);
+    if (it != cache.constEnd() && it->liveTuning && it->size == info.size() && it->modified == info.lastModified()) {
+        return it->liveTuning;
+    }
+
+    ParseResult result = parse(path, QByteArray());
+    if (!result.exists || result.parseFailed) {
+        return QSharedPointer<const LiveTuningStore>();
+    }
+    applyResult(result, false);
+    return result.liveTuning;
+}
+
+QSharedPointer<const QVariantMap> TuningFileWatcher::iniValues(const QString &filePath)
+{
+    const QString path = QDir::cleanPath(filePath);
+    QFileInfo info(path);
+    auto it = cache.constFind(path);
+    if (it != cache.constEnd() && it->ini && it->size == info.size() && it->modified == info.lastModified()) {
+        return it->ini;
+    }
+
+    ParseResult result = parse(path, QByteArray());
+    if (!result.exists) {
+        return QSharedPointer<const QVariantMap>();
+    }
+    applyResult(result, false);
+    return result.ini;
+}
+
+QByteArray TuningFileWatcher::fileHash(const QString &filePath) const
+{
+    auto it = cache.constFind(QDir::cleanPath(filePath));
+    return it != cache.constEnd() ? it->hash : QByteArray();
+}
+
+QVariantMap TuningFileWatcher::readIni(const QString &path)
+{
+    IniFile ini;
+    ini.load(path);
+    return ini.toMap();
+}
+
+void TuningFileWatcher::onPathChanged(const QString &path)
+{
+    Q_UNUSED(path);
+    debounceTimer->start();
+}
+
+void TuningFileWatcher::rescan()
+{
+    startScan(true);
+}
+
+TuningFileWatcher::ParseResult TuningFileWatcher::parse(const QString &path, const QByteArray &knownHash)
+{
+    ParseResult result;
+    result.path = path;
+
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return result;
+    }
+    QByteArray content = file.readAll();
+    file.close();
+
+    QFileInfo info(path);
+    result.exists = true;
+    result.size = info.size();
+    result.modified = info.lastModified();
+    result.hash = AtomicFileWriter::contentHash(content);
+
+    // Touched but identical, only the stamp needs refreshing
+    if (!knownHash.isEmpty() && result.hash == knownHash) {
+        return result;
+    }
+    result.contentChanged = true;
+
+    if (path.endsWith(QLatin1String(".json"))) {
+        QSharedPointer<LiveTuningStore> store = QSharedPointer<LiveTuningStore>::create();
+        QString parseError;
+        if (!store->loadJson(content, &parseError)) {
+            qDebug() << "Skipping" << path << "for now:" << parseError;
+            result.parseFailed = true;
+            return result;
+        }
+        result.liveTuning = store;
+    } else {
+        // Parsed from the bytes already read instead of opening the file again
+        IniFile ini;
+        ini.parse(content);
+        result.ini = QSharedPointer<const QVariantMap>(new QVariantMap(ini.toMap()));
+    }
+    return result;
+}
+
+QStringList TuningFileWatcher::candidatePaths() const
+{
+    QStringList paths;
+    QDir dir(liveTuningDir);
+    const QStringList names = dir.entryList({"LiveTuningData*.json"}, QDir::Files);
+    for (const QString &name : names) {
+        paths.append(dir.filePath(name));
+    }
+
+    if (QFileInfo::exists(baseConfigPath)) {
+        paths.append(baseConfigPath);
+    }
+    if (QFileInfo::exists(overrideConfigPath)) {
+        paths.append(overrideConfigPath);
+    }
+    return paths;
+}
+
+void TuningFileWatcher::startScan(bool announce)
+{
+    if (liveTuningDir.isEmpty()) {
+        return;
+    }
+    if (scanInFlight) {
+        rescanPending = true;
+        return;
+    }
+
+    const QStringList candidates = candidatePaths();
+    const QSet<QString> present(candidates.begin(), candidates.end());
+
+    // Deleted files and events renamed to OFF_ drop out of the candidates
+    const QStringList cachedPaths = cache.keys();
+    for (const QString &path : cachedPaths) {
+        if (!present.contains(path)) {
+            cache.remove(path);
+            if (announce) {
+                announceRemoval(path);
+            }
+        }
+    }
+
+    // Only files whose size or mtime moved are read, and only changed content is parsed
+    QVector<QPair<QString, QByteArray>> jobs;
+    for (const QString &path : candidates) {
+        QFileInfo info(path);
+        auto it = cache.constFind(path);
+        if (it != cache.constEnd() && it->size == info.size() && it->modified == info.lastModified()) {
+            continue;
+        }
+        jobs.append({path, it != cache.constEnd() ? it->hash : QByteArray()});
+    }
+
+    rewatch();
+
+    if (jobs.isEmpty()) {
+        return;
+    }
+
+    scanInFlight = true;
+    const quint64 scanGeneration = generation;
+
+    // The worker only sees the jobs and the promise; results come back through a watcher that
+    // belongs to this object, so nothing off the GUI thread has to know whether it still exists
+    QSharedPointer<QPromise<QVector<ParseResult>>> scan = QSharedPointer<QPromise<QVector<ParseResult>>>::create();
+    QFutureWatcher<QVector<ParseResult>> *scanWatcher = new QFutureWatcher<QVector<ParseResult>>(this);
+    connect(scanWatcher, &QFutureWatcher<QVector<ParseResult>>::finished, this, [this, scanWatcher, scanGeneration, announce]() {
+        scanWatcher->deleteLater();
+        if (generation != scanGeneration) {
+            return;
+        }
+
+        scanInFlight = false;
+        if (scanWatcher->future().resultCount() > 0) {
+            const QVector<ParseResult> results = scanWatcher->result();
+            for (const ParseResult &result : results) {
+                applyResult(result, announce);
+            }
+        }
+
+        if (rescanPending) {
+            rescanPending = false;
+            startScan(true);
+        }
+    });
+    scan->start();
+    scanWatcher->setFuture(scan->future());
+
+    QThreadPool::globalInstance()->start([scan, jobs]() {
+        QVector<ParseResult> results;
+        results.reserve(jobs.size());
+        for (const QPair<QString, QByteArray> &job : jobs) {
+            results.append(parse(job.first, job.second));
+        }
+        scan->addResult(results);
+        scan->finish();
+    });
+}
+
+void TuningFileWatcher::applyResult(const ParseResult &result, bool announce)
+{
+    if (!result.exists) {
+        if (cache.remove(result.path) && announce) {
+            announceRemoval(result.path);
+        }
+        return;
+    }
+    if (result.parseFailed) {
+        return;
+    }
+
+    CachedFile &entry = cache[result.path];
+    entry.size = result.size;
+    entry.modified = result.modified;
+    if (!result.contentChanged) {
+        return;
+    }
+
+    entry.hash = result.hash;
+    entry.liveTuning = result.liveTuning;
+    entry.ini = result.ini;
+
+    if (!announce) {
+        return;
+    }
+    if (result.liveTuning) {
+        emit liveTuningFileChanged(QFileInfo(result.path).fileName(), result.liveTuning, result.hash);
+    } else {
+        emit configFileChanged(result.path);
+    }
+}
+
+void TuningFileWatcher::announceRemoval(const QString &path)
+{
+    if (path.endsWith(QLatin1String(".json"))) {
+        emit liveTuningFileChanged(QFileInfo(path).fileName(), QSharedPointer<const LiveTuningStore>(), QByteArray());
+    } else {
+        emit configFileChanged(path);
+    }
+}
+
+void TuningFileWatcher::rewatch()
+{
+    // Atomic saves replace the file, which drops it from the watcher, so watches are re-added after each scan
+    QStringList missing;
+    const QStringList watchedDirs = watcher->directories();
+    const QStringList watchedFiles = watcher->files();
+
+    for (const QString &dir : {liveTuningDir, QFileInfo(baseConfigPath).absolutePath()}) {
+        if (QFileInfo::exists(dir) && !watchedDirs.contains(dir)) {
+            missing.append(dir);
+        }
+    }
+    for (const QString &path : candidatePaths()) {
+        if (!watchedFiles.contains(path)) {
+            missing.append(path);
+        }
+    }
+
+    if (!missing.isEmpty()) {
+        watcher->addPaths(missing);
+    }
+}
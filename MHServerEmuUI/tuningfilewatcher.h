@@ -0,0 +1,86 @@
+#ifndef TUNINGFILEWATCHER_H
+#define TUNINGFILEWATCHER_H
+
+#include <QObject>
+#include <QHash>
+#include <QDateTime>
+#include <QSharedPointer>
+#include <QVariantMap>
+#include "livetuningstore.h"
+
+class QFileSystemWatcher;
+class QTimer;
+
+// Watches a server's LiveTuning folder, config.ini and ConfigOverride.ini and keeps a parsed copy
+// of each file keyed by path, size, mtime and content hash. Bursts of notifications are debounced,
+// and only files whose content actually changed are re-parsed, off the GUI thread.
+class TuningFileWatcher : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int DebounceMs = 300;
+
+    explicit TuningFileWatcher(QObject *parent = nullptr);
+
+    void setServerPath(const QString &serverPath);
+    QString liveTuningDirectory() const { return liveTuningDir; }
+    QString configPath() const { return baseConfigPath; }
+    QString configOverridePath() const { return overrideConfigPath; }
+
+    // Cached parses; a file that changed since it was cached is parsed here on the calling thread
+    QSharedPointer<const LiveTuningStore> liveTuning(const QString &path);
+    QSharedPointer<const QVariantMap> iniValues(const QString &path);
+    QByteArray fileHash(const QString &path) const;
+
+    static QVariantMap readIni(const QString &path);
+
+signals:
+    // store is null when the file was removed or renamed to OFF_
+    void liveTuningFileChanged(const QString &fileName, QSharedPointer<const LiveTuningStore> store, const QByteArray &hash);
+    void configFileChanged(const QString &path);
+
+private slots:
+    void onPathChanged(const QString &path);
+    void rescan();
+
+private:
+    struct CachedFile {
+        qint64 size = -1;
+        QDateTime modified;
+        QByteArray hash;
+        QSharedPointer<const LiveTuningStore> liveTuning;
+        QSharedPointer<const QVariantMap> ini;
+    };
+
+    struct ParseResult {
+        QString path;
+        bool exists = false;
+        bool contentChanged = false;
+        bool parseFailed = false; // Left uncached so the next notification retries it
+        qint64 size = -1;
+        QDateTime modified;
+        QByteArray hash;
+        QSharedPointer<const LiveTuningStore> liveTuning;
+        QSharedPointer<const QVariantMap> ini;
+    };
+
+    static ParseResult parse(const QString &path, const QByteArray &knownHash);
+    QStringList candidatePaths() const;
+    void startScan(bool announce);
+    void applyResult(const ParseResult &result, bool announce);
+    void announceRemoval(const QString &path);
+    void rewatch();
+
+    QFileSystemWatcher *watcher;
+    QTimer *debounceTimer;
+    QString liveTuningDir;
+    QString baseConfigPath;
+    QString overrideConfigPath;
+    QHash<QString, CachedFile> cache;
+    quint64 generation;
+    bool scanInFlight;
+    bool rescanPending;
+};
+
+#endif // TUNINGFILEWATCHER_H
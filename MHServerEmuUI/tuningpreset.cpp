@@ -0,0 +1,423 @@
+#include "tuningpreset.h"
+#include "atomicfilewriter.h"
+#include "effectivelivetuning.h"
+#include <QDir>
+#include <QtEndian>
+#include <cstring>
+#include <algorithm>
+
+namespace {
+
+constexpr char Magic[4] = {'M', 'H', 'T', 'P'};
+constexpr qint64 HeaderSize = 48;
+constexpr qint64 FileRecordSize = 12 + TuningPreset::HashSize;
+constexpr int MaxDetailsPerFile = 50;
+
+void appendUInt32(QByteArray &out, quint32 value)
+{
+    char bytes[4];
+    qToLittleEndian(value, bytes);
+    out.append(bytes, 4);
+}
+
+void appendUInt64(QByteArray &out, quint64 value)
+{
+    char bytes[8];
+    qToLittleEndian(value, bytes);
+    out.append(bytes, 8);
+}
+
+void padTo8(QByteArray &out)
+{
+    while (out.size() % 8 != 0) {
+        out.append('\0');
+    }
+}
+
+QString entryName(const LiveTuningStore &store, int index)
+{
+    return QString("%1 / %2").arg(store.prototype(index), store.setting(index));
+}
+
+} // namespace
+
+TuningPreset::~TuningPreset()
+{
+    close();
+}
+
+bool TuningPreset::capture(const QString &liveTuningDir, QByteArray *snapshot, QString *errorMessage)
+{
+    QDir dir(liveTuningDir);
+    QStringList names;
+    for (const QString &name : dir.entryList({"LiveTuningData*.json"}, QDir::Files)) {
+        if (EffectiveLiveTuning::isActiveFileName(name)) {
+            names.append(name);
+        }
+    }
+    std::sort(names.begin(), names.end());
+
+    QVector<LiveTuningStore> stores(names.size());
+    for (int i = 0; i < names.size(); ++i) {
+        QString parseError;
+        if (!stores[i].loadFile(dir.filePath(names.at(i)), &parseError)) {
+            if (errorMessage) {
+                *errorMessage = QString("%1: %2").arg(names.at(i), parseError);
+            }
+            return false;
+        }
+    }
+
+    *snapshot = serialize(names, stores);
+    return true;
+}
+
+QByteArray TuningPreset::serialize(const QStringList &fileNames, const QVector<LiveTuningStore> &stores)
+{
+    // One string table for everything; each file's own pools are translated once per string
+    StringPool strings;
+    QVector<quint32> nameIds;
+    for (const QString &name : fileNames) {
+        nameIds.append(static_cast<quint32>(strings.intern(name)));
+    }
+
+    QVector<double> values;
+    QVector<quint32> prototypeIds;
+    QVector<quint32> settingIds;
+    QVector<quint32> firstEntries;
+    QVector<QByteArray> hashes;
+    for (const LiveTuningStore &store : stores) {
+        QVector<quint32> prototypeMap(store.prototypePool().size());
+        for (int id = 0; id < prototypeMap.size(); ++id) {
+            prototypeMap[id] = static_cast<quint32>(strings.intern(store.prototypePool().at(id)));
+        }
+        QVector<quint32> settingMap(store.settingPool().size());
+        for (int id = 0; id < settingMap.size(); ++id) {
+            settingMap[id] = static_cast<quint32>(strings.intern(store.settingPool().at(id)));
+        }
+
+        firstEntries.append(static_cast<quint32>(values.size()));
+        for (int i = 0; i < store.size(); ++i) {
+            values.append(store.value(i));
+            prototypeIds.append(prototypeMap.at(store.prototypeId(i)));
+            settingIds.append(settingMap.at(store.settingId(i)));
+        }
+        hashes.append(AtomicFileWriter::contentHash(store.toJson()));
+    }
+
+    QByteArray stringData;
+    QVector<quint32> stringOffsets;
+    for (int id = 0; id < strings.size(); ++id) {
+        stringOffsets.append(static_cast<quint32>(stringData.size()));
+        stringData += strings.at(id).toUtf8();
+    }
+    stringOffsets.append(static_cast<quint32>(stringData.size()));
+
+    QByteArray out;
+    out.reserve(HeaderSize + fileNames.size() * FileRecordSize + stringOffsets.size() * 4 + stringData.size() + 8
+                + values.size() * 16);
+
+    out.append(Magic, 4);
+    appendUInt32(out, Version);
+    appendUInt32(out, static_cast<quint32>(fileNames.size()));
+    appendUInt32(out, static_cast<quint32>(strings.size()));
+    appendUInt32(out, static_cast<quint32>(values.size()));
+    appendUInt32(out, static_cast<quint32>(stringData.size()));
+    appendUInt64(out, static_cast<quint64>(QDateTime::currentMSecsSinceEpoch()));
+    out.append(16, '\0'); // Reserved
+
+    for (int i = 0; i < fileNames.size(); ++i) {
+        appendUInt32(out, nameIds.at(i));
+        appendUInt32(out, firstEntries.at(i));
+        appendUInt32(out, static_cast<quint32>(stores.at(i).size()));
+        out.append(hashes.at(i).leftJustified(HashSize, '\0', true));
+    }
+
+    for (quint32 offset : stringOffsets) {
+        appendUInt32(out, offset);
+    }
+    out += stringData;
+    padTo8(out);
+
+    for (double value : values) {
+        quint64 bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        appendUInt64(out, bits);
+    }
+    for (quint32 id : prototypeIds) {
+        appendUInt32(out, id);
+    }
+    for (quint32 id : settingIds) {
+        appendUInt32(out, id);
+    }
+    return out;
+}
+
+bool TuningPreset::open(const QString &path, QString *errorMessage)
+{
+    close();
+
+    auto failWith = [this, errorMessage](const QString &message) {
+        if (errorMessage) {
+            *errorMessage = message;
+        }
+        close();
+        return false;
+    };
+
+    file.setFileName(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return failWith(file.errorString());
+    }
+    size = file.size();
+    if (size < HeaderSize) {
+        return failWith("Not a tuning preset.");
+    }
+
+    // Everything is read in place from the mapping; nothing is decoded until asked for
+    data = reinterpret_cast<const char *>(file.map(0, size));
+    if (!data) {
+        fallback = file.readAll();
+        data = fallback.constData();
+    }
+
+    if (std::memcmp(data, Magic, 4) != 0) {
+        return failWith("Not a tuning preset.");
+    }
+    if (readUInt32(4) != Version) {
+        return failWith(QString("Unsupported preset version %1.").arg(readUInt32(4)));
+    }
+
+    fileTotal = readUInt32(8);
+    stringTotal = readUInt32(12);
+    entryTotal = readUInt32(16);
+    const qint64 stringBytes = readUInt32(20);
+
+    filesOffset = HeaderSize;
+    stringOffsetsOffset = filesOffset + qint64(fileTotal) * FileRecordSize;
+    stringDataOffset = stringOffsetsOffset + (qint64(stringTotal) + 1) * 4;
+    valuesOffset = (stringDataOffset + stringBytes + 7) & ~qint64(7);
+    prototypesOffset = valuesOffset + qint64(entryTotal) * 8;
+    settingsOffset = prototypesOffset + qint64(entryTotal) * 4;
+    if (settingsOffset + qint64(entryTotal) * 4 > size) {
+        return failWith("The preset file is truncated.");
+    }
+
+    for (int i = 0; i < fileCount(); ++i) {
+        const qint64 record = filesOffset + i * FileRecordSize;
+        if (readUInt32(record) >= stringTotal || qint64(readUInt32(record + 4)) + readUInt32(record + 8) > entryTotal) {
+            return failWith("The preset file is corrupt.");
+        }
+    }
+    if (readUInt32(stringOffsetsOffset + qint64(stringTotal) * 4) != stringBytes) {
+        return failWith("The preset file is corrupt.");
+    }
+    return true;
+}
+
+void TuningPreset::close()
+{
+    if (data && data != fallback.constData()) {
+        file.unmap(reinterpret_cast<uchar *>(const_cast<char *>(data)));
+    }
+    data = nullptr;
+    fallback.clear();
+    if (file.isOpen()) {
+        file.close();
+    }
+    size = 0;
+    fileTotal = stringTotal = entryTotal = 0;
+}
+
+quint32 TuningPreset::readUInt32(qint64 offset) const
+{
+    return qFromLittleEndian<quint32>(data + offset);
+}
+
+const char *TuningPreset::string(quint32 id, int *length) const
+{
+    *length = 0;
+    if (id >= stringTotal) {
+        return data + stringDataOffset;
+    }
+    const quint32 begin = readUInt32(stringOffsetsOffset + qint64(id) * 4);
+    const quint32 end = readUInt32(stringOffsetsOffset + qint64(id + 1) * 4);
+    if (begin > end || end > readUInt32(20)) {
+        return data + stringDataOffset;
+    }
+    *length = static_cast<int>(end - begin);
+    return data + stringDataOffset + begin;
+}
+
+QDateTime TuningPreset::created() const
+{
+    return isOpen() ? QDateTime::fromMSecsSinceEpoch(static_cast<qint64>(qFromLittleEndian<quint64>(data + 24))) : QDateTime();
+}
+
+QString TuningPreset::fileName(int index) const
+{
+    int length;
+    const char *name = string(readUInt32(filesOffset + index * FileRecordSize), &length);
+    return QString::fromUtf8(name, length);
+}
+
+QByteArray TuningPreset::fileHash(int index) const
+{
+    return QByteArray(data + filesOffset + index * FileRecordSize + 12, HashSize);
+}
+
+int TuningPreset::entryCount(int index) const
+{
+    return static_cast<int>(readUInt32(filesOffset + index * FileRecordSize + 8));
+}
+
+LiveTuningStore TuningPreset::toStore(int index) const
+{
+    const qint64 record = filesOffset + index * FileRecordSize;
+    const quint32 first = readUInt32(record + 4);
+    const int count = static_cast<int>(readUInt32(record + 8));
+
+    LiveTuningStore store;
+    store.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        const qint64 entry = qint64(first) + i;
+        int prototypeLength;
+        int settingLength;
+        const char *prototype = string(readUInt32(prototypesOffset + entry * 4), &prototypeLength);
+        const char *setting = string(readUInt32(settingsOffset + entry * 4), &settingLength);
+        const quint64 bits = qFromLittleEndian<quint64>(data + valuesOffset + entry * 8);
+        double value;
+        std::memcpy(&value, &bits, sizeof(value));
+        store.appendUtf8(prototype, prototypeLength, setting, settingLength, value);
+    }
+    return store;
+}
+
+QMap<QString, TuningPreset::Side> TuningPreset::sides() const
+{
+    QMap<QString, Side> result;
+    for (int i = 0; i < fileCount(); ++i) {
+        result.insert(fileName(i), {fileHash(i), [this, i]() { return toStore(i); }});
+    }
+    return result;
+}
+
+QVector<TuningPreset::FileDiff> TuningPreset::diffFromFolder(const QString &liveTuningDir) const
+{
+    QMap<QString, Side> live;
+    QDir dir(liveTuningDir);
+    for (const QString &name : dir.entryList({"LiveTuningData*.json"}, QDir::Files)) {
+        if (!EffectiveLiveTuning::isActiveFileName(name)) {
+            continue;
+        }
+        QFile liveFile(dir.filePath(name));
+        if (!liveFile.open(QIODevice::ReadOnly)) {
+            continue;
+        }
+        const QByteArray content = liveFile.readAll();
+        live.insert(name, {AtomicFileWriter::contentHash(content), [content]() {
+            LiveTuningStore store;
+            store.loadJson(content, nullptr);
+            return store;
+        }});
+    }
+    return diff(live, sides());
+}
+
+QVector<TuningPreset::FileDiff> TuningPreset::diffFrom(const TuningPreset &other) const
+{
+    return diff(other.sides(), sides());
+}
+
+QVector<TuningPreset::FileDiff> TuningPreset::diff(const QMap<QString, Side> &from, const QMap<QString, Side> &to)
+{
+    QStringList names = from.keys() + to.keys();
+    std::sort(names.begin(), names.end());
+    names.erase(std::unique(names.begin(), names.end()), names.end());
+
+    QVector<FileDiff> diffs;
+    for (const QString &name : names) {
+        FileDiff result;
+        result.fileName = name;
+        auto fromIt = from.constFind(name);
+        auto toIt = to.constFind(name);
+
+        if (fromIt == from.constEnd()) {
+            result.kind = FileDiff::Added;
+            result.addedEntries = toIt->load().size();
+        } else if (toIt == to.constEnd()) {
+            result.kind = FileDiff::Removed;
+            result.removedEntries = fromIt->load().size();
+        } else if (fromIt->hash != toIt->hash) {
+            // Same hash means same JSON, only files that differ are decoded
+            diffEntries(fromIt->load(), toIt->load(), result);
+            result.kind = FileDiff::Modified;
+        }
+        diffs.append(result);
+    }
+    return diffs;
+}
+
+void TuningPreset::diffEntries(const LiveTuningStore &from, const LiveTuningStore &to, FileDiff &result)
+{
+    auto note = [&result](const QString &line) {
+        if (result.details.size() < MaxDetailsPerFile) {
+            result.details.append(line);
+        }
+    };
+
+    for (int i = 0; i < to.size(); ++i) {
+        if (to.indexOfKey(to.key(i)) != i) {
+            continue; // Overridden later in the same file
+        }
+        const int match = from.indexOf(to.prototype(i), to.setting(i));
+        if (match < 0) {
+            result.addedEntries++;
+            note(QString("+ %1 = %2").arg(entryName(to, i)).arg(to.value(i)));
+        } else if (from.value(match) != to.value(i)) {
+            result.changedEntries++;
+            note(QString("  %1: %2 -> %3").arg(entryName(to, i)).arg(from.value(match)).arg(to.value(i)));
+        }
+    }
+    for (int i = 0; i < from.size(); ++i) {
+        if (from.indexOfKey(from.key(i)) == i && to.indexOf(from.prototype(i), from.setting(i)) < 0) {
+            result.removedEntries++;
+            note(QString("- %1").arg(entryName(from, i)));
+        }
+    }
+}
+
+QString TuningPreset::summarize(const QVector<FileDiff> &diffs)
+{
+    QStringList lines;
+    int unchanged = 0;
+    for (const FileDiff &fileDiff : diffs) {
+        switch (fileDiff.kind) {
+        case FileDiff::Unchanged:
+            unchanged++;
+            continue;
+        case FileDiff::Added:
+            lines.append(QString("%1: enabled (%2 entries)").arg(fileDiff.fileName).arg(fileDiff.addedEntries));
+            continue;
+        case FileDiff::Removed:
+            lines.append(QString("%1: disabled (%2 entries)").arg(fileDiff.fileName).arg(fileDiff.removedEntries));
+            continue;
+        case FileDiff::Modified:
+            if (fileDiff.changedEntries == 0 && fileDiff.addedEntries == 0 && fileDiff.removedEntries == 0) {
+                lines.append(QString("%1: rewritten, no value changes").arg(fileDiff.fileName));
+                continue;
+            }
+            lines.append(QString("%1: %2 changed, %3 added, %4 removed")
+                             .arg(fileDiff.fileName)
+                             .arg(fileDiff.changedEntries)
+                             .arg(fileDiff.addedEntries)
+                             .arg(fileDiff.removedEntries));
+            for (const QString &detail : fileDiff.details) {
+                lines.append("    " + detail);
+            }
+            continue;
+        }
+    }
+    lines.prepend(QString("%1 file(s) unchanged, %2 would change.").arg(unchanged).arg(diffs.size() - unchanged));
+    return lines.join("\n");
+}
@@ -0,0 +1,103 @@
+#ifndef TUNINGPRESET_H
+#define TUNINGPRESET_H
+
+#include <QString>
+#include <QStringList>
+#include <QByteArray>
+#include <QDateTime>
+#include <QVector>
+#include <QMap>
+#include <QFile>
+#include <functional>
+#include "livetuningstore.h"
+
+// Named snapshot of every active LiveTuning file in a compact binary form that is read straight
+// from a memory mapping. Layout, all integers little-endian:
+//
+//   Header       magic "MHTP", version, file/string/entry counts, string bytes, creation time
+//   Files        per file: name string id, first entry, entry count, SHA-1 of the file's JSON
+//   Strings      offsets[stringCount + 1] followed by the UTF-8 bytes, padded to 8
+//   Values       double[entryCount]
+//   Prototypes   uint32[entryCount] string ids
+//   Settings     uint32[entryCount] string ids
+//
+// File names, prototypes and settings share one interned string table. The per-file hash is
+// the hash of the JSON that applying the preset writes, so unchanged files compare in O(1).
+class TuningPreset
+{
+public:
+    static constexpr quint32 Version = 1;
+    static constexpr int HashSize = 20;
+
+    TuningPreset() = default;
+    ~TuningPreset();
+    TuningPreset(const TuningPreset &) = delete;
+    TuningPreset &operator=(const TuningPreset &) = delete;
+
+    // Snapshot of the active LiveTuningData*.json files in a folder
+    static bool capture(const QString &liveTuningDir, QByteArray *snapshot, QString *errorMessage);
+    static QByteArray serialize(const QStringList &fileNames, const QVector<LiveTuningStore> &stores);
+
+    bool open(const QString &path, QString *errorMessage);
+    void close();
+    bool isOpen() const { return data != nullptr; }
+
+    QDateTime created() const;
+    int fileCount() const { return static_cast<int>(fileTotal); }
+    QString fileName(int file) const;
+    QByteArray fileHash(int file) const;
+    int entryCount(int file) const;
+    LiveTuningStore toStore(int file) const;
+
+    struct FileDiff {
+        enum Kind {
+            Unchanged,
+            Added,    // Active in the target only
+            Removed,  // Active in the source only
+            Modified
+        };
+        QString fileName;
+        Kind kind = Unchanged;
+        int addedEntries = 0;
+        int removedEntries = 0;
+        int changedEntries = 0;
+        QStringList details; // First few entry changes, "Prototype / Setting: a -> b"
+    };
+
+    // What applying this preset would change in the folder
+    QVector<FileDiff> diffFromFolder(const QString &liveTuningDir) const;
+    // What moving from the other preset to this one changes
+    QVector<FileDiff> diffFrom(const TuningPreset &other) const;
+
+    static QString summarize(const QVector<FileDiff> &diffs);
+
+private:
+    struct Side {
+        QByteArray hash;
+        std::function<LiveTuningStore()> load;
+    };
+
+    static QVector<FileDiff> diff(const QMap<QString, Side> &from, const QMap<QString, Side> &to);
+    static void diffEntries(const LiveTuningStore &from, const LiveTuningStore &to, FileDiff &result);
+    QMap<QString, Side> sides() const;
+
+    quint32 readUInt32(qint64 offset) const;
+    const char *string(quint32 id, int *size) const;
+
+    QFile file;
+    QByteArray fallback; // Used when the file can't be mapped
+    const char *data = nullptr;
+    qint64 size = 0;
+
+    quint32 fileTotal = 0;
+    quint32 stringTotal = 0;
+    quint32 entryTotal = 0;
+    qint64 filesOffset = 0;
+    qint64 stringOffsetsOffset = 0;
+    qint64 stringDataOffset = 0;
+    qint64 valuesOffset = 0;
+    qint64 prototypesOffset = 0;
+    qint64 settingsOffset = 0;
+};
+
+#endif // TUNINGPRESET_H
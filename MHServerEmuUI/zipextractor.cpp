@@ -0,0 +1,521 @@
+#include "zipextractor.h"
+#include "inflate.h"
+#include <QFile>
+#include <QDir>
+#include <QFileInfo>
+#include <QPointer>
+#include <QtEndian>
+#include <QDebug>
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+constexpr quint32 LocalHeaderSignature = 0x04034b50;
+constexpr quint32 CentralHeaderSignature = 0x02014b50;
+constexpr quint32 EndOfCentralDirSignature = 0x06054b50;
+constexpr quint32 Zip64LocatorSignature = 0x07064b50;
+constexpr quint32 Zip64EndSignature = 0x06064b50;
+constexpr int LocalHeaderSize = 30;
+constexpr int CentralHeaderSize = 46;
+constexpr int EndOfCentralDirSize = 22;
+
+constexpr quint16 EncryptedFlag = 0x0001;
+constexpr quint16 DataDescriptorFlag = 0x0008; // Sizes and CRC follow the data instead
+constexpr quint16 Utf8NameFlag = 0x0800;
+
+quint16 le16(const QByteArray &data, qint64 offset) { return qFromLittleEndian<quint16>(data.constData() + offset); }
+quint32 le32(const QByteArray &data, qint64 offset) { return qFromLittleEndian<quint32>(data.constData() + offset); }
+quint64 le64(const QByteArray &data, qint64 offset) { return qFromLittleEndian<quint64>(data.constData() + offset); }
+
+QString entryName(const QByteArray &raw, quint16 flags)
+{
+    QString name = flags & Utf8NameFlag ? QString::fromUtf8(raw) : QString::fromLatin1(raw);
+    return name.replace(QLatin1Char('\\'), QLatin1Char('/'));
+}
+
+bool fail(QString *errorMessage, const QString &message)
+{
+    if (errorMessage) {
+        *errorMessage = message;
+    }
+    return false;
+}
+
+struct EndRecord {
+    quint64 count = 0;
+    quint64 directorySize = 0;
+    quint64 directoryOffset = 0;
+};
+
+// Finds the end of central directory record and checks it accounts for the whole file: the
+// record and its comment end exactly at the end of the file, and the central directory ends
+// where the end records begin. A cut short or padded download fails here.
+bool readEndRecord(QFile &file, EndRecord *record, QString *errorMessage)
+{
+    const qint64 fileSize = file.size();
+
+    // The end record sits in the last 22 bytes plus a comment of up to 64 KiB
+    const qint64 tailSize = qMin<qint64>(fileSize, EndOfCentralDirSize + 0xFFFF);
+    const qint64 tailOffset = fileSize - tailSize;
+    file.seek(tailOffset);
+    const QByteArray tail = file.read(tailSize);
+    qint64 end = tail.size() - EndOfCentralDirSize;
+    while (end >= 0 && (le32(tail, end) != EndOfCentralDirSignature
+                        || end + EndOfCentralDirSize + le16(tail, end + 20) != tail.size())) {
+        --end;
+    }
+    if (end < 0) {
+        return fail(errorMessage, "Not a complete ZIP archive (no end of central directory record at the end of the file).");
+    }
+
+    record->count = le16(tail, end + 10);
+    record->directorySize = le32(tail, end + 12);
+    record->directoryOffset = le32(tail, end + 16);
+    quint64 recordsOffset = quint64(tailOffset + end);
+    // Saturated fields mean ZIP64, unless there is no locator and 65535 entries is the real count
+    const bool saturated = record->count == 0xFFFF || record->directorySize == 0xFFFFFFFF || record->directoryOffset == 0xFFFFFFFF;
+    if (saturated && end >= 20 && le32(tail, end - 20) == Zip64LocatorSignature) {
+        recordsOffset = le64(tail, end - 20 + 8);
+        file.seek(qint64(recordsOffset));
+        const QByteArray zip64 = file.read(56);
+        if (zip64.size() < 56 || le32(zip64, 0) != Zip64EndSignature) {
+            return fail(errorMessage, "Corrupt ZIP64 end of central directory record.");
+        }
+        record->count = le64(zip64, 32);
+        record->directorySize = le64(zip64, 40);
+        record->directoryOffset = le64(zip64, 48);
+    }
+    if (record->directoryOffset > recordsOffset || recordsOffset - record->directoryOffset != record->directorySize) {
+        return fail(errorMessage, "The central directory doesn't end where the end of central directory record says.");
+    }
+    return true;
+}
+
+} // namespace
+
+ZipExtractor::ZipExtractor(const QString &destinationDir, QObject *parent)
+    : QObject(parent)
+    , destinationDir(destinationDir)
+    , memoryBudget(MemoryBudgetMiB)
+{
+}
+
+ZipExtractor::~ZipExtractor()
+{
+    canceled.storeRelaxed(1);
+    pool.waitForDone();
+}
+
+bool ZipExtractor::checkArchiveEnd(const QString &archivePath, QString *errorMessage)
+{
+    QFile file(archivePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return fail(errorMessage, QString("Could not open %1: %2").arg(archivePath, file.errorString()));
+    }
+    EndRecord record;
+    return readEndRecord(file, &record, errorMessage);
+}
+
+bool ZipExtractor::readCentralDirectory(const QString &archivePath, QVector<Entry> *entries, QString *errorMessage)
+{
+    QFile file(archivePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return fail(errorMessage, QString("Could not open %1: %2").arg(archivePath, file.errorString()));
+    }
+    const qint64 fileSize = file.size();
+
+    EndRecord record;
+    if (!readEndRecord(file, &record, errorMessage)) {
+        return false;
+    }
+    const quint64 count = record.count;
+    const quint64 directorySize = record.directorySize;
+    const quint64 directoryOffset = record.directoryOffset;
+
+    file.seek(qint64(directoryOffset));
+    const QByteArray directory = file.read(qint64(directorySize));
+    entries->clear();
+    entries->reserve(int(qMin<quint64>(count, 1 << 20)));
+
+    qint64 pos = 0;
+    for (quint64 i = 0; i < count; ++i) {
+        if (pos + CentralHeaderSize > directory.size() || le32(directory, pos) != CentralHeaderSignature) {
+            return fail(errorMessage, QString("Corrupt central directory at entry %1.").arg(i));
+        }
+        const int nameLength = le16(directory, pos + 28);
+        const int extraLength = le16(directory, pos + 30);
+        const int commentLength = le16(directory, pos + 32);
+        if (pos + CentralHeaderSize + nameLength + extraLength + commentLength > directory.size()) {
+            return fail(errorMessage, QString("Corrupt central directory at entry %1.").arg(i));
+        }
+
+        Entry entry;
+        entry.flags = le16(directory, pos + 8);
+        entry.method = le16(directory, pos + 10);
+        entry.crc = le32(directory, pos + 16);
+        quint64 compressedSize = le32(directory, pos + 20);
+        quint64 size = le32(directory, pos + 24);
+        quint64 headerOffset = le32(directory, pos + 42);
+        entry.name = entryName(directory.mid(pos + CentralHeaderSize, nameLength), entry.flags);
+
+        // ZIP64 extra field: only the values that overflowed are present, in this order
+        qint64 extra = pos + CentralHeaderSize + nameLength;
+        const qint64 extraEnd = extra + extraLength;
+        while (extra + 4 <= extraEnd) {
+            const quint16 id = le16(directory, extra);
+            const quint16 length = le16(directory, extra + 2);
+            qint64 field = extra + 4;
+            const qint64 fieldEnd = qMin(field + length, extraEnd);
+            if (id == 0x0001) {
+                if (size == 0xFFFFFFFF && field + 8 <= fieldEnd) {
+                    size = le64(directory, field);
+                    field += 8;
+                }
+                if (compressedSize == 0xFFFFFFFF && field + 8 <= fieldEnd) {
+                    compressedSize = le64(directory, field);
+                    field += 8;
+                }
+                if (headerOffset == 0xFFFFFFFF && field + 8 <= fieldEnd) {
+                    headerOffset = le64(directory, field);
+                }
+            }
+            extra += 4 + length;
+        }
+
+        entry.compressedSize = qint64(compressedSize);
+        entry.size = qint64(size);
+        entry.headerOffset = qint64(headerOffset);
+        if (entry.flags & EncryptedFlag) {
+            return fail(errorMessage, QString("%1 is encrypted.").arg(entry.name));
+        }
+        if (entry.compressedSize < 0 || entry.size < 0 || entry.headerOffset + entry.compressedSize > fileSize) {
+            return fail(errorMessage, QString("%1 lies outside the archive.").arg(entry.name));
+        }
+        entries->append(entry);
+        pos += CentralHeaderSize + nameLength + extraLength + commentLength;
+    }
+    return true;
+}
+
+bool ZipExtractor::isSafeName(const QString &name)
+{
+    // Nothing may land outside the destination folder
+    if (name.isEmpty() || name.startsWith(QLatin1Char('/')) || (name.size() > 1 && name.at(1) == QLatin1Char(':'))) {
+        return false;
+    }
+    const QStringList parts = name.split(QLatin1Char('/'));
+    return !parts.contains(QLatin1String(".."));
+}
+
+bool ZipExtractor::sameEntry(const Entry &a, const Entry &b)
+{
+    return a.headerOffset == b.headerOffset && a.name == b.name && a.crc == b.crc
+           && a.size == b.size && a.compressedSize == b.compressedSize;
+}
+
+bool ZipExtractor::extractEntry(const QString &archivePath, const Entry &entry, const QString &root,
+                                const QAtomicInt *canceled, QSemaphore *memoryBudget, QString *errorMessage)
+{
+    if (canceled->loadRelaxed()) {
+        return fail(errorMessage, "Extraction cancelled.");
+    }
+
+    // The sizes may come from a local header nothing has checked yet
+    if (entry.size > MaxEntrySize || entry.compressedSize > MaxEntrySize) {
+        return fail(errorMessage, QString("%1: %2 bytes is more than an update file can hold.").arg(entry.name).arg(qMax(entry.size, entry.compressedSize)));
+    }
+    const qint64 mebibyte = 1024 * 1024;
+    const int budget = int(qBound<qint64>(1, (entry.size + entry.compressedSize + mebibyte - 1) / mebibyte, MemoryBudgetMiB));
+    while (!memoryBudget->tryAcquire(budget, 100)) {
+        if (canceled->loadRelaxed()) {
+            return fail(errorMessage, "Extraction cancelled.");
+        }
+    }
+    QSemaphoreReleaser releaseBudget(memoryBudget, budget);
+
+    QFile file(archivePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return fail(errorMessage, QString("Could not open %1: %2").arg(archivePath, file.errorString()));
+    }
+
+    // The local header's name and extra lengths can differ from the central directory's
+    file.seek(entry.headerOffset);
+    const QByteArray header = file.read(LocalHeaderSize);
+    if (header.size() < LocalHeaderSize || le32(header, 0) != LocalHeaderSignature) {
+        return fail(errorMessage, QString("%1: missing local header.").arg(entry.name));
+    }
+    const qint64 dataOffset = entry.headerOffset + LocalHeaderSize + le16(header, 26) + le16(header, 28);
+    if (dataOffset + entry.compressedSize > file.size()) {
+        return fail(errorMessage, QString("%1: data runs past the end of the archive.").arg(entry.name));
+    }
+
+    // Mapped when possible, so the compressed bytes aren't copied before inflating
+    QByteArray buffered;
+    const char *compressed = nullptr;
+    uchar *mapped = entry.compressedSize > 0 ? file.map(dataOffset, entry.compressedSize) : nullptr;
+    if (mapped) {
+        compressed = reinterpret_cast<const char *>(mapped);
+    } else {
+        file.seek(dataOffset);
+        buffered = file.read(entry.compressedSize);
+        if (buffered.size() != entry.compressedSize) {
+            return fail(errorMessage, QString("%1: could not read the compressed data.").arg(entry.name));
+        }
+        compressed = buffered.constData();
+    }
+
+    QByteArray output(entry.size, Qt::Uninitialized);
+    QString inflateError;
+    bool ok = true;
+    if (entry.method == 0) {
+        ok = entry.compressedSize == entry.size;
+        if (ok) {
+            std::memcpy(output.data(), compressed, size_t(entry.size));
+        } else {
+            inflateError = "stored size mismatch";
+        }
+    } else if (entry.method == 8) {
+        ok = Inflate::inflate(compressed, entry.compressedSize, output.data(), entry.size, &inflateError);
+    } else {
+        ok = false;
+        inflateError = QString("compression method %1 isn't supported").arg(entry.method);
+    }
+    if (mapped) {
+        file.unmap(mapped);
+    }
+    file.close();
+    if (!ok) {
+        return fail(errorMessage, QString("%1: %2.").arg(entry.name, inflateError));
+    }
+    if (Inflate::crc32(output.constData(), output.size()) != entry.crc) {
+        return fail(errorMessage, QString("%1: CRC-32 mismatch.").arg(entry.name));
+    }
+
+    // One write of the whole file
+    const QString path = root + QLatin1Char('/') + entry.name;
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    QFile out(path);
+    if (!out.open(QIODevice::WriteOnly | QIODevice::Truncate) || out.write(output) != output.size()) {
+        return fail(errorMessage, QString("Could not write %1: %2").arg(path, out.errorString()));
+    }
+    return true;
+}
+
+void ZipExtractor::beginStreaming(const QString &partPath)
+{
+    streaming = true;
+    streamPath = partPath;
+    scanOffset = 0;
+    seenBytes = 0;
+}
+
+void ZipExtractor::archiveGrew(qint64 bytesOnDisk)
+{
+    if (!streaming) {
+        return;
+    }
+    if (bytesOnDisk < seenBytes) {
+        // The download started over; the central directory sorts it out at the end
+        streaming = false;
+        return;
+    }
+    seenBytes = bytesOnDisk;
+
+    QFile file(streamPath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return;
+    }
+
+    while (scanOffset + LocalHeaderSize <= bytesOnDisk) {
+        file.seek(scanOffset);
+        const QByteArray header = file.read(LocalHeaderSize);
+        if (header.size() < LocalHeaderSize) {
+            return;
+        }
+
+        // The central directory, or an entry that doesn't say where it ends: the rest has to
+        // wait for the whole archive
+        const quint16 flags = le16(header, 6);
+        const quint32 compressedSize = le32(header, 18);
+        const quint32 size = le32(header, 22);
+        if (le32(header, 0) != LocalHeaderSignature || flags & (DataDescriptorFlag | EncryptedFlag)
+            || compressedSize == 0xFFFFFFFF || size == 0xFFFFFFFF) {
+            streaming = false;
+            return;
+        }
+
+        const int nameLength = le16(header, 26);
+        const qint64 dataOffset = scanOffset + LocalHeaderSize + nameLength + le16(header, 28);
+        if (dataOffset + compressedSize > bytesOnDisk) {
+            return; // Not all here yet
+        }
+
+        Entry entry;
+        entry.flags = flags;
+        entry.method = le16(header, 8);
+        entry.crc = le32(header, 14);
+        entry.compressedSize = compressedSize;
+        entry.size = size;
+        entry.headerOffset = scanOffset;
+        entry.name = entryName(file.read(nameLength), flags);
+        scanOffset = dataOffset + compressedSize;
+
+        if (!isSafeName(entry.name)) {
+            continue; // Rejected properly by the final pass
+        }
+        if (entry.name.endsWith(QLatin1Char('/'))) {
+            QDir().mkpath(destinationDir + QLatin1Char('/') + entry.name);
+            done.insert(entry.headerOffset, entry);
+            continue;
+        }
+        schedule(streamPath, entry, true);
+    }
+}
+
+void ZipExtractor::releaseArchive()
+{
+    streaming = false;
+    pool.waitForDone();
+}
+
+void ZipExtractor::extract(const QString &archivePath)
+{
+    archive = archivePath;
+    streaming = false;
+    finalPass = true;
+    ended = false;
+
+    QVector<Entry> entries;
+    QString errorMessage;
+    if (!readCentralDirectory(archivePath, &entries, &errorMessage)) {
+        finish(false, errorMessage);
+        return;
+    }
+
+    files.clear();
+    outstanding.clear();
+    filesDone = 0;
+    filesTotal = 0;
+    bytesTotal = 0;
+    bytesDone = 0;
+
+    QVector<Entry> toSchedule;
+    for (const Entry &entry : entries) {
+        if (!isSafeName(entry.name)) {
+            finish(false, QString("Refusing to extract %1 outside the destination folder.").arg(entry.name));
+            return;
+        }
+        if (entry.name.endsWith(QLatin1Char('/'))) {
+            QDir().mkpath(destinationDir + QLatin1Char('/') + entry.name);
+            continue;
+        }
+
+        files.append(entry.name);
+        ++filesTotal;
+        bytesTotal += entry.size;
+
+        auto it = done.constFind(entry.headerOffset);
+        if (it != done.constEnd() && sameEntry(*it, entry)) {
+            ++filesDone;
+            bytesDone += entry.size;
+            continue;
+        }
+        outstanding.insert(entry.headerOffset, entry);
+        if (!inFlight.contains(entry.headerOffset)) {
+            toSchedule.append(entry);
+        }
+    }
+
+    qDebug() << filesDone << "of" << filesTotal << "files were extracted while downloading";
+    emit progress(bytesDone, bytesTotal);
+    if (outstanding.isEmpty()) {
+        finish(true, QString());
+        return;
+    }
+
+    // Biggest first, so one large file doesn't end up running alone at the end
+    std::sort(toSchedule.begin(), toSchedule.end(), [](const Entry &a, const Entry &b) {
+        return a.size > b.size;
+    });
+    for (const Entry &entry : toSchedule) {
+        schedule(archivePath, entry, false);
+    }
+}
+
+void ZipExtractor::cancel()
+{
+    canceled.storeRelaxed(1);
+    streaming = false;
+    if (finalPass && !ended) {
+        finish(false, "Extraction cancelled.");
+    }
+}
+
+void ZipExtractor::schedule(const QString &archivePath, const Entry &entry, bool streamed)
+{
+    inFlight.insert(entry.headerOffset);
+
+    QPointer<ZipExtractor> self(this);
+    const QString root = destinationDir;
+    const QAtomicInt *cancelFlag = &canceled; // The destructor waits for the pool
+    QSemaphore *budget = &memoryBudget;
+    pool.start([self, archivePath, entry, root, cancelFlag, budget, streamed]() {
+        QString errorMessage;
+        const bool ok = extractEntry(archivePath, entry, root, cancelFlag, budget, &errorMessage);
+        QMetaObject::invokeMethod(self.data(), [self, entry, ok, errorMessage, streamed]() {
+            if (self) {
+                self->entryDone(entry, ok, errorMessage, streamed);
+            }
+        }, Qt::QueuedConnection);
+    });
+}
+
+void ZipExtractor::entryDone(const Entry &entry, bool ok, const QString &errorMessage, bool streamed)
+{
+    inFlight.remove(entry.headerOffset);
+    if (ok) {
+        done.insert(entry.headerOffset, entry);
+    }
+
+    if (!finalPass) {
+        // Failures while streaming aren't final, the entry is tried again from the complete archive
+        if (ok) {
+            bytesDone += entry.size;
+            emit fileExtracted(entry.name, done.size(), 0);
+            emit progress(bytesDone, -1);
+        } else {
+            qDebug() << "Extracting" << entry.name << "while downloading failed:" << errorMessage;
+        }
+        return;
+    }
+    if (ended) {
+        return;
+    }
+
+    auto it = outstanding.find(entry.headerOffset);
+    if (it == outstanding.end()) {
+        return;
+    }
+    if (ok && sameEntry(*it, entry)) {
+        outstanding.erase(it);
+        ++filesDone;
+        bytesDone += entry.size;
+        emit fileExtracted(entry.name, filesDone, filesTotal);
+        emit progress(bytesDone, bytesTotal);
+        if (outstanding.isEmpty()) {
+            finish(true, QString());
+        }
+    } else if (streamed) {
+        schedule(archive, *it, false); // Started from the part file, redo it from the archive
+    } else {
+        canceled.storeRelaxed(1);
+        finish(false, errorMessage);
+    }
+}
+
+void ZipExtractor::finish(bool success, const QString &errorMessage)
+{
+    ended = true;
+    emit finished(success, errorMessage);
+}
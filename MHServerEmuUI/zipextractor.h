@@ -0,0 +1,103 @@
+#ifndef ZIPEXTRACTOR_H
+#define ZIPEXTRACTOR_H
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QHash>
+#include <QSet>
+#include <QAtomicInt>
+#include <QSemaphore>
+#include <QThreadPool>
+
+// Extracts a ZIP archive into a folder, inflating entries in parallel on its own pool.
+// It can start on an archive that is still being downloaded: entries whose local header
+// gives their size are extracted as soon as their bytes are on disk, and once the archive
+// is complete the central directory decides what is still missing. Every entry is checked
+// against its CRC-32 before it counts as extracted.
+class ZipExtractor : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Entry {
+        QString name;           // Relative, '/'-separated; directories end with '/'
+        quint16 flags = 0;
+        quint16 method = 0;     // 0 stored, 8 deflated
+        quint32 crc = 0;
+        qint64 compressedSize = 0;
+        qint64 size = 0;
+        qint64 headerOffset = 0; // Local file header
+    };
+
+    // Each entry is inflated whole in memory: one can't be larger than MaxEntrySize, and the
+    // entries in flight together hold at most MemoryBudgetMiB (a larger one runs alone)
+    static constexpr qint64 MaxEntrySize = qint64(1) << 30;
+    static constexpr int MemoryBudgetMiB = 512;
+
+    explicit ZipExtractor(const QString &destinationDir, QObject *parent = nullptr);
+    ~ZipExtractor() override; // Cancels and waits for the workers
+
+    // The end of central directory record ends the file and the central directory ends where it
+    // begins; anything else is a truncated or padded download
+    static bool checkArchiveEnd(const QString &archivePath, QString *errorMessage);
+    static bool readCentralDirectory(const QString &archivePath, QVector<Entry> *entries, QString *errorMessage);
+
+    QString destination() const { return destinationDir; }
+    void setThreadCount(int count) { pool.setMaxThreadCount(count); }
+
+    // Streaming: feed the part file's size as it grows (NightlyDownloader::bytesWritten)
+    void beginStreaming(const QString &partPath);
+    void archiveGrew(qint64 bytesOnDisk);
+    // Blocks until no worker reads the part file any more, so it can be renamed or removed
+    void releaseArchive();
+
+    // The archive is complete: extracts whatever isn't already, then emits finished
+    void extract(const QString &archivePath);
+    void cancel();
+
+    QStringList extractedFiles() const { return files; } // Relative paths of the files, once finished
+
+signals:
+    void fileExtracted(const QString &name, int filesDone, int filesTotal); // Total is 0 while streaming
+    void progress(qint64 bytesWritten, qint64 bytesTotal);                 // Total is -1 while streaming
+    void finished(bool success, const QString &errorMessage);
+
+private:
+    static bool isSafeName(const QString &name);
+    static bool sameEntry(const Entry &a, const Entry &b);
+    static bool extractEntry(const QString &archivePath, const Entry &entry, const QString &root,
+                             const QAtomicInt *canceled, QSemaphore *memoryBudget, QString *errorMessage);
+
+    void schedule(const QString &archivePath, const Entry &entry, bool streamed);
+    void entryDone(const Entry &entry, bool ok, const QString &errorMessage, bool streamed);
+    void finish(bool success, const QString &errorMessage);
+
+    QString destinationDir;
+    QThreadPool pool;
+    QAtomicInt canceled;
+    QSemaphore memoryBudget; // In MiB
+
+    QHash<qint64, Entry> done; // By local header offset
+    QSet<qint64> inFlight;
+    qint64 bytesDone = 0;
+
+    // Streaming from the part file
+    bool streaming = false;
+    QString streamPath;
+    qint64 scanOffset = 0;
+    qint64 seenBytes = 0;
+
+    // Final pass over the central directory
+    bool finalPass = false;
+    bool ended = false;
+    QString archive;
+    QHash<qint64, Entry> outstanding;
+    QStringList files;
+    int filesDone = 0;
+    int filesTotal = 0;
+    qint64 bytesTotal = 0;
+};
+
+#endif // ZIPEXTRACTOR_H